@@ -679,6 +679,16 @@ typedef bool (stat_print_fn)(THD *thd, const char *type, size_t type_len,
                              const char *file, size_t file_len,
                              const char *status, size_t status_len);
 enum ha_stat_type { HA_ENGINE_STATUS, HA_ENGINE_LOGS, HA_ENGINE_MUTEX };
+
+/** Comparison of a column with a constant, see handler::column_filter() */
+enum ha_column_filter_op
+{
+  HA_COLUMN_FILTER_EQ,
+  HA_COLUMN_FILTER_LT,
+  HA_COLUMN_FILTER_LE,
+  HA_COLUMN_FILTER_GT,
+  HA_COLUMN_FILTER_GE
+};
 enum ha_notification_type { HA_NOTIFY_PRE_EVENT, HA_NOTIFY_POST_EVENT };
 
 extern st_plugin_int *hton2plugin[MAX_HA];
@@ -2745,6 +2755,23 @@ public:
   virtual ha_rows estimate_rows_upper_bound()
   { return stats.records+EXTRA_RECORDS; }
 
+  /**
+    Estimate the fraction of the rows of the table where a column compares
+    true with a constant, from statistics that the storage engine keeps on
+    the values of the column.
+
+    @param field  column of the table
+    @param op     comparison, with the column as the left operand
+    @param value  constant that the column is compared with
+
+    @return fraction of the rows between 0 and 1, or a negative value if
+    there are no statistics for the column
+  */
+  virtual double column_filter(const Field *field,
+                               enum ha_column_filter_op op,
+                               double value)
+  { return -1.0; }
+
   /**
     Get the row type from the storage engine.  If this method returns
     ROW_TYPE_NOT_USED, the information in HA_CREATE_INFO should be used.
@@ -2532,6 +2532,72 @@ longlong Item_func_equal::val_int()
   return cmp.compare();
 }
 
+/**
+  Calculate the filtering effect of comparing a field with a value from the
+  statistics that the storage engine keeps on the values of the field, see
+  handler::column_filter().
+
+  @param      fld     field in the table that filtering is calculated for
+  @param      value   value that the field is compared with
+  @param      op      comparison, with fld as the left operand
+  @param[out] filter  the filtering effect
+
+  @retval true   the filtering effect was calculated
+  @retval false  there are no statistics for the field, or value is not a
+                 numeric constant that is cheap to evaluate
+*/
+static bool get_column_filter(const Item_field *fld, Item *value,
+                              ha_column_filter_op op, float *filter)
+{
+  if (!value->const_item() || value->is_expensive())
+    return false;
+
+  switch (value->result_type())
+  {
+  case INT_RESULT:
+  case REAL_RESULT:
+  case DECIMAL_RESULT:
+    break;
+  default:
+    return false;
+  }
+
+  const double val= value->val_real();
+  if (value->null_value)
+    return false;
+
+  const double res=
+    fld->field->table->file->column_filter(fld->field, op, val);
+  if (res < 0.0)
+    return false;
+
+  *filter= static_cast<float>(res);
+  return true;
+}
+
+
+/**
+  Calculate the filtering effect of "args[0] op args[1]" where one of the
+  operands is fld, see get_column_filter().
+*/
+static bool get_column_filter(const Item_field *fld, Item **args,
+                              ha_column_filter_op op, float *filter)
+{
+  if (args[0]->real_item() == fld)
+    return get_column_filter(fld, args[1], op, filter);
+
+  // "value op fld": turn it around
+  switch (op)
+  {
+  case HA_COLUMN_FILTER_LT: op= HA_COLUMN_FILTER_GT; break;
+  case HA_COLUMN_FILTER_LE: op= HA_COLUMN_FILTER_GE; break;
+  case HA_COLUMN_FILTER_GT: op= HA_COLUMN_FILTER_LT; break;
+  case HA_COLUMN_FILTER_GE: op= HA_COLUMN_FILTER_LE; break;
+  case HA_COLUMN_FILTER_EQ: break;
+  }
+  return get_column_filter(fld, args[0], op, filter);
+}
+
 float Item_func_ne::get_filtering_effect(table_map filter_for_table,
                                          table_map read_tables,
                                          const MY_BITMAP *fields_to_ignore,
@@ -2542,6 +2608,10 @@ float Item_func_ne::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
+  float filter;
+  if (get_column_filter(fld, args, HA_COLUMN_FILTER_EQ, &filter))
+    return 1.0f - filter;
+
   return 1.0f - fld->get_cond_filter_default_probability(rows_in_table,
                                                          COND_FILTER_EQUALITY);
 }
@@ -2577,6 +2647,10 @@ float Item_func_ge::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
+  float filter;
+  if (get_column_filter(fld, args, HA_COLUMN_FILTER_GE, &filter))
+    return filter;
+
   return fld->get_cond_filter_default_probability(rows_in_table,
                                                   COND_FILTER_INEQUALITY);
 }
@@ -2591,6 +2665,10 @@ float Item_func_lt::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
+  float filter;
+  if (get_column_filter(fld, args, HA_COLUMN_FILTER_LT, &filter))
+    return filter;
+
   return fld->get_cond_filter_default_probability(rows_in_table,
                                                   COND_FILTER_INEQUALITY);
 }
@@ -2605,6 +2683,10 @@ float Item_func_le::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
+  float filter;
+  if (get_column_filter(fld, args, HA_COLUMN_FILTER_LE, &filter))
+    return filter;
+
   return fld->get_cond_filter_default_probability(rows_in_table,
                                                   COND_FILTER_INEQUALITY);
 }
@@ -2619,6 +2701,10 @@ float Item_func_gt::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
+  float filter;
+  if (get_column_filter(fld, args, HA_COLUMN_FILTER_GT, &filter))
+    return filter;
+
   return fld->get_cond_filter_default_probability(rows_in_table,
                                                   COND_FILTER_INEQUALITY);
 }
@@ -3106,9 +3192,16 @@ Item_func_between::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
-  const float filter=
-    fld->get_cond_filter_default_probability(rows_in_table,
-                                             COND_FILTER_BETWEEN);
+  float filter;
+  float filter_low, filter_high;
+  if (args[0]->real_item() == fld &&
+      get_column_filter(fld, args[1], HA_COLUMN_FILTER_LT, &filter_low) &&
+      get_column_filter(fld, args[2], HA_COLUMN_FILTER_LE, &filter_high))
+    filter= std::max(filter_high - filter_low,
+                     static_cast<float>(1 / rows_in_table));
+  else
+    filter= fld->get_cond_filter_default_probability(rows_in_table,
+                                                     COND_FILTER_BETWEEN);
 
   return negated ? 1.0f - filter : filter;
 }
@@ -7546,8 +7639,15 @@ float Item_equal::get_filtering_effect(table_map filter_for_table,
           cur_field->get_cond_filter_default_probability(rows_in_table,
                                                          COND_FILTER_EQUALITY);
 
+        // Use the statistics on the values of the field if available
+        const bool have_column_filter=
+          const_item &&
+          get_column_filter(cur_field, const_item, HA_COLUMN_FILTER_EQ,
+                            &cur_filter);
+
         // Use index statistics if available for this field
-        if (!cur_field->field->key_start.is_clear_all())
+        if (!have_column_filter &&
+            !cur_field->field->key_start.is_clear_all())
         { 
           // cur_field is indexed - there may be statistics for it.
           const TABLE *tab= cur_field->field->table;
@@ -7959,6 +8059,10 @@ float Item_func_eq::get_filtering_effect(table_map filter_for_table,
   if (!fld)
     return COND_FILTER_ALLPASS;
 
+  float filter;
+  if (get_column_filter(fld, args, HA_COLUMN_FILTER_EQ, &filter))
+    return filter;
+
   return fld->get_cond_filter_default_probability(rows_in_table,
                                                   COND_FILTER_EQUALITY);
 }
@@ -767,8 +767,7 @@ btr_page_get_father_node_ptr_func(
 	} else {
 		btr_cur_search_to_nth_level(
 			index, level + 1, tuple,
-			PAGE_CUR_LE, latch_mode, cursor, 0,
-			file, line, mtr);
+			PAGE_CUR_LE, latch_mode, cursor, file, line, mtr);
 	}
 
 	node_ptr = btr_cur_get_rec(cursor);
@@ -1128,12 +1127,15 @@ btr_create(
 /** Free a B-tree except the root page. The root page MUST be freed after
 this by calling btr_free_root.
 @param[in,out]	block		root page
-@param[in]	log_mode	mtr logging mode */
+@param[in]	log_mode	mtr logging mode
+@param[in]	ahi		whether to drop the adaptive hash index
+				entries of the freed pages */
 static
 void
 btr_free_but_not_root(
 	buf_block_t*	block,
-	mtr_log_t	log_mode)
+	mtr_log_t	log_mode,
+	bool		ahi)
 {
 	ibool	finished;
 	mtr_t	mtr;
@@ -1154,10 +1156,11 @@ leaf_loop:
 #endif /* UNIV_BTR_DEBUG */
 
 	/* NOTE: page hash indexes are dropped when a page is freed inside
-	fsp0fsp. */
+	fsp0fsp, unless ahi is false. Then they are dropped when the page
+	is evicted from the buffer pool or allocated again. */
 
 	finished = fseg_free_step(root + PAGE_HEADER + PAGE_BTR_SEG_LEAF,
-				  true, &mtr);
+				  ahi, &mtr);
 	mtr_commit(&mtr);
 
 	if (!finished) {
@@ -1177,7 +1180,7 @@ top_loop:
 #endif /* UNIV_BTR_DEBUG */
 
 	finished = fseg_free_step_not_header(
-		root + PAGE_HEADER + PAGE_BTR_SEG_TOP, true, &mtr);
+		root + PAGE_HEADER + PAGE_BTR_SEG_TOP, ahi, &mtr);
 	mtr_commit(&mtr);
 
 	if (!finished) {
@@ -1190,12 +1193,15 @@ top_loop:
 @param[in]	page_id		root page id
 @param[in]	page_size	page size
 @param[in]	index_id	PAGE_INDEX_ID contents
+@param[in]	ahi		whether to drop the adaptive hash index
+				entries of the freed pages
 @param[in,out]	mtr		mini-transaction */
 void
 btr_free_if_exists(
 	const page_id_t&	page_id,
 	const page_size_t&	page_size,
 	index_id_t		index_id,
+	bool			ahi,
 	mtr_t*			mtr)
 {
 	buf_block_t* root = btr_free_root_check(
@@ -1205,7 +1211,7 @@ btr_free_if_exists(
 		return;
 	}
 
-	btr_free_but_not_root(root, mtr->get_log_mode());
+	btr_free_but_not_root(root, mtr->get_log_mode(), ahi);
 	mtr->set_named_space(page_id.space());
 	btr_free_root(root, mtr);
 	btr_free_root_invalidate(root, mtr);
@@ -1228,7 +1234,7 @@ btr_free(
 
 	ut_ad(page_is_root(block->frame));
 
-	btr_free_but_not_root(block, MTR_LOG_NO_REDO);
+	btr_free_but_not_root(block, MTR_LOG_NO_REDO, true);
 	btr_free_root(block, &mtr);
 	mtr.commit();
 }
@@ -1504,7 +1510,7 @@ btr_page_reorganize(
 	dict_index_t*	index,	/*!< in: the index tree of the page */
 	mtr_t*		mtr)	/*!< in/out: mini-transaction */
 {
-	return(btr_page_reorganize_low(false, page_zip_level,
+	return(btr_page_reorganize_low(false, page_zip_get_level(),
 				       cursor, index, mtr));
 }
 #endif /* !UNIV_HOTBACKUP */
@@ -1538,7 +1544,8 @@ btr_parse_page_reorganize(
 
 		level = mach_read_from_1(ptr);
 
-		ut_a(level <= 9);
+		ut_a((level & PAGE_ZIP_LEVEL_MASK) <= 9);
+		ut_a(level >> PAGE_ZIP_LEVEL_CODEC_SHIFT < PAGE_ZIP_CODEC_N);
 		++ptr;
 	} else {
 		level = page_zip_level;
@@ -2129,7 +2136,7 @@ btr_insert_on_non_leaf_level_func(
 			btr_cur_search_to_nth_level(
 				index, level, tuple, PAGE_CUR_LE,
 				BTR_CONT_MODIFY_TREE,
-				&cursor, 0, file, line, mtr);
+				&cursor, file, line, mtr);
 		}
 	} else {
 		/* For spatial index, initialize structures to track
@@ -2141,7 +2148,7 @@ btr_insert_on_non_leaf_level_func(
 		btr_cur_search_to_nth_level(index, level, tuple,
 					    PAGE_CUR_RTREE_INSERT,
 					    BTR_CONT_MODIFY_TREE,
-					    &cursor, 0, file, line, mtr);
+					    &cursor, file, line, mtr);
 	}
 
 	ut_ad(cursor.flag == BTR_CUR_BINARY);
@@ -2555,6 +2562,8 @@ btr_page_split_and_insert(
 						 tuple, n_ext, mtr));
 	}
 
+	DEBUG_SYNC_C("btr_page_split_and_insert");
+
 	if (!*heap) {
 		*heap = mem_heap_create(1024);
 	}
@@ -2908,6 +2917,10 @@ func_exit:
 
 	MONITOR_INC(MONITOR_INDEX_SPLIT);
 
+	/* Let the inserts that found a page full before the split
+	know that they may find room now. */
+	cursor->index->smo_seq++;
+
 	ut_ad(page_validate(buf_block_get_frame(left_block), cursor->index));
 	ut_ad(page_validate(buf_block_get_frame(right_block), cursor->index));
 
@@ -5155,7 +5168,7 @@ btr_can_merge_with_page(
 		/* We have to reorganize mpage */
 
 		if (!btr_page_reorganize_block(
-			    false, page_zip_level, mblock, index, mtr)) {
+			    false, page_zip_get_level(), mblock, index, mtr)) {
 
 			goto error;
 		}
@@ -341,7 +341,7 @@ PageBulk::compress()
 	ut_ad(m_page_zip != NULL);
 
 	return(page_zip_compress(m_page_zip, m_page, m_index,
-				 page_zip_level, NULL, m_mtr));
+				 page_zip_get_level(), NULL, m_mtr));
 }
 
 /** Get node pointer
@@ -757,18 +757,9 @@ btr_cur_search_to_nth_level(
 				BTR_DELETE, or BTR_ESTIMATE;
 				cursor->left_block is used to store a pointer
 				to the left neighbor page, in the cases
-				BTR_SEARCH_PREV and BTR_MODIFY_PREV;
-				NOTE that if has_search_latch
-				is != 0, we maybe do not have a latch set
-				on the cursor page, we assume
-				the caller uses his search latch
-				to protect the record! */
+				BTR_SEARCH_PREV and BTR_MODIFY_PREV */
 	btr_cur_t*	cursor, /*!< in/out: tree cursor; the cursor page is
-				s- or x-latched, but see also above! */
-	ulint		has_search_latch,
-				/*!< in: info on the latch mode the
-				caller currently has on search system:
-				RW_S_LATCH, or 0 */
+				s- or x-latched */
 	const char*	file,	/*!< in: file name */
 	ulint		line,	/*!< in: line where called */
 	mtr_t*		mtr)	/*!< in: mtr */
@@ -914,9 +905,7 @@ btr_cur_search_to_nth_level(
 # endif
 	/* Use of AHI is disabled for intrinsic table as these tables re-use
 	the index-id and AHI validation is based on index-id. */
-	if (rw_lock_get_writer(btr_get_search_latch(index))
-		== RW_LOCK_NOT_LOCKED
-	    && latch_mode <= BTR_MODIFY_LEAF
+	if (latch_mode <= BTR_MODIFY_LEAF
 	    && info->last_hash_succ
 	    && !index->disable_ahi
 	    && !estimate
@@ -924,14 +913,13 @@ btr_cur_search_to_nth_level(
 	    && mode != PAGE_CUR_LE_OR_EXTENDS
 # endif /* PAGE_CUR_LE_OR_EXTENDS */
 	    && !dict_index_is_spatial(index)
-	    /* If !has_search_latch, we do a dirty read of
-	    btr_search_enabled below, and btr_search_guess_on_hash()
-	    will have to check it again. */
+	    /* We do a dirty read of btr_search_enabled below,
+	    and btr_search_guess_on_hash() will have to check it
+	    again. */
 	    && UNIV_LIKELY(btr_search_enabled)
 	    && !modify_external
 	    && btr_search_guess_on_hash(index, info, tuple, mode,
-					latch_mode, cursor,
-					has_search_latch, mtr)) {
+					latch_mode, cursor, mtr)) {
 
 		/* Search using the hash index succeeded */
 
@@ -950,11 +938,6 @@ btr_cur_search_to_nth_level(
 	/* If the hash search did not succeed, do binary search down the
 	tree */
 
-	if (has_search_latch) {
-		/* Release possible search latch to obey latching order */
-		rw_lock_s_unlock(btr_get_search_latch(index));
-	}
-
 	/* Store the position of the tree latch we push to mtr so that we
 	know how to release it when we have latched leaf node(s) */
 
@@ -1951,11 +1934,6 @@ func_exit:
 		ut_free(prev_tree_savepoints);
 	}
 
-	if (has_search_latch) {
-
-		rw_lock_s_lock(btr_get_search_latch(index));
-	}
-
 	if (mbr_adj) {
 		/* remember that we will need to adjust parent MBR */
 		cursor->rtr_info->mbr_adj = true;
@@ -3866,17 +3844,13 @@ btr_cur_update_in_place(
 			/* Remove possible hash index pointer to this record */
 			btr_search_update_hash_on_delete(cursor);
 		}
-
-		rw_lock_x_lock(btr_get_search_latch(index));
 	}
 
+	/* The adaptive hash index is only used with a latch on the
+	page, so the record can be updated without the search latches. */
 	assert_block_ahi_valid(block);
 	row_upd_rec_in_place(rec, index, offsets, update, page_zip);
 
-	if (is_hashed) {
-		rw_lock_x_unlock(btr_get_search_latch(index));
-	}
-
 	btr_cur_update_in_place_log(flags, rec, index, update,
 				    trx_id, roll_ptr, mtr);
 
@@ -5691,8 +5665,7 @@ btr_estimate_n_rows_in_range_low(
 
 		btr_cur_search_to_nth_level(index, 0, tuple1, mode1,
 					    BTR_SEARCH_LEAF | BTR_ESTIMATE,
-					    &cursor, 0,
-					    __FILE__, __LINE__, &mtr);
+					    &cursor, __FILE__, __LINE__, &mtr);
 
 		ut_ad(!page_rec_is_infimum(btr_cur_get_rec(&cursor)));
 
@@ -5730,8 +5703,7 @@ btr_estimate_n_rows_in_range_low(
 
 		btr_cur_search_to_nth_level(index, 0, tuple2, mode2,
 					    BTR_SEARCH_LEAF | BTR_ESTIMATE,
-					    &cursor, 0,
-					    __FILE__, __LINE__, &mtr);
+					    &cursor, __FILE__, __LINE__, &mtr);
 
 		const rec_t*	rec = btr_cur_get_rec(&cursor);
 
@@ -53,6 +53,8 @@ Created 2/17/1996 Heikki Tuuri
 #include "srv0mon.h"
 #include "sync0sync.h"
 
+#include <algorithm>
+
 /** Is search system enabled.
 Search system is protected by array of latches. */
 char		btr_search_enabled	= true;
@@ -72,14 +74,26 @@ hotspots from residing on the same memory
 cache line as btr_search_latches */
 byte		btr_sea_pad1[64];
 
-/** The latches protecting the adaptive search system: this latches protects the
-(1) positions of records on those pages where a hash index has been built.
+/** The latches protecting the partitions of the adaptive search system:
+btr_search_latches[i] protects btr_search_sys->hash_tables[i], which holds
+the entries whose fold value maps to i, and thus (1) positions of records on
+those pages where a hash index has been built. The entries of an index are
+spread over all the partitions, so that lookups on a hot index do not
+contend on a single latch.
 NOTE: It does not protect values of non-ordering fields within a record from
-being updated in-place! We can use fact (1) to perform unique searches to
-indexes. We will allocate the latches from dynamic memory to get it to the
-same DRAM page as other hotspot semaphores */
+being updated in-place! The page of a record found in the hash index is
+latched before the record is looked at. We will allocate the latches from
+dynamic memory to get it to the same DRAM page as other hotspot semaphores */
 rw_lock_t**	btr_search_latches;
 
+/** The latches protecting the adaptive hash index fields of the blocks
+(block->index, curr_n_fields, curr_n_bytes, curr_left_side); see
+btr_get_search_page_latch(). A page latch is held while the hash index
+entries of the page are added or removed, and it is acquired before any
+latch of btr_search_latches[]. A thread holds at most one page latch and
+one partition latch at a time, except in btr_search_x_lock_all(). */
+rw_lock_t**	btr_search_page_latches;
+
 /** padding to prevent other memory update hotspots from residing on
 the same memory cache line */
 byte		btr_sea_pad2[64];
@@ -96,6 +110,36 @@ is then built on the page, assuming the global limit has been reached */
 before hash index building is started */
 #define BTR_SEARCH_BUILD_LIMIT		100
 
+/** Compare fold values by their adaptive hash index partition.
+@param[in]	a	fold value
+@param[in]	b	fold value
+@return whether a belongs to a partition before that of b */
+static
+bool
+btr_search_fold_less(ulint a, ulint b)
+{
+	return(a % btr_ahi_parts < b % btr_ahi_parts);
+}
+
+/** Compare entries of an array of fold values by their adaptive hash index
+partition. */
+struct btr_search_fold_pos_less {
+	/** Constructor
+	@param[in]	folds	fold values */
+	explicit btr_search_fold_pos_less(const ulint* folds)
+		: m_folds(folds) {}
+
+	/** @return whether the entry a belongs to a partition before that
+	of the entry b */
+	bool operator()(ulint a, ulint b) const
+	{
+		return(btr_search_fold_less(m_folds[a], m_folds[b]));
+	}
+
+	/** fold values */
+	const ulint*	m_folds;
+};
+
 /** Determine the number of accessed key fields.
 @param[in]	n_fields	number of complete fields
 @param[in]	n_bytes		number of bytes in an incomplete last field
@@ -146,18 +190,18 @@ system. If not, allocates a free frames for the heap. This check makes it
 probable that, when have reserved the btr search system latch and we need to
 allocate a new node to the hash table, it will succeed. However, the check
 will not guarantee success.
-@param[in]	index	index handler */
+@param[in]	fold	fold value of the entry to be added */
 static
 void
-btr_search_check_free_space_in_heap(dict_index_t* index)
+btr_search_check_free_space_in_heap(ulint fold)
 {
 	hash_table_t*	table;
 	mem_heap_t*	heap;
 
-	ut_ad(!rw_lock_own(btr_get_search_latch(index), RW_LOCK_S));
-	ut_ad(!rw_lock_own(btr_get_search_latch(index), RW_LOCK_X));
+	ut_ad(!btr_search_own_any(RW_LOCK_S));
+	ut_ad(!btr_search_own_any(RW_LOCK_X));
 
-	table = btr_get_search_table(index);
+	table = btr_get_search_table(fold);
 
 	heap = table->heap;
 
@@ -167,8 +211,9 @@ btr_search_check_free_space_in_heap(dict_index_t* index)
 
 	if (heap->free_block == NULL) {
 		buf_block_t*	block = buf_block_alloc(NULL);
+		rw_lock_t*	latch = btr_get_search_latch(fold);
 
-		btr_search_x_lock(index);
+		rw_lock_x_lock(latch);
 
 		if (btr_search_enabled
 		    && heap->free_block == NULL) {
@@ -177,7 +222,7 @@ btr_search_check_free_space_in_heap(dict_index_t* index)
 			buf_block_free(block);
 		}
 
-		btr_search_x_unlock(index);
+		rw_lock_x_unlock(latch);
 	}
 }
 
@@ -190,10 +235,13 @@ btr_search_sys_create(ulint hash_size)
 	Each part controls access to distinct set of hash buckets from
 	hash table through its own latch. */
 
-	/* Step-1: Allocate latches (1 per part). */
+	/* Step-1: Allocate latches (1 per part, and as many for pages). */
 	btr_search_latches = reinterpret_cast<rw_lock_t**>(
 		ut_malloc(sizeof(rw_lock_t*) * btr_ahi_parts, mem_key_ahi));
 
+	btr_search_page_latches = reinterpret_cast<rw_lock_t**>(
+		ut_malloc(sizeof(rw_lock_t*) * btr_ahi_parts, mem_key_ahi));
+
 	for (ulint i = 0; i < btr_ahi_parts; ++i) {
 
 		btr_search_latches[i] = reinterpret_cast<rw_lock_t*>(
@@ -201,6 +249,12 @@ btr_search_sys_create(ulint hash_size)
 
 		rw_lock_create(btr_search_latch_key,
 			       btr_search_latches[i], SYNC_SEARCH_SYS);
+
+		btr_search_page_latches[i] = reinterpret_cast<rw_lock_t*>(
+			ut_malloc(sizeof(rw_lock_t), mem_key_ahi));
+
+		rw_lock_create(btr_search_page_latch_key,
+			       btr_search_page_latches[i], SYNC_SEARCH_SYS);
 	}
 
 	/* Step-2: Allocate hash tablees. */
@@ -221,6 +275,8 @@ btr_search_sys_create(ulint hash_size)
 		btr_search_sys->hash_tables[i]->adaptive = TRUE;
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
 	}
+
+	UT_LIST_INIT(btr_search_sys->freed_indexes, &dict_index_t::indexes);
 }
 
 /** Resize hash index hash table.
@@ -266,6 +322,7 @@ void
 btr_search_sys_free()
 {
 	ut_ad(btr_search_sys != NULL && btr_search_latches != NULL);
+	ut_ad(UT_LIST_GET_LEN(btr_search_sys->freed_indexes) == 0);
 
 	/* Step-1: Release the hash tables. */
 	for (ulint i = 0; i < btr_ahi_parts; ++i) {
@@ -284,10 +341,118 @@ btr_search_sys_free()
 
 		rw_lock_free(btr_search_latches[i]);
 		ut_free(btr_search_latches[i]);
+
+		rw_lock_free(btr_search_page_latches[i]);
+		ut_free(btr_search_page_latches[i]);
 	}
 
 	ut_free(btr_search_latches);
 	btr_search_latches = NULL;
+
+	ut_free(btr_search_page_latches);
+	btr_search_page_latches = NULL;
+}
+
+/** Free an index that btr_search_free_index() left to the adaptive hash
+index, and the memory heap of its table if the table was freed and this
+was the last such index of it.
+@param[in,out]	index	index whose pages are no longer in the adaptive
+			hash index */
+static
+void
+btr_search_lazy_free(dict_index_t* index)
+{
+	dict_table_t*	table = index->table;
+
+	ut_ad(btr_search_own_all(RW_LOCK_X));
+	ut_ad(index->search_info->freed);
+
+	UT_LIST_REMOVE(btr_search_sys->freed_indexes, index);
+
+	dict_mem_index_free(index);
+
+	ut_ad(table->n_ahi_freed_indexes > 0);
+
+	/* Read table->ahi_freed before decrementing the counter:
+	once it reaches zero, btr_search_defer_table_free() may let
+	the table be freed without acquiring the search latches. */
+	const bool	free_table = table->ahi_freed
+		&& table->n_ahi_freed_indexes == 1;
+
+	table->n_ahi_freed_indexes--;
+
+	if (free_table) {
+		mem_heap_free(table->heap);
+	}
+}
+
+/** Free an index that was removed from the dictionary cache. If pages of
+the index are still in the adaptive hash index, because its tree was freed
+without dropping them (see dict_drop_index_tree()), the index is freed
+when the last of those pages is evicted from the buffer pool or
+allocated again.
+@param[in,out]	index	index that was removed from the dictionary cache */
+void
+btr_search_free_index(dict_index_t* index)
+{
+	btr_search_t*	info = btr_search_get_info(index);
+
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+	/* The ref_count of an index that is no longer in the cache
+	cannot grow. When it has dropped to zero, the last
+	btr_search_drop_page_hash_index() saw btr_search_t::freed
+	unset and no longer accesses the index. */
+	if (info->ref_count > 0) {
+		btr_search_x_lock_all();
+
+		if (info->ref_count > 0) {
+			info->freed = TRUE;
+
+			/* dict_index_remove_from_cache_low() already
+			removed the index from the virtual column index
+			lists, which may be freed before the index. */
+			index->cached = FALSE;
+
+			UT_LIST_ADD_LAST(btr_search_sys->freed_indexes, index);
+			index->table->n_ahi_freed_indexes++;
+
+			btr_search_x_unlock_all();
+
+			return;
+		}
+
+		btr_search_x_unlock_all();
+	}
+
+	dict_mem_index_free(index);
+}
+
+/** Check if freeing the memory heap of a table that was removed from the
+dictionary cache must be deferred, because btr_search_free_index() left
+indexes of the table to the adaptive hash index. The heap is then freed
+together with the last of those indexes.
+@param[in,out]	table	table whose other resources were already freed
+@return whether the caller must not free table->heap */
+bool
+btr_search_defer_table_free(dict_table_t* table)
+{
+	/* No more indexes of the table can be left to the adaptive hash
+	index, and btr_search_lazy_free() no longer accesses the table
+	after the counter dropped to zero. */
+	if (table->n_ahi_freed_indexes == 0) {
+		return(false);
+	}
+
+	btr_search_x_lock_all();
+
+	const bool	defer = table->n_ahi_freed_indexes > 0;
+
+	table->ahi_freed = defer;
+
+	btr_search_x_unlock_all();
+
+	return(defer);
 }
 
 /** Set index->ref_count = 0 on all indexes of a table.
@@ -300,13 +465,12 @@ btr_search_disable_ref_count(
 	dict_index_t*	index;
 
 	ut_ad(mutex_own(&dict_sys->mutex));
+	ut_ad(btr_search_own_all(RW_LOCK_X));
 
 	for (index = dict_table_get_first_index(table);
 	     index != NULL;
 	     index = dict_table_get_next_index(index)) {
 
-		ut_ad(rw_lock_own(btr_get_search_latch(index), RW_LOCK_X));
-
 		index->search_info->ref_count = 0;
 	}
 }
@@ -364,6 +528,24 @@ btr_search_disable(
 		mem_heap_empty(btr_search_sys->hash_tables[i]->heap);
 	}
 
+	/* No page of the indexes left to the adaptive hash index by
+	btr_search_free_index() is hashed any more. An index whose
+	ref_count already dropped to zero is being freed by
+	btr_search_drop_page_hash_index(), which is waiting for
+	the latches that we hold. */
+	for (dict_index_t* index
+		     = UT_LIST_GET_FIRST(btr_search_sys->freed_indexes);
+	     index != NULL; ) {
+
+		dict_index_t*	next = UT_LIST_GET_NEXT(indexes, index);
+
+		if (index->search_info->ref_count > 0) {
+			btr_search_lazy_free(index);
+		}
+
+		index = next;
+	}
+
 	btr_search_x_unlock_all();
 }
 
@@ -396,6 +578,7 @@ btr_search_info_create(mem_heap_t* heap)
 	ut_d(info->magic_n = BTR_SEARCH_MAGIC_N);
 
 	info->ref_count = 0;
+	info->freed = FALSE;
 	info->root_guess = NULL;
 
 	info->hash_analysis = 0;
@@ -403,6 +586,12 @@ btr_search_info_create(mem_heap_t* heap)
 
 	info->last_hash_succ = FALSE;
 
+	info->n_hits = 0;
+	info->n_misses = 0;
+	info->n_rows_added = 0;
+	info->auto_disabled = FALSE;
+	info->n_disabled_searches = 0;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 	info->n_hash_succ = 0;
 	info->n_hash_fail = 0;
@@ -419,31 +608,21 @@ btr_search_info_create(mem_heap_t* heap)
 	return(info);
 }
 
-/** Returns the value of ref_count. The value is protected by latch.
+/** Returns the value of ref_count. The value is updated with atomic
+operations.
 @param[in]	info		search info
-@param[in]	index		index identifier
 @return ref_count value. */
 ulint
 btr_search_info_get_ref_count(
-	btr_search_t*	info,
-	dict_index_t*	index)
+	const btr_search_t*	info)
 {
-	ulint ret = 0;
-
 	if (!btr_search_enabled) {
-		return(ret);
+		return(0);
 	}
 
 	ut_ad(info);
 
-	ut_ad(!rw_lock_own(btr_get_search_latch(index), RW_LOCK_S));
-	ut_ad(!rw_lock_own(btr_get_search_latch(index), RW_LOCK_X));
-
-	btr_search_s_lock(index);
-	ret = info->ref_count;
-	btr_search_s_unlock(index);
-
-	return(ret);
+	return(info->ref_count);
 }
 
 /** Updates the search info of an index about hash successes. NOTE that info
@@ -461,8 +640,8 @@ btr_search_info_update_hash(
 	ulint		n_unique;
 	int		cmp;
 
-	ut_ad(!rw_lock_own(btr_get_search_latch(index), RW_LOCK_S));
-	ut_ad(!rw_lock_own(btr_get_search_latch(index), RW_LOCK_X));
+	ut_ad(!btr_search_own_any(RW_LOCK_S));
+	ut_ad(!btr_search_own_any(RW_LOCK_X));
 
 	if (dict_index_is_ibuf(index)) {
 		/* So many deletes are performed on an insert buffer tree
@@ -575,8 +754,8 @@ btr_search_update_block_hash_info(
 	buf_block_t*		block,
 	const btr_cur_t*	cursor)
 {
-	ut_ad(!rw_lock_own(btr_get_search_latch(cursor->index), RW_LOCK_S));
-	ut_ad(!rw_lock_own(btr_get_search_latch(cursor->index), RW_LOCK_X));
+	ut_ad(!btr_search_own_any(RW_LOCK_S));
+	ut_ad(!btr_search_own_any(RW_LOCK_X));
 	ut_ad(rw_lock_own(&block->lock, RW_LOCK_S)
 	      || rw_lock_own(&block->lock, RW_LOCK_X));
 
@@ -656,56 +835,143 @@ btr_search_update_hash_ref(
 	dict_index_t*	index;
 	ulint		fold;
 	const rec_t*	rec;
+	rw_lock_t*	page_latch = btr_get_search_page_latch(block);
 
 	ut_ad(cursor->flag == BTR_CUR_HASH_FAIL);
-	ut_ad(rw_lock_own(btr_get_search_latch(cursor->index), RW_LOCK_X));
+	ut_ad(!btr_search_own_any(RW_LOCK_S));
+	ut_ad(!btr_search_own_any(RW_LOCK_X));
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_S)
 	      || rw_lock_own(&(block->lock), RW_LOCK_X));
 	ut_ad(page_align(btr_cur_get_rec(cursor))
 	      == buf_block_get_frame(block));
-	assert_block_ahi_valid(block);
 
-	index = block->index;
+	rec = btr_cur_get_rec(cursor);
 
-	if (!index) {
+	if (!page_rec_is_user_rec(rec) || info->n_hash_potential == 0) {
 
 		return;
 	}
 
-	ut_ad(block->page.id.space() == index->space);
-	ut_a(index == cursor->index);
-	ut_a(!dict_index_is_ibuf(index));
+	index = cursor->index;
+
+	/* The search info may be updated concurrently. The entry is
+	only added if the block was hashed with the parameters that
+	the fold value is computed with. */
+	const ulint	n_fields = info->n_fields;
+	const ulint	n_bytes = info->n_bytes;
+	const ibool	left_side = info->left_side;
+
+	if (n_fields == 0 && n_bytes == 0) {
 
-	if ((info->n_hash_potential > 0)
-	    && (block->curr_n_fields == info->n_fields)
-	    && (block->curr_n_bytes == info->n_bytes)
-	    && (block->curr_left_side == info->left_side)) {
-		mem_heap_t*	heap		= NULL;
-		ulint		offsets_[REC_OFFS_NORMAL_SIZE];
-		rec_offs_init(offsets_);
+		return;
+	}
 
-		rec = btr_cur_get_rec(cursor);
+	mem_heap_t*	heap		= NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	rec_offs_init(offsets_);
 
-		if (!page_rec_is_user_rec(rec)) {
+	fold = rec_fold(rec,
+			rec_get_offsets(rec, index, offsets_,
+					ULINT_UNDEFINED, &heap),
+			n_fields, n_bytes, index->id);
+	if (UNIV_LIKELY_NULL(heap)) {
+		mem_heap_free(heap);
+	}
 
-			return;
-		}
+	btr_search_check_free_space_in_heap(fold);
 
-		fold = rec_fold(rec,
-				rec_get_offsets(rec, index, offsets_,
-						ULINT_UNDEFINED, &heap),
-				block->curr_n_fields,
-				block->curr_n_bytes, index->id);
-		if (UNIV_LIKELY_NULL(heap)) {
-			mem_heap_free(heap);
-		}
-		ut_ad(rw_lock_own(btr_get_search_latch(index), RW_LOCK_X));
+	/* The page latch keeps the hash index parameters of the block
+	unchanged, and prevents the hash index of the page from being
+	dropped before the entry has been added. */
+	rw_lock_s_lock(page_latch);
+	assert_block_ahi_valid(block);
+
+	if (block->index == NULL) {
+
+		rw_lock_s_unlock(page_latch);
+		return;
+	}
 
-		ha_insert_for_fold(btr_get_search_table(index), fold,
+	ut_ad(block->page.id.space() == index->space);
+	ut_a(block->index == index);
+	ut_a(!dict_index_is_ibuf(index));
+
+	if (block->curr_n_fields == n_fields
+	    && block->curr_n_bytes == n_bytes
+	    && block->curr_left_side == left_side) {
+		rw_lock_t*	latch = btr_get_search_latch(fold);
+
+		rw_lock_x_lock(latch);
+
+		ha_insert_for_fold(btr_get_search_table(fold), fold,
 				   block, rec);
 
+		rw_lock_x_unlock(latch);
+
+		index->search_info->n_rows_added++;
+
 		MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
 	}
+
+	rw_lock_s_unlock(page_latch);
+}
+
+/** Check the hit rate of the hash searches on an index after
+BTR_SEARCH_TUNE_SAMPLE hash searches and added hash index entries, and
+disable the hash searches if they do not pay off.
+@param[in,out]	info	search info of the index */
+static
+void
+btr_search_check_hit_rate(
+	btr_search_t*	info)
+{
+	const ulint	n_hits = info->n_hits;
+	const ulint	n_cost = info->n_misses + info->n_rows_added;
+
+	if (n_hits + n_cost < BTR_SEARCH_TUNE_SAMPLE) {
+		return;
+	}
+
+	info->n_hits = 0;
+	info->n_misses = 0;
+	info->n_rows_added = 0;
+
+	if (n_hits * BTR_SEARCH_HIT_GAIN < n_cost) {
+		info->n_disabled_searches = 0;
+		info->last_hash_succ = FALSE;
+		info->auto_disabled = TRUE;
+
+		MONITOR_INC(MONITOR_ADAPTIVE_HASH_INDEX_DISABLED);
+	}
+}
+
+/** Update the search info of an index whose hash searches were disabled
+by btr_search_check_hit_rate(). The hash index of the page that was
+searched is dropped, and the hash searches are tried again after
+BTR_SEARCH_RETRY_SEARCHES searches.
+@param[in,out]	info	search info of the index
+@param[in,out]	block	page of the cursor, s- or x-latched */
+static
+void
+btr_search_info_update_disabled(
+	btr_search_t*	info,
+	buf_block_t*	block)
+{
+	if (block->index != NULL) {
+		btr_search_drop_page_hash_index(block);
+
+		MONITOR_INC(MONITOR_ADAPTIVE_HASH_PAGE_REMOVED_LAZILY);
+	}
+
+	if (++info->n_disabled_searches >= BTR_SEARCH_RETRY_SEARCHES) {
+		info->n_hits = 0;
+		info->n_misses = 0;
+		info->n_rows_added = 0;
+		info->n_hash_potential = 0;
+		info->auto_disabled = FALSE;
+
+		MONITOR_INC(MONITOR_ADAPTIVE_HASH_INDEX_ENABLED);
+	}
 }
 
 /** Updates the search info.
@@ -719,11 +985,16 @@ btr_search_info_update_slow(
 	buf_block_t*	block;
 	ibool		build_index;
 
-	ut_ad(!rw_lock_own(btr_get_search_latch(cursor->index), RW_LOCK_S));
-	ut_ad(!rw_lock_own(btr_get_search_latch(cursor->index), RW_LOCK_X));
+	ut_ad(!btr_search_own_any(RW_LOCK_S));
+	ut_ad(!btr_search_own_any(RW_LOCK_X));
 
 	block = btr_cur_get_block(cursor);
 
+	if (info->auto_disabled) {
+		btr_search_info_update_disabled(info, block);
+		return;
+	}
+
 	/* NOTE that the following two function calls do NOT protect
 	info or block->n_fields etc. with any semaphore, to save CPU time!
 	We cannot assume the fields are consistent when we return from
@@ -733,11 +1004,6 @@ btr_search_info_update_slow(
 
 	build_index = btr_search_update_block_hash_info(info, block, cursor);
 
-	if (build_index || (cursor->flag == BTR_CUR_HASH_FAIL)) {
-
-		btr_search_check_free_space_in_heap(cursor->index);
-	}
-
 	if (cursor->flag == BTR_CUR_HASH_FAIL) {
 		/* Update the hash node reference, if appropriate */
 
@@ -745,11 +1011,7 @@ btr_search_info_update_slow(
 		btr_search_n_hash_fail++;
 #endif /* UNIV_SEARCH_PERF_STAT */
 
-		btr_search_x_lock(cursor->index);
-
 		btr_search_update_hash_ref(info, block, cursor);
-
-		btr_search_x_unlock(cursor->index);
 	}
 
 	if (build_index) {
@@ -761,6 +1023,8 @@ btr_search_info_update_slow(
 						 block->n_bytes,
 						 block->left_side);
 	}
+
+	btr_search_check_hit_rate(info);
 }
 
 /** Checks if a guessed position for a tree cursor is right. Note that if
@@ -807,7 +1071,8 @@ btr_search_check_guess(
 
 	offsets = rec_get_offsets(rec, cursor->index, offsets,
 				  n_unique, &heap);
-	cmp = cmp_dtuple_rec_with_match(tuple, rec, offsets, &match);
+	cmp = cmp_dtuple_rec_with_match_index(
+		tuple, rec, cursor->index, offsets, &match);
 
 	if (mode == PAGE_CUR_GE) {
 		if (cmp > 0) {
@@ -861,8 +1126,8 @@ btr_search_check_guess(
 
 		offsets = rec_get_offsets(prev_rec, cursor->index, offsets,
 					  n_unique, &heap);
-		cmp = cmp_dtuple_rec_with_match(
-			tuple, prev_rec, offsets, &match);
+		cmp = cmp_dtuple_rec_with_match_index(
+			tuple, prev_rec, cursor->index, offsets, &match);
 		if (mode == PAGE_CUR_GE) {
 			success = cmp > 0;
 		} else {
@@ -890,8 +1155,8 @@ btr_search_check_guess(
 
 		offsets = rec_get_offsets(next_rec, cursor->index, offsets,
 					  n_unique, &heap);
-		cmp = cmp_dtuple_rec_with_match(
-			tuple, next_rec, offsets, &match);
+		cmp = cmp_dtuple_rec_with_match_index(
+			tuple, next_rec, cursor->index, offsets, &match);
 		if (mode == PAGE_CUR_LE) {
 			success = cmp < 0;
 			cursor->up_match = match;
@@ -912,6 +1177,10 @@ btr_search_failure(btr_search_t* info, btr_cur_t* cursor)
 {
 	cursor->flag = BTR_CUR_HASH_FAIL;
 
+	info->n_misses++;
+
+	MONITOR_INC(MONITOR_ADAPTIVE_HASH_SEARCH_FAIL);
+
 #ifdef UNIV_SEARCH_PERF_STAT
 	++info->n_hash_fail;
 
@@ -931,15 +1200,8 @@ both have sensible values.
 @param[in,out]	info		index search info
 @param[in]	tuple		logical record
 @param[in]	mode		PAGE_CUR_L, ....
-@param[in]	latch_mode	BTR_SEARCH_LEAF, ...;
-				NOTE that only if has_search_latch is 0, we will
-				have a latch set on the cursor page, otherwise
-				we assume the caller uses his search latch
-				to protect the record!
+@param[in]	latch_mode	BTR_SEARCH_LEAF, ...
 @param[out]	cursor		tree cursor
-@param[in]	has_search_latch
-				latch mode the caller currently has on
-				search system: RW_S/X_LATCH or 0
 @param[in]	mtr		mini transaction
 @return TRUE if succeeded */
 ibool
@@ -950,12 +1212,12 @@ btr_search_guess_on_hash(
 	ulint		mode,
 	ulint		latch_mode,
 	btr_cur_t*	cursor,
-	ulint		has_search_latch,
 	mtr_t*		mtr)
 {
 	const rec_t*	rec;
 	ulint		fold;
 	index_id_t	index_id;
+	rw_lock_t*	latch;
 #ifdef notdefined
 	btr_cur_t	cursor2;
 	btr_pcur_t	pcur;
@@ -976,7 +1238,7 @@ btr_search_guess_on_hash(
 	/* Note that, for efficiency, the struct info may not be protected by
 	any latch here! */
 
-	if (info->n_hash_potential == 0) {
+	if (info->n_hash_potential == 0 || info->auto_disabled) {
 
 		return(FALSE);
 	}
@@ -999,29 +1261,23 @@ btr_search_guess_on_hash(
 	cursor->fold = fold;
 	cursor->flag = BTR_CUR_HASH;
 
-	if (!has_search_latch) {
-		btr_search_s_lock(index);
+	latch = btr_get_search_latch(fold);
 
-		if (!btr_search_enabled) {
-			btr_search_s_unlock(index);
+	rw_lock_s_lock(latch);
 
-			btr_search_failure(info, cursor);
+	if (!btr_search_enabled) {
+		rw_lock_s_unlock(latch);
 
-			return(FALSE);
-		}
-	}
+		btr_search_failure(info, cursor);
 
-	ut_ad(rw_lock_get_writer(btr_get_search_latch(index)) != RW_LOCK_X);
-	ut_ad(rw_lock_get_reader_count(btr_get_search_latch(index)) > 0);
+		return(FALSE);
+	}
 
-	rec = (rec_t*) ha_search_and_get_data(
-			btr_get_search_table(index), fold);
+	rec = (rec_t*) ha_search_and_get_data(btr_get_search_table(fold), fold);
 
 	if (rec == NULL) {
 
-		if (!has_search_latch) {
-			btr_search_s_unlock(index);
-		}
+		rw_lock_s_unlock(latch);
 
 		btr_search_failure(info, cursor);
 
@@ -1030,34 +1286,26 @@ btr_search_guess_on_hash(
 
 	buf_block_t*	block = buf_block_from_ahi(rec);
 
-	if (!has_search_latch) {
-
-		if (!buf_page_get_known_nowait(
-			latch_mode, block, BUF_MAKE_YOUNG,
-			__FILE__, __LINE__, mtr)) {
+	if (!buf_page_get_known_nowait(
+		latch_mode, block, BUF_MAKE_YOUNG,
+		__FILE__, __LINE__, mtr)) {
 
-			if (!has_search_latch) {
-				btr_search_s_unlock(index);
-			}
+		rw_lock_s_unlock(latch);
 
-			btr_search_failure(info, cursor);
+		btr_search_failure(info, cursor);
 
-			return(FALSE);
-		}
+		return(FALSE);
+	}
 
-		btr_search_s_unlock(index);
+	rw_lock_s_unlock(latch);
 
-		buf_block_dbg_add_level(block, SYNC_TREE_NODE_FROM_HASH);
-	}
+	buf_block_dbg_add_level(block, SYNC_TREE_NODE_FROM_HASH);
 
 	if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE) {
 
 		ut_ad(buf_block_get_state(block) == BUF_BLOCK_REMOVE_HASH);
 
-		if (!has_search_latch) {
-
-			btr_leaf_page_release(block, latch_mode, mtr);
-		}
+		btr_leaf_page_release(block, latch_mode, mtr);
 
 		btr_search_failure(info, cursor);
 
@@ -1070,19 +1318,15 @@ btr_search_guess_on_hash(
 
 	/* Check the validity of the guess within the page */
 
-	/* If we only have the latch on search system, not on the
-	page, it only protects the columns of the record the cursor
-	is positioned on. We cannot look at the next of the previous
-	record to determine if our guess for the cursor position is
-	right. */
+	/* The page is latched, so that the records next to the one the
+	cursor is positioned on can be looked at to check our guess.
+	The page may also belong to another index whose pages are still
+	in the adaptive hash index after the index was freed, if the
+	fold values collide. */
 	if (index_id != btr_page_get_index_id(block->frame)
-	    || !btr_search_check_guess(cursor,
-				       has_search_latch,
-				       tuple, mode, mtr)) {
+	    || !btr_search_check_guess(cursor, FALSE, tuple, mode, mtr)) {
 
-		if (!has_search_latch) {
-			btr_leaf_page_release(block, latch_mode, mtr);
-		}
+		btr_leaf_page_release(block, latch_mode, mtr);
 
 		btr_search_failure(info, cursor);
 
@@ -1100,13 +1344,10 @@ btr_search_guess_on_hash(
 
 	info->last_hash_succ = FALSE;
 
-	/* Currently, does not work if the following fails: */
-	ut_ad(!has_search_latch);
-
 	btr_leaf_page_release(block, latch_mode, mtr);
 
 	btr_cur_search_to_nth_level(
-		index, 0, tuple, mode, latch_mode, &cursor2, 0, mtr);
+		index, 0, tuple, mode, latch_mode, &cursor2, mtr);
 
 	if (mode == PAGE_CUR_GE
 	    && page_rec_is_supremum(btr_cur_get_rec(&cursor2))) {
@@ -1131,10 +1372,12 @@ btr_search_guess_on_hash(
 #endif
 	info->last_hash_succ = TRUE;
 
+	info->n_hits++;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 	btr_search_n_succ++;
 #endif
-	if (!has_search_latch && buf_page_peek_if_too_old(&block->page)) {
+	if (buf_page_peek_if_too_old(&block->page)) {
 
 		buf_page_make_young(&block->page);
 	}
@@ -1152,8 +1395,8 @@ btr_search_guess_on_hash(
 }
 
 /** Drop any adaptive hash index entries that point to an index page.
-@param[in,out]	block	block containing index page, s- or x-latched, or an
-			index page for which we know that
+@param[in,out]	block	block containing index page, s-, sx- or x-latched,
+			or an index page for which we know that
 			block->buf_fix_count == 0 or it is an index page which
 			has already been removed from the buf_pool->page_hash
 			i.e.: it is in state BUF_BLOCK_REMOVE_HASH */
@@ -1171,12 +1414,11 @@ btr_search_drop_page_hash_index(buf_block_t* block)
 	ulint*			folds;
 	ulint			i;
 	mem_heap_t*		heap;
-	const dict_index_t*	index;
+	dict_index_t*		index;
 	ulint*			offsets;
-	rw_lock_t*		latch;
+	rw_lock_t*		page_latch;
 	btr_search_t*		info;
 
-retry:
 	/* Do a dirty check on block->index, return if the block is
 	not in the adaptive hash index. */
 	index = block->index;
@@ -1191,43 +1433,31 @@ retry:
 	ut_ad(block->page.buf_fix_count == 0
 	      || buf_block_get_state(block) == BUF_BLOCK_REMOVE_HASH
 	      || rw_lock_own(&block->lock, RW_LOCK_S)
+	      || rw_lock_own(&block->lock, RW_LOCK_SX)
 	      || rw_lock_own(&block->lock, RW_LOCK_X));
 
-	/* We must not dereference index here, because it could be freed
-	if (index->table->n_ref_count == 0 && !mutex_own(&dict_sys->mutex)).
-	Determine the ahi_slot based on the block contents. */
-
-	const index_id_t	index_id
-		= btr_page_get_index_id(block->frame);
-	const ulint		ahi_slot
-		= ut_fold_ulint_pair(static_cast<ulint>(index_id),
-				     static_cast<ulint>(block->page.id.space()))
-		% btr_ahi_parts;
-	latch = btr_search_latches[ahi_slot];
-
 	ut_ad(!btr_search_own_any(RW_LOCK_S));
 	ut_ad(!btr_search_own_any(RW_LOCK_X));
 
-	rw_lock_s_lock(latch);
+	/* The page latch keeps block->index and the hash index
+	parameters of the block unchanged. While block->index is set,
+	the index cannot be freed, because its ref_count is positive. */
+	page_latch = btr_get_search_page_latch(block);
+
+	rw_lock_x_lock(page_latch);
 	assert_block_ahi_valid(block);
 
-	if (block->index == NULL) {
-		rw_lock_s_unlock(latch);
+	index = block->index;
+
+	if (index == NULL) {
+		rw_lock_x_unlock(page_latch);
 		return;
 	}
 
-	/* The index associated with a block must remain the
-	same, because we are holding block->lock or the block is
-	not accessible by other threads (BUF_BLOCK_REMOVE_HASH),
-	or the index is not accessible to other threads
-	(buf_fix_count == 0 when DROP TABLE or similar is executing
-	buf_LRU_drop_page_hash_for_tablespace()). */
-	ut_a(index == block->index);
-	ut_ad(!index->disable_ahi);
 	ut_ad(btr_search_enabled);
 
 	ut_ad(block->page.id.space() == index->space);
-	ut_a(index_id == index->id);
+	ut_a(btr_page_get_index_id(block->frame) == index->id);
 	ut_a(!dict_index_is_ibuf(index));
 #ifdef UNIV_DEBUG
 	switch (dict_index_get_online_status(index)) {
@@ -1243,21 +1473,17 @@ retry:
 		rollback_inplace_alter_table(). */
 		break;
 	case ONLINE_INDEX_ABORTED_DROPPED:
-		/* The index should have been dropped from the tablespace
-		already, and the adaptive hash index entries should have
-		been dropped as well. */
-		ut_error;
+		/* The index has been dropped from the tablespace
+		already, but dict_drop_index_tree() left the adaptive
+		hash index entries to be dropped when the pages are
+		evicted or allocated again. */
+		break;
 	}
 #endif /* UNIV_DEBUG */
 
 	n_fields = block->curr_n_fields;
 	n_bytes = block->curr_n_bytes;
 
-	/* NOTE: The AHI fields of block must not be accessed after
-	releasing search latch, as the index page might only be s-latched! */
-
-	rw_lock_s_unlock(latch);
-
 	ut_a(n_fields > 0 || n_bytes > 0);
 
 	page = block->frame;
@@ -1283,7 +1509,7 @@ retry:
 			rec, index, offsets,
 			btr_search_get_n_fields(n_fields, n_bytes),
 			&heap);
-		fold = rec_fold(rec, offsets, n_fields, n_bytes, index_id);
+		fold = rec_fold(rec, offsets, n_fields, n_bytes, index->id);
 
 		if (fold == prev_fold && prev_fold != 0) {
 
@@ -1304,49 +1530,51 @@ next_rec:
 		mem_heap_free(heap);
 	}
 
-	rw_lock_x_lock(latch);
+	/* Remove the entries one partition at a time. */
+	std::sort(folds, folds + n_cached, btr_search_fold_less);
 
-	if (UNIV_UNLIKELY(!block->index)) {
-		/* Someone else has meanwhile dropped the hash index */
-
-		goto cleanup;
-	}
-
-	ut_a(block->index == index);
+	for (i = 0; i < n_cached; ) {
+		const ulint	part = folds[i] % btr_ahi_parts;
+		rw_lock_t*	latch = btr_search_latches[part];
+		hash_table_t*	table = btr_search_sys->hash_tables[part];
 
-	if (block->curr_n_fields != n_fields
-	    || block->curr_n_bytes != n_bytes) {
+		rw_lock_x_lock(latch);
 
-		/* Someone else has meanwhile built a new hash index on the
-		page, with different parameters */
+		do {
+			ha_remove_all_nodes_to_page(table, folds[i], page);
+		} while (++i < n_cached && folds[i] % btr_ahi_parts == part);
 
 		rw_lock_x_unlock(latch);
-
-		ut_free(folds);
-		goto retry;
-	}
-
-	for (i = 0; i < n_cached; i++) {
-
-		ha_remove_all_nodes_to_page(
-			btr_search_sys->hash_tables[ahi_slot],
-			folds[i], page);
 	}
 
-	info = btr_search_get_info(block->index);
+	info = btr_search_get_info(index);
 	ut_a(info->ref_count > 0);
-	info->ref_count--;
+
+	/* Once ref_count drops to zero, btr_search_free_index() may
+	free the index unless it was already left to us. */
+	const ibool	freed = info->freed;
+	const bool	last = os_atomic_decrement_ulint(
+		&info->ref_count, 1) == 0;
 
 	block->index = NULL;
 
 	MONITOR_INC(MONITOR_ADAPTIVE_HASH_PAGE_REMOVED);
 	MONITOR_INC_VALUE(MONITOR_ADAPTIVE_HASH_ROW_REMOVED, n_cached);
 
-cleanup:
 	assert_block_ahi_valid(block);
-	rw_lock_x_unlock(latch);
+	rw_lock_x_unlock(page_latch);
 
 	ut_free(folds);
+
+	if (last && freed) {
+		/* This was the last hashed page of an index that was
+		removed from the dictionary cache. */
+		DEBUG_SYNC_C("ahi_lazy_free");
+
+		btr_search_x_lock_all();
+		btr_search_lazy_free(index);
+		btr_search_x_unlock_all();
+	}
 }
 
 /** Drop any adaptive hash index entries that may point to an index
@@ -1378,9 +1606,8 @@ btr_search_drop_page_hash_when_freed(
 
 	if (block) {
 
-		/* If AHI is still valid, page can't be in free state.
-		AHI is dropped when page is freed. */
-		ut_ad(!block->page.file_page_was_freed);
+		/* The page may be in free state, if dict_drop_index_tree()
+		freed it without dropping its adaptive hash index. */
 
 		buf_block_dbg_add_level(block, SYNC_TREE_NODE_FROM_HASH);
 
@@ -1388,9 +1615,12 @@ btr_search_drop_page_hash_when_freed(
 		if (index != NULL) {
 			/* In all our callers, the table handle should
 			be open, or we should be in the process of
-			dropping the table (preventing eviction). */
+			dropping the table (preventing eviction), or the
+			index was left to the adaptive hash index. The
+			index cannot be freed while the page is hashed. */
 			ut_ad(index->table->n_ref_count > 0
-			      || mutex_own(&dict_sys->mutex));
+			      || mutex_own(&dict_sys->mutex)
+			      || index->search_info->freed);
 			btr_search_drop_page_hash_index(block);
 		}
 	}
@@ -1416,7 +1646,6 @@ btr_search_build_page_hash_index(
 	ulint		n_bytes,
 	ibool		left_side)
 {
-	hash_table_t*	table;
 	page_t*		page;
 	rec_t*		rec;
 	rec_t*		next_rec;
@@ -1426,12 +1655,14 @@ btr_search_build_page_hash_index(
 	ulint		n_recs;
 	ulint*		folds;
 	rec_t**		recs;
+	ulint*		order;
 	ulint		i;
 	mem_heap_t*	heap		= NULL;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	ulint*		offsets		= offsets_;
 
-	if (index->disable_ahi || !btr_search_enabled) {
+	if (index->disable_ahi || !btr_search_enabled
+	    || index->search_info->auto_disabled) {
 		return;
 	}
 
@@ -1440,24 +1671,26 @@ btr_search_build_page_hash_index(
 	ut_ad(block->page.id.space() == index->space);
 	ut_a(!dict_index_is_ibuf(index));
 
-	ut_ad(!rw_lock_own(btr_get_search_latch(index), RW_LOCK_X));
+	ut_ad(!btr_search_own_any(RW_LOCK_S));
+	ut_ad(!btr_search_own_any(RW_LOCK_X));
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_S)
 	      || rw_lock_own(&(block->lock), RW_LOCK_X));
 
-	btr_search_s_lock(index);
+	rw_lock_t*	page_latch = btr_get_search_page_latch(block);
+
+	rw_lock_s_lock(page_latch);
 
-	table = btr_get_search_table(index);
 	page = buf_block_get_frame(block);
 
 	if (block->index && ((block->curr_n_fields != n_fields)
 			     || (block->curr_n_bytes != n_bytes)
 			     || (block->curr_left_side != left_side))) {
 
-		btr_search_s_unlock(index);
+		rw_lock_s_unlock(page_latch);
 
 		btr_search_drop_page_hash_index(block);
 	} else {
-		btr_search_s_unlock(index);
+		rw_lock_s_unlock(page_latch);
 	}
 
 	/* Check that the values for hash index build are sensible */
@@ -1484,6 +1717,7 @@ btr_search_build_page_hash_index(
 
 	folds = (ulint*) ut_malloc_nokey(n_recs * sizeof(ulint));
 	recs = (rec_t**) ut_malloc_nokey(n_recs * sizeof(rec_t*));
+	order = (ulint*) ut_malloc_nokey(n_recs * sizeof(ulint));
 
 	n_cached = 0;
 
@@ -1547,9 +1781,15 @@ btr_search_build_page_hash_index(
 		fold = next_fold;
 	}
 
-	btr_search_check_free_space_in_heap(index);
+	for (i = 0; i < n_cached; i++) {
+		btr_search_check_free_space_in_heap(folds[i]);
+		order[i] = i;
+	}
+
+	/* Insert the entries one partition at a time. */
+	std::sort(order, order + n_cached, btr_search_fold_pos_less(folds));
 
-	btr_search_x_lock(index);
+	rw_lock_x_lock(page_latch);
 
 	if (!btr_search_enabled) {
 		goto exit_func;
@@ -1568,7 +1808,7 @@ btr_search_build_page_hash_index(
 	case. */
 	if (!block->index) {
 		assert_block_ahi_empty(block);
-		index->search_info->ref_count++;
+		os_atomic_increment_ulint(&index->search_info->ref_count, 1);
 	}
 
 	block->n_hash_helps = 0;
@@ -1578,19 +1818,33 @@ btr_search_build_page_hash_index(
 	block->curr_left_side = left_side;
 	block->index = index;
 
-	for (i = 0; i < n_cached; i++) {
+	for (i = 0; i < n_cached; ) {
+		const ulint	part = folds[order[i]] % btr_ahi_parts;
+		rw_lock_t*	latch = btr_search_latches[part];
+		hash_table_t*	table = btr_search_sys->hash_tables[part];
+
+		rw_lock_x_lock(latch);
 
-		ha_insert_for_fold(table, folds[i], block, recs[i]);
+		do {
+			ha_insert_for_fold(table, folds[order[i]], block,
+					   recs[order[i]]);
+		} while (++i < n_cached
+			 && folds[order[i]] % btr_ahi_parts == part);
+
+		rw_lock_x_unlock(latch);
 	}
 
+	index->search_info->n_rows_added += n_cached;
+
 	MONITOR_INC(MONITOR_ADAPTIVE_HASH_PAGE_ADDED);
 	MONITOR_INC_VALUE(MONITOR_ADAPTIVE_HASH_ROW_ADDED, n_cached);
 exit_func:
 	assert_block_ahi_valid(block);
-	btr_search_x_unlock(index);
+	rw_lock_x_unlock(page_latch);
 
 	ut_free(folds);
 	ut_free(recs);
+	ut_free(order);
 	if (UNIV_LIKELY_NULL(heap)) {
 		mem_heap_free(heap);
 	}
@@ -1622,24 +1876,35 @@ btr_search_move_or_delete_hash_entries(
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_X));
 	ut_ad(rw_lock_own(&(new_block->lock), RW_LOCK_X));
 
-	btr_search_s_lock(index);
+	/* Only one page latch of the adaptive hash index may be held
+	at a time, because they are not ordered. */
+	rw_lock_t*	page_latch = btr_get_search_page_latch(new_block);
+
+	rw_lock_s_lock(page_latch);
 
 	ut_a(!new_block->index || new_block->index == index);
-	ut_a(!block->index || block->index == index);
-	ut_a(!(new_block->index || block->index)
-	     || !dict_index_is_ibuf(index));
-	assert_block_ahi_valid(block);
+	ut_a(!new_block->index || !dict_index_is_ibuf(index));
 	assert_block_ahi_valid(new_block);
 
-	if (new_block->index) {
+	const bool	new_hashed = new_block->index != NULL;
+
+	rw_lock_s_unlock(page_latch);
 
-		btr_search_s_unlock(index);
+	if (new_hashed) {
 
 		btr_search_drop_page_hash_index(block);
 
 		return;
 	}
 
+	page_latch = btr_get_search_page_latch(block);
+
+	rw_lock_s_lock(page_latch);
+
+	ut_a(!block->index || block->index == index);
+	ut_a(!block->index || !dict_index_is_ibuf(index));
+	assert_block_ahi_valid(block);
+
 	if (block->index) {
 		ulint	n_fields = block->curr_n_fields;
 		ulint	n_bytes = block->curr_n_bytes;
@@ -1649,7 +1914,7 @@ btr_search_move_or_delete_hash_entries(
 		new_block->n_bytes = block->curr_n_bytes;
 		new_block->left_side = left_side;
 
-		btr_search_s_unlock(index);
+		rw_lock_s_unlock(page_latch);
 
 		ut_a(n_fields > 0 || n_bytes > 0);
 
@@ -1661,7 +1926,7 @@ btr_search_move_or_delete_hash_entries(
 		return;
 	}
 
-	btr_search_s_unlock(index);
+	rw_lock_s_unlock(page_latch);
 }
 
 /** Updates the page hash index when a single record is deleted from a page.
@@ -1670,7 +1935,6 @@ btr_search_move_or_delete_hash_entries(
 void
 btr_search_update_hash_on_delete(btr_cur_t* cursor)
 {
-	hash_table_t*	table;
 	buf_block_t*	block;
 	const rec_t*	rec;
 	ulint		fold;
@@ -1700,10 +1964,11 @@ btr_search_update_hash_on_delete(btr_cur_t* cursor)
 	ut_a(block->curr_n_fields > 0 || block->curr_n_bytes > 0);
 	ut_a(!dict_index_is_ibuf(index));
 
-	table = btr_get_search_table(index);
-
 	rec = btr_cur_get_rec(cursor);
 
+	/* The hash index parameters of the block cannot change while it
+	is x-latched, but btr_search_disable() may reset block->index.
+	It holds all the search latches while doing so. */
 	fold = rec_fold(rec, rec_get_offsets(rec, index, offsets_,
 					     ULINT_UNDEFINED, &heap),
 			block->curr_n_fields, block->curr_n_bytes, index->id);
@@ -1711,13 +1976,16 @@ btr_search_update_hash_on_delete(btr_cur_t* cursor)
 		mem_heap_free(heap);
 	}
 
-	btr_search_x_lock(index);
+	rw_lock_t*	latch = btr_get_search_latch(fold);
+
+	rw_lock_x_lock(latch);
 	assert_block_ahi_valid(block);
 
 	if (block->index) {
 		ut_a(block->index == index);
 
-		if (ha_search_and_delete_if_found(table, fold, rec)) {
+		if (ha_search_and_delete_if_found(
+			btr_get_search_table(fold), fold, rec)) {
 			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_REMOVED);
 		} else {
 			MONITOR_INC(
@@ -1727,7 +1995,7 @@ btr_search_update_hash_on_delete(btr_cur_t* cursor)
 		assert_block_ahi_valid(block);
 	}
 
-	btr_search_x_unlock(index);
+	rw_lock_x_unlock(latch);
 }
 
 /** Updates the page hash index when a single record is inserted on a page.
@@ -1737,10 +2005,10 @@ btr_search_update_hash_on_delete(btr_cur_t* cursor)
 void
 btr_search_update_hash_node_on_insert(btr_cur_t* cursor)
 {
-	hash_table_t*	table;
 	buf_block_t*	block;
 	dict_index_t*	index;
 	rec_t*		rec;
+	rw_lock_t*	latch;
 
 	if (cursor->index->disable_ahi || !btr_search_enabled) {
 		return;
@@ -1762,38 +2030,63 @@ btr_search_update_hash_node_on_insert(btr_cur_t* cursor)
 	ut_a(cursor->index == index);
 	ut_a(!dict_index_is_ibuf(index));
 
-	btr_search_x_lock(index);
-
-	if (!block->index) {
-
-		goto func_exit;
-	}
-
-	ut_a(block->index == index);
-
 	if ((cursor->flag == BTR_CUR_HASH)
 	    && (cursor->n_fields == block->curr_n_fields)
 	    && (cursor->n_bytes == block->curr_n_bytes)
 	    && !block->curr_left_side) {
 
-		table = btr_get_search_table(index);
+		latch = btr_get_search_latch(cursor->fold);
+
+		rw_lock_x_lock(latch);
 
-		if (ha_search_and_update_if_found(
-			table, cursor->fold, rec, block,
-			page_rec_get_next(rec))) {
-			MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_UPDATED);
+		if (block->index) {
+			ut_a(block->index == index);
+
+			if (ha_search_and_update_if_found(
+				btr_get_search_table(cursor->fold),
+				cursor->fold, rec, block,
+				page_rec_get_next(rec))) {
+				MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_UPDATED);
+			}
 		}
 
-func_exit:
 		assert_block_ahi_valid(block);
-		btr_search_x_unlock(index);
+		rw_lock_x_unlock(latch);
 	} else {
-		btr_search_x_unlock(index);
-
 		btr_search_update_hash_on_insert(cursor);
 	}
 }
 
+/** Add an entry to the adaptive hash index for a record on an x-latched
+page, unless the hash index of the page was dropped by
+btr_search_disable().
+@param[in]	fold	fold value of the record
+@param[in]	block	index page of the record, x-latched
+@param[in]	rec	record */
+static
+void
+btr_search_insert_for_fold(
+	ulint			fold,
+	buf_block_t*		block,
+	const rec_t*		rec)
+{
+	ut_ad(rw_lock_own(&block->lock, RW_LOCK_X));
+
+	btr_search_check_free_space_in_heap(fold);
+
+	rw_lock_t*	latch = btr_get_search_latch(fold);
+
+	rw_lock_x_lock(latch);
+
+	if (block->index != NULL) {
+		ha_insert_for_fold(btr_get_search_table(fold), fold,
+				   block, rec);
+	}
+
+	assert_block_ahi_valid(block);
+	rw_lock_x_unlock(latch);
+}
+
 /** Updates the page hash index when a single record is inserted on a page.
 @param[in,out]	cursor		cursor which was positioned to the
 				place to insert using btr_cur_search_...,
@@ -1802,7 +2095,6 @@ func_exit:
 void
 btr_search_update_hash_on_insert(btr_cur_t* cursor)
 {
-	hash_table_t*	table;
 	buf_block_t*	block;
 	dict_index_t*	index;
 	const rec_t*	rec;
@@ -1814,7 +2106,6 @@ btr_search_update_hash_on_insert(btr_cur_t* cursor)
 	ulint		n_fields;
 	ulint		n_bytes;
 	ibool		left_side;
-	ibool		locked		= FALSE;
 	mem_heap_t*	heap		= NULL;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	ulint*		offsets		= offsets_;
@@ -1837,9 +2128,6 @@ btr_search_update_hash_on_insert(btr_cur_t* cursor)
 	}
 
 	ut_ad(block->page.id.space() == index->space);
-	btr_search_check_free_space_in_heap(index);
-
-	table = btr_get_search_table(index);
 
 	rec = btr_cur_get_rec(cursor);
 
@@ -1873,16 +2161,7 @@ btr_search_update_hash_on_insert(btr_cur_t* cursor)
 		fold = rec_fold(rec, offsets, n_fields, n_bytes, index->id);
 	} else {
 		if (left_side) {
-
-			btr_search_x_lock(index);
-
-			locked = TRUE;
-
-			if (!btr_search_enabled) {
-				goto function_exit;
-			}
-
-			ha_insert_for_fold(table, ins_fold, block, ins_rec);
+			btr_search_insert_for_fold(ins_fold, block, ins_rec);
 		}
 
 		goto check_next_rec;
@@ -1890,21 +2169,10 @@ btr_search_update_hash_on_insert(btr_cur_t* cursor)
 
 	if (fold != ins_fold) {
 
-		if (!locked) {
-
-			btr_search_x_lock(index);
-
-			locked = TRUE;
-
-			if (!btr_search_enabled) {
-				goto function_exit;
-			}
-		}
-
 		if (!left_side) {
-			ha_insert_for_fold(table, fold, block, rec);
+			btr_search_insert_for_fold(fold, block, rec);
 		} else {
-			ha_insert_for_fold(table, ins_fold, block, ins_rec);
+			btr_search_insert_for_fold(ins_fold, block, ins_rec);
 		}
 	}
 
@@ -1912,18 +2180,7 @@ check_next_rec:
 	if (page_rec_is_supremum(next_rec)) {
 
 		if (!left_side) {
-
-			if (!locked) {
-				btr_search_x_lock(index);
-
-				locked = TRUE;
-
-				if (!btr_search_enabled) {
-					goto function_exit;
-				}
-			}
-
-			ha_insert_for_fold(table, ins_fold, block, ins_rec);
+			btr_search_insert_for_fold(ins_fold, block, ins_rec);
 		}
 
 		goto function_exit;
@@ -1931,21 +2188,10 @@ check_next_rec:
 
 	if (ins_fold != next_fold) {
 
-		if (!locked) {
-
-			btr_search_x_lock(index);
-
-			locked = TRUE;
-
-			if (!btr_search_enabled) {
-				goto function_exit;
-			}
-		}
-
 		if (!left_side) {
-			ha_insert_for_fold(table, ins_fold, block, ins_rec);
+			btr_search_insert_for_fold(ins_fold, block, ins_rec);
 		} else {
-			ha_insert_for_fold(table, next_fold, block, next_rec);
+			btr_search_insert_for_fold(next_fold, block, next_rec);
 		}
 	}
 
@@ -1953,9 +2199,6 @@ function_exit:
 	if (UNIV_LIKELY_NULL(heap)) {
 		mem_heap_free(heap);
 	}
-	if (locked) {
-		btr_search_x_unlock(index);
-	}
 }
 
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
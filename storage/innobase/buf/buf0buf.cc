@@ -1831,6 +1831,8 @@ buf_pool_init_instance(
 
 		buf_pool->zip_hash = hash_create(2 * buf_pool->curr_size);
 
+		buf_LRU_ghost_resize(buf_pool);
+
 		buf_pool->last_printout_time = ut_time_monotonic();
 	}
 	/* 2. Initialize flushing fields
@@ -1939,10 +1941,34 @@ buf_pool_free_instance(
 	ha_clear(buf_pool->page_hash);
 	hash_table_free(buf_pool->page_hash);
 	hash_table_free(buf_pool->zip_hash);
+	buf_LRU_ghost_free(&buf_pool->LRU_ghost);
 
 	buf_pool->allocator.~ut_allocator();
 }
 
+/** Register the memory of all the buffer pool chunks with the
+asynchronous I/O system. */
+static
+void
+buf_pool_register_chunks()
+{
+	os_aio_buffers_t	bufs;
+
+	for (ulint i = 0; i < srv_buf_pool_instances; ++i) {
+		const buf_pool_t*	buf_pool = buf_pool_from_array(i);
+
+		for (ulint j = 0; j < buf_pool->n_chunks; ++j) {
+			const buf_chunk_t*	chunk = &buf_pool->chunks[j];
+
+			bufs.push_back(std::make_pair(
+				static_cast<byte*>(chunk->mem),
+				chunk->mem_size()));
+		}
+	}
+
+	os_aio_register_buffers(bufs);
+}
+
 /********************************************************************//**
 Creates the buffer pool.
 @return DB_SUCCESS if success, DB_ERROR if not enough memory or error */
@@ -1984,9 +2010,12 @@ buf_pool_init(
 
 	buf_pool_set_sizes();
 	buf_LRU_old_ratio_update(100 * 3/ 8, FALSE);
+	buf_LRU_policy_set(srv_buf_pool_LRU_policy);
 
 	btr_search_sys_create(buf_pool_get_curr_size() / sizeof(void*) / 64);
 
+	buf_pool_register_chunks();
+
 	return(DB_SUCCESS);
 }
 
@@ -2725,6 +2754,9 @@ withdraw_retry:
 		return;
 	}
 
+	/* Chunks may be freed below. */
+	os_aio_register_buffers(os_aio_buffers_t());
+
 	/* Indicate critical path */
 	buf_pool_resizing = true;
 
@@ -2913,6 +2945,8 @@ calc_buf_pool_size:
 				= buf_pool->curr_size * UNIV_PAGE_SIZE;
 			curr_size += buf_pool->curr_pool_size;
 			buf_pool->old_size = buf_pool->curr_size;
+
+			buf_LRU_ghost_resize(buf_pool);
 		}
 		srv_buf_pool_curr_size = curr_size;
 		innodb_set_buf_pool_size(buf_pool_size_align(curr_size));
@@ -2950,6 +2984,8 @@ calc_buf_pool_size:
 
 	buf_pool_resizing = false;
 
+	buf_pool_register_chunks();
+
 	/* Normalize other components, if the new size is too different */
 	if (!warning && new_size_too_diff) {
 		srv_buf_pool_base_size = srv_buf_pool_size;
@@ -5160,8 +5196,9 @@ buf_page_init_for_read(
 
 		rw_lock_x_unlock(hash_lock);
 
-		/* The block must be put to the LRU list, to the old blocks */
-		buf_LRU_add_block(bpage, TRUE/* to old blocks */);
+		/* The block must be put to the LRU list, to the old blocks
+		unless the replacement policy says otherwise */
+		buf_LRU_add_block(bpage, buf_LRU_add_to_old(buf_pool, page_id));
 
 		/* We set a pass-type x-lock on the frame because then
 		the same thread which called for the read operation
@@ -5281,9 +5318,10 @@ buf_page_init_for_read(
 
 		rw_lock_x_unlock(hash_lock);
 
-		/* The block must be put to the LRU list, to the old blocks.
+		/* The block must be put to the LRU list, to the old blocks
+		unless the replacement policy says otherwise.
 		The zip size is already set into the page zip */
-		buf_LRU_add_block(bpage, TRUE/* to old blocks */);
+		buf_LRU_add_block(bpage, buf_LRU_add_to_old(buf_pool, page_id));
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 		buf_LRU_insert_zip_clean(bpage);
 #endif /* UNIV_DEBUG || UNIV_BUF_DEBUG */
@@ -5971,6 +6009,7 @@ buf_pool_invalidate_instance(
 	buf_pool->LRU_old_len = 0;
 
 	memset(&buf_pool->stat, 0x00, sizeof(buf_pool->stat));
+	buf_pool->LRU_policy_start = buf_pool->stat;
 	buf_refresh_io_stats(buf_pool);
 
 	buf_pool_mutex_exit(buf_pool);
@@ -122,8 +122,201 @@ buf_dblwr_sync_datafiles()
 	fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
 }
 
+/** Name prefix of the doublewrite files of the batch segments; the
+buffer pool instance number is appended to it */
+static const char	BUF_DBLWR_FILE_PREFIX[] = "ib_dblwr_";
+
+/** Name of the doublewrite file of the single page flush segment */
+static const char	BUF_DBLWR_SINGLE_FILE[] = "ib_dblwr_single";
+
+/** Number of page slots in the single page flush segment */
+static const ulint	BUF_DBLWR_SINGLE_SLOTS
+	= 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
+
+/****************************************************************//**
+Generates the path of a doublewrite file. The files are created in the
+innodb_data_home_dir, or in the data directory if it is empty. */
+static
+void
+buf_dblwr_file_path(
+/*================*/
+	char*	path,	/*!< out: path, FN_REFLEN bytes */
+	ulint	seg_no)	/*!< in: batch segment number, or
+			ULINT_UNDEFINED for the single page
+			flush segment */
+{
+	const char*	dir = (strcmp(srv_data_home, "") == 0)
+		? fil_path_to_mysql_datadir : srv_data_home;
+
+	if (seg_no == ULINT_UNDEFINED) {
+		ut_snprintf(path, FN_REFLEN, "%s%c%s",
+			    dir, OS_PATH_SEPARATOR, BUF_DBLWR_SINGLE_FILE);
+	} else {
+		ut_snprintf(path, FN_REFLEN, "%s%c%s%lu",
+			    dir, OS_PATH_SEPARATOR, BUF_DBLWR_FILE_PREFIX,
+			    seg_no);
+	}
+
+	os_normalize_path(path);
+}
+
+/****************************************************************//**
+Initializes the memory structure of a doublewrite segment. The file is
+opened later by buf_dblwr_seg_open(). */
+static
+void
+buf_dblwr_seg_init(
+/*===============*/
+	buf_dblwr_seg_t*	seg,	/*!< out: segment */
+	ulint			seg_no,	/*!< in: batch segment number, or
+					ULINT_UNDEFINED */
+	ulint			n_slots)/*!< in: number of page slots */
+{
+	char	path[FN_REFLEN];
+
+	mutex_create(LATCH_ID_BUF_DBLWR, &seg->mutex);
+
+	seg->b_event = os_event_create("dblwr_batch_event");
+	seg->s_event = os_event_create("dblwr_single_event");
+	seg->n_slots = n_slots;
+	seg->first_free = 0;
+	seg->s_reserved = 0;
+	seg->b_reserved = 0;
+	seg->batch_running = false;
+
+	buf_dblwr_file_path(path, seg_no);
+	seg->path = mem_strdup(path);
+	seg->file.m_file = OS_FILE_CLOSED;
+
+	seg->in_use = static_cast<bool*>(
+		ut_zalloc_nokey(n_slots * sizeof(bool)));
+
+	seg->write_buf_unaligned = static_cast<byte*>(
+		ut_malloc_nokey((1 + n_slots) * UNIV_PAGE_SIZE));
+
+	seg->write_buf = static_cast<byte*>(
+		ut_align(seg->write_buf_unaligned,
+			 UNIV_PAGE_SIZE));
+
+	seg->buf_block_arr = static_cast<buf_page_t**>(
+		ut_zalloc_nokey(n_slots * sizeof(void*)));
+}
+
+/****************************************************************//**
+Frees the memory structure of a doublewrite segment and closes its file. */
+static
+void
+buf_dblwr_seg_free(
+/*===============*/
+	buf_dblwr_seg_t*	seg)	/*!< in,out: segment */
+{
+	ut_ad(seg->s_reserved == 0);
+	ut_ad(seg->b_reserved == 0);
+
+	if (seg->file.m_file != OS_FILE_CLOSED) {
+		bool	success = os_file_close(seg->file);
+		ut_a(success);
+		seg->file.m_file = OS_FILE_CLOSED;
+	}
+
+	os_event_destroy(seg->b_event);
+	os_event_destroy(seg->s_event);
+
+	ut_free(seg->write_buf_unaligned);
+	seg->write_buf_unaligned = NULL;
+
+	ut_free(seg->buf_block_arr);
+	seg->buf_block_arr = NULL;
+
+	ut_free(seg->in_use);
+	seg->in_use = NULL;
+
+	ut_free(seg->path);
+	seg->path = NULL;
+
+	mutex_free(&seg->mutex);
+}
+
+/****************************************************************//**
+Opens the file of a doublewrite segment, creating it if it does not exist.
+The contents of an existing file are preserved, because they may still be
+needed by crash recovery.
+@return DB_SUCCESS or error code */
+static
+dberr_t
+buf_dblwr_seg_open(
+/*===============*/
+	buf_dblwr_seg_t*	seg)	/*!< in,out: segment */
+{
+	bool		exists = false;
+	bool		success;
+	os_file_type_t	type;
+
+	ut_ad(!srv_read_only_mode);
+	ut_ad(seg->file.m_file == OS_FILE_CLOSED);
+
+	os_file_status(seg->path, &exists, &type);
+
+	seg->file = os_file_create(
+		innodb_data_file_key, seg->path,
+		(exists ? OS_FILE_OPEN : OS_FILE_CREATE)
+		| OS_FILE_ON_ERROR_NO_EXIT,
+		OS_FILE_NORMAL, OS_DATA_FILE, false, &success);
+
+	if (!success) {
+		ib::error() << "Cannot open the doublewrite file "
+			<< seg->path;
+
+		seg->file.m_file = OS_FILE_CLOSED;
+		return(DB_ERROR);
+	}
+
+	const os_offset_t	size = static_cast<os_offset_t>(
+		seg->n_slots) * UNIV_PAGE_SIZE;
+
+	if (os_file_get_size(seg->file) < size
+	    && !os_file_set_size(seg->path, seg->file, size, false)) {
+
+		ib::error() << "Cannot set the doublewrite file "
+			<< seg->path << " to size " << size;
+
+		return(DB_ERROR);
+	}
+
+	return(DB_SUCCESS);
+}
+
 /****************************************************************//**
-Creates or initialializes the doublewrite buffer at a database start. */
+Opens the doublewrite files of all the segments.
+@return DB_SUCCESS or error code */
+static
+dberr_t
+buf_dblwr_open_files()
+/*==================*/
+{
+	if (srv_read_only_mode || !srv_use_doublewrite_buf) {
+		/* Nothing will be written to the doublewrite files. */
+		return(DB_SUCCESS);
+	}
+
+	for (ulint i = 0; i < buf_dblwr->n_segs; ++i) {
+		dberr_t	err = buf_dblwr_seg_open(&buf_dblwr->segs[i]);
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+	}
+
+	return(buf_dblwr_seg_open(&buf_dblwr->single));
+}
+
+/****************************************************************//**
+Creates or initialializes the doublewrite buffer at a database start.
+Each buffer pool instance gets its own segment for batch flushes, and
+one more segment is used by single page flushes. The segments are
+stored in separate files, so that they are written independently. The
+blocks in the system tablespace are only read at startup, to recover
+pages which were written there by older versions. */
 static
 void
 buf_dblwr_init(
@@ -131,45 +324,32 @@ buf_dblwr_init(
 	byte*	doublewrite)	/*!< in: pointer to the doublewrite buf
 				header on trx sys page */
 {
-	ulint	buf_size;
-
 	buf_dblwr = static_cast<buf_dblwr_t*>(
 		ut_zalloc_nokey(sizeof(buf_dblwr_t)));
 
-	/* There are two blocks of same size in the doublewrite
-	buffer. */
-	buf_size = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
-
-	/* There must be atleast one buffer for single page writes
-	and one buffer for batch writes. */
+	/* There must be atleast one buffer for batch writes and the
+	batch must fit in the two blocks of the doublewrite buffer. */
 	ut_a(srv_doublewrite_batch_size > 0
-	     && srv_doublewrite_batch_size < buf_size);
-
-	mutex_create(LATCH_ID_BUF_DBLWR, &buf_dblwr->mutex);
-
-	buf_dblwr->b_event = os_event_create("dblwr_batch_event");
-	buf_dblwr->s_event = os_event_create("dblwr_single_event");
-	buf_dblwr->first_free = 0;
-	buf_dblwr->s_reserved = 0;
-	buf_dblwr->b_reserved = 0;
+	     && srv_doublewrite_batch_size
+	     < 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE);
 
 	buf_dblwr->block1 = mach_read_from_4(
 		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
 	buf_dblwr->block2 = mach_read_from_4(
 		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK2);
 
-	buf_dblwr->in_use = static_cast<bool*>(
-		ut_zalloc_nokey(buf_size * sizeof(bool)));
+	buf_dblwr->n_segs = srv_buf_pool_instances;
 
-	buf_dblwr->write_buf_unaligned = static_cast<byte*>(
-		ut_malloc_nokey((1 + buf_size) * UNIV_PAGE_SIZE));
+	buf_dblwr->segs = static_cast<buf_dblwr_seg_t*>(
+		ut_zalloc_nokey(buf_dblwr->n_segs * sizeof(buf_dblwr_seg_t)));
 
-	buf_dblwr->write_buf = static_cast<byte*>(
-		ut_align(buf_dblwr->write_buf_unaligned,
-			 UNIV_PAGE_SIZE));
+	for (ulint i = 0; i < buf_dblwr->n_segs; ++i) {
+		buf_dblwr_seg_init(
+			&buf_dblwr->segs[i], i, srv_doublewrite_batch_size);
+	}
 
-	buf_dblwr->buf_block_arr = static_cast<buf_page_t**>(
-		ut_zalloc_nokey(buf_size * sizeof(void*)));
+	buf_dblwr_seg_init(
+		&buf_dblwr->single, ULINT_UNDEFINED, BUF_DBLWR_SINGLE_SLOTS);
 }
 
 /****************************************************************//**
@@ -211,7 +391,7 @@ start_again:
 
 		mtr_commit(&mtr);
 		buf_dblwr_being_created = FALSE;
-		return(true);
+		return(buf_dblwr_open_files() == DB_SUCCESS);
 	}
 
 	ib::info() << "Doublewrite buffer not found: creating new";
@@ -346,12 +526,109 @@ start_again:
 	goto start_again;
 }
 
+/** Path of a doublewrite file and the number of page slots in it */
+typedef std::pair<std::string, ulint>	dblwr_file_t;
+
+/** List of doublewrite files */
+typedef std::vector<dblwr_file_t, ut_allocator<dblwr_file_t> >
+	dblwr_files_t;
+
+/** Look up a doublewrite file and add it to a list if it exists.
+@param[in]	seg_no	batch segment number, or ULINT_UNDEFINED
+@param[in,out]	files	list of existing files
+@return true if the file exists */
+static
+bool
+buf_dblwr_find_file(
+	ulint		seg_no,
+	dblwr_files_t&	files)
+{
+	char		path[FN_REFLEN];
+
+	buf_dblwr_file_path(path, seg_no);
+
+	os_file_size_t	size = os_file_get_size(path);
+
+	if (size.m_total_size == static_cast<os_offset_t>(~0)) {
+		return(false);
+	}
+
+	files.push_back(dblwr_file_t(
+		path, static_cast<ulint>(size.m_total_size / UNIV_PAGE_SIZE)));
+
+	return(true);
+}
+
+/** Find the doublewrite files which exist at startup. The number of
+buffer pool instances may have been changed since the files were
+written, so the batch segment files are looked up until the first
+missing one.
+@param[out]	files	the existing files */
+static
+void
+buf_dblwr_find_files(
+	dblwr_files_t&	files)
+{
+	for (ulint seg_no = 0; seg_no < MAX_BUFFER_POOLS; ++seg_no) {
+
+		if (!buf_dblwr_find_file(seg_no, files)) {
+			break;
+		}
+	}
+
+	buf_dblwr_find_file(ULINT_UNDEFINED, files);
+}
+
+/** Read the page slots of a doublewrite file into memory.
+@param[in]	path	path of the doublewrite file
+@param[out]	buf	buffer for the pages
+@param[in]	n_pages	number of pages to read
+@return DB_SUCCESS or error code */
+static
+dberr_t
+buf_dblwr_read_file(
+	const char*	path,
+	byte*		buf,
+	ulint		n_pages)
+{
+	bool		success;
+	pfs_os_file_t	file;
+
+	file = os_file_create(
+		innodb_data_file_key, path,
+		OS_FILE_OPEN | OS_FILE_ON_ERROR_NO_EXIT,
+		OS_FILE_NORMAL, OS_DATA_FILE, true, &success);
+
+	if (!success) {
+		ib::error() << "Cannot open the doublewrite file " << path;
+
+		return(DB_ERROR);
+	}
+
+	IORequest	read_request(IORequest::READ);
+
+	read_request.disable_compression();
+
+	dberr_t	err = os_file_read(
+		read_request, file, buf, 0, n_pages * UNIV_PAGE_SIZE);
+
+	if (err != DB_SUCCESS) {
+		ib::error() << "Failed to read the doublewrite file " << path;
+	}
+
+	success = os_file_close(file);
+	ut_a(success);
+
+	return(err);
+}
+
 /**
 At database startup initializes the doublewrite buffer memory structure if
 we already have a doublewrite buffer created in the data files. If we are
 upgrading to an InnoDB version which supports multiple tablespaces, then this
 function performs the necessary update operations. If we are in a crash
-recovery, this function loads the pages from double write buffer into memory.
+recovery, this function loads the pages from double write buffer and from
+the doublewrite files of the segments into memory.
 @param[in]	file		File handle
 @param[in]	path		Path name of file
 @return DB_SUCCESS or error code */
@@ -405,20 +682,38 @@ buf_dblwr_init_or_load_pages(
 	doublewrite = read_buf + TRX_SYS_DOUBLEWRITE;
 
 	if (mach_read_from_4(doublewrite + TRX_SYS_DOUBLEWRITE_MAGIC)
-	    == TRX_SYS_DOUBLEWRITE_MAGIC_N) {
-		/* The doublewrite buffer has been created */
+	    != TRX_SYS_DOUBLEWRITE_MAGIC_N) {
+		ut_free(unaligned_read_buf);
+		return(DB_SUCCESS);
+	}
 
-		buf_dblwr_init(doublewrite);
+	/* The doublewrite buffer has been created */
 
-		block1 = buf_dblwr->block1;
-		block2 = buf_dblwr->block2;
+	buf_dblwr_init(doublewrite);
 
-		buf = buf_dblwr->write_buf;
-	} else {
-		ut_free(unaligned_read_buf);
-		return(DB_SUCCESS);
+	block1 = buf_dblwr->block1;
+	block2 = buf_dblwr->block2;
+
+	/* Find out how many pages the doublewrite files hold. */
+	dblwr_files_t	files;
+	ulint		n_file_pages = 0;
+
+	buf_dblwr_find_files(files);
+
+	for (dblwr_files_t::const_iterator it = files.begin();
+	     it != files.end();
+	     ++it) {
+
+		n_file_pages += it->second;
 	}
 
+	buf_dblwr->recv_buf_unaligned = static_cast<byte*>(
+		ut_malloc_nokey((1 + 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE
+				 + n_file_pages) * UNIV_PAGE_SIZE));
+
+	buf = static_cast<byte*>(
+		ut_align(buf_dblwr->recv_buf_unaligned, UNIV_PAGE_SIZE));
+
 	if (mach_read_from_4(doublewrite + TRX_SYS_DOUBLEWRITE_SPACE_ID_STORED)
 	    != TRX_SYS_DOUBLEWRITE_SPACE_ID_STORED_N) {
 
@@ -528,7 +823,35 @@ buf_dblwr_init_or_load_pages(
 
 	ut_free(unaligned_read_buf);
 
-	return(DB_SUCCESS);
+	/* Read the pages from the doublewrite files to memory. The
+	slots which were never written to are skipped. */
+	for (dblwr_files_t::const_iterator it = files.begin();
+	     it != files.end();
+	     ++it) {
+
+		if (it->second == 0) {
+			continue;
+		}
+
+		err = buf_dblwr_read_file(it->first.c_str(), page, it->second);
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+
+		for (ulint i = 0; i < it->second; ++i) {
+
+			if (!buf_page_is_zeroes(page, univ_page_size)) {
+				recv_dblwr.add(page);
+			}
+
+			page += univ_page_size.physical();
+		}
+	}
+
+	/* The pages have been copied to memory: the files can now be
+	opened for writing. */
+	return(buf_dblwr_open_files());
 }
 
 /** Process and remove the double write buffer pages for all tablespaces. */
@@ -605,6 +928,10 @@ buf_dblwr_process(void)
 					<< "error: " << ut_strerr(err);
 			}
 
+			/* The page may have been written to more than
+			one segment: restore it from the newest copy. */
+			page = recv_dblwr.find_page(space_id, page_no);
+
 			/* Check if the page is corrupt */
 			if (buf_page_is_corrupted(
 				true, read_buf, page_size,
@@ -691,12 +1018,59 @@ buf_dblwr_process(void)
 		}
 	}
 
-	recv_dblwr.pages.clear();
+	buf_dblwr_free_recovered_pages();
 
 	fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
 	ut_free(unaligned_read_buf);
 }
 
+/** Delete the doublewrite files which are not written by this server
+instance. They are left behind when innodb_buffer_pool_instances was
+lowered, or all of them when innodb_doublewrite is off. Their pages
+were loaded for recovery at startup, but they would become stale copies
+of the pages which are flushed from now on. */
+static
+void
+buf_dblwr_delete_stale_files()
+{
+	const ulint	n_segs = srv_use_doublewrite_buf
+		? buf_dblwr->n_segs : 0;
+
+	for (ulint seg_no = n_segs; seg_no < MAX_BUFFER_POOLS; ++seg_no) {
+		char	path[FN_REFLEN];
+
+		buf_dblwr_file_path(path, seg_no);
+
+		os_file_delete_if_exists(innodb_data_file_key, path, NULL);
+	}
+
+	if (!srv_use_doublewrite_buf) {
+		char	path[FN_REFLEN];
+
+		buf_dblwr_file_path(path, ULINT_UNDEFINED);
+
+		os_file_delete_if_exists(innodb_data_file_key, path, NULL);
+	}
+}
+
+/** Free the copies of the pages which were loaded from the doublewrite
+buffer and files at startup, and delete the doublewrite files which are
+no longer used. */
+void
+buf_dblwr_free_recovered_pages()
+{
+	recv_sys->dblwr.pages.clear();
+
+	if (buf_dblwr != NULL) {
+		ut_free(buf_dblwr->recv_buf_unaligned);
+		buf_dblwr->recv_buf_unaligned = NULL;
+
+		if (!srv_read_only_mode) {
+			buf_dblwr_delete_stale_files();
+		}
+	}
+}
+
 /****************************************************************//**
 Frees doublewrite buffer. */
 void
@@ -705,21 +1079,19 @@ buf_dblwr_free(void)
 {
 	/* Free the double write data structures. */
 	ut_a(buf_dblwr != NULL);
-	ut_ad(buf_dblwr->s_reserved == 0);
-	ut_ad(buf_dblwr->b_reserved == 0);
 
-	os_event_destroy(buf_dblwr->b_event);
-	os_event_destroy(buf_dblwr->s_event);
-	ut_free(buf_dblwr->write_buf_unaligned);
-	buf_dblwr->write_buf_unaligned = NULL;
+	for (ulint i = 0; i < buf_dblwr->n_segs; ++i) {
+		buf_dblwr_seg_free(&buf_dblwr->segs[i]);
+	}
+
+	buf_dblwr_seg_free(&buf_dblwr->single);
 
-	ut_free(buf_dblwr->buf_block_arr);
-	buf_dblwr->buf_block_arr = NULL;
+	ut_free(buf_dblwr->segs);
+	buf_dblwr->segs = NULL;
 
-	ut_free(buf_dblwr->in_use);
-	buf_dblwr->in_use = NULL;
+	ut_free(buf_dblwr->recv_buf_unaligned);
+	buf_dblwr->recv_buf_unaligned = NULL;
 
-	mutex_free(&buf_dblwr->mutex);
 	ut_free(buf_dblwr);
 	buf_dblwr = NULL;
 }
@@ -740,52 +1112,58 @@ buf_dblwr_update(
 
 	ut_ad(!srv_read_only_mode);
 
+	buf_dblwr_seg_t*	seg;
+
 	switch (flush_type) {
 	case BUF_FLUSH_LIST:
 	case BUF_FLUSH_LRU:
-		mutex_enter(&buf_dblwr->mutex);
+		ut_ad(bpage->buf_pool_index < buf_dblwr->n_segs);
 
-		ut_ad(buf_dblwr->batch_running);
-		ut_ad(buf_dblwr->b_reserved > 0);
-		ut_ad(buf_dblwr->b_reserved <= buf_dblwr->first_free);
+		seg = &buf_dblwr->segs[bpage->buf_pool_index];
 
-		buf_dblwr->b_reserved--;
+		mutex_enter(&seg->mutex);
 
-		if (buf_dblwr->b_reserved == 0) {
-			mutex_exit(&buf_dblwr->mutex);
+		ut_ad(seg->batch_running);
+		ut_ad(seg->b_reserved > 0);
+		ut_ad(seg->b_reserved <= seg->first_free);
+
+		seg->b_reserved--;
+
+		if (seg->b_reserved == 0) {
+			mutex_exit(&seg->mutex);
 			/* This will finish the batch. Sync data files
 			to the disk. */
 			fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
-			mutex_enter(&buf_dblwr->mutex);
+			mutex_enter(&seg->mutex);
 
 			/* We can now reuse the doublewrite memory buffer: */
-			buf_dblwr->first_free = 0;
-			buf_dblwr->batch_running = false;
-			os_event_set(buf_dblwr->b_event);
+			seg->first_free = 0;
+			seg->batch_running = false;
+			os_event_set(seg->b_event);
 		}
 
-		mutex_exit(&buf_dblwr->mutex);
+		mutex_exit(&seg->mutex);
 		break;
 	case BUF_FLUSH_SINGLE_PAGE:
+		seg = &buf_dblwr->single;
 		{
-			const ulint size = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
 			ulint i;
-			mutex_enter(&buf_dblwr->mutex);
-			for (i = srv_doublewrite_batch_size; i < size; ++i) {
-				if (buf_dblwr->buf_block_arr[i] == bpage) {
-					buf_dblwr->s_reserved--;
-					buf_dblwr->buf_block_arr[i] = NULL;
-					buf_dblwr->in_use[i] = false;
+			mutex_enter(&seg->mutex);
+			for (i = 0; i < seg->n_slots; ++i) {
+				if (seg->buf_block_arr[i] == bpage) {
+					seg->s_reserved--;
+					seg->buf_block_arr[i] = NULL;
+					seg->in_use[i] = false;
 					break;
 				}
 			}
 
 			/* The block we are looking for must exist as a
 			reserved block. */
-			ut_a(i < size);
+			ut_a(i < seg->n_slots);
 		}
-		os_event_set(buf_dblwr->s_event);
-		mutex_exit(&buf_dblwr->mutex);
+		os_event_set(seg->s_event);
+		mutex_exit(&seg->mutex);
 		break;
 	case BUF_FLUSH_N_TYPES:
 		ut_error;
@@ -937,37 +1315,64 @@ buf_dblwr_write_block_to_datafile(
 }
 
 /********************************************************************//**
-Flushes possible buffered writes from the doublewrite memory buffer to disk,
-and also wakes up the aio thread if simulated aio is used. It is very
-important to call this function after a batch of writes has been posted,
-and also when we may have to wait for a page latch! Otherwise a deadlock
-of threads can occur. */
+Writes page slots to the file of a doublewrite segment and flushes the file
+to disk. */
+static
 void
-buf_dblwr_flush_buffered_writes(void)
-/*=================================*/
+buf_dblwr_seg_write(
+/*================*/
+	buf_dblwr_seg_t*	seg,	/*!< in: segment */
+	ulint			slot,	/*!< in: first slot to write */
+	const byte*		buf,	/*!< in: page frames, aligned to
+					UNIV_PAGE_SIZE */
+	ulint			n_slots)/*!< in: number of slots to write */
 {
-	byte*		write_buf;
-	ulint		first_free;
-	ulint		len;
+	ut_ad(slot + n_slots <= seg->n_slots);
+	ut_ad(seg->file.m_file != OS_FILE_CLOSED);
 
-	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
-		/* Sync the writes to the disk. */
-		buf_dblwr_sync_datafiles();
-		return;
+	IORequest	request(IORequest::WRITE);
+
+	request.disable_compression();
+
+	dberr_t	err = os_file_write(
+		request, seg->path, seg->file, buf,
+		static_cast<os_offset_t>(slot) * UNIV_PAGE_SIZE,
+		n_slots * UNIV_PAGE_SIZE);
+
+	if (err != DB_SUCCESS) {
+		ib::fatal() << "Cannot write to the doublewrite file "
+			<< seg->path << ": " << ut_strerr(err);
 	}
 
-	ut_ad(!srv_read_only_mode);
+	if (!os_file_flush(seg->file)) {
+		ib::fatal() << "Cannot flush the doublewrite file "
+			<< seg->path;
+	}
+}
+
+/********************************************************************//**
+Flushes possible buffered writes from the memory buffer of a doublewrite
+batch segment to disk, and posts the writes to the datafiles. Only the
+threads flushing the same buffer pool instance wait for each other. */
+static
+void
+buf_dblwr_seg_flush(
+/*================*/
+	buf_dblwr_seg_t*	seg)	/*!< in,out: batch segment */
+{
+	byte*		write_buf;
+	ulint		first_free;
 
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&seg->mutex);
 
-	/* Write first to doublewrite buffer blocks. We use synchronous
-	aio and thus know that file write has been completed when the
+	/* Write first to the doublewrite file. We use synchronous
+	i/o and thus know that file write has been completed when the
 	control returns. */
 
-	if (buf_dblwr->first_free == 0) {
+	if (seg->first_free == 0) {
 
-		mutex_exit(&buf_dblwr->mutex);
+		mutex_exit(&seg->mutex);
 
 		/* Wake possible simulated aio thread as there could be
 		system temporary tablespace pages active for flushing.
@@ -978,39 +1383,38 @@ try_again:
 		return;
 	}
 
-	if (buf_dblwr->batch_running) {
+	if (seg->batch_running) {
 		/* Another thread is running the batch right now. Wait
 		for it to finish. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		int64_t	sig_count = os_event_reset(seg->b_event);
+		mutex_exit(&seg->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(seg->b_event, sig_count);
 		goto try_again;
 	}
 
-	ut_a(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
+	ut_a(!seg->batch_running);
+	ut_ad(seg->first_free == seg->b_reserved);
 
-	/* Disallow anyone else to post to doublewrite buffer or to
-	start another batch of flushing. */
-	buf_dblwr->batch_running = true;
-	first_free = buf_dblwr->first_free;
+	/* Disallow anyone else to post to this segment or to start
+	another batch of flushing from it. */
+	seg->batch_running = true;
+	first_free = seg->first_free;
 
 	/* Now safe to release the mutex. Note that though no other
-	thread is allowed to post to the doublewrite batch flushing
-	but any threads working on single page flushes are allowed
-	to proceed. */
-	mutex_exit(&buf_dblwr->mutex);
+	thread is allowed to post to this segment, the other segments
+	and the single page flushes are allowed to proceed. */
+	mutex_exit(&seg->mutex);
 
-	write_buf = buf_dblwr->write_buf;
+	write_buf = seg->write_buf;
 
 	for (ulint len2 = 0, i = 0;
-	     i < buf_dblwr->first_free;
+	     i < first_free;
 	     len2 += UNIV_PAGE_SIZE, i++) {
 
 		const buf_block_t*	block;
 
-		block = (buf_block_t*) buf_dblwr->buf_block_arr[i];
+		block = (buf_block_t*) seg->buf_block_arr[i];
 
 		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
 		    || block->page.zip.data) {
@@ -1028,57 +1432,32 @@ try_again:
 		buf_dblwr_check_page_lsn(write_buf + len2);
 	}
 
-	/* Write out the first block of the doublewrite buffer */
-	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
-		     buf_dblwr->first_free) * UNIV_PAGE_SIZE;
-
-	fil_io(IORequestWrite, true,
-	       page_id_t(TRX_SYS_SPACE, buf_dblwr->block1), univ_page_size,
-	       0, len, (void*) write_buf, NULL);
-
-	if (buf_dblwr->first_free <= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		/* No unwritten pages in the second block. */
-		goto flush;
-	}
-
-	/* Write out the second block of the doublewrite buffer. */
-	len = (buf_dblwr->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
-	       * UNIV_PAGE_SIZE;
+	/* Write out the batch to the doublewrite file and flush it */
+	buf_dblwr_seg_write(seg, 0, write_buf, first_free);
 
-	write_buf = buf_dblwr->write_buf
-		    + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * UNIV_PAGE_SIZE;
-
-	fil_io(IORequestWrite, true,
-	       page_id_t(TRX_SYS_SPACE, buf_dblwr->block2), univ_page_size,
-	       0, len, (void*) write_buf, NULL);
-
-flush:
 	/* increment the doublewrite flushed pages counter */
-	srv_stats.dblwr_pages_written.add(buf_dblwr->first_free);
+	srv_stats.dblwr_pages_written.add(first_free);
 	srv_stats.dblwr_writes.inc();
 
-	/* Now flush the doublewrite buffer data to disk */
-	fil_flush(TRX_SYS_SPACE);
-
 	/* We know that the writes have been flushed to disk now
-	and in recovery we will find them in the doublewrite buffer
-	blocks. Next do the writes to the intended positions. */
+	and in recovery we will find them in the doublewrite file.
+	Next do the writes to the intended positions. */
 
-	/* Up to this point first_free and buf_dblwr->first_free are
-	same because we have set the buf_dblwr->batch_running flag
+	/* Up to this point first_free and seg->first_free are
+	same because we have set the seg->batch_running flag
 	disallowing any other thread to post any request but we
-	can't safely access buf_dblwr->first_free in the loop below.
+	can't safely access seg->first_free in the loop below.
 	This is so because it is possible that after we are done with
 	the last iteration and before we terminate the loop, the batch
 	gets finished in the IO helper thread and another thread posts
-	a new batch setting buf_dblwr->first_free to a higher value.
-	If this happens and we are using buf_dblwr->first_free in the
+	a new batch setting seg->first_free to a higher value.
+	If this happens and we are using seg->first_free in the
 	loop termination condition then we'll end up dispatching
 	the same block twice from two different threads. */
-	ut_ad(first_free == buf_dblwr->first_free);
+	ut_ad(first_free == seg->first_free);
 	for (ulint i = 0; i < first_free; i++) {
 		buf_dblwr_write_block_to_datafile(
-			buf_dblwr->buf_block_arr[i], false);
+			seg->buf_block_arr[i], false);
 	}
 
 	/* Wake possible simulated aio thread to actually post the
@@ -1089,46 +1468,93 @@ flush:
 }
 
 /********************************************************************//**
-Posts a buffer page for writing. If the doublewrite memory buffer is
-full, calls buf_dblwr_flush_buffered_writes and waits for for free
-space to appear. */
+Flushes possible buffered writes from the doublewrite memory buffers of all
+the buffer pool instances to disk, and also wakes up the aio thread if
+simulated aio is used. It is very important to call this function after a
+batch of writes has been posted, and also when we may have to wait for a
+page latch! Otherwise a deadlock of threads can occur. */
+void
+buf_dblwr_flush_buffered_writes(void)
+/*=================================*/
+{
+	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
+		/* Sync the writes to the disk. */
+		buf_dblwr_sync_datafiles();
+		return;
+	}
+
+	ut_ad(!srv_read_only_mode);
+
+	for (ulint i = 0; i < buf_dblwr->n_segs; ++i) {
+		buf_dblwr_seg_flush(&buf_dblwr->segs[i]);
+	}
+}
+
+/** Flushes possible buffered writes from the doublewrite memory buffer of
+one buffer pool instance to disk. The batches of the other instances are
+not waited for.
+@param[in]	instance_no	buffer pool instance number */
+void
+buf_dblwr_flush_buffered_writes(
+	ulint	instance_no)
+{
+	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
+		/* Sync the writes to the disk. */
+		buf_dblwr_sync_datafiles();
+		return;
+	}
+
+	ut_ad(!srv_read_only_mode);
+	ut_ad(instance_no < buf_dblwr->n_segs);
+
+	buf_dblwr_seg_flush(&buf_dblwr->segs[instance_no]);
+}
+
+/********************************************************************//**
+Posts a buffer page for writing. If the doublewrite memory buffer of the
+buffer pool instance of the page is full, calls
+buf_dblwr_flush_buffered_writes and waits for for free space to appear. */
 void
 buf_dblwr_add_to_batch(
 /*====================*/
 	buf_page_t*	bpage)	/*!< in: buffer block to write */
 {
 	ut_a(buf_page_in_file(bpage));
+	ut_ad(bpage->buf_pool_index < buf_dblwr->n_segs);
+
+	const ulint		instance_no = bpage->buf_pool_index;
+	buf_dblwr_seg_t*	seg = &buf_dblwr->segs[instance_no];
 
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&seg->mutex);
 
-	ut_a(buf_dblwr->first_free <= srv_doublewrite_batch_size);
+	ut_a(seg->first_free <= seg->n_slots);
 
-	if (buf_dblwr->batch_running) {
+	if (seg->batch_running) {
 
-		/* This not nearly as bad as it looks. There is only
-		page_cleaner thread which does background flushing
-		in batches therefore it is unlikely to be a contention
-		point. The only exception is when a user thread is
-		forced to do a flush batch because of a sync
-		checkpoint. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		/* This not nearly as bad as it looks. Only the page
+		cleaner thread flushing this buffer pool instance does
+		background flushing to this segment, therefore it is
+		unlikely to be a contention point. The only exception
+		is when a user thread is forced to do a flush batch
+		because of a sync checkpoint. */
+		int64_t	sig_count = os_event_reset(seg->b_event);
+		mutex_exit(&seg->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(seg->b_event, sig_count);
 		goto try_again;
 	}
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (seg->first_free == seg->n_slots) {
+		mutex_exit(&seg->mutex);
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes(instance_no);
 
 		goto try_again;
 	}
 
-	byte*	p = buf_dblwr->write_buf
-		+ univ_page_size.physical() * buf_dblwr->first_free;
+	byte*	p = seg->write_buf
+		+ univ_page_size.physical() * seg->first_free;
 
 	if (bpage->size.is_compressed()) {
 		UNIV_MEM_ASSERT_RW(bpage->zip.data, bpage->size.physical());
@@ -1147,55 +1573,46 @@ try_again:
 		memcpy(p, ((buf_block_t*) bpage)->frame, bpage->size.logical());
 	}
 
-	buf_dblwr->buf_block_arr[buf_dblwr->first_free] = bpage;
+	seg->buf_block_arr[seg->first_free] = bpage;
 
-	buf_dblwr->first_free++;
-	buf_dblwr->b_reserved++;
+	seg->first_free++;
+	seg->b_reserved++;
 
-	ut_ad(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
-	ut_ad(buf_dblwr->b_reserved <= srv_doublewrite_batch_size);
+	ut_ad(!seg->batch_running);
+	ut_ad(seg->first_free == seg->b_reserved);
+	ut_ad(seg->b_reserved <= seg->n_slots);
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (seg->first_free == seg->n_slots) {
+		mutex_exit(&seg->mutex);
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes(instance_no);
 
 		return;
 	}
 
-	mutex_exit(&(buf_dblwr->mutex));
+	mutex_exit(&seg->mutex);
 }
 
 /********************************************************************//**
-Writes a page to the doublewrite buffer on disk, sync it, then write
-the page to the datafile and sync the datafile. This function is used
-for single page flushes. If all the buffers allocated for single page
-flushes in the doublewrite buffer are in use we wait here for one to
-become free. We are guaranteed that a slot will become free because any
-thread that is using a slot must also release the slot before leaving
-this function. */
+Writes a page to the doublewrite file of the single page flush segment,
+sync it, then write the page to the datafile and sync the datafile. This
+function is used for single page flushes. If all the slots of the segment
+are in use we wait here for one to become free. We are guaranteed that a
+slot will become free because any thread that is using a slot must also
+release the slot before leaving this function. */
 void
 buf_dblwr_write_single_page(
 /*========================*/
 	buf_page_t*	bpage,	/*!< in: buffer block to write */
 	bool		sync)	/*!< in: true if sync IO requested */
 {
-	ulint		n_slots;
-	ulint		size;
-	ulint		offset;
 	ulint		i;
 
 	ut_a(buf_page_in_file(bpage));
 	ut_a(srv_use_doublewrite_buf);
 	ut_a(buf_dblwr != NULL);
 
-	/* total number of slots available for single page flushes
-	starts from srv_doublewrite_batch_size to the end of the
-	buffer. */
-	size = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
-	ut_a(size > srv_doublewrite_batch_size);
-	n_slots = size - srv_doublewrite_batch_size;
+	buf_dblwr_seg_t*	seg = &buf_dblwr->single;
 
 	if (buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE) {
 
@@ -1212,86 +1629,65 @@ buf_dblwr_write_single_page(
 	}
 
 retry:
-	mutex_enter(&buf_dblwr->mutex);
-	if (buf_dblwr->s_reserved == n_slots) {
+	mutex_enter(&seg->mutex);
+	if (seg->s_reserved == seg->n_slots) {
 
 		/* All slots are reserved. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->s_event);
-		mutex_exit(&buf_dblwr->mutex);
-		os_event_wait_low(buf_dblwr->s_event, sig_count);
+		int64_t	sig_count = os_event_reset(seg->s_event);
+		mutex_exit(&seg->mutex);
+		os_event_wait_low(seg->s_event, sig_count);
 
 		goto retry;
 	}
 
-	for (i = srv_doublewrite_batch_size; i < size; ++i) {
+	for (i = 0; i < seg->n_slots; ++i) {
 
-		if (!buf_dblwr->in_use[i]) {
+		if (!seg->in_use[i]) {
 			break;
 		}
 	}
 
 	/* We are guaranteed to find a slot. */
-	ut_a(i < size);
-	buf_dblwr->in_use[i] = true;
-	buf_dblwr->s_reserved++;
-	buf_dblwr->buf_block_arr[i] = bpage;
+	ut_a(i < seg->n_slots);
+	seg->in_use[i] = true;
+	seg->s_reserved++;
+	seg->buf_block_arr[i] = bpage;
 
 	/* increment the doublewrite flushed pages counter */
 	srv_stats.dblwr_pages_written.inc();
 	srv_stats.dblwr_writes.inc();
 
-	mutex_exit(&buf_dblwr->mutex);
-
-	/* Lets see if we are going to write in the first or second
-	block of the doublewrite buffer. */
-	if (i < TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		offset = buf_dblwr->block1 + i;
-	} else {
-		offset = buf_dblwr->block2 + i
-			 - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
-	}
+	mutex_exit(&seg->mutex);
 
 	/* We deal with compressed and uncompressed pages a little
 	differently here. In case of uncompressed pages we can
 	directly write the block to the allocated slot in the
-	doublewrite buffer in the system tablespace and then after
-	syncing the system table space we can proceed to write the page
-	in the datafile.
+	doublewrite file and then after syncing the file we can
+	proceed to write the page in the datafile.
 	In case of compressed page we first do a memcpy of the block
 	to the in-memory buffer of doublewrite before proceeding to
 	write it. This is so because we want to pad the remaining
 	bytes in the doublewrite page with zeros. */
 
 	if (bpage->size.is_compressed()) {
-		memcpy(buf_dblwr->write_buf + univ_page_size.physical() * i,
-		       bpage->zip.data, bpage->size.physical());
+		byte*	p = seg->write_buf + univ_page_size.physical() * i;
 
-		memset(buf_dblwr->write_buf + univ_page_size.physical() * i
-		       + bpage->size.physical(), 0x0,
+		memcpy(p, bpage->zip.data, bpage->size.physical());
+
+		memset(p + bpage->size.physical(), 0x0,
 		       univ_page_size.physical() - bpage->size.physical());
 
-		fil_io(IORequestWrite, true,
-		       page_id_t(TRX_SYS_SPACE, offset), univ_page_size, 0,
-		       univ_page_size.physical(),
-		       (void*) (buf_dblwr->write_buf
-				+ univ_page_size.physical() * i),
-		       NULL);
+		buf_dblwr_seg_write(seg, i, p, 1);
 	} else {
 		/* It is a regular page. Write it directly to the
-		doublewrite buffer */
-		fil_io(IORequestWrite, true,
-		       page_id_t(TRX_SYS_SPACE, offset), univ_page_size, 0,
-		       univ_page_size.physical(),
-		       (void*) ((buf_block_t*) bpage)->frame,
-		       NULL);
+		doublewrite file */
+		buf_dblwr_seg_write(
+			seg, i, ((buf_block_t*) bpage)->frame, 1);
 	}
 
-	/* Now flush the doublewrite buffer data to disk */
-	fil_flush(TRX_SYS_SPACE);
-
 	/* We know that the write has been flushed to disk now
-	and during recovery we will find it in the doublewrite buffer
-	blocks. Next do the write to the intended position. */
+	and during recovery we will find it in the doublewrite file.
+	Next do the write to the intended position. */
 	buf_dblwr_write_block_to_datafile(bpage, sync);
 }
 #endif /* !UNIV_HOTBACKUP */
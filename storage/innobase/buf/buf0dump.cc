@@ -43,12 +43,14 @@ Created April 08, 2011 Vasil Dimov
 #include "buf0buf.h"
 #include "buf0dump.h"
 #include "dict0dict.h"
+#include "mach0data.h"
 #include "os0file.h"
 #include "os0thread.h"
 #include "srv0srv.h"
 #include "srv0start.h"
 #include "sync0rw.h"
 #include "ut0byte.h"
+#include "zlib.h"
 
 #include <algorithm>
 
@@ -78,6 +80,48 @@ typedef ib_uint64_t	buf_dump_t;
 #define BUF_DUMP_SPACE(a)		((ulint) ((a) >> 32))
 #define BUF_DUMP_PAGE(a)		((ulint) ((a) & 0xFFFFFFFFUL))
 
+/* The dump file is written in a binary format:
+BUF_DUMP_MAGIC, followed by compressed chunks of page entries of each
+buffer pool instance in LRU order. Each chunk starts with the number of
+entries (4 bytes) and the size of the zlib compressed entries (4 bytes).
+Each entry consists of the space id (4 bytes), the page number (4 bytes)
+and the hotness of the page (1 byte), which is 255 at the head of the
+LRU list and decreases towards its tail. The old text format of one
+"space,page" line per page can still be loaded. */
+static const char	BUF_DUMP_MAGIC[] = "IBPD0001";
+
+/** Size of BUF_DUMP_MAGIC */
+#define BUF_DUMP_MAGIC_SIZE	8
+
+/** Size of a chunk header in the dump file */
+#define BUF_DUMP_CHUNK_HDR_SIZE	8
+
+/** Size of a page entry in the dump file */
+#define BUF_DUMP_ENTRY_SIZE	9
+
+/** Maximum number of page entries in a chunk of the dump file */
+#define BUF_DUMP_CHUNK_ENTRIES	16384
+
+/** Maximum hotness of a page */
+#define BUF_DUMP_MAX_HOTNESS	255
+
+/** Number of hotness tiers that are loaded one after another, hottest
+first. The pages of a tier are read in (space, page) order. */
+#define BUF_LOAD_N_TIERS	4
+
+/** Get the load tier of a page.
+@param[in]	hotness	hotness of the page
+@return load tier, 0 for the coldest pages */
+#define BUF_LOAD_TIER(hotness)	\
+	((hotness) * BUF_LOAD_N_TIERS / (BUF_DUMP_MAX_HOTNESS + 1))
+
+/** Maximum number of contiguous pages that are submitted together as
+one read request during load */
+#define BUF_LOAD_MAX_RUN	64
+
+/** Maximum number of pending page reads during load */
+#define BUF_LOAD_MAX_PENDING	1024
+
 /*****************************************************************//**
 Wakes up the buffer pool dump/load thread and instructs it to start
 a dump. This function is called by MySQL code via buffer_pool_dump_now()
@@ -258,6 +302,41 @@ buf_dump_generate_path(
 	}
 }
 
+/** Compress and write a chunk of page entries to a dump file.
+@param[in,out]	f		dump file
+@param[in]	entries		page entries
+@param[in]	n		number of page entries, at most
+BUF_DUMP_CHUNK_ENTRIES
+@param[out]	zbuf		buffer for the compressed entries
+@param[in]	zbuf_size	size of zbuf
+@return whether the chunk was written */
+static
+bool
+buf_dump_write_chunk(
+	FILE*		f,
+	const byte*	entries,
+	ulint		n,
+	byte*		zbuf,
+	ulint		zbuf_size)
+{
+	byte	hdr[BUF_DUMP_CHUNK_HDR_SIZE];
+	uLongf	zlen = static_cast<uLongf>(zbuf_size);
+
+	ut_ad(n > 0);
+	ut_ad(n <= BUF_DUMP_CHUNK_ENTRIES);
+
+	if (compress2(zbuf, &zlen, entries,
+		      static_cast<uLong>(n * BUF_DUMP_ENTRY_SIZE), 1) != Z_OK) {
+		return(false);
+	}
+
+	mach_write_to_4(hdr, n);
+	mach_write_to_4(hdr + 4, zlen);
+
+	return(fwrite(hdr, 1, sizeof hdr, f) == sizeof hdr
+	       && fwrite(zbuf, 1, zlen, f) == zlen);
+}
+
 /*****************************************************************//**
 Perform a buffer pool dump into the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
@@ -279,6 +358,9 @@ buf_dump(
 	FILE*	f;
 	ulint	i;
 	int	ret;
+	byte*	zbuf;
+	ulint	zbuf_size = compressBound(
+		BUF_DUMP_CHUNK_ENTRIES * BUF_DUMP_ENTRY_SIZE);
 
 	buf_dump_generate_path(full_filename, sizeof(full_filename));
 
@@ -288,7 +370,7 @@ buf_dump(
 	buf_dump_status(STATUS_INFO, "Dumping buffer pool(s) to %s",
 			full_filename);
 
-	f = fopen(tmp_filename, "w");
+	f = fopen(tmp_filename, "wb");
 	if (f == NULL) {
 		buf_dump_status(STATUS_ERR,
 				"Cannot open '%s' for writing: %s",
@@ -297,11 +379,33 @@ buf_dump(
 	}
 	/* else */
 
+	if (fwrite(BUF_DUMP_MAGIC, 1, BUF_DUMP_MAGIC_SIZE, f)
+	    != BUF_DUMP_MAGIC_SIZE) {
+		fclose(f);
+		buf_dump_status(STATUS_ERR,
+				"Cannot write to '%s': %s",
+				tmp_filename, strerror(errno));
+		/* leave tmp_filename to exist */
+		return;
+	}
+
+	zbuf = static_cast<byte*>(ut_malloc_nokey(zbuf_size));
+
+	if (zbuf == NULL) {
+		fclose(f);
+		buf_dump_status(STATUS_ERR,
+				"Cannot allocate " ULINTPF " bytes: %s",
+				zbuf_size, strerror(errno));
+		/* leave tmp_filename to exist */
+		return;
+	}
+
 	/* walk through each buffer pool */
 	for (i = 0; i < srv_buf_pool_instances && !SHOULD_QUIT(); i++) {
 		buf_pool_t*		buf_pool;
 		const buf_page_t*	bpage;
-		buf_dump_t*		dump;
+		byte*			entries;
+		ulint			n_lru;
 		ulint			n_pages;
 		ulint			j;
 
@@ -311,7 +415,7 @@ buf_dump(
 		UT_LIST_GET_LEN(buf_pool->LRU) could change */
 		buf_pool_mutex_enter(buf_pool);
 
-		n_pages = UT_LIST_GET_LEN(buf_pool->LRU);
+		n_lru = n_pages = UT_LIST_GET_LEN(buf_pool->LRU);
 
 		/* skip empty buffer pools */
 		if (n_pages == 0) {
@@ -329,15 +433,16 @@ buf_dump(
 			}
 		}
 
-		dump = static_cast<buf_dump_t*>(ut_malloc_nokey(
-				n_pages * sizeof(*dump)));
+		entries = static_cast<byte*>(ut_malloc_nokey(
+				n_pages * BUF_DUMP_ENTRY_SIZE));
 
-		if (dump == NULL) {
+		if (entries == NULL) {
 			buf_pool_mutex_exit(buf_pool);
+			ut_free(zbuf);
 			fclose(f);
 			buf_dump_status(STATUS_ERR,
 					"Cannot allocate " ULINTPF " bytes: %s",
-					(ulint) (n_pages * sizeof(*dump)),
+					(ulint) (n_pages * BUF_DUMP_ENTRY_SIZE),
 					strerror(errno));
 			/* leave tmp_filename to exist */
 			return;
@@ -347,22 +452,31 @@ buf_dump(
 		     bpage != NULL && j < n_pages;
 		     bpage = UT_LIST_GET_NEXT(LRU, bpage), j++) {
 
+			byte*	entry = entries + j * BUF_DUMP_ENTRY_SIZE;
+
 			ut_a(buf_page_in_file(bpage));
 
-			dump[j] = BUF_DUMP_CREATE(bpage->id.space(),
-						  bpage->id.page_no());
+			mach_write_to_4(entry, bpage->id.space());
+			mach_write_to_4(entry + 4, bpage->id.page_no());
+			mach_write_to_1(entry + 8, BUF_DUMP_MAX_HOTNESS
+					- j * (BUF_DUMP_MAX_HOTNESS + 1) / n_lru);
 		}
 
 		ut_a(j == n_pages);
 
 		buf_pool_mutex_exit(buf_pool);
 
-		for (j = 0; j < n_pages && !SHOULD_QUIT(); j++) {
-			ret = fprintf(f, ULINTPF "," ULINTPF "\n",
-				      BUF_DUMP_SPACE(dump[j]),
-				      BUF_DUMP_PAGE(dump[j]));
-			if (ret < 0) {
-				ut_free(dump);
+		for (j = 0; j < n_pages && !SHOULD_QUIT();
+		     j += BUF_DUMP_CHUNK_ENTRIES) {
+
+			const ulint	n = ut_min(n_pages - j,
+						   ulint(BUF_DUMP_CHUNK_ENTRIES));
+
+			if (!buf_dump_write_chunk(
+				    f, entries + j * BUF_DUMP_ENTRY_SIZE, n,
+				    zbuf, zbuf_size)) {
+				ut_free(entries);
+				ut_free(zbuf);
 				fclose(f);
 				buf_dump_status(STATUS_ERR,
 						"Cannot write to '%s': %s",
@@ -371,20 +485,20 @@ buf_dump(
 				return;
 			}
 
-			if (j % 128 == 0) {
-				buf_dump_status(
-					STATUS_VERBOSE,
-					"Dumping buffer pool"
-					" " ULINTPF "/" ULINTPF ","
-					" page " ULINTPF "/" ULINTPF,
-					i + 1, srv_buf_pool_instances,
-					j + 1, n_pages);
-			}
+			buf_dump_status(
+				STATUS_VERBOSE,
+				"Dumping buffer pool"
+				" " ULINTPF "/" ULINTPF ","
+				" page " ULINTPF "/" ULINTPF,
+				i + 1, srv_buf_pool_instances,
+				j + n, n_pages);
 		}
 
-		ut_free(dump);
+		ut_free(entries);
 	}
 
+	ut_free(zbuf);
+
 	ret = fclose(f);
 	if (ret != 0) {
 		buf_dump_status(STATUS_ERR,
@@ -484,6 +598,10 @@ buf_load_throttle_if_needed(
 	ut_time_monotonic_ms() that often may turn out to be too expensive. */
 
 	if (elapsed_time < 1000 /* 1 sec (1000 milli secs) */) {
+		/* Do not leave the reads of the current run queued
+		while sleeping. */
+		os_aio_simulated_wake_handler_threads();
+
 		os_thread_sleep((1000 - elapsed_time) * 1000 /* micro secs */);
 	}
 
@@ -491,12 +609,167 @@ buf_load_throttle_if_needed(
 	*last_activity_count = srv_get_activity_count();
 }
 
+/** Reader of a buffer pool dump file */
+struct buf_load_file_t {
+	/** the dump file */
+	FILE*	f;
+	/** whether the file is in the binary format */
+	bool	binary;
+	/** uncompressed page entries of the current chunk */
+	byte*	entries;
+	/** number of page entries in the current chunk */
+	ulint	n_entries;
+	/** next page entry to return from the current chunk */
+	ulint	next;
+	/** buffer for a compressed chunk */
+	byte*	zbuf;
+	/** size of zbuf */
+	ulint	zbuf_size;
+};
+
+/** Result of buf_load_file_next() */
+enum buf_load_read_t {
+	/** a page entry was read */
+	BUF_LOAD_READ_OK,
+	/** the end of the file was reached */
+	BUF_LOAD_READ_EOF,
+	/** reading the file failed */
+	BUF_LOAD_READ_ERROR,
+	/** the file is corrupted */
+	BUF_LOAD_READ_CORRUPT
+};
+
+/** Position a dump file reader at the first page entry, and determine
+the format of the file.
+@param[in,out]	file	dump file reader */
+static
+void
+buf_load_file_rewind(
+	buf_load_file_t*	file)
+{
+	char	magic[BUF_DUMP_MAGIC_SIZE];
+
+	rewind(file->f);
+
+	file->n_entries = 0;
+	file->next = 0;
+	file->binary = fread(magic, 1, sizeof magic, file->f) == sizeof magic
+		&& !memcmp(magic, BUF_DUMP_MAGIC, sizeof magic);
+
+	if (!file->binary) {
+		rewind(file->f);
+	}
+}
+
+/** Read the next page entry from a dump file.
+@param[in,out]	file	dump file reader
+@param[out]	space_id	space id of the page
+@param[out]	page_no		page number
+@param[out]	hotness		hotness of the page, or 0 if the file is in
+the text format
+@return BUF_LOAD_READ_OK if an entry was read */
+static
+buf_load_read_t
+buf_load_file_next(
+	buf_load_file_t*	file,
+	ulint*			space_id,
+	ulint*			page_no,
+	ulint*			hotness)
+{
+	if (!file->binary) {
+		if (fscanf(file->f, ULINTPF "," ULINTPF,
+			   space_id, page_no) == 2) {
+			*hotness = 0;
+			return(BUF_LOAD_READ_OK);
+		}
+
+		return(feof(file->f)
+		       ? BUF_LOAD_READ_EOF
+		       : ferror(file->f)
+		       ? BUF_LOAD_READ_ERROR
+		       : BUF_LOAD_READ_CORRUPT);
+	}
+
+	if (file->next == file->n_entries) {
+		byte	hdr[BUF_DUMP_CHUNK_HDR_SIZE];
+		size_t	len = fread(hdr, 1, sizeof hdr, file->f);
+
+		if (len == 0 && feof(file->f)) {
+			return(BUF_LOAD_READ_EOF);
+		} else if (len != sizeof hdr) {
+			return(ferror(file->f)
+			       ? BUF_LOAD_READ_ERROR : BUF_LOAD_READ_CORRUPT);
+		}
+
+		const ulint	n = mach_read_from_4(hdr);
+		const ulint	zlen = mach_read_from_4(hdr + 4);
+
+		if (n == 0 || n > BUF_DUMP_CHUNK_ENTRIES
+		    || zlen > file->zbuf_size) {
+			return(BUF_LOAD_READ_CORRUPT);
+		}
+
+		if (fread(file->zbuf, 1, zlen, file->f) != zlen) {
+			return(ferror(file->f)
+			       ? BUF_LOAD_READ_ERROR : BUF_LOAD_READ_CORRUPT);
+		}
+
+		uLongf	size = BUF_DUMP_CHUNK_ENTRIES * BUF_DUMP_ENTRY_SIZE;
+
+		if (uncompress(file->entries, &size, file->zbuf,
+			       static_cast<uLong>(zlen)) != Z_OK
+		    || size != n * BUF_DUMP_ENTRY_SIZE) {
+			return(BUF_LOAD_READ_CORRUPT);
+		}
+
+		file->n_entries = n;
+		file->next = 0;
+	}
+
+	const byte*	entry = file->entries
+		+ file->next++ * BUF_DUMP_ENTRY_SIZE;
+
+	*space_id = mach_read_from_4(entry);
+	*page_no = mach_read_from_4(entry + 4);
+	*hotness = mach_read_from_1(entry + 8);
+
+	return(BUF_LOAD_READ_OK);
+}
+
+/** Close a dump file reader.
+@param[in,out]	file	dump file reader */
+static
+void
+buf_load_file_close(
+	buf_load_file_t*	file)
+{
+	fclose(file->f);
+	ut_free(file->entries);
+	ut_free(file->zbuf);
+}
+
+/** Wait until the number of pending page reads drops below
+BUF_LOAD_MAX_PENDING, so that the loading does not flood the I/O
+subsystem with asynchronous reads. */
+static
+void
+buf_load_wait_pending()
+{
+	while (buf_get_n_pending_read_ios() > BUF_LOAD_MAX_PENDING
+	       && !SHUTTING_DOWN() && !buf_load_abort_flag) {
+		os_thread_sleep(1000);
+	}
+}
+
 /*****************************************************************//**
 Perform a buffer pool load from the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
 innodb_buffer_pool_load_status will be set accordingly, see buf_load_status().
 The dump filename can be specified by (relative to srv_data_home):
-SET GLOBAL innodb_buffer_pool_filename='filename'; */
+SET GLOBAL innodb_buffer_pool_filename='filename';
+The pages are loaded by hotness tiers, hottest first, and the pages of
+each tier in (space, page) order with asynchronous reads that are
+submitted in runs of contiguous pages. */
 static
 void
 buf_load()
@@ -504,14 +777,19 @@ buf_load()
 {
 	char		full_filename[OS_FILE_MAX_PATH];
 	char		now[32];
-	FILE*		f;
+	buf_load_file_t	file;
+	buf_load_read_t	read;
 	buf_dump_t*	dump;
 	ulint		dump_n;
 	ulint		total_buffer_pools_pages;
 	ulint		i;
+	ulint		t;
 	ulint		space_id;
 	ulint		page_no;
-	int		fscanf_ret;
+	ulint		hotness;
+	ulint		n_tier[BUF_LOAD_N_TIERS];
+	ulint		tier_start[BUF_LOAD_N_TIERS];
+	ulint		tier_n[BUF_LOAD_N_TIERS];
 
 	/* Ignore any leftovers from before */
 	buf_load_abort_flag = FALSE;
@@ -521,8 +799,8 @@ buf_load()
 	buf_load_status(STATUS_INFO,
 			"Loading buffer pool(s) from %s", full_filename);
 
-	f = fopen(full_filename, "r");
-	if (f == NULL) {
+	file.f = fopen(full_filename, "rb");
+	if (file.f == NULL) {
 		buf_load_status(STATUS_ERR,
 				"Cannot open '%s' for reading: %s",
 				full_filename, strerror(errno));
@@ -530,24 +808,44 @@ buf_load()
 	}
 	/* else */
 
-	/* First scan the file to estimate how many entries are in it.
-	This file is tiny (approx 500KB per 1GB buffer pool), reading it
-	two times is fine. */
-	dump_n = 0;
-	while (fscanf(f, ULINTPF "," ULINTPF, &space_id, &page_no) == 2
+	file.zbuf_size = compressBound(
+		BUF_DUMP_CHUNK_ENTRIES * BUF_DUMP_ENTRY_SIZE);
+	file.zbuf = static_cast<byte*>(ut_malloc_nokey(file.zbuf_size));
+	file.entries = static_cast<byte*>(ut_malloc_nokey(
+		BUF_DUMP_CHUNK_ENTRIES * BUF_DUMP_ENTRY_SIZE));
+
+	if (file.zbuf == NULL || file.entries == NULL) {
+		buf_load_file_close(&file);
+		buf_load_status(STATUS_ERR,
+				"Cannot allocate " ULINTPF " bytes: %s",
+				file.zbuf_size, strerror(errno));
+		return;
+	}
+
+	buf_load_file_rewind(&file);
+
+	/* First scan the file to count the entries of each hotness
+	tier. This file is tiny (approx 500KB per 1GB buffer pool in the
+	text format, less in the binary format), reading it two times is
+	fine. */
+	for (t = 0; t < BUF_LOAD_N_TIERS; t++) {
+		n_tier[t] = 0;
+	}
+
+	while ((read = buf_load_file_next(&file, &space_id, &page_no,
+					  &hotness)) == BUF_LOAD_READ_OK
 	       && !SHUTTING_DOWN()) {
-		dump_n++;
+		n_tier[BUF_LOAD_TIER(hotness)]++;
 	}
 
-	if (!SHUTTING_DOWN() && !feof(f)) {
-		/* fscanf() returned != 2 */
+	if (!SHUTTING_DOWN() && read != BUF_LOAD_READ_EOF) {
 		const char*	what;
-		if (ferror(f)) {
+		if (read == BUF_LOAD_READ_ERROR) {
 			what = "reading";
 		} else {
 			what = "parsing";
 		}
-		fclose(f);
+		buf_load_file_close(&file);
 		buf_load_status(STATUS_ERR, "Error %s '%s',"
 				" unable to load buffer pool (stage 1)",
 				what, full_filename);
@@ -555,19 +853,28 @@ buf_load()
 	}
 
 	/* If dump is larger than the buffer pool(s), then we ignore the
-	extra trailing. This could happen if a dump is made, then buffer
-	pool is shrunk and then load is attempted. */
+	coldest pages. This could happen if a dump is made, then buffer
+	pool is shrunk and then load is attempted. The hottest tier is
+	stored first in dump[]. */
 	total_buffer_pools_pages = buf_pool_get_n_pages()
 		* srv_buf_pool_instances;
-	if (dump_n > total_buffer_pools_pages) {
-		dump_n = total_buffer_pools_pages;
+	dump_n = 0;
+
+	for (t = BUF_LOAD_N_TIERS; t--; ) {
+		if (n_tier[t] > total_buffer_pools_pages - dump_n) {
+			n_tier[t] = total_buffer_pools_pages - dump_n;
+		}
+
+		tier_start[t] = dump_n;
+		tier_n[t] = 0;
+		dump_n += n_tier[t];
 	}
 
 	if(dump_n != 0) {
 		dump = static_cast<buf_dump_t*>(ut_malloc_nokey(
 				dump_n * sizeof(*dump)));
 	} else {
-		fclose(f);
+		buf_load_file_close(&file);
 		ut_sprintf_timestamp(now);
 		buf_load_status(STATUS_INFO,
 				"Buffer pool(s) load completed at %s"
@@ -576,7 +883,7 @@ buf_load()
 	}
 
 	if (dump == NULL) {
-		fclose(f);
+		buf_load_file_close(&file);
 		buf_load_status(STATUS_ERR,
 				"Cannot allocate " ULINTPF " bytes: %s",
 				(ulint) (dump_n * sizeof(*dump)),
@@ -584,20 +891,20 @@ buf_load()
 		return;
 	}
 
-	rewind(f);
+	buf_load_file_rewind(&file);
 
-	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
-		fscanf_ret = fscanf(f, ULINTPF "," ULINTPF,
-				    &space_id, &page_no);
+	for (i = 0; !SHUTTING_DOWN(); i++) {
+		read = buf_load_file_next(&file, &space_id, &page_no,
+					  &hotness);
 
-		if (fscanf_ret != 2) {
-			if (feof(f)) {
+		if (read != BUF_LOAD_READ_OK) {
+			if (read == BUF_LOAD_READ_EOF) {
 				break;
 			}
 			/* else */
 
 			ut_free(dump);
-			fclose(f);
+			buf_load_file_close(&file);
 			buf_load_status(STATUS_ERR,
 					"Error parsing '%s', unable"
 					" to load buffer pool (stage 2)",
@@ -607,7 +914,7 @@ buf_load()
 
 		if (space_id > ULINT32_MASK || page_no > ULINT32_MASK) {
 			ut_free(dump);
-			fclose(f);
+			buf_load_file_close(&file);
 			buf_load_status(STATUS_ERR,
 					"Error parsing '%s': bogus"
 					" space,page " ULINTPF "," ULINTPF
@@ -619,15 +926,32 @@ buf_load()
 			return;
 		}
 
-		dump[i] = BUF_DUMP_CREATE(space_id, page_no);
+		t = BUF_LOAD_TIER(hotness);
+
+		if (tier_n[t] < n_tier[t]) {
+			dump[tier_start[t] + tier_n[t]++]
+				= BUF_DUMP_CREATE(space_id, page_no);
+		}
 	}
 
+	buf_load_file_close(&file);
+
 	/* Set dump_n to the actual number of initialized elements,
-	i could be smaller than dump_n here if the file got truncated after
-	we read it the first time. */
-	dump_n = i;
+	the tiers could be smaller than counted here if the file got
+	truncated after we read it the first time. Move the tiers
+	together and sort each of them by (space, page). */
+	dump_n = 0;
 
-	fclose(f);
+	for (t = BUF_LOAD_N_TIERS; t--; ) {
+		memmove(dump + dump_n, dump + tier_start[t],
+			tier_n[t] * sizeof(*dump));
+
+		if (!SHUTTING_DOWN()) {
+			std::sort(dump + dump_n, dump + dump_n + tier_n[t]);
+		}
+
+		dump_n += tier_n[t];
+	}
 
 	if (dump_n == 0) {
 		ut_free(dump);
@@ -638,16 +962,14 @@ buf_load()
 		return;
 	}
 
-	if (!SHUTTING_DOWN()) {
-		std::sort(dump, dump + dump_n);
-	}
-
 	ib_time_monotonic_ms_t		last_check_time = 0;
 	ulint		last_activity_cnt = 0;
+	ulint		n_run = 0;
 
 	/* Avoid calling the expensive fil_space_acquire_silent() for each
-	page within the same tablespace. dump[] is sorted by (space, page),
-	so all pages from a given tablespace are consecutive. */
+	page within the same tablespace. Each tier of dump[] is sorted by
+	(space, page), so the pages from a given tablespace are mostly
+	consecutive. */
 	ulint		cur_space_id = BUF_DUMP_SPACE(dump[0]);
 	fil_space_t*	space = fil_space_acquire_silent(cur_space_id);
 	page_size_t	page_size(space ? space->flags : 0);
@@ -686,10 +1008,15 @@ buf_load()
 
 		buf_read_page_background(
 			page_id_t(this_space_id, BUF_DUMP_PAGE(dump[i])),
-			page_size, true);
+			page_size, false);
 
-		if (i % 64 == 63) {
+		/* Submit the reads of contiguous pages together, so that
+		they can be merged into larger requests. */
+		if (++n_run == BUF_LOAD_MAX_RUN || i + 1 == dump_n
+		    || dump[i + 1] != dump[i] + 1) {
 			os_aio_simulated_wake_handler_threads();
+			buf_load_wait_pending();
+			n_run = 0;
 		}
 
 		/* Update the progress every 32 MiB, which is every Nth page,
@@ -710,6 +1037,8 @@ buf_load()
 			if (space != NULL) {
 				fil_space_release(space);
 			}
+			/* Submit the reads of the current run. */
+			os_aio_simulated_wake_handler_threads();
 			buf_load_abort_flag = FALSE;
 			ut_free(dump);
 			buf_load_status(
@@ -733,6 +1062,8 @@ buf_load()
 		fil_space_release(space);
 	}
 
+	os_aio_simulated_wake_handler_threads();
+
 	ut_free(dump);
 
 	ut_sprintf_timestamp(now);
@@ -95,8 +95,37 @@ static lsn_t buf_flush_sync_lsn = 0;
 
 #ifdef UNIV_PFS_THREAD
 mysql_pfs_key_t page_cleaner_thread_key;
+mysql_pfs_key_t buf_lru_manager_thread_key;
 #endif /* UNIV_PFS_THREAD */
 
+/** Maximum sleep time of an LRU manager thread in milliseconds */
+static const ulint buf_lru_manager_max_sleep_time = 1000;
+
+/** Step by which an LRU manager thread adapts its sleep time, in
+milliseconds */
+static const ulint buf_lru_manager_sleep_step = 50;
+
+/** Maximum time in microseconds that a thread which found no free block
+waits for the LRU manager thread before searching again */
+static const ulint buf_lru_manager_free_wait_time = 10000;
+
+/** LRU manager thread of a buffer pool instance */
+struct buf_lru_manager_t {
+	ulint		instance_no;	/*!< buffer pool instance */
+	os_event_t	wake_event;	/*!< set to make the thread flush
+					the tail of the LRU list at once */
+	os_event_t	batch_event;	/*!< set at the end of each LRU
+					batch of the thread */
+	volatile bool	alive;		/*!< true while the thread runs */
+};
+
+/** LRU manager threads, one for each buffer pool instance */
+static buf_lru_manager_t*	buf_lru_managers = NULL;
+
+/** true if the LRU manager threads keep the free lists filled. Written
+only by the thread starting or stopping them. */
+bool	buf_lru_manager_is_active = false;
+
 /** Event to synchronise with the flushing. */
 os_event_t	buf_flush_event;
 
@@ -1963,7 +1992,7 @@ buf_flush_end(
 	buf_pool_mutex_exit(buf_pool);
 
 	if (!srv_read_only_mode) {
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes(buf_pool->instance_no);
 	} else {
 		os_aio_simulated_wake_handler_threads();
 	}
@@ -2359,6 +2388,42 @@ buf_flush_wait_LRU_batch_end(void)
 	}
 }
 
+/** Adapt the sleep time of an LRU manager thread to the length of the
+free list: flush sooner when the free list is short compared to the target
+innodb_LRU_scan_depth, and later when it is long.
+@param[in]	buf_pool	buffer pool instance
+@param[in]	sleep_time	current sleep time in milliseconds
+@param[in]	n_flushed	number of pages flushed by the last batch
+@return the next sleep time in milliseconds */
+static
+ulint
+buf_lru_manager_adapt_sleep_time(
+	const buf_pool_t*	buf_pool,
+	ulint			sleep_time,
+	ulint			n_flushed)
+{
+	/* Dirty read: the length is only a hint */
+	ulint	free_len = UT_LIST_GET_LEN(buf_pool->free);
+
+	if (free_len < srv_LRU_scan_depth / 100) {
+		/* The free list is almost empty: run the next batch at
+		once, unless the last one could not write anything. */
+		return(n_flushed > 0 ? 0 : 1);
+
+	} else if (free_len < srv_LRU_scan_depth / 20) {
+
+		return(sleep_time > buf_lru_manager_sleep_step
+		       ? sleep_time - buf_lru_manager_sleep_step : 0);
+
+	} else if (free_len > srv_LRU_scan_depth / 5) {
+
+		return(ut_min(sleep_time + buf_lru_manager_sleep_step,
+			      buf_lru_manager_max_sleep_time));
+	}
+
+	return(sleep_time);
+}
+
 /*********************************************************************//**
 Calculates if flushing is required based on number of dirty pages in
 the buffer pool.
@@ -2878,13 +2943,19 @@ pc_flush_slot(void)
 
 		mutex_exit(&page_cleaner->mutex);
 
-		lru_tm = ut_time_monotonic_ms();
+		if (buf_lru_manager_is_active) {
+			/* The LRU manager thread of the instance
+			keeps its free list filled. */
+			slot->n_flushed_lru = 0;
+		} else {
+			lru_tm = ut_time_monotonic_ms();
 
-		/* Flush pages from end of LRU if required */
-		slot->n_flushed_lru = buf_flush_LRU_list(buf_pool);
+			/* Flush pages from end of LRU if required */
+			slot->n_flushed_lru = buf_flush_LRU_list(buf_pool);
 
-		lru_tm = ut_time_monotonic_ms() - lru_tm;
-		lru_pass++;
+			lru_tm = ut_time_monotonic_ms() - lru_tm;
+			lru_pass++;
+		}
 
 		if (!page_cleaner->is_running) {
 			slot->n_flushed_list = 0;
@@ -3556,6 +3627,191 @@ DECLARE_THREAD(buf_flush_page_cleaner_worker)(
 	OS_THREAD_DUMMY_RETURN;
 }
 
+/** LRU manager thread of a buffer pool instance: keeps
+innodb_LRU_scan_depth free blocks in the free list by evicting clean pages
+and flushing dirty pages from the tail of the LRU list, independently of
+the flush_list flushing of the page cleaner threads.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(buf_lru_manager_thread)(
+	void*	arg)	/*!< in: buf_lru_manager_t of the instance */
+{
+	buf_lru_manager_t*	manager = static_cast<buf_lru_manager_t*>(arg);
+	buf_pool_t*		buf_pool = buf_pool_from_array(
+		manager->instance_no);
+	ulint			sleep_time = buf_lru_manager_max_sleep_time;
+
+	my_thread_init();
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(buf_lru_manager_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+#ifdef UNIV_LINUX
+	buf_flush_page_cleaner_set_priority(buf_flush_page_cleaner_priority);
+#endif /* UNIV_LINUX */
+
+	int64_t	sig_count = os_event_reset(manager->wake_event);
+
+	while (buf_lru_manager_is_active
+	       && srv_shutdown_state != SRV_SHUTDOWN_EXIT_THREADS) {
+
+		if (sleep_time > 0) {
+			os_event_wait_time_low(
+				manager->wake_event, sleep_time * 1000,
+				sig_count);
+		}
+
+		sig_count = os_event_reset(manager->wake_event);
+
+		if (!buf_lru_manager_is_active
+		    || srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS) {
+			break;
+		}
+
+		ulint	n_flushed = buf_flush_LRU_list(buf_pool);
+
+		os_event_set(manager->batch_event);
+
+		if (n_flushed > 0) {
+			buf_flush_stats(0, n_flushed);
+
+			MONITOR_INC_VALUE_CUMULATIVE(
+				MONITOR_LRU_BATCH_FLUSH_TOTAL_PAGE,
+				MONITOR_LRU_BATCH_FLUSH_COUNT,
+				MONITOR_LRU_BATCH_FLUSH_PAGES,
+				n_flushed);
+		}
+
+		sleep_time = buf_lru_manager_adapt_sleep_time(
+			buf_pool, sleep_time, n_flushed);
+	}
+
+	manager->alive = false;
+
+	my_thread_end();
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Start one LRU manager thread for each buffer pool instance. From now
+on, the page cleaner threads only flush the flush_list, and the threads
+which find no free block wait for the LRU manager thread instead of
+flushing a single page. */
+void
+buf_lru_manager_start()
+{
+	ut_ad(!srv_read_only_mode);
+	ut_ad(!buf_lru_manager_is_active);
+	ut_ad(buf_lru_managers == NULL);
+
+	buf_lru_managers = static_cast<buf_lru_manager_t*>(
+		ut_zalloc_nokey(srv_buf_pool_instances
+				* sizeof(*buf_lru_managers)));
+
+	for (ulint i = 0; i < srv_buf_pool_instances; ++i) {
+		buf_lru_manager_t*	manager = &buf_lru_managers[i];
+
+		manager->instance_no = i;
+		manager->wake_event = os_event_create(0);
+		manager->batch_event = os_event_create(0);
+		manager->alive = true;
+	}
+
+	buf_lru_manager_is_active = true;
+
+	os_wmb;
+
+	for (ulint i = 0; i < srv_buf_pool_instances; ++i) {
+		os_thread_create(buf_lru_manager_thread,
+				 &buf_lru_managers[i], NULL);
+	}
+}
+
+/** Stop the LRU manager threads and wait for them to exit. From now on,
+the page cleaner threads flush the tail of the LRU lists again. */
+void
+buf_lru_manager_stop()
+{
+	if (buf_lru_managers == NULL) {
+		return;
+	}
+
+	buf_lru_manager_is_active = false;
+
+	os_wmb;
+
+	for (ulint i = 0; i < srv_buf_pool_instances; ++i) {
+		buf_lru_manager_t*	manager = &buf_lru_managers[i];
+
+		while (manager->alive) {
+			os_event_set(manager->wake_event);
+			os_thread_sleep(1000);
+		}
+	}
+
+	/* Let the threads waiting for a free block notice that they
+	are on their own. The events are freed by buf_lru_manager_free(). */
+	for (ulint i = 0; i < srv_buf_pool_instances; ++i) {
+		os_event_set(buf_lru_managers[i].batch_event);
+	}
+}
+
+/** Free the LRU manager thread state. Called at shutdown, when no thread
+can wait for a free block anymore. */
+void
+buf_lru_manager_free()
+{
+	if (buf_lru_managers == NULL) {
+		return;
+	}
+
+	ut_ad(!buf_lru_manager_is_active);
+
+	for (ulint i = 0; i < srv_buf_pool_instances; ++i) {
+		os_event_destroy(buf_lru_managers[i].wake_event);
+		os_event_destroy(buf_lru_managers[i].batch_event);
+	}
+
+	ut_free(buf_lru_managers);
+
+	buf_lru_managers = NULL;
+}
+
+/** Wake up the LRU manager thread of a buffer pool instance because its
+free list is empty, and wait until it has completed an LRU batch or for
+a short while. Called by a thread which did not find a free block,
+instead of flushing a single page.
+@param[in]	buf_pool	buffer pool instance
+@return false if the LRU manager threads are not running */
+bool
+buf_lru_manager_wait_for_free_block(
+	buf_pool_t*	buf_pool)
+{
+	ut_ad(!buf_pool_mutex_own(buf_pool));
+
+	if (!buf_lru_manager_is_active) {
+		return(false);
+	}
+
+	buf_lru_manager_t*	manager
+		= &buf_lru_managers[buf_pool->instance_no];
+
+	int64_t	sig_count = os_event_reset(manager->batch_event);
+
+	os_event_set(manager->wake_event);
+
+	os_event_wait_time_low(manager->batch_event,
+			       buf_lru_manager_free_wait_time, sig_count);
+
+	return(true);
+}
+
 /*******************************************************************//**
 Synchronously flush dirty blocks from the end of the flush list of all buffer
 pool instances.
@@ -947,9 +947,9 @@ buf_LRU_flush_or_remove_pages(
 
 		case BUF_REMOVE_FLUSH_NO_WRITE:
 			/* It is a DROP TABLE for a single table
-			tablespace. No AHI entries exist because
-			we already dealt with them when freeing up
-			extents. */
+			tablespace. The AHI entries of the freed
+			pages are dropped when the pages are evicted,
+			see dict_drop_index_tree(). */
 		case BUF_REMOVE_FLUSH_WRITE:
 			/* We allow read-only queries against the
 			table, there is no need to drop the AHI entries. */
@@ -1403,6 +1403,21 @@ loop:
 		os_event_set(lock_sys->timeout_event);
 	}
 
+	/* No free block was found: have the LRU manager thread flush
+	the LRU list and wait for it, rather than flushing a page in the
+	user thread. */
+
+	if (buf_lru_manager_wait_for_free_block(buf_pool)) {
+
+		MONITOR_INC( MONITOR_LRU_GET_FREE_WAITS );
+
+		srv_stats.buf_pool_wait_free.add(n_iterations, 1);
+
+		n_iterations++;
+
+		goto loop;
+	}
+
 	/* If we have scanned the whole LRU and still are unable to
 	find a free block then we should sleep here to let the
 	page_cleaner do an LRU batch for us. */
@@ -1928,6 +1943,11 @@ func_exit:
         ut_ad(rw_lock_own(hash_lock, RW_LOCK_X));
 	ut_ad(buf_page_can_relocate(bpage));
 
+	if (b == NULL && buf_pool->LRU_policy == BUF_LRU_POLICY_2Q) {
+		/* The page leaves the buffer pool. */
+		buf_LRU_ghost_insert(&buf_pool->LRU_ghost, bpage->id);
+	}
+
 	if (!buf_LRU_block_remove_hashed(bpage, zip)) {
 		return(true);
 	}
@@ -2546,6 +2566,198 @@ buf_LRU_old_ratio_update(
 	return(new_ratio);
 }
 
+/** Add the statistics of a buffer pool instance since its LRU policy was
+last set to the statistics of a policy.
+@param[in]	buf_pool	buffer pool instance
+@param[in,out]	stat		statistics of the policy */
+static
+void
+buf_LRU_policy_add_stat(
+	const buf_pool_t*	buf_pool,
+	buf_LRU_policy_stat_t*	stat)
+{
+	const buf_pool_stat_t*	cur = &buf_pool->stat;
+	const buf_pool_stat_t*	start = &buf_pool->LRU_policy_start;
+
+	stat->n_page_gets += cur->n_page_gets - start->n_page_gets;
+	stat->n_pages_read += cur->n_pages_read - start->n_pages_read;
+	stat->n_ghost_hits += cur->n_ghost_hits - start->n_ghost_hits;
+}
+
+/** Set the replacement policy of the LRU lists.
+@param[in]	policy	buf_LRU_policy_t */
+void
+buf_LRU_policy_set(
+	ulint	policy)
+{
+	ut_ad(policy < BUF_LRU_N_POLICIES);
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool_t*	buf_pool = buf_pool_from_array(i);
+
+		buf_pool_mutex_enter(buf_pool);
+
+		if (buf_pool->LRU_policy != policy) {
+			buf_LRU_policy_add_stat(
+				buf_pool,
+				&buf_pool->LRU_policy_stat[
+					buf_pool->LRU_policy]);
+
+			buf_pool->LRU_policy_start = buf_pool->stat;
+			buf_pool->LRU_policy = policy;
+
+			/* Forget the pages evicted under 2Q before. */
+			memset(buf_pool->LRU_ghost.slots, 0,
+			       buf_pool->LRU_ghost.n_slots
+			       * sizeof *buf_pool->LRU_ghost.slots);
+		}
+
+		buf_pool_mutex_exit(buf_pool);
+	}
+}
+
+/** Get the statistics of the buffer pool instances under an LRU
+replacement policy, since the start of the server.
+@param[in]	policy	buf_LRU_policy_t
+@param[out]	stat	statistics */
+void
+buf_LRU_policy_get_stat(
+	ulint			policy,
+	buf_LRU_policy_stat_t*	stat)
+{
+	ut_ad(policy < BUF_LRU_N_POLICIES);
+
+	memset(stat, 0, sizeof *stat);
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool_t*			buf_pool = buf_pool_from_array(i);
+		const buf_LRU_policy_stat_t*	past;
+
+		buf_pool_mutex_enter(buf_pool);
+
+		past = &buf_pool->LRU_policy_stat[policy];
+
+		stat->n_page_gets += past->n_page_gets;
+		stat->n_pages_read += past->n_pages_read;
+		stat->n_ghost_hits += past->n_ghost_hits;
+
+		if (buf_pool->LRU_policy == policy) {
+			buf_LRU_policy_add_stat(buf_pool, stat);
+		}
+
+		buf_pool_mutex_exit(buf_pool);
+	}
+}
+
+/** Determine whether a page that is being read into the buffer pool
+is to be added to the old blocks of the LRU list.
+@param[in,out]	buf_pool	buffer pool instance
+@param[in]	page_id		page id
+@return TRUE if the page is to be added to the old blocks */
+ibool
+buf_LRU_add_to_old(
+	buf_pool_t*		buf_pool,
+	const page_id_t&	page_id)
+{
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	if (buf_pool->LRU_policy == BUF_LRU_POLICY_2Q
+	    && buf_LRU_ghost_remove(&buf_pool->LRU_ghost, page_id)) {
+		/* The page was evicted before it could prove that it
+		is hot: the accesses to it are further apart than the
+		old blocks last. */
+		buf_pool->stat.n_ghost_hits++;
+		return(FALSE);
+	}
+
+	return(TRUE);
+}
+
+/** Size the table of recently evicted pages of a buffer pool instance
+for its current size, emptying it.
+@param[in,out]	buf_pool	buffer pool instance */
+void
+buf_LRU_ghost_resize(
+	buf_pool_t*	buf_pool)
+{
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	buf_LRU_ghost_free(&buf_pool->LRU_ghost);
+
+	/* 2Q remembers as many evicted pages as half of the buffer
+	pool holds. */
+	buf_LRU_ghost_create(&buf_pool->LRU_ghost, buf_pool->curr_size / 2);
+}
+
+/** Create a table of recently evicted pages.
+@param[out]	ghost	table
+@param[in]	n_slots	number of slots */
+void
+buf_LRU_ghost_create(
+	buf_LRU_ghost_t*	ghost,
+	ulint			n_slots)
+{
+	ghost->n_slots = ut_max(n_slots, ulint(1));
+	ghost->slots = static_cast<ib_uint64_t*>(
+		ut_zalloc_nokey(ghost->n_slots * sizeof *ghost->slots));
+}
+
+/** Free a table of recently evicted pages.
+@param[in,out]	ghost	table */
+void
+buf_LRU_ghost_free(
+	buf_LRU_ghost_t*	ghost)
+{
+	ut_free(ghost->slots);
+	ghost->slots = NULL;
+	ghost->n_slots = 0;
+}
+
+/** Get the key of a page in a table of recently evicted pages.
+@param[in]	page_id	page id
+@return key, never 0 */
+static
+ib_uint64_t
+buf_LRU_ghost_key(
+	const page_id_t&	page_id)
+{
+	return(1 + (ib_uint64_t(page_id.space()) << 32
+		    | page_id.page_no()));
+}
+
+/** Remember that a page was evicted.
+@param[in,out]	ghost	table of recently evicted pages
+@param[in]	page_id	page id */
+void
+buf_LRU_ghost_insert(
+	buf_LRU_ghost_t*	ghost,
+	const page_id_t&	page_id)
+{
+	ulint	slot = ut_hash_ulint(page_id.fold(), ghost->n_slots);
+
+	ghost->slots[slot] = buf_LRU_ghost_key(page_id);
+}
+
+/** Check whether a page was evicted recently, and forget it.
+@param[in,out]	ghost	table of recently evicted pages
+@param[in]	page_id	page id
+@return whether the page was evicted recently */
+bool
+buf_LRU_ghost_remove(
+	buf_LRU_ghost_t*	ghost,
+	const page_id_t&	page_id)
+{
+	ulint	slot = ut_hash_ulint(page_id.fold(), ghost->n_slots);
+
+	if (ghost->slots[slot] != buf_LRU_ghost_key(page_id)) {
+		return(false);
+	}
+
+	ghost->slots[slot] = 0;
+
+	return(true);
+}
+
 /********************************************************************//**
 Update the historical stats that we are collecting for LRU eviction
 policy at the end of each interval. */
@@ -1102,12 +1102,17 @@ dict_create_index_tree_in_mem(
 /** Drop the index tree associated with a row in SYS_INDEXES table.
 @param[in,out]	rec	SYS_INDEXES record
 @param[in,out]	pcur	persistent cursor on rec
+@param[in]	ahi	whether to drop the adaptive hash index entries
+			of the freed pages; if not, they are dropped when
+			the pages are evicted or allocated again, which
+			requires that the index id is never used again
 @param[in,out]	mtr	mini-transaction
 @return	whether freeing the B-tree was attempted */
 bool
 dict_drop_index_tree(
 	rec_t*		rec,
 	btr_pcur_t*	pcur,
+	bool		ahi,
 	mtr_t*		mtr)
 {
 	const byte*	ptr;
@@ -1165,7 +1170,7 @@ dict_drop_index_tree(
 	}
 
 	btr_free_if_exists(page_id_t(space, root_page_no), page_size,
-			   mach_read_from_8(ptr), mtr);
+			   mach_read_from_8(ptr), ahi, mtr);
 
 	return(true);
 }
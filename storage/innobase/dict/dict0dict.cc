@@ -1534,19 +1534,17 @@ dict_table_can_be_evicted(
 
 			btr_search_t*	info = btr_search_get_info(index);
 
-			/* We are not allowed to free the in-memory index
-			struct dict_index_t until all entries in the adaptive
-			hash index that point to any of the page belonging to
-			his b-tree index are dropped. This is so because
-			dropping of these entries require access to
-			dict_index_t struct. To avoid such scenario we keep
-			a count of number of such pages in the search_info and
-			only free the dict_index_t struct when this count
-			drops to zero.
+			/* The pages of an evicted table stay in the
+			buffer pool, and they must not be found in the
+			adaptive hash index with a freed dict_index_t once
+			the table is loaded again. Dropping the entries of a
+			page requires access to the dict_index_t struct, so
+			we only evict the table when no page of its indexes
+			is in the adaptive hash index.
 
 			See also: dict_index_remove_from_cache_low() */
 
-			if (btr_search_info_get_ref_count(info, index) > 0) {
+			if (btr_search_info_get_ref_count(info) > 0) {
 				return(FALSE);
 			}
 		}
@@ -2590,6 +2588,51 @@ add_field_size:
 	return(FALSE);
 }
 
+/** Count the leading fields of an index that can be compared to a search
+tuple field of the same length with cmp_fixed_binary(): fixed-length
+integer, system and binary columns that are indexed in full.
+@param[in]	index	index whose fields have been built
+@return number of fields for dict_index_t::n_memcmp_fields */
+static
+ulint
+dict_index_get_n_memcmp_fields(
+	const dict_index_t*	index)
+{
+	if (dict_index_is_spatial(index) || dict_index_is_ibuf(index)) {
+		return(0);
+	}
+
+	ulint	i;
+
+	for (i = 0; i < index->n_def; i++) {
+		const dict_field_t*	field = dict_index_get_nth_field(
+			index, i);
+
+		if (field->prefix_len != 0 || field->fixed_len == 0) {
+			break;
+		}
+
+		const dict_col_t*	col = field->col;
+
+		switch (col->mtype) {
+		case DATA_FIXBINARY:
+		case DATA_BINARY:
+			if (dtype_get_charset_coll(col->prtype)
+			    != DATA_MYSQL_BINARY_CHARSET_COLL) {
+				return(i);
+			}
+			/* fall through */
+		case DATA_INT:
+		case DATA_SYS:
+			continue;
+		}
+
+		break;
+	}
+
+	return(i);
+}
+
 /** Adds an index to the dictionary cache.
 @param[in,out]	table	table on which the index is
 @param[in,out]	index	index; NOTE! The index memory
@@ -2784,6 +2827,9 @@ dict_index_add_to_cache_w_vcol(
 	rw_lock_create(index_tree_rw_lock_key, &new_index->lock,
 		       SYNC_INDEX_TREE);
 
+	new_index->n_memcmp_fields = dict_index_get_n_memcmp_fields(
+		new_index);
+
 	/* Intrinsic table are not added to dictionary cache instead are
 	cached to session specific thread cache. */
 	if (!dict_table_is_intrinsic(table)) {
@@ -2835,8 +2881,6 @@ dict_index_remove_from_cache_low(
 					to make room in the table LRU list */
 {
 	lint		size;
-	ulint		retries = 0;
-	btr_search_t*	info;
 
 	ut_ad(table && index);
 	ut_ad(table->magic_n == DICT_TABLE_MAGIC_N);
@@ -2851,47 +2895,6 @@ dict_index_remove_from_cache_low(
 		row_log_free(index->online_log);
 	}
 
-	/* We always create search info whether or not adaptive
-	hash index is enabled or not. */
-	info = btr_search_get_info(index);
-	ut_ad(info);
-
-	/* We are not allowed to free the in-memory index struct
-	dict_index_t until all entries in the adaptive hash index
-	that point to any of the page belonging to his b-tree index
-	are dropped. This is so because dropping of these entries
-	require access to dict_index_t struct. To avoid such scenario
-	We keep a count of number of such pages in the search_info and
-	only free the dict_index_t struct when this count drops to
-	zero. See also: dict_table_can_be_evicted() */
-
-	do {
-		ulint ref_count = btr_search_info_get_ref_count(info, index);
-
-		if (ref_count == 0) {
-			break;
-		}
-
-		/* Sleep for 10ms before trying again. */
-		os_thread_sleep(10000);
-		++retries;
-
-		if (retries % 500 == 0) {
-			/* No luck after 5 seconds of wait. */
-			ib::error() << "Waited for " << retries / 100
-				<< " secs for hash index"
-				" ref_count (" << ref_count << ") to drop to 0."
-				" index: " << index->name
-				<< " table: " << table->name;
-		}
-
-		/* To avoid a hang here we commit suicide if the
-		ref_count doesn't drop to zero in 600 seconds. */
-		if (retries >= 60000) {
-			ut_error;
-		}
-	} while (srv_shutdown_state == SRV_SHUTDOWN_NONE || !lru_evict);
-
 	rw_lock_free(&index->lock);
 
 	/* The index is being dropped, remove any compression stats for it. */
@@ -2944,7 +2947,16 @@ dict_index_remove_from_cache_low(
 
 	dict_sys->size -= size;
 
-	dict_mem_index_free(index);
+	/* We are not allowed to free the in-memory index struct
+	dict_index_t until all entries in the adaptive hash index
+	that point to any of the page belonging to his b-tree index
+	are dropped. This is so because dropping of these entries
+	require access to dict_index_t struct. We keep a count of
+	number of such pages in the search_info, and if it is not
+	zero, the dict_index_t struct is freed when the last of
+	those pages is removed from the adaptive hash index.
+	See also: dict_table_can_be_evicted() */
+	btr_search_free_index(index);
 }
 
 /**********************************************************************//**
@@ -5918,7 +5930,7 @@ dict_set_corrupted(
 
 	btr_cur_search_to_nth_level(sys_index, 0, tuple, PAGE_CUR_LE,
 				    BTR_MODIFY_LEAF,
-				    &cursor, 0, __FILE__, __LINE__, &mtr);
+				    &cursor, __FILE__, __LINE__, &mtr);
 
 	if (cursor.low_match == dtuple_get_n_fields(tuple)) {
 		/* UPDATE SYS_INDEXES SET TYPE=index->type
@@ -6020,7 +6032,7 @@ dict_index_set_merge_threshold(
 
 	btr_cur_search_to_nth_level(sys_index, 0, tuple, PAGE_CUR_GE,
 				    BTR_MODIFY_LEAF,
-				    &cursor, 0, __FILE__, __LINE__, &mtr);
+				    &cursor, __FILE__, __LINE__, &mtr);
 
 	if (cursor.up_match == dtuple_get_n_fields(tuple)
 	    && rec_get_n_fields_old(btr_cur_get_rec(&cursor))
@@ -52,6 +52,7 @@ Created 1/8/1996 Heikki Tuuri
 
 #ifndef UNIV_HOTBACKUP
 # include "lock0lock.h"
+# include "btr0sea.h"
 #endif /* !UNIV_HOTBACKUP */
 
 #include "sync0sync.h"
@@ -217,6 +218,7 @@ dict_mem_table_free(
 
 	dict_mem_table_free_foreign_vcol_set(table);
 	dict_table_stats_latch_destroy(table);
+	ut_free(table->stat_col_hist);
 
 	table->foreign_set.~dict_foreign_set();
 	table->referenced_set.~dict_foreign_set();
@@ -237,6 +239,14 @@ dict_mem_table_free(
 		UT_DELETE(table->s_cols);
 	}
 
+#ifndef UNIV_HOTBACKUP
+	/* The columns of indexes whose pages are still in the adaptive
+	hash index are allocated from the heap. */
+	if (btr_search_defer_table_free(table)) {
+		return;
+	}
+#endif /* !UNIV_HOTBACKUP */
+
 	mem_heap_free(table->heap);
         table = NULL;
 }
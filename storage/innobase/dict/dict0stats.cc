@@ -432,6 +432,9 @@ dict_stats_table_clone_create(
 
 	t->corrupted = table->corrupted;
 
+	t->stat_col_hist = NULL;
+	t->stat_n_col_hist = 0;
+
 	/* This private object "t" is not shared with other threads, so
 	we do not need the stats_latch (thus we pass false below). The
 	dict_table_stats_lock()/unlock() routines will do nothing. */
@@ -511,6 +514,7 @@ dict_stats_table_clone_free(
 	dict_table_t*	t)	/*!< in: dummy table object to free */
 {
 	dict_table_stats_latch_destroy(t);
+	ut_free(t->stat_col_hist);
 	mem_heap_free(t->heap);
 }
 
@@ -560,6 +564,10 @@ dict_stats_empty_table(
 		= UT_LIST_GET_LEN(table->indexes) - 1;
 	table->stat_modified_counter = 0;
 
+	ut_free(table->stat_col_hist);
+	table->stat_col_hist = NULL;
+	table->stat_n_col_hist = 0;
+
 	dict_index_t*	index;
 
 	for (index = dict_table_get_first_index(table);
@@ -679,6 +687,22 @@ dict_stats_copy(
 	dst->stat_sum_of_other_index_sizes = src->stat_sum_of_other_index_sizes;
 	dst->stat_modified_counter = src->stat_modified_counter;
 
+	if (dst->stat_n_col_hist != src->stat_n_col_hist) {
+		ut_free(dst->stat_col_hist);
+		dst->stat_col_hist = src->stat_n_col_hist == 0
+			? NULL
+			: static_cast<dict_col_hist_t*>(ut_malloc_nokey(
+				src->stat_n_col_hist
+				* sizeof *src->stat_col_hist));
+		dst->stat_n_col_hist = dst->stat_col_hist == NULL
+			? 0 : src->stat_n_col_hist;
+	}
+
+	if (dst->stat_n_col_hist > 0) {
+		memcpy(dst->stat_col_hist, src->stat_col_hist,
+		       dst->stat_n_col_hist * sizeof *src->stat_col_hist);
+	}
+
 	dict_index_t*	dst_idx;
 	dict_index_t*	src_idx;
 
@@ -938,6 +962,11 @@ dict_stats_update_transient(
 	table->stat_sum_of_other_index_sizes = sum_of_index_sizes
 		- index->stat_index_size;
 
+	/* Histograms are only built with the persistent statistics. */
+	ut_free(table->stat_col_hist);
+	table->stat_col_hist = NULL;
+	table->stat_n_col_hist = 0;
+
 	table->stats_last_recalc = ut_time_monotonic();
 
 	table->stat_modified_counter = 0;
@@ -2197,6 +2226,492 @@ found_level:
 	DBUG_VOID_RETURN;
 }
 
+/** Check whether a histogram can be built for a column.
+@param[in]	col	column
+@return whether col is an integer column */
+bool
+dict_stats_hist_col_ok(
+	const dict_col_t*	col)
+{
+	if (col->mtype != DATA_INT || col->len == 0 || col->len > 8
+	    || dict_col_is_virtual(col)) {
+		return(false);
+	}
+
+	/* ENUM, SET, YEAR and the old temporal types are stored
+	in DATA_INT columns as well, but not as their SQL value. */
+	switch (col->prtype & DATA_MYSQL_TYPE_MASK) {
+	case MYSQL_TYPE_TINY:
+	case MYSQL_TYPE_SHORT:
+	case MYSQL_TYPE_INT24:
+	case MYSQL_TYPE_LONG:
+	case MYSQL_TYPE_LONGLONG:
+		return(true);
+	}
+
+	return(false);
+}
+
+/** Convert a value of a column histogram to the value of the column.
+@param[in]	value	value in the format of dict_col_hist_t
+@param[in]	col	the column
+@return the value of the column */
+static
+double
+dict_stats_hist_value(
+	ib_uint64_t		value,
+	const dict_col_t*	col)
+{
+	double	d = static_cast<double>(value);
+
+	if (!(col->prtype & DATA_UNSIGNED)) {
+		/* The sign bit is inverted in InnoDB records. */
+		d -= static_cast<double>(
+			ib_uint64_t(1) << (8 * col->len - 1));
+	}
+
+	return(d);
+}
+
+/** Build the histogram of a column from a sample of its values.
+@param[out]	hist		histogram
+@param[in]	col_no		column number, dict_col_t::ind
+@param[in,out]	values		the non-NULL values in the sample, in the
+format of dict_col_hist_t; will be sorted
+@param[in]	n_values	number of elements in values
+@param[in]	n_rows		number of sampled records, including NULL
+values
+@param[in]	n_buckets	maximum number of buckets, at most
+DICT_HIST_MAX_BUCKETS */
+void
+dict_stats_hist_build(
+	dict_col_hist_t*	hist,
+	ulint			col_no,
+	ib_uint64_t*		values,
+	ulint			n_values,
+	ib_uint64_t		n_rows,
+	ulint			n_buckets)
+{
+	ut_ad(n_buckets > 0);
+	ut_ad(n_buckets <= DICT_HIST_MAX_BUCKETS);
+	ut_ad(n_values <= n_rows);
+
+	hist->col_no = col_no;
+	hist->name_fold = 0;
+	hist->n_rows = n_rows;
+	hist->n_distinct = 0;
+	hist->lower = 0;
+	hist->n_buckets = 0;
+
+	if (n_values == 0) {
+		return;
+	}
+
+	std::sort(values, values + n_values);
+
+	hist->lower = values[0];
+
+	for (ulint i = 0; i < n_values; i++) {
+		if (i == 0 || values[i] != values[i - 1]) {
+			hist->n_distinct++;
+		}
+	}
+
+	/* Close a bucket at the end of each run of equal values if
+	every value gets a bucket of its own, or else if the bucket
+	holds its share of the values. Equal values never span buckets,
+	so that a frequent value makes its buckets narrow. */
+	const bool	singleton = hist->n_distinct <= n_buckets;
+
+	for (ulint i = 0; i < n_values; i++) {
+		if (i + 1 < n_values && values[i + 1] == values[i]) {
+			continue;
+		}
+
+		const ulint	b = hist->n_buckets;
+
+		if (singleton || i + 1 == n_values
+		    || (i + 1) * n_buckets >= (b + 1) * n_values) {
+			hist->upper[b] = values[i];
+			hist->n_le[b] = i + 1;
+			hist->n_buckets++;
+		}
+	}
+
+	ut_ad(hist->n_buckets <= n_buckets);
+	ut_ad(singleton == (hist->n_buckets == hist->n_distinct));
+}
+
+/** Estimate the number of sampled records where a column is at most
+a constant.
+@param[in]	hist	histogram of the column
+@param[in]	col	the column
+@param[in]	value	constant, an integer
+@return estimated number of records */
+static
+double
+dict_stats_hist_n_le(
+	const dict_col_hist_t*	hist,
+	const dict_col_t*	col,
+	double			value)
+{
+	double	lo = dict_stats_hist_value(hist->lower, col) - 1;
+
+	if (value <= lo) {
+		return(0);
+	}
+
+	for (ulint i = 0; i < hist->n_buckets; i++) {
+		const double	up = dict_stats_hist_value(
+			hist->upper[i], col);
+		const double	below = i > 0
+			? static_cast<double>(hist->n_le[i - 1]) : 0;
+
+		if (value >= up) {
+			if (value == up) {
+				return(static_cast<double>(hist->n_le[i]));
+			}
+
+			lo = up;
+			continue;
+		}
+
+		if (hist->n_buckets == hist->n_distinct) {
+			/* The value is between the values of two
+			buckets of a singleton histogram. */
+			return(below);
+		}
+
+		/* Assume that the values are spread evenly over the
+		range (lo, up] of the bucket. */
+		return(below + (hist->n_le[i] - below)
+		       * (value - lo) / (up - lo));
+	}
+
+	return(static_cast<double>(hist->n_le[hist->n_buckets - 1]));
+}
+
+/** Estimate the number of sampled records where a column is equal to
+a constant.
+@param[in]	hist	histogram of the column
+@param[in]	col	the column
+@param[in]	value	constant, an integer
+@return estimated number of records */
+static
+double
+dict_stats_hist_n_eq(
+	const dict_col_hist_t*	hist,
+	const dict_col_t*	col,
+	double			value)
+{
+	double	lo = dict_stats_hist_value(hist->lower, col) - 1;
+
+	if (value <= lo) {
+		return(0);
+	}
+
+	for (ulint i = 0; i < hist->n_buckets; i++) {
+		const double	up = dict_stats_hist_value(
+			hist->upper[i], col);
+
+		if (value > up) {
+			lo = up;
+			continue;
+		}
+
+		const double	n = static_cast<double>(hist->n_le[i])
+			- (i > 0 ? static_cast<double>(hist->n_le[i - 1]) : 0);
+
+		if (hist->n_buckets == hist->n_distinct) {
+			return(value == up ? n : 0);
+		}
+
+		/* Assume that the bucket holds distinct values in the
+		same proportion as the whole sample, but no more than
+		fit in its range. */
+		const double	n_non_null = static_cast<double>(
+			hist->n_le[hist->n_buckets - 1]);
+		double		n_distinct = n * hist->n_distinct / n_non_null;
+
+		n_distinct = std::min(n_distinct, up - lo);
+
+		return(n / std::max(n_distinct, 1.0));
+	}
+
+	return(0);
+}
+
+/** Estimate the fraction of the records where a column compares to a
+constant, from the histogram of the column.
+@param[in]	hist	histogram of the column
+@param[in]	col	the column
+@param[in]	op	comparison
+@param[in]	value	constant
+@return fraction of the records, between 0 and 1 */
+double
+dict_stats_hist_estimate(
+	const dict_col_hist_t*	hist,
+	const dict_col_t*	col,
+	dict_hist_op_t		op,
+	double			value)
+{
+	ut_ad(hist->n_buckets > 0);
+	ut_ad(hist->n_rows >= hist->n_le[hist->n_buckets - 1]);
+
+	const double	n_non_null = static_cast<double>(
+		hist->n_le[hist->n_buckets - 1]);
+	double		n;
+
+	/* The column only holds integers. */
+	switch (op) {
+	case DICT_HIST_EQ:
+		n = value == floor(value)
+			? dict_stats_hist_n_eq(hist, col, value) : 0;
+		break;
+	case DICT_HIST_LT:
+		n = dict_stats_hist_n_le(hist, col, ceil(value) - 1);
+		break;
+	case DICT_HIST_LE:
+		n = dict_stats_hist_n_le(hist, col, floor(value));
+		break;
+	case DICT_HIST_GT:
+		n = n_non_null - dict_stats_hist_n_le(hist, col, floor(value));
+		break;
+	case DICT_HIST_GE:
+		n = n_non_null - dict_stats_hist_n_le(
+			hist, col, ceil(value) - 1);
+		break;
+	default:
+		ut_error;
+	}
+
+	/* Values that were not sampled may still occur in the table. */
+	n = std::max(n, 0.5);
+
+	return(std::min(n / hist->n_rows, 1.0));
+}
+
+/** Estimate the fraction of the records of a table where a column
+compares to a constant, from the histogram of the column.
+@param[in]	table	table
+@param[in]	col_no	column number, dict_col_t::ind
+@param[in]	op	comparison
+@param[in]	value	constant
+@return fraction of the records, or a negative value if the column
+has no histogram */
+double
+dict_stats_hist_filter(
+	dict_table_t*	table,
+	ulint		col_no,
+	dict_hist_op_t	op,
+	double		value)
+{
+	double	filter = -1;
+
+	dict_table_stats_lock(table, RW_S_LATCH);
+
+	for (ulint i = 0; i < table->stat_n_col_hist; i++) {
+		const dict_col_hist_t*	hist = &table->stat_col_hist[i];
+
+		if (hist->col_no == col_no) {
+			filter = dict_stats_hist_estimate(
+				hist, dict_table_get_nth_col(table, col_no),
+				op, value);
+			break;
+		}
+	}
+
+	dict_table_stats_unlock(table, RW_S_LATCH);
+
+	return(filter);
+}
+
+/** Values of a column in the sample of dict_stats_analyze_columns() */
+typedef std::vector<ib_uint64_t, ut_allocator<ib_uint64_t> >	hist_values_t;
+
+/** Add the records of a leaf page of the clustered index to the sample
+of dict_stats_analyze_columns().
+@param[in]	page	leaf page
+@param[in]	index	clustered index
+@param[in]	pos	positions of the columns in the index
+@param[in]	n_cols	number of columns
+@param[in,out]	values	non-NULL values of each column
+@param[in,out]	n_rows	number of sampled records */
+static
+void
+dict_stats_hist_sample_page(
+	const page_t*		page,
+	const dict_index_t*	index,
+	const ulint*		pos,
+	ulint			n_cols,
+	hist_values_t*		values,
+	ib_uint64_t*		n_rows)
+{
+	mem_heap_t*	heap = NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets = offsets_;
+	const bool	comp = page_is_comp(page) != 0;
+
+	rec_offs_init(offsets_);
+
+	for (const rec_t* rec = page_rec_get_next_const(
+		     page_get_infimum_rec(page));
+	     !page_rec_is_supremum(rec);
+	     rec = page_rec_get_next_const(rec)) {
+
+		if (rec_get_deleted_flag(rec, comp)
+		    && !srv_stats_include_delete_marked) {
+			continue;
+		}
+
+		offsets = rec_get_offsets(rec, index, offsets,
+					  ULINT_UNDEFINED, &heap);
+
+		(*n_rows)++;
+
+		for (ulint i = 0; i < n_cols; i++) {
+			ulint		len;
+			const byte*	data = rec_get_nth_field(
+				rec, offsets, pos[i], &len);
+
+			if (len == UNIV_SQL_NULL) {
+				continue;
+			}
+
+			ib_uint64_t	value = 0;
+
+			for (ulint j = 0; j < len; j++) {
+				value = value << 8 | data[j];
+			}
+
+			values[i].push_back(value);
+		}
+	}
+
+	if (heap != NULL) {
+		mem_heap_free(heap);
+	}
+}
+
+/** Build the histograms of the integer columns of a table from a sample
+of the leaf pages of its clustered index. All leaf pages are read if
+there are no more of them than N_SAMPLE_PAGES(index).
+@param[in]	index		clustered index
+@param[in]	n_buckets	maximum number of buckets per histogram
+@param[out]	n_hist		number of histograms
+@return histograms, allocated with ut_malloc_nokey(), or NULL */
+static
+dict_col_hist_t*
+dict_stats_analyze_columns(
+	dict_index_t*	index,
+	ulint		n_buckets,
+	ulint*		n_hist)
+{
+	const dict_table_t*	table = index->table;
+	const ulint		n_user_cols = dict_table_get_n_user_cols(
+		table);
+	ulint*			col_nos = static_cast<ulint*>(
+		ut_malloc_nokey(2 * n_user_cols * sizeof *col_nos));
+	ulint*			pos = col_nos + n_user_cols;
+	ulint			n_cols = 0;
+
+	ut_ad(dict_index_is_clust(index));
+
+	*n_hist = 0;
+
+	/* The index is unavailable, see btr_get_size(). */
+	if (index->page == FIL_NULL
+	    || dict_index_is_online_ddl(index)
+	    || !index->is_committed()) {
+		ut_free(col_nos);
+		return(NULL);
+	}
+
+	for (ulint i = 0; i < n_user_cols; i++) {
+		const dict_col_t*	col = dict_table_get_nth_col(table, i);
+
+		if (dict_stats_hist_col_ok(col)) {
+			col_nos[n_cols] = i;
+			pos[n_cols++] = dict_col_get_clust_pos(col, index);
+		}
+	}
+
+	if (n_cols == 0) {
+		ut_free(col_nos);
+		return(NULL);
+	}
+
+	hist_values_t*	values = UT_NEW_ARRAY_NOKEY(hist_values_t, n_cols);
+	ib_uint64_t	n_rows = 0;
+	btr_pcur_t	pcur;
+	mtr_t		mtr;
+
+	if (index->stat_n_leaf_pages <= N_SAMPLE_PAGES(index)) {
+		mtr_start(&mtr);
+
+		btr_pcur_open_at_index_side(
+			true, index, BTR_SEARCH_LEAF, &pcur, true, 0, &mtr);
+
+		for (;;) {
+			const page_t*	page = btr_pcur_get_page(&pcur);
+
+			dict_stats_hist_sample_page(
+				page, index, pos, n_cols, values, &n_rows);
+
+			if (btr_page_get_next(page, &mtr) == FIL_NULL) {
+				break;
+			}
+
+			btr_pcur_move_to_last_on_page(&pcur, &mtr);
+			btr_pcur_move_to_next_page(&pcur, &mtr);
+		}
+
+		btr_pcur_close(&pcur);
+		mtr_commit(&mtr);
+	} else {
+		for (ib_uint64_t i = 0; i < N_SAMPLE_PAGES(index); i++) {
+			mtr_start(&mtr);
+
+			if (btr_pcur_open_at_rnd_pos(
+				    index, BTR_SEARCH_LEAF, &pcur, &mtr)) {
+				dict_stats_hist_sample_page(
+					btr_pcur_get_page(&pcur), index,
+					pos, n_cols, values, &n_rows);
+			}
+
+			btr_pcur_close(&pcur);
+			mtr_commit(&mtr);
+		}
+	}
+
+	dict_col_hist_t*	hist = static_cast<dict_col_hist_t*>(
+		ut_malloc_nokey(n_cols * sizeof *hist));
+
+	for (ulint i = 0; i < n_cols; i++) {
+		dict_stats_hist_build(
+			&hist[*n_hist], col_nos[i],
+			values[i].empty() ? NULL : &values[i][0],
+			values[i].size(), n_rows, n_buckets);
+
+		hist[*n_hist].name_fold = ut_fold_string(
+			dict_table_get_col_name(table, col_nos[i]));
+
+		if (hist[*n_hist].n_buckets > 0) {
+			++*n_hist;
+		}
+	}
+
+	UT_DELETE_ARRAY(values);
+	ut_free(col_nos);
+
+	if (*n_hist == 0) {
+		ut_free(hist);
+		return(NULL);
+	}
+
+	return(hist);
+}
+
 /*********************************************************************//**
 Calculates new estimates for table and index statistics. This function
 is relatively slow and is used to calculate persistent statistics that
@@ -2235,6 +2750,15 @@ dict_stats_update_persistent(
 
 	dict_stats_analyze_index(index);
 
+	const ulint		n_buckets = srv_stats_histogram_buckets;
+	ulint			n_col_hist = 0;
+	dict_col_hist_t*	col_hist = NULL;
+
+	if (n_buckets > 0) {
+		col_hist = dict_stats_analyze_columns(
+			index, n_buckets, &n_col_hist);
+	}
+
 	ulint	n_unique = dict_index_get_n_unique(index);
 
 	ib_uint64_t stat_n_rows_tmp = index->stat_n_diff_key_vals[n_unique - 1];
@@ -2277,6 +2801,10 @@ dict_stats_update_persistent(
 
 	table->stat_sum_of_other_index_sizes = stat_sum_of_other_index_sizes_tmp;
 
+	std::swap(table->stat_col_hist, col_hist);
+
+	table->stat_n_col_hist = n_col_hist;
+
 	table->stats_last_recalc = ut_time_monotonic();
 
 	table->stat_modified_counter = 0;
@@ -2289,6 +2817,9 @@ dict_stats_update_persistent(
 
 	dict_table_analyze_index_unlock(table);
 
+	/* Free the old histograms. */
+	ut_free(col_hist);
+
 	return(DB_SUCCESS);
 }
 
@@ -2385,6 +2916,154 @@ dict_stats_save_index_stat(
 	return(ret);
 }
 
+/** Format a value of a column histogram for the description of a
+statistic in the persistent statistics storage.
+@param[out]	buf	formatted value
+@param[in]	size	size of buf
+@param[in]	value	value as stored in the histogram
+@param[in]	col	column of the histogram */
+static
+void
+dict_stats_hist_format(
+	char*			buf,
+	size_t			size,
+	ib_uint64_t		value,
+	const dict_col_t*	col)
+{
+	if (col->prtype & DATA_UNSIGNED) {
+		ut_snprintf(buf, size, UINT64PF, value);
+	} else {
+		/* Undo the inversion of the sign bit. */
+		value -= ib_uint64_t(1) << (8 * col->len - 1);
+
+		ut_snprintf(buf, size, "%lld",
+			    static_cast<long long>(value));
+	}
+}
+
+/** Save the column histograms of a table into the persistent statistics
+storage, as statistics of its clustered index, replacing the histograms
+that were saved before.
+@param[in]	table_orig	table, for the names and types of the columns
+@param[in]	table		snapshot of the statistics of table_orig
+@param[in]	index		clustered index of the snapshot
+@param[in]	last_update	timestamp of the stats
+@param[in,out]	trx		transaction; it will be rolled back in the
+case of error, but not freed
+@return DB_SUCCESS or error code */
+static
+dberr_t
+dict_stats_save_col_hist(
+	const dict_table_t*	table_orig,
+	const dict_table_t*	table,
+	dict_index_t*		index,
+	lint			last_update,
+	trx_t*			trx)
+{
+	pars_info_t*	pinfo;
+	dberr_t		ret;
+	char		db_utf8[MAX_DB_UTF8_LEN];
+	char		table_utf8[MAX_TABLE_UTF8_LEN];
+
+	ut_ad(dict_index_is_clust(index));
+
+	dict_fs2utf8(table->name.m_name, db_utf8, sizeof(db_utf8),
+		     table_utf8, sizeof(table_utf8));
+
+	pinfo = pars_info_create();
+	pars_info_add_str_literal(pinfo, "database_name", db_utf8);
+	pars_info_add_str_literal(pinfo, "table_name", table_utf8);
+	pars_info_add_str_literal(pinfo, "index_name", index->name);
+	pars_info_add_str_literal(pinfo, "hist_first", "hist_c");
+	pars_info_add_str_literal(pinfo, "hist_last", "hist_d");
+
+	/* The histograms of the columns that are no longer analyzed must
+	go too. The rows sort before "n_diff_pfx..", so they are locked
+	in the order of the PK. */
+	ret = dict_stats_exec_sql(
+		pinfo,
+		"PROCEDURE COL_HIST_DELETE () IS\n"
+		"BEGIN\n"
+		"DELETE FROM \"" INDEX_STATS_NAME "\"\n"
+		"WHERE\n"
+		"database_name = :database_name AND\n"
+		"table_name = :table_name AND\n"
+		"index_name = :index_name AND\n"
+		"stat_name >= :hist_first AND\n"
+		"stat_name < :hist_last;\n"
+		"END;", trx);
+
+	for (ulint i = 0;
+	     ret == DB_SUCCESS && i < table->stat_n_col_hist;
+	     i++) {
+
+		const dict_col_hist_t*	hist = &table->stat_col_hist[i];
+		const dict_col_t*	col = dict_table_get_nth_col(
+			table_orig, hist->col_no);
+		const char*		col_name = dict_table_get_col_name(
+			table_orig, hist->col_no);
+		char			stat_name[32];
+		char			stat_description[1024];
+		char			value[32];
+		ib_uint64_t		sample_size = hist->n_rows;
+
+		ut_snprintf(stat_name, sizeof(stat_name),
+			    "hist_c%04lu", hist->col_no);
+		ut_snprintf(stat_description, sizeof(stat_description),
+			    "Number of distinct values of %s in the sample",
+			    col_name);
+
+		ret = dict_stats_save_index_stat(
+			index, last_update, stat_name, hist->n_distinct,
+			&sample_size, stat_description, trx);
+
+		for (ulint b = 0;
+		     ret == DB_SUCCESS && b < hist->n_buckets;
+		     b++) {
+
+			ut_snprintf(stat_name, sizeof(stat_name),
+				    "hist_c%04lu_b%03lu", hist->col_no, b);
+			dict_stats_hist_format(
+				value, sizeof(value), hist->upper[b], col);
+			ut_snprintf(stat_description,
+				    sizeof(stat_description),
+				    "%s <= %s", col_name, value);
+
+			sample_size = hist->n_le[b];
+
+			ret = dict_stats_save_index_stat(
+				index, last_update, stat_name,
+				hist->upper[b], &sample_size,
+				stat_description, trx);
+		}
+
+		if (ret == DB_SUCCESS) {
+			ut_snprintf(stat_name, sizeof(stat_name),
+				    "hist_c%04lu_min", hist->col_no);
+			dict_stats_hist_format(
+				value, sizeof(value), hist->lower, col);
+			ut_snprintf(stat_description,
+				    sizeof(stat_description),
+				    "%s >= %s", col_name, value);
+
+			/* The sample_size binds the histogram to the
+			name of the column. */
+			sample_size = hist->name_fold;
+
+			ret = dict_stats_save_index_stat(
+				index, last_update, stat_name, hist->lower,
+				&sample_size, stat_description, trx);
+		}
+	}
+
+	if (ret != DB_SUCCESS) {
+		ib::error() << "Cannot save column histograms for table "
+			<< table->name << ": " << ut_strerr(ret);
+	}
+
+	return(ret);
+}
+
 /** Save the table's statistics into the persistent statistics storage.
 @param[in]	table_orig	table whose stats to save
 @param[in]	only_for_index	if this is non-NULL, then stats for indexes
@@ -2510,6 +3189,15 @@ dict_stats_save(
 
 		ut_ad(!dict_index_is_ibuf(index));
 
+		if (dict_index_is_clust(index)) {
+			ret = dict_stats_save_col_hist(
+				table_orig, table, index, now, trx);
+
+			if (ret != DB_SUCCESS) {
+				goto end;
+			}
+		}
+
 		for (ulint i = 0; i < index->n_uniq; i++) {
 
 			char	stat_name[16];
@@ -2658,6 +3346,144 @@ dict_stats_fetch_table_stats_step(
 	return(TRUE);
 }
 
+/** Store a row of a column histogram that was read from the persistent
+statistics storage. The rows are read in the order of stat_name, that is,
+column by column.
+@param[in,out]	table		table whose statistics are being fetched
+@param[in]	name		stat_name after "hist_c", not NUL-terminated
+@param[in]	len		length of name
+@param[in]	stat_value	stat_value of the row
+@param[in]	sample_size	sample_size of the row, or UINT64_UNDEFINED
+if it is NULL */
+static
+void
+dict_stats_fetch_col_hist(
+	dict_table_t*	table,
+	const char*	name,
+	ulint		len,
+	ib_uint64_t	stat_value,
+	ib_uint64_t	sample_size)
+{
+	ulint		col_no = 0;
+	dict_col_hist_t*	hist = NULL;
+
+	if (len < 4) {
+		return;
+	}
+
+	for (ulint i = 0; i < 4; i++) {
+		if (name[i] < '0' || name[i] > '9') {
+			return;
+		}
+
+		col_no = col_no * 10 + (name[i] - '0');
+	}
+
+	name += 4;
+	len -= 4;
+
+	if (sample_size == UINT64_UNDEFINED) {
+		sample_size = 0;
+	}
+
+	if (table->stat_n_col_hist > 0) {
+		hist = &table->stat_col_hist[table->stat_n_col_hist - 1];
+	}
+
+	if (hist == NULL || hist->col_no != col_no) {
+		void*	ptr = ut_realloc(
+			table->stat_col_hist,
+			(table->stat_n_col_hist + 1) * sizeof *hist);
+
+		if (ptr == NULL) {
+			return;
+		}
+
+		table->stat_col_hist = static_cast<dict_col_hist_t*>(ptr);
+		hist = &table->stat_col_hist[table->stat_n_col_hist++];
+
+		memset(hist, 0, sizeof *hist);
+		hist->col_no = col_no;
+	}
+
+	if (len == 0) {
+		hist->n_distinct = stat_value;
+		hist->n_rows = sample_size;
+	} else if (len == 4 && native_strncasecmp("_min", name, len) == 0) {
+		hist->lower = stat_value;
+		hist->name_fold = static_cast<ulint>(sample_size);
+	} else if (len == 5 && name[0] == '_' && name[1] == 'b'
+		   && name[2] >= '0' && name[2] <= '9'
+		   && name[3] >= '0' && name[3] <= '9'
+		   && name[4] >= '0' && name[4] <= '9') {
+
+		ulint	b = (name[2] - '0') * 100 + (name[3] - '0') * 10
+			+ (name[4] - '0');
+
+		if (b < DICT_HIST_MAX_BUCKETS) {
+			hist->upper[b] = stat_value;
+			hist->n_le[b] = sample_size;
+			hist->n_buckets = ut_max(hist->n_buckets, b + 1);
+		}
+	}
+}
+
+/** Remove the column histograms that were read from the persistent
+statistics storage and do not fit the columns of the table, or are
+inconsistent because some of their rows were lost or modified by hand.
+A histogram does not fit when the column at its position has another
+name than the one it was built for, for example after the columns were
+reordered and the histograms were not built again.
+@param[in,out]	t	statistics that were read
+@param[in]	table	table whose statistics were read */
+static
+void
+dict_stats_fetch_col_hist_check(
+	dict_table_t*		t,
+	const dict_table_t*	table)
+{
+	ulint	n = 0;
+
+	for (ulint i = 0; i < t->stat_n_col_hist; i++) {
+		const dict_col_hist_t*	hist = &t->stat_col_hist[i];
+		const ulint		n_buckets = hist->n_buckets;
+		bool			ok = n_buckets > 0
+			&& hist->col_no < dict_table_get_n_user_cols(table)
+			&& hist->n_distinct >= n_buckets
+			&& hist->n_le[0] > 0
+			&& hist->n_le[n_buckets - 1] <= hist->n_rows
+			&& hist->lower <= hist->upper[0];
+
+		if (ok) {
+			const dict_col_t*	col = dict_table_get_nth_col(
+				table, hist->col_no);
+
+			ok = dict_stats_hist_col_ok(col)
+				&& hist->name_fold == ut_fold_string(
+					dict_table_get_col_name(
+						table, hist->col_no))
+				&& (col->len >= 8
+				    || hist->upper[n_buckets - 1]
+				    >> (8 * col->len) == 0);
+		}
+
+		for (ulint b = 1; ok && b < n_buckets; b++) {
+			ok = hist->upper[b] > hist->upper[b - 1]
+				&& hist->n_le[b] > hist->n_le[b - 1];
+		}
+
+		if (ok) {
+			if (n != i) {
+				t->stat_col_hist[n] = *hist;
+			}
+
+			n++;
+		}
+	}
+
+	t->stat_n_col_hist = n;
+}
+
 /** Aux struct used to pass a table and a boolean to
 dict_stats_fetch_index_stats_step(). */
 struct index_fetch_t {
@@ -2905,6 +3731,13 @@ dict_stats_fetch_index_stats_step(
 		index->stat_n_non_null_key_vals[n_pfx - 1] = 0;
 
 		arg->stats_were_modified = true;
+	} else if (stat_name_len > 6 /* strlen("hist_c") */
+		   && native_strncasecmp("hist_c", stat_name, 6) == 0
+		   && dict_index_is_clust(index)) {
+
+		dict_stats_fetch_col_hist(table, stat_name + 6,
+					  stat_name_len - 6,
+					  stat_value, sample_size);
 	} else {
 		/* silently ignore rows with unknown stat_name, the
 		user may have developed her own stats */
@@ -3237,6 +4070,8 @@ dict_stats_update(
 		switch (err) {
 		case DB_SUCCESS:
 
+			dict_stats_fetch_col_hist_check(t, table);
+
 			dict_table_stats_lock(table, RW_X_LATCH);
 
 			dict_stats_copy(table, t);
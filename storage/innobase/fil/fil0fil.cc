@@ -42,6 +42,7 @@ Created 10/25/1995 Heikki Tuuri
 #include "fsp0fsp.h"
 #include "fsp0space.h"
 #include "fsp0sysspace.h"
+#include "ha0ha.h"
 #include "hash0hash.h"
 #include "log0recv.h"
 #include "mach0data.h"
@@ -127,10 +128,18 @@ Some operating systems do not support many open files at the same time,
 though NT seems to tolerate at least 900 open files. Therefore, we put the
 open files in an LRU-list. If we need to open another file, we may close the
 file at the end of the LRU-list. When an i/o-operation is pending on a file,
-the file cannot be closed. We take the file nodes with pending i/o-operations
-out of the LRU-list and keep a count of pending operations. When an operation
-completes, we decrement the count and return the file node to the LRU-list if
-the count drops to zero. */
+the file cannot be closed. We keep a count of pending operations in the file
+node, and skip the nodes with pending i/o-operations when looking for a file
+to close.
+
+Most page i/o's are for tablespaces that consist of one open file. fil_io()
+looks up such files in fil_system->spaces while holding the latch of the hash
+table cell in shared mode, and increments the count of pending operations
+without acquiring fil_system->mutex. Therefore, anything that changes the
+fields checked by fil_node_prepare_for_io_fast() or that must see a stable
+count of pending operations also acquires the latch in exclusive mode. Such a
+file is not moved to the start of the LRU-list when it is accessed; instead,
+fil_node_t::accessed gives it a second chance before it is closed. */
 
 /** This tablespace name is used internally during recovery to open a
 general tablespace before the data dictionary are recovered and available. */
@@ -159,6 +168,9 @@ ulint	fil_n_file_opened			= 0;
 /** The null file address */
 fil_addr_t	fil_addr_null = {FIL_NULL, 0};
 
+/** Number of rw-locks protecting fil_system_t::spaces; must be a power of 2 */
+static const ulint	FIL_SPACE_HASH_LOCKS = 64;
+
 /** The tablespace memory cache; also the totality of logs (the log
 data space) is stored here; below we talk about tablespaces, but also
 the ib_logfiles form a 'space' and it is handled here */
@@ -168,7 +180,11 @@ struct fil_system_t {
 #endif /* !UNIV_HOTBACKUP */
 	hash_table_t*	spaces;		/*!< The hash table of spaces in the
 					system; they are hashed on the space
-					id */
+					id. Modifications are protected by
+					mutex and the rw-lock of the cell in
+					exclusive mode; fil_io() may search
+					it while holding the rw-lock in shared
+					mode */
 	hash_table_t*	name_hash;	/*!< hash table based on the space
 					name */
 	UT_LIST_BASE_NODE_T(fil_node_t) LRU;
@@ -299,9 +315,9 @@ fil_space_belongs_in_lru(
 NOTE: you must call fil_mutex_enter_and_prepare_for_io() first!
 
 Prepares a file node for i/o. Opens the file if it is closed. Updates the
-pending i/o's field in the node and the system appropriately. Takes the node
-off the LRU list if it is in the LRU list. The caller must hold the fil_sys
-mutex.
+pending i/o's field in the node and the system appropriately. Moves the node
+to the start of the LRU list if it is in the LRU list. The caller must hold
+the fil_sys mutex.
 @return false if the file can't be opened, otherwise true */
 static
 bool
@@ -313,7 +329,8 @@ fil_node_prepare_for_io(
 
 /**
 Updates the data structures when an i/o operation finishes. Updates the
-pending i/o's field in the node appropriately.
+pending i/o's field in the node appropriately. The caller must hold the
+fil_sys mutex if the i/o was a write.
 @param[in,out] node		file node
 @param[in,out] system		tablespace instance
 @param[in] type			IO context */
@@ -379,7 +396,8 @@ fil_write(
 }
 
 /*******************************************************************//**
-Returns the table space by a given id, NULL if not found. */
+Returns the table space by a given id, NULL if not found. The caller must
+hold fil_system->mutex or the fil_system->spaces latch of the id. */
 UNIV_INLINE
 fil_space_t*
 fil_space_get_by_id(
@@ -388,7 +406,9 @@ fil_space_get_by_id(
 {
 	fil_space_t*	space;
 
-	ut_ad(mutex_own(&fil_system->mutex));
+	ut_ad(mutex_own(&fil_system->mutex)
+	      || rw_lock_own(hash_get_lock(fil_system->spaces, id),
+			     RW_LOCK_S));
 
 	HASH_SEARCH(hash, fil_system->spaces, id,
 		    fil_space_t*, space,
@@ -398,6 +418,25 @@ fil_space_get_by_id(
 	return(space);
 }
 
+/** Acquire the fil_system->spaces latch of a tablespace id in exclusive
+mode. This prevents fil_io() from accessing the tablespace without
+fil_system->mutex. The caller must hold fil_system->mutex.
+@param[in]	id	tablespace id
+@return the latch, to be released with rw_lock_x_unlock() */
+static
+rw_lock_t*
+fil_space_hash_lock_x(
+	ulint	id)
+{
+	ut_ad(mutex_own(&fil_system->mutex));
+
+	rw_lock_t*	hash_lock = hash_get_lock(fil_system->spaces, id);
+
+	rw_lock_x_lock(hash_lock);
+
+	return(hash_lock);
+}
+
 /*******************************************************************//**
 Returns the table space by a given name, NULL if not found. */
 UNIV_INLINE
@@ -661,7 +700,10 @@ fil_node_create_low(
 
 	node->atomic_write = atomic_write;
 
+	rw_lock_t*	hash_lock = fil_space_hash_lock_x(space->id);
 	UT_LIST_ADD_LAST(space->chain, node);
+	rw_lock_x_unlock(hash_lock);
+
 	mutex_exit(&fil_system->mutex);
 
 	return(node);
@@ -921,7 +963,9 @@ add_size:
 
 	ut_a(success);
 
+	rw_lock_t*	hash_lock = fil_space_hash_lock_x(space->id);
 	node->is_open = true;
+	rw_lock_x_unlock(hash_lock);
 
 	fil_system->n_open++;
 	fil_n_file_opened++;
@@ -929,22 +973,26 @@ add_size:
 	if (fil_space_belongs_in_lru(space)) {
 
 		/* Put the node to the LRU list */
+		node->accessed = false;
 		UT_LIST_ADD_FIRST(fil_system->LRU, node);
 	}
 
 	return(true);
 }
 
-/** Close a file node.
+/** Close a file node. The caller must hold fil_system->mutex and the
+fil_system->spaces latch of the tablespace in exclusive mode.
 @param[in,out]	node	File node */
 static
 void
-fil_node_close_file(
+fil_node_close_file_low(
 	fil_node_t*	node)
 {
 	bool	ret;
 
 	ut_ad(mutex_own(&(fil_system->mutex)));
+	ut_ad(rw_lock_own(hash_get_lock(fil_system->spaces, node->space->id),
+			  RW_LOCK_X));
 	ut_a(node->is_open);
 	ut_a(node->n_pending == 0);
 	ut_a(node->n_pending_flushes == 0);
@@ -974,6 +1022,20 @@ fil_node_close_file(
 	}
 }
 
+/** Close a file node.
+@param[in,out]	node	File node */
+static
+void
+fil_node_close_file(
+	fil_node_t*	node)
+{
+	rw_lock_t*	hash_lock = fil_space_hash_lock_x(node->space->id);
+
+	fil_node_close_file_low(node);
+
+	rw_lock_x_unlock(hash_lock);
+}
+
 /** Tries to close a file in the LRU list. The caller must hold the fil_sys
 mutex.
 @return true if success, false if should retry later; since i/o's
@@ -990,6 +1052,7 @@ fil_try_to_close_file_in_LRU(
 	bool	print_info)
 {
 	fil_node_t*	node;
+	fil_node_t*	prev_node;
 
 	ut_ad(mutex_own(&fil_system->mutex));
 
@@ -1000,21 +1063,50 @@ fil_try_to_close_file_in_LRU(
 
 	for (node = UT_LIST_GET_LAST(fil_system->LRU);
 	     node != NULL;
-	     node = UT_LIST_GET_PREV(LRU, node)) {
+	     node = prev_node) {
 
-		if (node->modification_counter == node->flush_counter
+		prev_node = UT_LIST_GET_PREV(LRU, node);
+
+		if (node->accessed) {
+			/* fil_io() has used the file without moving it
+			to the start of the LRU list. Give it a second
+			chance. */
+			node->accessed = false;
+
+			UT_LIST_REMOVE(fil_system->LRU, node);
+			UT_LIST_ADD_FIRST(fil_system->LRU, node);
+
+			continue;
+		}
+
+		rw_lock_t*	hash_lock = fil_space_hash_lock_x(
+			node->space->id);
+
+		if (node->n_pending == 0
+		    && node->modification_counter == node->flush_counter
 		    && node->n_pending_flushes == 0
 		    && !node->being_extended) {
 
-			fil_node_close_file(node);
+			fil_node_close_file_low(node);
+
+			rw_lock_x_unlock(hash_lock);
 
 			return(true);
 		}
 
+		rw_lock_x_unlock(hash_lock);
+
 		if (!print_info) {
 			continue;
 		}
 
+		if (node->n_pending > 0) {
+
+			ib::info() << "Cannot close file " << node->name
+				<< ", because n_pending "
+				<< node->n_pending;
+		}
+
 		if (node->n_pending_flushes > 0) {
 
 			ib::info() << "Cannot close file " << node->name
@@ -1215,7 +1307,9 @@ fil_space_detach(
 {
 	ut_ad(mutex_own(&fil_system->mutex));
 
+	rw_lock_t*	hash_lock = fil_space_hash_lock_x(space->id);
 	HASH_DELETE(fil_space_t, hash, fil_system->spaces, space->id, space);
+	rw_lock_x_unlock(hash_lock);
 
 	fil_space_t*	fnamespace = fil_space_get_by_name(space->name);
 
@@ -1412,7 +1506,9 @@ fil_space_create(
 #endif /* !UNIV_HOTBACKUP */
 	}
 
+	rw_lock_t*	hash_lock = fil_space_hash_lock_x(id);
 	HASH_INSERT(fil_space_t, hash, fil_system->spaces, id, space);
+	rw_lock_x_unlock(hash_lock);
 
 	HASH_INSERT(fil_space_t, name_hash, fil_system->name_hash,
 		    ut_fold_string(name), space);
@@ -1756,7 +1852,9 @@ fil_init(
 
 	mutex_create(LATCH_ID_FIL_SYSTEM, &fil_system->mutex);
 
-	fil_system->spaces = hash_create(hash_size);
+	fil_system->spaces = ib_create(
+		hash_size, LATCH_ID_FIL_SPACE_HASH, FIL_SPACE_HASH_LOCKS,
+		MEM_HEAP_FOR_PAGE_HASH);
 	fil_system->name_hash = hash_create(hash_size);
 
 	UT_LIST_INIT(fil_system->LRU, &fil_node_t::LRU);
@@ -2650,7 +2748,9 @@ fil_check_pending_operations(
 	mutex_enter(&fil_system->mutex);
 	fil_space_t* sp = fil_space_get_by_id(id);
 	if (sp) {
+		rw_lock_t*	hash_lock = fil_space_hash_lock_x(id);
 		sp->stop_new_ops = true;
+		rw_lock_x_unlock(hash_lock);
 	}
 	mutex_exit(&fil_system->mutex);
 
@@ -3393,7 +3493,9 @@ func_exit:
 	operating systems can rename an open file. For the closing we have to
 	wait until there are no pending i/o's or flushes on the file. */
 
+	rw_lock_t*	hash_lock = fil_space_hash_lock_x(id);
 	space->stop_ios = true;
+	rw_lock_x_unlock(hash_lock);
 
 	/* The following code must change when InnoDB supports
 	multiple datafiles per tablespace. */
@@ -5354,9 +5456,9 @@ fil_space_get_n_reserved_extents(
 NOTE: you must call fil_mutex_enter_and_prepare_for_io() first!
 
 Prepares a file node for i/o. Opens the file if it is closed. Updates the
-pending i/o's field in the node and the system appropriately. Takes the node
-off the LRU list if it is in the LRU list. The caller must hold the fil_sys
-mutex.
+pending i/o's field in the node and the system appropriately. Moves the node
+to the start of the LRU list if it is in the LRU list. The caller must hold
+the fil_sys mutex.
 @return false if the file can't be opened, otherwise true */
 static
 bool
@@ -5381,24 +5483,72 @@ fil_node_prepare_for_io(
 		if (!fil_node_open_file(node)) {
 			return(false);
 		}
-	}
 
-	if (node->n_pending == 0 && fil_space_belongs_in_lru(space)) {
-		/* The node is in the LRU list, remove it */
-
-		ut_a(UT_LIST_GET_LEN(system->LRU) > 0);
+	} else if (fil_space_belongs_in_lru(space)
+		   && node != UT_LIST_GET_FIRST(system->LRU)) {
+		/* The node is in the LRU list, move it to the start */
 
 		UT_LIST_REMOVE(system->LRU, node);
+		UT_LIST_ADD_FIRST(system->LRU, node);
+
+		node->accessed = false;
 	}
 
-	node->n_pending++;
+	os_atomic_increment_ulint(&node->n_pending, 1);
 
 	return(true);
 }
 
+/** Prepare a file node for a page i/o without acquiring the fil_sys mutex.
+This succeeds if the tablespace consists of one open data file that contains
+the page, and no operation on the tablespace wants to stop i/o's. Updates
+the pending i/o's field in the node, but does not move the node in the LRU
+list.
+@param[in]	page_id	page id
+@return file node, or NULL if the fil_sys mutex must be acquired */
+static
+fil_node_t*
+fil_node_prepare_for_io_fast(
+	const page_id_t&	page_id)
+{
+	rw_lock_t*	hash_lock = hash_get_lock(
+		fil_system->spaces, page_id.space());
+
+	rw_lock_s_lock(hash_lock);
+
+	fil_space_t*	space = fil_space_get_by_id(page_id.space());
+	fil_node_t*	node = NULL;
+
+	if (space != NULL
+	    && !space->stop_ios
+	    && !space->stop_new_ops
+	    && !space->is_being_truncated
+	    && fil_type_is_data(space->purpose)
+	    && UT_LIST_GET_LEN(space->chain) == 1) {
+
+		node = UT_LIST_GET_FIRST(space->chain);
+
+		if (node->is_open && node->size > page_id.page_no()) {
+
+			os_atomic_increment_ulint(&node->n_pending, 1);
+
+			if (!node->accessed) {
+				node->accessed = true;
+			}
+		} else {
+			node = NULL;
+		}
+	}
+
+	rw_lock_s_unlock(hash_lock);
+
+	return(node);
+}
+
 /********************************************************************//**
 Updates the data structures when an i/o operation finishes. Updates the
-pending i/o's field in the node appropriately. */
+pending i/o's field in the node appropriately. The caller must hold the
+fil_sys mutex if the i/o was a write. */
 static
 void
 fil_node_complete_io(
@@ -5408,10 +5558,10 @@ fil_node_complete_io(
 	const IORequest&type)	/*!< in: IO_TYPE_*, marks the node as
 				modified if TYPE_IS_WRITE() */
 {
-	ut_ad(mutex_own(&system->mutex));
+	ut_ad(!type.is_write() || mutex_own(&system->mutex));
 	ut_a(node->n_pending > 0);
 
-	--node->n_pending;
+	os_atomic_decrement_ulint(&node->n_pending, 1);
 
 	ut_ad(type.validate());
 
@@ -5440,12 +5590,6 @@ fil_node_complete_io(
 				system->unflushed_spaces, node->space);
 		}
 	}
-
-	if (node->n_pending == 0 && fil_space_belongs_in_lru(node->space)) {
-
-		/* The node must be put back to the LRU list */
-		UT_LIST_ADD_FIRST(system->LRU, node);
-	}
 }
 
 /** Report information about an invalid page access. */
@@ -5601,12 +5745,25 @@ fil_io(
 	}
 #endif /* !UNIV_HOTBACKUP */
 
+	fil_space_t*	space;
+	ulint		cur_page_no = page_id.page_no();
+	fil_node_t*	node = fil_node_prepare_for_io_fast(page_id);
+
+	if (node != NULL) {
+		space = node->space;
+
+		ut_ad(mode != OS_AIO_IBUF
+		      || fil_type_is_data(space->purpose));
+
+		goto do_io;
+	}
+
 	/* Reserve the fil_system mutex and make sure that we can open at
 	least one file while holding it, if the file is not already open */
 
 	fil_mutex_enter_and_prepare_for_io(page_id.space());
 
-	fil_space_t*	space = fil_space_get_by_id(page_id.space());
+	space = fil_space_get_by_id(page_id.space());
 
 	/* If we are deleting a tablespace we don't allow async read operations
 	on that. However, we do allow write operations and sync read operations. */
@@ -5632,8 +5789,7 @@ fil_io(
 
 	ut_ad(mode != OS_AIO_IBUF || fil_type_is_data(space->purpose));
 
-	ulint		cur_page_no = page_id.page_no();
-	fil_node_t*	node = UT_LIST_GET_FIRST(space->chain);
+	node = UT_LIST_GET_FIRST(space->chain);
 
 	for (;;) {
 
@@ -5733,6 +5889,7 @@ fil_io(
 	/* Now we have made the changes in the data structures of fil_system */
 	mutex_exit(&fil_system->mutex);
 
+do_io:
 	/* Calculate the low 32 bits and the high 32 bits of the file offset */
 
 	if (!page_size.is_compressed()) {
@@ -5846,11 +6003,15 @@ fil_io(
 		/* The i/o operation is already completed when we return from
 		os_aio: */
 
-		mutex_enter(&fil_system->mutex);
+		if (req_type.is_write()) {
+			mutex_enter(&fil_system->mutex);
 
-		fil_node_complete_io(node, fil_system, req_type);
+			fil_node_complete_io(node, fil_system, req_type);
 
-		mutex_exit(&fil_system->mutex);
+			mutex_exit(&fil_system->mutex);
+		} else {
+			fil_node_complete_io(node, fil_system, req_type);
+		}
 
 		ut_ad(fil_validate_skip());
 	}
@@ -5887,11 +6048,16 @@ fil_aio_wait(
 
 	srv_set_io_thread_op_info(segment, "complete io for fil node");
 
-	mutex_enter(&fil_system->mutex);
+	if (type.is_write()) {
+		mutex_enter(&fil_system->mutex);
 
-	fil_node_complete_io(node, fil_system, type);
+		fil_node_complete_io(node, fil_system, type);
 
-	mutex_exit(&fil_system->mutex);
+		mutex_exit(&fil_system->mutex);
+	} else {
+		/* A completed read only updates node->n_pending. */
+		fil_node_complete_io(node, fil_system, type);
+	}
 
 	ut_ad(fil_validate_skip());
 
@@ -6223,8 +6389,6 @@ fil_validate(void)
 	     fil_node != 0;
 	     fil_node = UT_LIST_GET_NEXT(LRU, fil_node)) {
 
-		ut_a(fil_node->n_pending == 0);
-		ut_a(!fil_node->being_extended);
 		ut_a(fil_node->is_open);
 		ut_a(fil_space_belongs_in_lru(fil_node->space));
 	}
@@ -6309,6 +6473,7 @@ void
 fil_close(void)
 /*===========*/
 {
+	ha_clear(fil_system->spaces);
 	hash_table_free(fil_system->spaces);
 
 	hash_table_free(fil_system->name_hash);
@@ -7218,9 +7383,6 @@ truncate_t::truncate(
 		err = DB_ERROR;
 	}
 
-	space->stop_new_ops = false;
-	space->is_being_truncated = false;
-
 	/* If we opened the file in this function, close it. */
 	if (!already_open) {
 		bool	closed = os_file_close(node->handle);
@@ -7236,6 +7398,11 @@ truncate_t::truncate(
 		}
 	}
 
+	/* Only now that node->is_open is up to date, allow fil_io() to
+	access the file without fil_system->mutex. */
+	space->stop_new_ops = false;
+	space->is_being_truncated = false;
+
 	mutex_exit(&fil_system->mutex);
 
 	ut_free(path);
@@ -1892,6 +1892,10 @@ fsp_page_create(
 	mtr_memo_push(init_mtr, block, rw_latch == RW_X_LATCH
 		      ? MTR_MEMO_PAGE_X_FIX : MTR_MEMO_PAGE_SX_FIX);
 
+	/* The page may still be in the adaptive hash index, if it was
+	freed by dict_drop_index_tree(). */
+	btr_search_drop_page_hash_index(block);
+
 	if (init_mtr == mtr
 	    || (rw_latch == RW_X_LATCH
 		? rw_lock_get_x_lock_count(&block->lock) == 1
@@ -579,7 +579,11 @@ SysTablespace::read_lsn_and_check_flags(lsn_t* flushed_lsn)
 	ut_a(it->order() == 0);
 
 
-	buf_dblwr_init_or_load_pages(it->handle(), it->filepath());
+	err = buf_dblwr_init_or_load_pages(it->handle(), it->filepath());
+
+	if (err != DB_SUCCESS) {
+		return(err);
+	}
 
 	/* Check the contents of the first page of the
 	first datafile. */
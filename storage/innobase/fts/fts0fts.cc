@@ -47,6 +47,7 @@ Full Text Search interface
 #include "dict0stats.h"
 #include "btr0pcur.h"
 #include "sync0sync.h"
+#include "srv0mon.h"
 #include "ut0new.h"
 
 static const ulint FTS_MAX_ID_LEN = 32;
@@ -98,6 +99,12 @@ static const ulint FTS_CACHE_SIZE_UPPER_LIMIT_IN_MB = 1024;
 /** Time to sleep after DEADLOCK error before retrying operation. */
 static const ulint FTS_DEADLOCK_RETRY_WAIT = 100000;
 
+/** Number of passes over the cache that a SYNC makes while releasing the
+cache lock around each node write. Words that were added to the cache
+during the last of these passes are written out while holding the lock,
+so that the SYNC cannot be starved by concurrent inserts. */
+static const ulint FTS_SYNC_MAX_UNLOCKED_PASSES = 3;
+
 /** variable to record innodb_fts_internal_tbl_name for information
 schema table INNODB_FTS_INSERTED etc. */
 char* fts_internal_tbl_name		= NULL;
@@ -3580,7 +3587,7 @@ fts_add_doc_by_id(
 
 	btr_pcur_open_with_no_init(
 		fts_id_index, tuple, PAGE_CUR_LE, BTR_SEARCH_LEAF,
-		&pcur, 0, &mtr);
+		&pcur, &mtr);
 
 	/* If we have a match, add the data to doc structure */
 	if (btr_pcur_get_low_match(&pcur) == 1) {
@@ -3618,7 +3625,7 @@ fts_add_doc_by_id(
 
 			btr_pcur_open_with_no_init(
 				clust_index, clust_ref, PAGE_CUR_LE,
-				BTR_SEARCH_LEAF, &clust_pcur, 0, &mtr);
+				BTR_SEARCH_LEAF, &clust_pcur, &mtr);
 
 			doc_pcur = &clust_pcur;
 			clust_rec = btr_pcur_get_rec(&clust_pcur);
@@ -4762,8 +4769,10 @@ fts_sync(
 	bool		has_dict_lock)
 {
 	ulint		i;
+	ulint		n_passes = 0;
 	dberr_t		error = DB_SUCCESS;
 	fts_cache_t*	cache = sync->table->fts->cache;
+	uint64_t	start_time = ut_time_monotonic_us();
 
 	rw_lock_x_lock(&cache->lock);
 
@@ -4796,13 +4805,21 @@ fts_sync(
 	}
 
 	do {
-		if (cache->total_size > fts_max_cache_size) {
+		if (n_passes >= FTS_SYNC_MAX_UNLOCKED_PASSES) {
 			/* Avoid the case: sync never finish when
-			insert/update keeps comming. */
-			ut_ad(sync->unlock_cache);
+			insert/update keeps comming. Each pass only has
+			to write the words that were added during the
+			previous one, so this last pass is short. */
 			sync->unlock_cache = false;
 		}
 
+		++n_passes;
+		MONITOR_INC(MONITOR_FTS_SYNC_PASSES);
+
+		if (!sync->unlock_cache) {
+			MONITOR_INC(MONITOR_FTS_SYNC_EXCLUSIVE_PASSES);
+		}
+
 		for (i = 0; i < ib_vector_size(cache->indexes); ++i) {
 			fts_index_cache_t*	index_cache;
 
@@ -4870,6 +4887,10 @@ fts_sync(
 
 	mutex_exit(&cache->deleted_lock);
 
+	MONITOR_INC(MONITOR_FTS_SYNC);
+	MONITOR_INC_TIME_IN_MICRO_SECS(
+		MONITOR_FTS_SYNC_MICROSECOND, start_time);
+
 	return(error);
 }
 
@@ -5137,7 +5158,7 @@ fts_get_token_size(
 		int	ctype;
 		int	mbl;
 
-		mbl = cs->cset->ctype(
+		mbl = fts_get_ctype(
 			cs, &ctype,
 			reinterpret_cast<uchar*>(start),
 			reinterpret_cast<uchar*>(end));
@@ -43,6 +43,7 @@ Completed 2011/7/10 Sunny and Jimmy Yang
 #include "ut0wqueue.h"
 #include "srv0start.h"
 #include "ut0list.h"
+#include "srv0mon.h"
 #include "zlib.h"
 
 #ifdef UNIV_NONINL
@@ -53,6 +54,9 @@ Completed 2011/7/10 Sunny and Jimmy Yang
 /** The FTS optimize thread's work queue. */
 static ib_wqueue_t* fts_optimize_wq;
 
+/** The work queue of the FTS optimize worker threads. */
+static ib_wqueue_t* fts_optimize_worker_wq;
+
 /** The FTS vector to store fts_slot_t */
 static ib_vector_t*  fts_slots;
 
@@ -92,7 +96,13 @@ enum fts_msg_type_t {
 
 	FTS_MSG_DEL_TABLE,		/*!< Remove a table from the optimize
 					threads work queue */
-	FTS_MSG_SYNC_TABLE		/*!< Sync fts cache of a table */
+	FTS_MSG_SYNC_TABLE,		/*!< Sync fts cache of a table */
+
+	FTS_MSG_OPTIMIZE_TABLE,		/*!< Optimize a table, sent to the
+					worker threads */
+
+	FTS_MSG_JOB_DONE		/*!< A worker thread finished a job,
+					sent to the optimize thread */
 };
 
 /** Compressed list of words that have been read from FTS INDEX
@@ -209,6 +219,14 @@ struct fts_slot_t {
 
 	ib_time_t	interval_time;	   /*!< Minimum time to wait before
 					   optimizing the table again. */
+
+	ulint		n_jobs;		/*!< Number of optimize and sync jobs
+					of this table that the worker threads
+					have not finished yet */
+
+	os_event_t	del_event;	/*!< If not NULL, the table is to be
+					removed when n_jobs drops to 0, and
+					this event set; see fts_msg_del_t */
 };
 
 /** A table remove message for the FTS optimize thread. */
@@ -220,6 +238,19 @@ struct fts_msg_del_t {
 					this message by the consumer */
 };
 
+/** An optimize or sync job for the FTS optimize worker threads. */
+struct fts_msg_job_t {
+	ulint		pos;		/*!< Position of the table in
+					fts_slots, or ULINT_UNDEFINED */
+
+	dict_table_t*	table;		/*!< The table to optimize, or NULL
+					for a sync job */
+
+	table_id_t	table_id;	/*!< The table to sync */
+
+	dberr_t		error;		/*!< Outcome of the optimize */
+};
+
 /** The FTS optimize message work queue message type. */
 struct fts_msg_t {
 	fts_msg_type_t	type;		/*!< Message type */
@@ -234,6 +265,9 @@ struct fts_msg_t {
 /** The number of words to read and optimize in a single pass. */
 ulong	fts_num_word_optimize;
 
+/** The number of FTS optimize worker threads. */
+ulong	fts_optimize_threads;
+
 /** Whether to enable additional FTS diagnostic printout. */
 char	fts_enable_diag_print;
 
@@ -1134,7 +1168,8 @@ fts_optimize_encode_node(
 /*=====================*/
 	fts_node_t*	node,		/*!< in: node to fill*/
 	doc_id_t	doc_id,		/*!< in: doc id to encode */
-	fts_encode_t*	enc)		/*!< in: encoding state.*/
+	fts_encode_t*	enc,		/*!< in: encoding state.*/
+	const byte*	src_end)	/*!< in: end of the source ilist */
 {
 	byte*		dst;
 	ulint		enc_len;
@@ -1154,13 +1189,9 @@ fts_optimize_encode_node(
 	doc_id_delta = doc_id - node->last_doc_id;
 	enc_len = fts_get_encoded_len(static_cast<ulint>(doc_id_delta));
 
-	/* Calculate the size of the encoded pos array. */
-	while (*src) {
-		fts_decode_vlc(&src);
-	}
-
-	/* Skip the 0x00 byte at the end of the word positions list. */
-	++src;
+	/* Calculate the size of the encoded pos array, including the
+	0x00 byte at the end of the word positions list. */
+	fts_skip_positions(&src, src_end);
 
 	/* Number of encoded pos bytes to copy. */
 	pos_enc_len = src - enc->src_ilist_ptr;
@@ -1271,13 +1302,11 @@ test_again:
 
 			++*del_pos;
 
-			/* Skip the entries for this document. */
-			while (*enc->src_ilist_ptr) {
-				fts_decode_vlc(&enc->src_ilist_ptr);
-			}
-
-			/* Skip the end of word position marker. */
-			++enc->src_ilist_ptr;
+			/* Skip the entries for this document, and the
+			end of word position marker. */
+			fts_skip_positions(
+				&enc->src_ilist_ptr,
+				src_node->ilist + src_node->ilist_size);
 
 		} else {
 
@@ -1292,7 +1321,9 @@ test_again:
 
 			/* Decode and copy the word positions into
 			the dest node. */
-			fts_optimize_encode_node(dst_node, doc_id, enc);
+			fts_optimize_encode_node(
+				dst_node, doc_id, enc,
+				src_node->ilist + src_node->ilist_size);
 
 			++dst_node->doc_count;
 
@@ -2397,44 +2428,6 @@ fts_optimize_reset_start_time(
 	return(error);
 }
 
-/*********************************************************************//**
-Run OPTIMIZE on the given table by a background thread.
-@return DB_SUCCESS if all OK */
-static MY_ATTRIBUTE((nonnull))
-dberr_t
-fts_optimize_table_bk(
-/*==================*/
-	fts_slot_t*	slot)	/*!< in: table to optimiza */
-{
-	dberr_t		error;
-	dict_table_t*	table = slot->table;
-	fts_t*		fts = table->fts;
-
-	/* Avoid optimizing tables that were optimized recently. */
-	if (slot->last_run > 0
-	    && (ut_time_monotonic() - slot->last_run) < slot->interval_time) {
-
-		return(DB_SUCCESS);
-
-	} else if (fts && fts->cache
-		   && fts->cache->deleted >= FTS_OPTIMIZE_THRESHOLD) {
-
-		error = fts_optimize_table(table);
-
-		if (error == DB_SUCCESS) {
-			slot->state = FTS_STATE_DONE;
-			slot->last_run = 0;
-			slot->completed = ut_time_monotonic();
-		}
-	} else {
-		error = DB_SUCCESS;
-	}
-
-	/* Note time this run completed. */
-	slot->last_run = ut_time_monotonic();
-
-	return(error);
-}
 /*********************************************************************//**
 Run OPTIMIZE on the given table.
 @return DB_SUCCESS if all OK */
@@ -2701,7 +2694,10 @@ fts_optimize_new_table(
 }
 
 /**********************************************************************//**
-Remove the table from the vector if it exists. */
+Remove the table from the vector if it exists, and signal the producer of
+the message. If worker threads are still busy with the table, the removal
+is completed by fts_optimize_finish_job().
+@return TRUE if the table was removed */
 static
 ibool
 fts_optimize_del_table(
@@ -2720,6 +2716,13 @@ fts_optimize_del_table(
 		if (slot->state != FTS_STATE_EMPTY
 		    && slot->table == table) {
 
+			if (slot->n_jobs > 0) {
+				ut_ad(slot->del_event == NULL);
+				slot->del_event = msg->event;
+
+				return(FALSE);
+			}
+
 			if (fts_enable_diag_print) {
 				ib::info() << "FTS Optimize Removing table "
 					<< table->name;
@@ -2728,13 +2731,169 @@ fts_optimize_del_table(
 			slot->table = NULL;
 			slot->state = FTS_STATE_EMPTY;
 
+			os_event_set(msg->event);
+
 			return(TRUE);
 		}
 	}
 
+	os_event_set(msg->event);
+
 	return(FALSE);
 }
 
+/** Hand a table over to the worker threads for optimization, unless it
+was optimized recently or does not have enough deleted documents.
+@param[in,out]	slot	table to optimize
+@param[in]	pos	position of slot in fts_slots
+@return true if an optimize job was started */
+static
+bool
+fts_optimize_start_job(
+	fts_slot_t*	slot,
+	ulint		pos)
+{
+	dict_table_t*	table = slot->table;
+	fts_t*		fts = table->fts;
+
+	/* Avoid optimizing tables that were optimized recently. */
+	if (slot->last_run > 0
+	    && (ut_time_monotonic() - slot->last_run) < slot->interval_time) {
+
+	} else if (fts && fts->cache
+		   && fts->cache->deleted >= FTS_OPTIMIZE_THRESHOLD) {
+
+		fts_msg_t*	msg;
+		fts_msg_job_t*	job;
+
+		msg = fts_optimize_create_msg(FTS_MSG_OPTIMIZE_TABLE, NULL);
+
+		job = static_cast<fts_msg_job_t*>(
+			mem_heap_alloc(msg->heap, sizeof(*job)));
+
+		job->pos = pos;
+		job->table = table;
+		job->table_id = slot->table_id;
+		job->error = DB_SUCCESS;
+		msg->ptr = job;
+
+		++slot->n_jobs;
+
+		ib_wqueue_add(fts_optimize_worker_wq, msg, msg->heap);
+
+		return(true);
+	}
+
+	/* Note time this run completed. */
+	slot->last_run = ut_time_monotonic();
+
+	return(false);
+}
+
+/** Hand a table over to the worker threads for a sync of its cache.
+@param[in,out]	tables		registered tables
+@param[in]	table_id	table to sync
+@return true if a sync job was started */
+static
+bool
+fts_optimize_start_sync(
+	ib_vector_t*	tables,
+	table_id_t	table_id)
+{
+	ulint		pos = ULINT_UNDEFINED;
+	fts_msg_t*	msg;
+	fts_msg_job_t*	job;
+
+	for (ulint i = 0; i < ib_vector_size(tables); ++i) {
+		fts_slot_t*	slot;
+
+		slot = static_cast<fts_slot_t*>(ib_vector_get(tables, i));
+
+		if (slot->state == FTS_STATE_EMPTY
+		    || slot->table_id != table_id) {
+			continue;
+		}
+
+		if (slot->del_event != NULL) {
+			/* The table is being removed. */
+			return(false);
+		}
+
+		++slot->n_jobs;
+		pos = i;
+		break;
+	}
+
+	msg = fts_optimize_create_msg(FTS_MSG_SYNC_TABLE, NULL);
+
+	job = static_cast<fts_msg_job_t*>(
+		mem_heap_alloc(msg->heap, sizeof(*job)));
+
+	job->pos = pos;
+	job->table = NULL;
+	job->table_id = table_id;
+	job->error = DB_SUCCESS;
+	msg->ptr = job;
+
+	ib_wqueue_add(fts_optimize_worker_wq, msg, msg->heap);
+
+	return(true);
+}
+
+/** Note that a worker thread finished a job, and complete the removal
+of its table if that was waiting for the job.
+@param[in,out]	tables	registered tables
+@param[in]	job	finished job, or NULL if a worker thread stopped
+@return true if the table was removed */
+static
+bool
+fts_optimize_finish_job(
+	ib_vector_t*		tables,
+	const fts_msg_job_t*	job)
+{
+	fts_slot_t*	slot;
+
+	if (job == NULL || job->pos == ULINT_UNDEFINED) {
+		return(false);
+	}
+
+	slot = static_cast<fts_slot_t*>(ib_vector_get(tables, job->pos));
+
+	ut_a(slot->n_jobs > 0);
+	ut_ad(slot->table_id == job->table_id);
+
+	--slot->n_jobs;
+
+	if (job->table != NULL) {
+		if (job->error == DB_SUCCESS) {
+			slot->state = FTS_STATE_DONE;
+			slot->completed = ut_time_monotonic();
+		}
+
+		/* Note time this run completed. */
+		slot->last_run = ut_time_monotonic();
+	}
+
+	if (slot->n_jobs > 0 || slot->del_event == NULL) {
+		return(false);
+	}
+
+	if (fts_enable_diag_print) {
+		ib::info() << "FTS Optimize Removing table "
+			<< slot->table->name;
+	}
+
+	os_event_t	event = slot->del_event;
+
+	slot->table = NULL;
+	slot->state = FTS_STATE_EMPTY;
+	slot->del_event = NULL;
+
+	os_event_set(event);
+
+	return(true);
+}
+
 /**********************************************************************//**
 Calculate how many of the registered tables need to be optimized.
 @return no. of tables to optimize */
@@ -2758,6 +2917,11 @@ fts_optimize_how_many(
 		slot = static_cast<const fts_slot_t*>(
 			ib_vector_get_const(tables, i));
 
+		/* Skip slots that the worker threads are busy with. */
+		if (slot->n_jobs > 0) {
+			continue;
+		}
+
 		switch (slot->state) {
 		case FTS_STATE_DONE:
 		case FTS_STATE_LOADED:
@@ -2822,13 +2986,11 @@ fts_is_sync_needed(
 		    && slot->table->fts && slot->table->fts->cache) {
 			total_memory += slot->table->fts->cache->total_size;
 		}
-
-		if (total_memory > fts_max_total_cache_size) {
-			return(true);
-		}
 	}
 
-	return(false);
+	MONITOR_SET(MONITOR_FTS_CACHE_SIZE, total_memory);
+
+	return(total_memory > fts_max_total_cache_size);
 }
 
 /** Sync fts cache of a table
@@ -2850,8 +3012,74 @@ fts_optimize_sync_table(
 	}
 }
 
+/** Run the optimize and sync jobs that fts_optimize_thread() hands out.
+@param[in]	arg	work queue of the worker threads
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(fts_optimize_worker)(
+	void*	arg)
+{
+	ib_wqueue_t*	wq = static_cast<ib_wqueue_t*>(arg);
+	bool		done = false;
+
+	ut_ad(!srv_read_only_mode);
+	my_thread_init();
+
+	while (!done) {
+		fts_msg_t*	msg;
+		fts_msg_job_t*	job;
+
+		msg = static_cast<fts_msg_t*>(ib_wqueue_wait(wq));
+		job = static_cast<fts_msg_job_t*>(msg->ptr);
+
+		switch (msg->type) {
+		case FTS_MSG_STOP:
+			done = true;
+			break;
+
+		case FTS_MSG_OPTIMIZE_TABLE: {
+			uint64_t	start_time = ut_time_monotonic_us();
+
+			job->error = fts_optimize_table(job->table);
+
+			MONITOR_INC(MONITOR_FTS_OPTIMIZE);
+			MONITOR_INC_TIME_IN_MICRO_SECS(
+				MONITOR_FTS_OPTIMIZE_MICROSECOND, start_time);
+			break;
+		}
+
+		case FTS_MSG_SYNC_TABLE:
+			DBUG_EXECUTE_IF("fts_instrument_msg_sync_sleep",
+				os_thread_sleep(300000);
+			);
+
+			fts_optimize_sync_table(job->table_id);
+			break;
+
+		default:
+			ut_error;
+		}
+
+		/* Hand the message back to the optimize thread, which
+		frees it. */
+		msg->type = FTS_MSG_JOB_DONE;
+		ib_wqueue_add(fts_optimize_wq, msg, msg->heap);
+	}
+
+	my_thread_end();
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /**********************************************************************//**
-Optimize all FTS tables.
+Optimize all FTS tables. The tables are optimized and synced by
+fts_optimize_threads worker threads, this thread processes the messages
+and hands out the jobs.
 @return Dummy return */
 os_thread_ret_t
 fts_optimize_thread(
@@ -2862,6 +3090,7 @@ fts_optimize_thread(
 	ibool		done = FALSE;
 	ulint		n_tables = 0;
 	ulint		n_optimize = 0;
+	ulint		n_jobs = 0;
 	ib_wqueue_t*	wq = (ib_wqueue_t*) arg;
 
 	ut_ad(!srv_read_only_mode);
@@ -2874,13 +3103,15 @@ fts_optimize_thread(
 
 	while (!done && srv_shutdown_state == SRV_SHUTDOWN_NONE) {
 
-		/* If there is no message in the queue and we have tables
-		to optimize then optimize the tables. */
+		/* If there is no message in the queue, we have tables
+		to optimize and an idle worker thread, then hand out
+		the next table. */
 
 		if (!done
 		    && ib_wqueue_is_empty(wq)
 		    && n_tables > 0
-		    && n_optimize > 0) {
+		    && n_optimize > 0
+		    && n_jobs < fts_optimize_threads) {
 
 			fts_slot_t*	slot;
 
@@ -2889,12 +3120,16 @@ fts_optimize_thread(
 			slot = static_cast<fts_slot_t*>(
 				ib_vector_get(fts_slots, current));
 
-			/* Handle the case of empty slots. */
-			if (slot->state != FTS_STATE_EMPTY) {
+			/* Handle the case of empty slots, and of tables
+			that the worker threads are busy with. */
+			if (slot->state != FTS_STATE_EMPTY
+			    && slot->n_jobs == 0) {
 
 				slot->state = FTS_STATE_RUNNING;
 
-				fts_optimize_table_bk(slot);
+				if (fts_optimize_start_job(slot, current)) {
+					++n_jobs;
+				}
 			}
 
 			++current;
@@ -2906,7 +3141,7 @@ fts_optimize_thread(
 				current = 0;
 			}
 
-		} else if (n_optimize == 0 || !ib_wqueue_is_empty(wq)) {
+		} else {
 			fts_msg_t*	msg;
 
 			msg = static_cast<fts_msg_t*>(
@@ -2936,23 +3171,31 @@ fts_optimize_thread(
 				break;
 
 			case FTS_MSG_DEL_TABLE:
+				/* This signals the producer once the
+				table has been removed. */
 				if (fts_optimize_del_table(
 					fts_slots, static_cast<fts_msg_del_t*>(msg->ptr))) {
 					--n_tables;
 				}
-
-				/* Signal the producer that we have
-				removed the table. */
-				os_event_set(((fts_msg_del_t*) msg->ptr)->event);
 				break;
 
 			case FTS_MSG_SYNC_TABLE:
-				DBUG_EXECUTE_IF("fts_instrument_msg_sync_sleep",
-					os_thread_sleep(300000);
-				);
+				if (fts_optimize_start_sync(
+					fts_slots,
+					*static_cast<table_id_t*>(msg->ptr))) {
+					++n_jobs;
+				}
+				break;
 
-				fts_optimize_sync_table(
-					*static_cast<table_id_t*>(msg->ptr));
+			case FTS_MSG_JOB_DONE:
+				ut_a(n_jobs > 0);
+				--n_jobs;
+
+				if (fts_optimize_finish_job(
+					fts_slots,
+					static_cast<fts_msg_job_t*>(msg->ptr))) {
+					--n_tables;
+				}
 				break;
 
 			default:
@@ -2980,12 +3223,54 @@ fts_optimize_thread(
 			slot = static_cast<fts_slot_t*>(
 				ib_vector_get(fts_slots, i));
 
-			if (slot->state != FTS_STATE_EMPTY) {
-				fts_optimize_sync_table(slot->table_id);
+			if (slot->state != FTS_STATE_EMPTY
+			    && fts_optimize_start_sync(
+				    fts_slots, slot->table_id)) {
+				++n_jobs;
 			}
 		}
 	}
 
+	/* The worker threads stop after the jobs queued before. */
+	for (ulint i = 0; i < fts_optimize_threads; ++i) {
+		fts_msg_t*	msg;
+
+		msg = fts_optimize_create_msg(FTS_MSG_STOP, NULL);
+
+		ib_wqueue_add(fts_optimize_worker_wq, msg, msg->heap);
+
+		++n_jobs;
+	}
+
+	while (n_jobs > 0) {
+		fts_msg_t*	msg;
+
+		msg = static_cast<fts_msg_t*>(ib_wqueue_wait(wq));
+
+		switch (msg->type) {
+		case FTS_MSG_JOB_DONE:
+			--n_jobs;
+			fts_optimize_finish_job(
+				fts_slots,
+				static_cast<fts_msg_job_t*>(msg->ptr));
+			break;
+
+		case FTS_MSG_DEL_TABLE:
+			fts_optimize_del_table(
+				fts_slots, static_cast<fts_msg_del_t*>(msg->ptr));
+			break;
+
+		default:
+			/* Ignore any other message, we are exiting. */
+			break;
+		}
+
+		mem_heap_free(msg->heap);
+	}
+
+	ib_wqueue_free(fts_optimize_worker_wq);
+	fts_optimize_worker_wq = NULL;
+
 	ib_vector_free(fts_slots);
 
 	ib::info() << "FTS optimize thread exiting.";
@@ -3019,6 +3304,9 @@ fts_optimize_init(void)
 	fts_optimize_wq = ib_wqueue_create();
 	ut_a(fts_optimize_wq != NULL);
 
+	fts_optimize_worker_wq = ib_wqueue_create();
+	ut_a(fts_optimize_worker_wq != NULL);
+
 	/* Create FTS vector to store fts_slot_t */
 	heap = mem_heap_create(sizeof(dict_table_t*) * 64);
 	heap_alloc = ib_heap_allocator_create(heap);
@@ -3054,6 +3342,11 @@ fts_optimize_init(void)
 	fts_opt_shutdown_event = os_event_create(0);
 	last_check_sync_time = ut_time_monotonic();
 
+	for (ulint i = 0; i < fts_optimize_threads; ++i) {
+		os_thread_create(fts_optimize_worker, fts_optimize_worker_wq,
+				 NULL);
+	}
+
 	os_thread_create(fts_optimize_thread, fts_optimize_wq, NULL);
 }
 
@@ -3285,16 +3285,23 @@ fts_query_filter_doc_ids(
 		}
 
 		/* Unpack the positions within the document. */
-		while (*ptr) {
-			last_pos += fts_decode_vlc(&ptr);
+		if (query->collect_positions) {
+			while (*ptr) {
+				last_pos += fts_decode_vlc(&ptr);
 
-			/* Collect the matching word positions, for phrase
-			matching later. */
-			if (query->collect_positions) {
+				/* Collect the matching word positions, for
+				phrase matching later. */
 				ib_vector_push(match->positions, &last_pos);
+
+				++freq;
 			}
 
-			++freq;
+			/* Skip the end of word position marker. */
+			++ptr;
+		} else {
+			/* Only the number of positions is needed. */
+			freq = fts_skip_positions(
+				&ptr, static_cast<byte*>(data) + len);
 		}
 
 		/* End of list marker. */
@@ -3314,9 +3321,6 @@ fts_query_filter_doc_ids(
 			doc_freq->freq = freq;
 		}
 
-		/* Skip the end of word position marker. */
-		++ptr;
-
 		/* Bytes decoded so far */
 		decoded = ptr - (byte*) data;
 
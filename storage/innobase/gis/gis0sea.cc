@@ -594,7 +594,7 @@ rtr_pcur_open_low(
 	}
 
 	btr_cur_search_to_nth_level(index, level, tuple, mode, latch_mode,
-				    btr_cursor, 0, file, line, mtr);
+				    btr_cursor, file, line, mtr);
 	cursor->pos_state = BTR_PCUR_IS_POSITIONED;
 
 	cursor->trx_if_known = NULL;
@@ -887,7 +887,7 @@ rtr_get_father_node(
 		/* root split, and search the new root */
 		btr_cur_search_to_nth_level(
 			index, level, tuple, PAGE_CUR_RTREE_LOCATE,
-			BTR_CONT_MODIFY_TREE, btr_cur, 0,
+			BTR_CONT_MODIFY_TREE, btr_cur,
 			__FILE__, __LINE__, mtr);
 
 	} else {
@@ -897,7 +897,7 @@ rtr_get_father_node(
 
 		btr_cur_search_to_nth_level(
 			index, level, tuple, PAGE_CUR_RTREE_LOCATE,
-			BTR_CONT_MODIFY_TREE, btr_cur, 0,
+			BTR_CONT_MODIFY_TREE, btr_cur,
 			__FILE__, __LINE__, mtr);
 
 		rec = btr_cur_get_rec(btr_cur);
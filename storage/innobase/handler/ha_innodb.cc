@@ -291,6 +291,38 @@ static TYPELIB innodb_checksum_algorithm_typelib = {
 	NULL
 };
 
+/** Possible values of the parameter innodb_compression_codec */
+static const char* innodb_compression_codec_names[] = {
+	"zlib",
+	"lz4",
+	NullS
+};
+
+/** Used to define an enumerate type of the system variable
+innodb_compression_codec. */
+static TYPELIB innodb_compression_codec_typelib = {
+	array_elements(innodb_compression_codec_names) - 1,
+	"innodb_compression_codec_typelib",
+	innodb_compression_codec_names,
+	NULL
+};
+
+/** Possible values of the parameter innodb_buffer_pool_lru_policy */
+static const char* innodb_buffer_pool_lru_policy_names[] = {
+	"midpoint",
+	"2q",
+	NullS
+};
+
+/** Used to define an enumerate type of the system variable
+innodb_buffer_pool_lru_policy. */
+static TYPELIB innodb_buffer_pool_lru_policy_typelib = {
+	array_elements(innodb_buffer_pool_lru_policy_names) - 1,
+	"innodb_buffer_pool_lru_policy_typelib",
+	innodb_buffer_pool_lru_policy_names,
+	NULL
+};
+
 /** Possible values for system variable "innodb_default_row_format". */
 static const char* innodb_default_row_format_names[] = {
 	"redundant",
@@ -451,6 +483,8 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_KEY(sync_array_mutex),
 	PSI_KEY(zip_pad_mutex),
 	PSI_KEY(row_drop_list_mutex),
+	PSI_KEY(row_merge_mutex),
+	PSI_KEY(row_pread_mutex),
 	PSI_KEY(master_key_id_mutex),
 	PSI_KEY(analyze_index_mutex),
 };
@@ -462,6 +496,7 @@ performance schema instrumented if "UNIV_PFS_RWLOCK"
 is defined */
 static PSI_rwlock_info all_innodb_rwlocks[] = {
 	PSI_RWLOCK_KEY(btr_search_latch),
+	PSI_RWLOCK_KEY(btr_search_page_latch),
 #  ifndef PFS_SKIP_BUFFER_MUTEX_RWLOCK
 	PSI_RWLOCK_KEY(buf_block_lock),
 #  endif /* !PFS_SKIP_BUFFER_MUTEX_RWLOCK */
@@ -471,6 +506,7 @@ static PSI_rwlock_info all_innodb_rwlocks[] = {
 	PSI_RWLOCK_KEY(dict_operation_lock),
 	PSI_RWLOCK_KEY(fil_space_latch),
 	PSI_RWLOCK_KEY(checkpoint_lock),
+	PSI_RWLOCK_KEY(lock_sys_latch),
 	PSI_RWLOCK_KEY(fts_cache_rw_lock),
 	PSI_RWLOCK_KEY(fts_cache_init_rw_lock),
 	PSI_RWLOCK_KEY(trx_i_s_cache_lock),
@@ -488,13 +524,17 @@ performance schema instrumented if "UNIV_PFS_THREAD"
 is defined */
 static PSI_thread_info	all_innodb_threads[] = {
 	PSI_KEY(buf_dump_thread),
+	PSI_KEY(buf_lru_manager_thread),
 	PSI_KEY(dict_stats_thread),
 	PSI_KEY(io_handler_thread),
 	PSI_KEY(io_ibuf_thread),
 	PSI_KEY(io_log_thread),
 	PSI_KEY(io_read_thread),
 	PSI_KEY(io_write_thread),
+	PSI_KEY(log_flusher_thread),
+	PSI_KEY(log_writer_thread),
 	PSI_KEY(page_cleaner_thread),
+	PSI_KEY(recv_apply_thread),
 	PSI_KEY(recv_writer_thread),
 	PSI_KEY(srv_error_monitor_thread),
 	PSI_KEY(srv_lock_timeout_thread),
@@ -2853,6 +2893,9 @@ ha_innobase::ha_innobase(
 			  | HA_CAN_FULLTEXT_EXT
 			  | HA_CAN_FULLTEXT_HINTS
 #ifdef WL6742
+			  /* Removing WL6742 as part of Bug#23046302: the
+			  optimizer would count the records of the whole
+			  table in EXPLAIN and in ALTER TABLE. */
 			  | HA_HAS_RECORDS
 #endif
 			  | HA_CAN_EXPORT
@@ -6641,8 +6684,7 @@ innobase_mysql_fts_get_token(
 
 		int	ctype;
 
-		mbl = cs->cset->ctype(
-			cs, &ctype, doc, (const uchar*) end);
+		mbl = fts_get_ctype(cs, &ctype, doc, end);
 
 		if (true_word_char(ctype, *doc)) {
 			break;
@@ -6660,8 +6702,7 @@ innobase_mysql_fts_get_token(
 
 		int	ctype;
 
-		mbl = cs->cset->ctype(
-			cs, &ctype, (uchar*) doc, (uchar*) end);
+		mbl = fts_get_ctype(cs, &ctype, doc, end);
 		if (true_word_char(ctype, *doc)) {
 			mwc = 0;
 		} else if (!misc_word_char(*doc) || mwc) {
@@ -13455,14 +13496,11 @@ ha_innobase::rename_table(
 
 
 
-#ifdef WL6742
-
 /*********************************************************************//**
-
-Removing WL6742  as part of Bug23046302
-
 Returns the exact number of records that this client can see using this
-handler object.
+handler object. HA_HAS_RECORDS is not set, so that the optimizer does not
+call this; only the callers of handler::ha_records() which need an exact
+count do.
 @return Error code in case something goes wrong.
 These errors will abort the current query:
       case HA_ERR_LOCK_DEADLOCK:
@@ -13567,7 +13605,6 @@ ha_innobase::records(
 	*num_rows= n_rows;
 	DBUG_RETURN(0);
 }
-#endif
 
 /*********************************************************************//**
 Estimates the number of index records in a range.
@@ -13708,6 +13745,59 @@ func_exit:
 	DBUG_RETURN((ha_rows) n_rows);
 }
 
+/** Estimate the fraction of the rows where a column compares true with a
+constant, from the histogram of the column.
+@param[in]	field	column of the table
+@param[in]	op	comparison, with the column as the left operand
+@param[in]	value	constant that the column is compared with
+@return fraction of the rows, or a negative value if the column has no
+histogram */
+
+double
+ha_innobase::column_filter(
+	const Field*		field,
+	ha_column_filter_op	op,
+	double			value)
+{
+	dict_hist_op_t	hist_op;
+
+	if (innobase_is_v_fld(field)) {
+		return(-1.0);
+	}
+
+	switch (op) {
+	case HA_COLUMN_FILTER_EQ:
+		hist_op = DICT_HIST_EQ;
+		break;
+	case HA_COLUMN_FILTER_LT:
+		hist_op = DICT_HIST_LT;
+		break;
+	case HA_COLUMN_FILTER_LE:
+		hist_op = DICT_HIST_LE;
+		break;
+	case HA_COLUMN_FILTER_GT:
+		hist_op = DICT_HIST_GT;
+		break;
+	case HA_COLUMN_FILTER_GE:
+		hist_op = DICT_HIST_GE;
+		break;
+	default:
+		return(-1.0);
+	}
+
+	/* Virtual columns are not counted in dict_col_t::ind. */
+	ulint	col_no = 0;
+
+	for (uint i = 0; i < field->field_index; i++) {
+		if (!innobase_is_v_fld(table->field[i])) {
+			col_no++;
+		}
+	}
+
+	return(dict_stats_hist_filter(m_prebuilt->table, col_no, hist_op,
+				      value));
+}
+
 /*********************************************************************//**
 Gives an UPPER BOUND to the number of rows in a table. This is used in
 filesort.cc.
@@ -14773,7 +14863,7 @@ ha_innobase::check(
 			ret = row_count_rtree_recs(m_prebuilt, &n_rows);
 		} else {
 			ret = row_scan_index_for_mysql(
-				m_prebuilt, index, &n_rows);
+				m_prebuilt, index, true, &n_rows);
 		}
 
 		DBUG_EXECUTE_IF(
@@ -14787,6 +14877,9 @@ ha_innobase::check(
 			during shutdown */
 			break;
 		}
+
+		DEBUG_SYNC(m_user_thd, "ha_innobase_check_index_scanned");
+
 		if (ret != DB_SUCCESS) {
 			/* Assume some kind of corruption. */
 			push_warning_printf(
@@ -17993,6 +18086,23 @@ innodb_old_blocks_pct_update(
 			*static_cast<const uint*>(save), TRUE));
 }
 
+/** Update the system variable innodb_buffer_pool_lru_policy.
+@param[in]	thd	thread handle
+@param[in]	var	pointer to system variable
+@param[out]	var_ptr	where the formal string goes
+@param[in]	save	immediate result from check function */
+static
+void
+innodb_buffer_pool_lru_policy_update(
+	THD*				thd,
+	struct st_mysql_sys_var*	var,
+	void*				var_ptr,
+	const void*			save)
+{
+	srv_buf_pool_LRU_policy = *static_cast<const ulong*>(save);
+	buf_LRU_policy_set(srv_buf_pool_LRU_policy);
+}
+
 /****************************************************************//**
 Update the system variable innodb_old_blocks_pct using the "saved"
 value. This function is registered as a callback with MySQL. */
@@ -19585,6 +19695,12 @@ static MYSQL_SYSVAR_ULONG(flush_log_at_trx_commit, srv_flush_log_at_trx_commit,
   " or 2 (write at commit, flush once per second).",
   NULL, NULL, 1, 0, 2, 0);
 
+static MYSQL_SYSVAR_BOOL(commit_wait_dependencies, srv_commit_wait_dependencies,
+  PLUGIN_VAR_OPCMDARG,
+  "Make the commit of a transaction that wrote no redo log wait until the"
+  " commits whose changes it may have read are durable (off by default).",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_STR(flush_method, innobase_file_flush_method,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "With which method to flush data.", NULL, NULL, NULL);
@@ -19615,6 +19731,12 @@ static MYSQL_SYSVAR_ULONG(page_cleaners, srv_n_page_cleaners,
   "Page cleaner threads can be from 1 to 64. Default is 4.",
   NULL, NULL, 4, 1, 64, 0);
 
+static MYSQL_SYSVAR_ULONG(recovery_apply_threads, srv_n_recv_apply_threads,
+  PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
+  "Number of threads applying redo log records to the pages during crash"
+  " recovery, from 1 to 64. Default is 4.",
+  NULL, NULL, 4, 1, 64, 0);
+
 static MYSQL_SYSVAR_DOUBLE(max_dirty_pages_pct, srv_max_buf_pool_modified_pct,
   PLUGIN_VAR_RQCMDARG,
   "Percentage of dirty pages allowed in bufferpool.",
@@ -19710,6 +19832,14 @@ static MYSQL_SYSVAR_ULONGLONG(stats_persistent_sample_pages,
   " statistics (by ANALYZE, default 20)",
   NULL, NULL, 20, 1, ~0ULL, 0);
 
+static MYSQL_SYSVAR_ULONG(stats_histogram_buckets,
+  srv_stats_histogram_buckets,
+  PLUGIN_VAR_RQCMDARG,
+  "The number of buckets of the histograms of the integer columns that are"
+  " built together with the persistent statistics (by ANALYZE), 0 disables"
+  " the histograms (default 0)",
+  NULL, NULL, 0, 0, DICT_HIST_MAX_BUCKETS, 0);
+
 static MYSQL_SYSVAR_BOOL(adaptive_hash_index, btr_search_enabled,
   PLUGIN_VAR_OPCMDARG,
   "Enable InnoDB adaptive hash index (enabled by default). "
@@ -19736,6 +19866,14 @@ static MYSQL_SYSVAR_UINT(compression_level, page_zip_level,
   ", 1 is fastest, 9 is best compression and default is 6.",
   NULL, NULL, DEFAULT_COMPRESSION_LEVEL, 0, 9, 0);
 
+static MYSQL_SYSVAR_ENUM(compression_codec, page_zip_codec,
+  PLUGIN_VAR_RQCMDARG,
+  "Codec used for compressing the pages of compressed row format tables."
+  " zlib uses innodb_compression_level; lz4 compresses faster, and pages"
+  " that do not fit with lz4 are compressed with zlib."
+  " Pages compressed with any codec can be read.",
+  NULL, NULL, PAGE_ZIP_CODEC_ZLIB, &innodb_compression_codec_typelib);
+
 static MYSQL_SYSVAR_BOOL(log_compressed_pages, page_zip_log_pages,
        PLUGIN_VAR_OPCMDARG,
   "Enables/disables the logging of entire compressed page images."
@@ -19854,6 +19992,13 @@ static MYSQL_SYSVAR_ULONG(lru_scan_depth, srv_LRU_scan_depth,
   "How deep to scan LRU to keep it clean",
   NULL, NULL, 1024, 100, ~0UL, 0);
 
+static MYSQL_SYSVAR_BOOL(lru_manager_threads, srv_lru_manager_threads,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Whether a dedicated thread for each buffer pool instance keeps"
+  " innodb_LRU_scan_depth free pages by flushing the tail of the LRU list,"
+  " independently of the page cleaner threads.",
+  NULL, NULL, TRUE);
+
 static MYSQL_SYSVAR_ULONG(flush_neighbors, srv_flush_neighbors,
   PLUGIN_VAR_OPCMDARG,
   "Set to 0 (don't flush neighbors from buffer pool),"
@@ -19930,6 +20075,11 @@ static MYSQL_SYSVAR_ULONG(ft_num_word_optimize, fts_num_word_optimize,
   "InnoDB Fulltext search number of words to optimize for each optimize table call ",
   NULL, NULL, 2000, 1000, 10000, 0);
 
+static MYSQL_SYSVAR_ULONG(ft_optimize_threads, fts_optimize_threads,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of InnoDB Fulltext search threads that optimize and sync tables in the background",
+  NULL, NULL, 2, 1, 16, 0);
+
 static MYSQL_SYSVAR_ULONG(ft_sort_pll_degree, fts_sort_pll_degree,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "InnoDB Fulltext search parallel sort degree, will round up to nearest power of 2 number",
@@ -19940,6 +20090,19 @@ static MYSQL_SYSVAR_ULONG(sort_buffer_size, srv_sort_buf_size,
   "Memory buffer size for index creation",
   NULL, NULL, 1048576, 65536, 64<<20, 0);
 
+static MYSQL_SYSVAR_ULONG(ddl_threads, srv_ddl_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that scan the clustered index, merge sort and load"
+  " the new indexes in index creation, each using up to"
+  " innodb_sort_buffer_size memory per index. 1 disables parallelism.",
+  NULL, NULL, 4, 1, 64, 0);
+
+static MYSQL_SYSVAR_ULONG(parallel_read_threads, srv_parallel_read_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that scan the clustered index in CHECK TABLE."
+  " 1 disables parallelism.",
+  NULL, NULL, 4, 1, 64, 0);
+
 static MYSQL_SYSVAR_ULONGLONG(online_alter_log_max_size, srv_online_max_size,
   PLUGIN_VAR_RQCMDARG,
   "Maximum modification log file size for online index creation",
@@ -20000,6 +20163,26 @@ static MYSQL_SYSVAR_ULONG(log_write_ahead_size, srv_log_write_ahead_size,
   NULL, innodb_log_write_ahead_size_update,
   8*1024L, OS_FILE_LOG_BLOCK_SIZE, UNIV_PAGE_SIZE_DEF, OS_FILE_LOG_BLOCK_SIZE);
 
+static MYSQL_SYSVAR_BOOL(log_writer_threads, srv_log_writer_threads,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Whether dedicated threads write and flush the redo log, while the"
+  " committing threads wait for their notification.",
+  NULL, NULL, TRUE);
+
+static MYSQL_SYSVAR_ULONG(log_wait_for_flush_spin_hwm,
+  srv_log_wait_for_flush_spin_hwm,
+  PLUGIN_VAR_RQCMDARG,
+  "Threads waiting for a redo log write or flush spin for at most this"
+  " many microseconds, and only while the average write or flush time"
+  " is not above it. 0 disables spinning.",
+  NULL, NULL, 400, 0, 1000000, 0);
+
+static MYSQL_SYSVAR_ULONG(log_events, srv_log_events,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of events which the threads waiting for a redo log write or"
+  " flush are spread over (rounded up to a power of 2).",
+  NULL, NULL, 2048, 1, 1024 * 1024, 0);
+
 static MYSQL_SYSVAR_UINT(old_blocks_pct, innobase_old_blocks_pct,
   PLUGIN_VAR_RQCMDARG,
   "Percentage of the buffer pool to reserve for 'old' blocks.",
@@ -20012,6 +20195,16 @@ static MYSQL_SYSVAR_UINT(old_blocks_time, buf_LRU_old_threshold_ms,
   " The timeout is disabled if 0.",
   NULL, NULL, 1000, 0, UINT_MAX32, 0);
 
+static MYSQL_SYSVAR_ENUM(buffer_pool_lru_policy, srv_buf_pool_LRU_policy,
+  PLUGIN_VAR_RQCMDARG,
+  "Replacement policy of the buffer pool LRU lists."
+  " midpoint inserts pages at the head of the 'old' blocks and moves them"
+  " to the 'new' blocks as innodb_old_blocks_time says;"
+  " 2q moves pages to the 'new' blocks only when they are read again soon"
+  " after being evicted, which resists large scans.",
+  NULL, innodb_buffer_pool_lru_policy_update, BUF_LRU_POLICY_MIDPOINT,
+  &innodb_buffer_pool_lru_policy_typelib);
+
 static MYSQL_SYSVAR_LONG(open_files, innobase_open_files,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "How many files at the maximum InnoDB keeps open at the same time.",
@@ -20131,6 +20324,11 @@ static MYSQL_SYSVAR_BOOL(use_native_aio, srv_use_native_aio,
   "Use native AIO if supported on this platform.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(use_io_uring, srv_use_io_uring,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Use io_uring for native AIO on Linux if supported by the kernel.",
+  NULL, NULL, FALSE);
+
 #ifdef HAVE_LIBNUMA
 static MYSQL_SYSVAR_BOOL(numa_interleave, srv_numa_interleave,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
@@ -20220,6 +20418,12 @@ static MYSQL_SYSVAR_ULONG(read_ahead_threshold, srv_read_ahead_threshold,
   " trigger a readahead.",
   NULL, NULL, 56, 0, 64, 0);
 
+static MYSQL_SYSVAR_ULONG(fetch_cache_size, srv_fetch_cache_size,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum number of bytes of rows that a scan may prefetch in one batch."
+  " The batches of a long scan grow up to this size.",
+  NULL, NULL, 1024 * 1024, 0, 64 * 1024 * 1024, 0);
+
 static MYSQL_SYSVAR_STR(monitor_enable, innobase_enable_monitor_counter,
   PLUGIN_VAR_RQCMDARG,
   "Turn on a monitor counter",
@@ -20365,13 +20569,16 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(buffer_pool_load_abort),
   MYSQL_SYSVAR(buffer_pool_load_at_startup),
   MYSQL_SYSVAR(lru_scan_depth),
+  MYSQL_SYSVAR(lru_manager_threads),
   MYSQL_SYSVAR(flush_neighbors),
   MYSQL_SYSVAR(checksum_algorithm),
   MYSQL_SYSVAR(log_checksums),
   MYSQL_SYSVAR(checksums),
   MYSQL_SYSVAR(commit_concurrency),
+  MYSQL_SYSVAR(commit_wait_dependencies),
   MYSQL_SYSVAR(concurrency_tickets),
   MYSQL_SYSVAR(compression_level),
+  MYSQL_SYSVAR(compression_codec),
   MYSQL_SYSVAR(data_file_path),
   MYSQL_SYSVAR(temp_data_file_path),
   MYSQL_SYSVAR(data_home_dir),
@@ -20402,6 +20609,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(ft_max_token_size),
   MYSQL_SYSVAR(ft_min_token_size),
   MYSQL_SYSVAR(ft_num_word_optimize),
+  MYSQL_SYSVAR(ft_optimize_threads),
   MYSQL_SYSVAR(ft_sort_pll_degree),
   MYSQL_SYSVAR(large_prefix),
   MYSQL_SYSVAR(force_load_corrupted),
@@ -20413,6 +20621,9 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(log_file_size),
   MYSQL_SYSVAR(log_files_in_group),
   MYSQL_SYSVAR(log_write_ahead_size),
+  MYSQL_SYSVAR(log_writer_threads),
+  MYSQL_SYSVAR(log_wait_for_flush_spin_hwm),
+  MYSQL_SYSVAR(log_events),
   MYSQL_SYSVAR(log_group_home_dir),
   MYSQL_SYSVAR(log_compressed_pages),
   MYSQL_SYSVAR(max_dirty_pages_pct),
@@ -20425,6 +20636,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(max_purge_lag_delay),
   MYSQL_SYSVAR(old_blocks_pct),
   MYSQL_SYSVAR(old_blocks_time),
+  MYSQL_SYSVAR(buffer_pool_lru_policy),
   MYSQL_SYSVAR(open_files),
   MYSQL_SYSVAR(optimize_fulltext_only),
   MYSQL_SYSVAR(rollback_on_timeout),
@@ -20438,6 +20650,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(stats_transient_sample_pages),
   MYSQL_SYSVAR(stats_persistent),
   MYSQL_SYSVAR(stats_persistent_sample_pages),
+  MYSQL_SYSVAR(stats_histogram_buckets),
   MYSQL_SYSVAR(stats_auto_recalc),
   MYSQL_SYSVAR(adaptive_hash_index),
   MYSQL_SYSVAR(adaptive_hash_index_parts),
@@ -20447,6 +20660,8 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(strict_mode),
   MYSQL_SYSVAR(support_xa),
   MYSQL_SYSVAR(sort_buffer_size),
+  MYSQL_SYSVAR(ddl_threads),
+  MYSQL_SYSVAR(parallel_read_threads),
   MYSQL_SYSVAR(online_alter_log_max_size),
   MYSQL_SYSVAR(sync_spin_loops),
   MYSQL_SYSVAR(spin_wait_delay),
@@ -20458,6 +20673,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(autoinc_lock_mode),
   MYSQL_SYSVAR(version),
   MYSQL_SYSVAR(use_native_aio),
+  MYSQL_SYSVAR(use_io_uring),
 #ifdef HAVE_LIBNUMA
   MYSQL_SYSVAR(numa_interleave),
 #endif /* HAVE_LIBNUMA */
@@ -20469,10 +20685,12 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
 #endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
   MYSQL_SYSVAR(random_read_ahead),
   MYSQL_SYSVAR(read_ahead_threshold),
+  MYSQL_SYSVAR(fetch_cache_size),
   MYSQL_SYSVAR(read_only),
   MYSQL_SYSVAR(io_capacity),
   MYSQL_SYSVAR(io_capacity_max),
   MYSQL_SYSVAR(page_cleaners),
+  MYSQL_SYSVAR(recovery_apply_threads),
   MYSQL_SYSVAR(monitor_enable),
   MYSQL_SYSVAR(monitor_disable),
   MYSQL_SYSVAR(monitor_reset),
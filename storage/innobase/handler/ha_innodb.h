@@ -213,10 +213,7 @@ public:
 
 	void position(uchar *record);
 
-#ifdef WL6742
-	/* Removing WL6742 as part of Bug #23046302 */
 	virtual int records(ha_rows* num_rows);
-#endif
 	ha_rows records_in_range(
 		uint			inx,
 		key_range*		min_key,
@@ -224,6 +221,11 @@ public:
 
 	ha_rows estimate_rows_upper_bound();
 
+	double column_filter(
+		const Field*		field,
+		ha_column_filter_op	op,
+		double			value);
+
 	void update_create_info(HA_CREATE_INFO* create_info);
 
 	int create(
@@ -3225,10 +3225,6 @@ ha_innopart::truncate()
 	DBUG_RETURN(error);
 }
 
-#ifdef WL6742
-
-/* Removing Wl6742 as part of Bug#23046302 */
-
 /** Total number of rows in all used partitions.
 Returns the exact number of records that this client can see using this
 handler object.
@@ -3263,7 +3259,6 @@ ha_innopart::records(
 	}
 	DBUG_RETURN(0);
 }
-#endif
 
 /** Estimates the number of index records in a range.
 @param[in]	keynr	Index number.
@@ -375,6 +375,18 @@ public:
 	ha_rows
 	estimate_rows_upper_bound();
 
+	/** The column histograms are built for each partition and are not
+	merged for the whole table, so there are none to estimate from.
+	@return -1 */
+	double
+	column_filter(
+		const Field*		field,
+		ha_column_filter_op	op,
+		double			value)
+	{
+		return(-1.0);
+	}
+
 	uint
 	alter_table_flags(
 		uint	flags);
@@ -1237,12 +1249,9 @@ protected:
 		uchar*	record,
 		uchar*	pos);
 
-#ifdef WL6742
-	/* Removing WL6742 as part of Bug 23046302 */
 	int
 	records(
 		ha_rows*	num_rows);
-#endif
 
 	int
 	index_next(
@@ -8095,8 +8095,9 @@ commit_cache_norebuild(
 }
 
 /** Adjust the persistent statistics after non-rebuilding ALTER TABLE.
-Remove statistics for dropped indexes, add statistics for created indexes
-and rename statistics for renamed indexes.
+Remove statistics for dropped indexes, add statistics for created indexes,
+rename statistics for renamed indexes and build the column histograms
+again for renamed columns.
 @param ha_alter_info Data used during in-place alter
 @param ctx In-place ALTER TABLE context
 @param altered_table MySQL table that is being altered
@@ -8190,6 +8191,25 @@ alter_stats_norebuild(
 		}
 	}
 
+	/* The column histograms are bound to the column names. Build
+	them again for the new names. */
+	if ((ha_alter_info->handler_flags
+	     & Alter_inplace_info::ALTER_COLUMN_NAME)
+	    && ctx->new_table->stat_n_col_hist > 0) {
+		dberr_t	err = dict_stats_update(
+			ctx->new_table, DICT_STATS_RECALC_PERSISTENT);
+
+		if (err != DB_SUCCESS) {
+			push_warning_printf(
+				thd,
+				Sql_condition::SL_WARNING,
+				ER_ALTER_INFO,
+				"Error updating stats for table '%s'"
+				" after renaming columns: %s",
+				table_name, ut_strerr(err));
+		}
+	}
+
 	DBUG_VOID_RETURN;
 }
 
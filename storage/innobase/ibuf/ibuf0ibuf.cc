@@ -299,6 +299,18 @@ static ib_mutex_t	ibuf_bitmap_mutex;
 /** The area in pages from which contract looks for page numbers for merge */
 const ulint		IBUF_MERGE_AREA = 8;
 
+/** The maximum number of pages of a tablespace that a background merge
+batch reads, see ibuf_merge_pages_sweep() */
+const ulint		IBUF_SWEEP_N_PAGES = 64;
+
+/** The change buffer key (space id, page number) where the next background
+merge batch starts. The background merge sweeps through the change buffer
+tree in key order, so that each batch covers nearby pages of one
+tablespace. Only accessed by the master thread. */
+static ulint		ibuf_sweep_space;
+/** Page number of the next background merge batch, see ibuf_sweep_space */
+static ulint		ibuf_sweep_page_no;
+
 /** Inside the merge area, pages which have at most 1 per this number less
 buffered entries compared to maximum volume that can buffered for a single
 page are merged along with the page whose buffer became full */
@@ -2634,6 +2646,89 @@ ibuf_merge_space(
 	return(n_pages);
 }
 
+/** Contract the change buffer by reading the pages of the next
+tablespace area of the background merge sweep to the buffer pool. The
+buffered changes are merged to the pages when the reads complete, by the
+I/O handler threads.
+@param[out]	n_pages		number of pages to which merged
+@param[in]	sync		whether the caller waits for
+the issued reads to complete
+@return a lower limit for the combined size in bytes of entries which
+will be merged from ibuf trees to the pages read, 0 if ibuf is
+empty */
+static
+ulint
+ibuf_merge_pages_sweep(
+	ulint*		n_pages,
+	bool		sync)
+{
+	mtr_t		mtr;
+	btr_pcur_t	pcur;
+	ulint		sum_sizes = 0;
+	ulint		page_nos[IBUF_SWEEP_N_PAGES];
+	ulint		space_ids[IBUF_SWEEP_N_PAGES];
+	const ulint	limit = ut_min(IBUF_SWEEP_N_PAGES,
+				       buf_pool_get_curr_size() / 4);
+
+	*n_pages = 0;
+
+	for (;;) {
+		const bool	from_start = ibuf_sweep_space == 0
+			&& ibuf_sweep_page_no == 0;
+		mem_heap_t*	heap = mem_heap_create(512);
+		dtuple_t*	tuple = ibuf_search_tuple_build(
+			ibuf_sweep_space, ibuf_sweep_page_no, heap);
+
+		ibuf_mtr_start(&mtr);
+
+		btr_pcur_open(ibuf->index, tuple, PAGE_CUR_GE,
+			      BTR_SEARCH_LEAF, &pcur, &mtr);
+
+		mem_heap_free(heap);
+
+		const rec_t*	rec = ibuf_get_user_rec(&pcur, &mtr);
+
+		if (rec != NULL) {
+			const ulint	space = ibuf_rec_get_space(&mtr, rec);
+
+			sum_sizes = ibuf_get_merge_pages(
+				&pcur, space, limit, page_nos, space_ids,
+				n_pages, &mtr);
+
+			ut_ad(*n_pages > 0);
+
+			ibuf_sweep_space = space;
+			ibuf_sweep_page_no = page_nos[*n_pages - 1] + 1;
+		}
+
+		ibuf_mtr_commit(&mtr);
+		btr_pcur_close(&pcur);
+
+		if (rec != NULL || from_start) {
+			break;
+		}
+
+		/* The end of the change buffer was reached. Start a new
+		sweep from the beginning. */
+		ibuf_sweep_space = 0;
+		ibuf_sweep_page_no = 0;
+
+		MONITOR_INC(MONITOR_IBUF_MERGE_SWEEPS);
+	}
+
+	if (*n_pages == 0) {
+		return(0);
+	}
+
+	MONITOR_INC(MONITOR_IBUF_MERGE_BATCHES);
+	MONITOR_INC_VALUE(MONITOR_IBUF_MERGE_PAGES_SCHEDULED, *n_pages);
+	MONITOR_INC_VALUE(MONITOR_IBUF_MERGE_BYTES_SCHEDULED, sum_sizes);
+
+	buf_read_ibuf_merge_pages(sync, space_ids, page_nos, *n_pages);
+
+	return(sum_sizes + 1);
+}
+
 /** Contract the change buffer by reading pages to the buffer pool.
 @param[out]	n_pages		number of pages merged
 @param[in]	sync		whether the caller waits for
@@ -2661,7 +2756,7 @@ ibuf_merge(
 		return(0);
 #endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
 	} else {
-		return(ibuf_merge_pages(n_pages, sync));
+		return(ibuf_merge_pages_sweep(n_pages, sync));
 	}
 }
 
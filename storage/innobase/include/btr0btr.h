@@ -346,12 +346,15 @@ btr_create(
 @param[in]	page_id		root page id
 @param[in]	page_size	page size
 @param[in]	index_id	PAGE_INDEX_ID contents
+@param[in]	ahi		whether to drop the adaptive hash index
+				entries of the freed pages
 @param[in,out]	mtr		mini-transaction */
 void
 btr_free_if_exists(
 	const page_id_t&	page_id,
 	const page_size_t&	page_size,
 	index_id_t		index_id,
+	bool			ahi,
 	mtr_t*			mtr);
 
 /** Free an index tree in a temporary tablespace or during TRUNCATE TABLE.
@@ -81,14 +81,13 @@ btr_search_get_info(
 btr_search_t*
 btr_search_info_create(mem_heap_t* heap);
 
-/** Returns the value of ref_count. The value is protected by latch.
+/** Returns the value of ref_count. The value is updated with atomic
+operations.
 @param[in]	info		search info
-@param[in]	index		index identifier
 @return ref_count value. */
 ulint
 btr_search_info_get_ref_count(
-	btr_search_t*	info,
-	dict_index_t*	index);
+	const btr_search_t*	info);
 
 /*********************************************************************//**
 Updates the search info. */
@@ -107,15 +106,8 @@ both have sensible values.
 @param[in,out]	info		index search info
 @param[in]	tuple		logical record
 @param[in]	mode		PAGE_CUR_L, ....
-@param[in]	latch_mode	BTR_SEARCH_LEAF, ...;
-				NOTE that only if has_search_latch is 0, we will
-				have a latch set on the cursor page, otherwise
-				we assume the caller uses his search latch
-				to protect the record!
+@param[in]	latch_mode	BTR_SEARCH_LEAF, ...
 @param[out]	cursor		tree cursor
-@param[in]	has_search_latch
-				latch mode the caller currently has on
-				search system: RW_S/X_LATCH or 0
 @param[in]	mtr		mini transaction
 @return TRUE if succeeded */
 ibool
@@ -126,7 +118,6 @@ btr_search_guess_on_hash(
 	ulint		mode,
 	ulint		latch_mode,
 	btr_cur_t*	cursor,
-	ulint		has_search_latch,
 	mtr_t*		mtr);
 
 /** Moves or deletes hash entries for moved records. If new_page is already
@@ -144,8 +135,8 @@ btr_search_move_or_delete_hash_entries(
 	dict_index_t*	index);
 
 /** Drop any adaptive hash index entries that point to an index page.
-@param[in,out]	block	block containing index page, s- or x-latched, or an
-			index page for which we know that
+@param[in,out]	block	block containing index page, s-, sx- or x-latched,
+			or an index page for which we know that
 			block->buf_fix_count == 0 or it is an index page which
 			has already been removed from the buf_pool->page_hash
 			i.e.: it is in state BUF_BLOCK_REMOVE_HASH */
@@ -188,17 +179,23 @@ btr_search_update_hash_on_delete(btr_cur_t* cursor);
 bool
 btr_search_validate();
 
-/** X-Lock the search latch (corresponding to given index)
-@param[in]	index	index handler */
-UNIV_INLINE
-void
-btr_search_x_lock(const dict_index_t* index);
-
-/** X-Unlock the search latch (corresponding to given index)
-@param[in]	index	index handler */
-UNIV_INLINE
+/** Free an index that was removed from the dictionary cache. If pages of
+the index are still in the adaptive hash index, because its tree was freed
+without dropping them (see dict_drop_index_tree()), the index is freed
+when the last of those pages is evicted from the buffer pool or
+allocated again.
+@param[in,out]	index	index that was removed from the dictionary cache */
 void
-btr_search_x_unlock(const dict_index_t* index);
+btr_search_free_index(dict_index_t* index);
+
+/** Check if freeing the memory heap of a table that was removed from the
+dictionary cache must be deferred, because btr_search_free_index() left
+indexes of the table to the adaptive hash index. The heap is then freed
+together with the last of those indexes.
+@param[in,out]	table	table whose other resources were already freed
+@return whether the caller must not free table->heap */
+bool
+btr_search_defer_table_free(dict_table_t* table);
 
 /** Lock all search latches in exclusive mode. */
 UNIV_INLINE
@@ -210,18 +207,6 @@ UNIV_INLINE
 void
 btr_search_x_unlock_all();
 
-/** S-Lock the search latch (corresponding to given index)
-@param[in]	index	index handler */
-UNIV_INLINE
-void
-btr_search_s_lock(const dict_index_t* index);
-
-/** S-Unlock the search latch (corresponding to given index)
-@param[in]	index	index handler */
-UNIV_INLINE
-void
-btr_search_s_unlock(const dict_index_t* index);
-
 /** Lock all search latches in shared mode. */
 UNIV_INLINE
 void
@@ -250,30 +235,38 @@ UNIV_INLINE
 void
 btr_search_s_unlock_all();
 
-/** Get the latch based on index attributes.
-A latch is selected from an array of latches using pair of index-id, space-id.
-@param[in]	index	index handler
+/** Get the latch of the adaptive hash index partition of a fold value.
+@param[in]	fold	fold value of a hash index entry
 @return latch */
 UNIV_INLINE
 rw_lock_t*
-btr_get_search_latch(const dict_index_t* index);
+btr_get_search_latch(ulint fold);
 
-/** Get the hash-table based on index attributes.
-A table is selected from an array of tables using pair of index-id, space-id.
-@param[in]	index	index handler
+/** Get the hash table of the adaptive hash index partition of a fold value.
+@param[in]	fold	fold value of a hash index entry
 @return hash table */
 UNIV_INLINE
 hash_table_t*
-btr_get_search_table(const dict_index_t* index);
+btr_get_search_table(ulint fold);
+
+/** Get the latch protecting the adaptive hash index fields of a block.
+@param[in]	block	buffer block
+@return latch */
+UNIV_INLINE
+rw_lock_t*
+btr_get_search_page_latch(const buf_block_t* block);
 
 /** The search info struct in an index */
 struct btr_search_t{
 	ulint	ref_count;	/*!< Number of blocks in this index tree
 				that have search index built
 				i.e. block->index points to this index.
-				Protected by search latch except
-				when during initialization in
-				btr_search_info_create(). */
+				Updated with atomic operations while
+				holding the page latch of the block. */
+	ibool	freed;		/*!< TRUE if the index was removed from
+				the dictionary cache while ref_count > 0;
+				it is freed when ref_count drops to 0.
+				Protected by all the page latches. */
 
 	/* @{ The following fields are not protected by any latch.
 	Unfortunately, this means that they must be aligned to
@@ -306,6 +299,22 @@ struct btr_search_t{
 				the same prefix should be indexed in the
 				hash index */
 	/*---------------------- @} */
+	/* @{ Hit rate self-tuning of the index. These fields are not
+	protected by any latch either, and are only approximate. */
+	ulint	n_hits;		/*!< number of successful hash searches
+				since the hit rate was last checked */
+	ulint	n_misses;	/*!< number of failed hash searches since
+				the hit rate was last checked */
+	ulint	n_rows_added;	/*!< number of hash index entries added
+				since the hit rate was last checked */
+	ibool	auto_disabled;	/*!< TRUE if hash searches on the index
+				are disabled because they did not pay off;
+				the hash index of its pages is then dropped
+				lazily, when the pages are searched */
+	ulint	n_disabled_searches;
+				/*!< number of searches since
+				auto_disabled was set */
+	/* @} */
 #ifdef UNIV_SEARCH_PERF_STAT
 	ulint	n_hash_succ;	/*!< number of successful hash searches thus
 				far */
@@ -325,12 +334,22 @@ struct btr_search_t{
 struct btr_search_sys_t{
 	hash_table_t**	hash_tables;	/*!< the adaptive hash tables,
 					mapping dtuple_fold values
-					to rec_t pointers on index pages */
+					to rec_t pointers on index pages;
+					a fold value is mapped to
+					hash_tables[fold % btr_ahi_parts] */
+	UT_LIST_BASE_NODE_T(dict_index_t)
+			freed_indexes;	/*!< indexes with
+					btr_search_t::freed set,
+					linked by dict_index_t::indexes;
+					protected by all the search latches */
 };
 
-/** Latches protecting access to adaptive hash index. */
+/** Latches protecting the partitions of the adaptive hash index. */
 extern rw_lock_t**		btr_search_latches;
 
+/** Latches protecting the adaptive hash index fields of the blocks. */
+extern rw_lock_t**		btr_search_page_latches;
+
 /** The adaptive hash index */
 extern btr_search_sys_t*	btr_search_sys;
 
@@ -354,10 +373,18 @@ pattern */
 the hash index */
 #define BTR_SEARCH_ON_HASH_LIMIT	3
 
-/** We do this many searches before trying to keep the search latch
-over calls from MySQL. If we notice someone waiting for the latch, we
-again set this much timeout. This is to reduce contention. */
-#define BTR_SEA_TIMEOUT			10000
+/** Number of hash searches and added hash index entries of an index after
+which the hit rate of its hash searches is checked */
+#define BTR_SEARCH_TUNE_SAMPLE		1000000
+
+/** A successful hash search is assumed to save this many times the work
+of a failed hash search or of adding a hash index entry. Hash searches are
+disabled on an index when they save less work than they cost. */
+#define BTR_SEARCH_HIT_GAIN		4
+
+/** Number of searches on an index whose hash searches were disabled by
+the hit rate check, after which they are tried again */
+#define BTR_SEARCH_RETRY_SEARCHES	1000000
 
 #ifndef UNIV_NONINL
 #include "btr0sea.ic"
@@ -1747,7 +1747,7 @@ struct buf_block_t{
 
 	/** @name Hash search fields
 	These 5 fields may only be modified when:
-	we are holding the appropriate x-latch in btr_search_latches[], and
+	we are holding the x-latch btr_get_search_page_latch(block), and
 	one of the following holds:
 	(1) the block state is BUF_BLOCK_FILE_PAGE, and
 	we are holding an s-latch or x-latch on buf_block_t::lock, or
@@ -1761,14 +1761,15 @@ struct buf_block_t{
 	assigning block->index = NULL (and block->n_pointers = 0)
 	is allowed whenever btr_search_own_all(RW_LOCK_X).
 
-	Another exception is that ha_insert_for_fold_func() may
-	decrement n_pointers without holding the appropriate latch
-	in btr_search_latches[]. Thus, n_pointers must be
+	Another exception is that n_pointers is modified while holding
+	the latch in btr_search_latches[] of the hash table that the
+	entry belongs to, and ha_insert_for_fold_func() may decrement
+	it without holding that latch. Thus, n_pointers must be
 	protected by atomic memory access.
 
 	This implies that the fields may be read without race
 	condition whenever any of the following hold:
-	- the btr_search_latches[] s-latch or x-latch is being held, or
+	- btr_get_search_page_latch(block) is s-latched or x-latched, or
 	- the block state is not BUF_BLOCK_FILE_PAGE or BUF_BLOCK_REMOVE_HASH,
 	and holding some latch prevents the state from changing to that.
 
@@ -2036,6 +2037,10 @@ struct buf_pool_stat_t{
 				young because the first access
 				was not long enough ago, in
 				buf_page_peek_if_too_old() */
+	ulint	n_ghost_hits;	/*!< number of pages that were made
+				young when they were read, because the
+				2Q policy evicted them recently, in
+				buf_LRU_add_to_old() */
 	ulint	LRU_bytes;	/*!< LRU size in bytes */
 	ulint	flush_list_bytes;/*!< flush_list size in bytes */
 };
@@ -2236,6 +2241,17 @@ struct buf_pool_t{
 					/*!< base node of the
 					unzip_LRU list */
 
+	ulint		LRU_policy;	/*!< replacement policy of the
+					LRU list, buf_LRU_policy_t */
+	buf_LRU_ghost_t	LRU_ghost;	/*!< pages that the 2Q policy
+					evicted recently */
+	buf_pool_stat_t	LRU_policy_start;
+					/*!< stat when LRU_policy was
+					last set */
+	buf_LRU_policy_stat_t	LRU_policy_stat[BUF_LRU_N_POLICIES];
+					/*!< statistics under each policy
+					until LRU_policy was last set */
+
 	/* @} */
 	/** @name Buddy allocator fields
 	The buddy allocator is used for allocating compressed page
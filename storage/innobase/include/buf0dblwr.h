@@ -61,7 +61,8 @@ At a database startup initializes the doublewrite buffer memory structure if
 we already have a doublewrite buffer created in the data files. If we are
 upgrading to an InnoDB version which supports multiple tablespaces, then this
 function performs the necessary update operations. If we are in a crash
-recovery, this function loads the pages from double write buffer into memory.
+recovery, this function loads the pages from double write buffer and from
+the doublewrite files into memory.
 @return DB_SUCCESS or error code */
 dberr_t
 buf_dblwr_init_or_load_pages(
@@ -72,6 +73,12 @@ buf_dblwr_init_or_load_pages(
 void
 buf_dblwr_process(void);
 
+/** Free the copies of the pages which were loaded from the doublewrite
+buffer and files at startup, and delete the doublewrite files which are
+no longer used. */
+void
+buf_dblwr_free_recovered_pages();
+
 /****************************************************************//**
 frees doublewrite buffer. */
 void
@@ -108,14 +115,23 @@ void
 buf_dblwr_sync_datafiles();
 
 /********************************************************************//**
-Flushes possible buffered writes from the doublewrite memory buffer to disk,
-and also wakes up the aio thread if simulated aio is used. It is very
-important to call this function after a batch of writes has been posted,
-and also when we may have to wait for a page latch! Otherwise a deadlock
-of threads can occur. */
+Flushes possible buffered writes from the doublewrite memory buffers of all
+the buffer pool instances to disk, and also wakes up the aio thread if
+simulated aio is used. It is very important to call this function after a
+batch of writes has been posted, and also when we may have to wait for a
+page latch! Otherwise a deadlock of threads can occur. */
 void
 buf_dblwr_flush_buffered_writes(void);
 /*=================================*/
+
+/** Flushes possible buffered writes from the doublewrite memory buffer of
+one buffer pool instance to disk. The batches of the other instances are
+not waited for.
+@param[in]	instance_no	buffer pool instance number */
+void
+buf_dblwr_flush_buffered_writes(
+	ulint	instance_no);
+
 /********************************************************************//**
 Writes a page to the doublewrite buffer on disk, sync it, then write
 the page to the datafile and sync the datafile. This function is used
@@ -130,13 +146,14 @@ buf_dblwr_write_single_page(
 	buf_page_t*	bpage,	/*!< in: buffer block to write */
 	bool		sync);	/*!< in: true if sync IO requested */
 
-/** Doublewrite control struct */
-struct buf_dblwr_t{
+/** Doublewrite segment: a file of page slots which is written
+independently of the other segments */
+struct buf_dblwr_seg_t{
 	ib_mutex_t	mutex;	/*!< mutex protecting the first_free
 				field and write_buf */
-	ulint		block1;	/*!< the page number of the first
-				doublewrite block (64 pages) */
-	ulint		block2;	/*!< page number of the second block */
+	char*		path;	/*!< path of the doublewrite file */
+	pfs_os_file_t	file;	/*!< handle of the doublewrite file */
+	ulint		n_slots;/*!< number of page slots in the file */
 	ulint		first_free;/*!< first free position in write_buf
 				measured in units of UNIV_PAGE_SIZE */
 	ulint		b_reserved;/*!< number of slots currently reserved
@@ -154,7 +171,7 @@ struct buf_dblwr_t{
 				is being written from the doublewrite
 				buffer. */
 	byte*		write_buf;/*!< write buffer used in writing to the
-				doublewrite buffer, aligned to an
+				doublewrite file, aligned to an
 				address divisible by UNIV_PAGE_SIZE
 				(which is required by Windows aio) */
 	byte*		write_buf_unaligned;/*!< pointer to write_buf,
@@ -164,6 +181,24 @@ struct buf_dblwr_t{
 				cached to write_buf */
 };
 
+/** Doublewrite control struct */
+struct buf_dblwr_t{
+	ulint		block1;	/*!< the page number of the first
+				doublewrite block (64 pages) */
+	ulint		block2;	/*!< page number of the second block */
+	ulint		n_segs;	/*!< number of batch segments, one per
+				buffer pool instance */
+	buf_dblwr_seg_t*
+			segs;	/*!< batch segments; the pages of a
+				buffer pool instance are always batched
+				in the segment of that instance */
+	buf_dblwr_seg_t	single;	/*!< segment used for single page
+				flushes */
+	byte*		recv_buf_unaligned;/*!< pages read from the
+				doublewrite blocks and files at startup,
+				until recovery has processed them */
+};
+
 
 #endif /* UNIV_HOTBACKUP */
 
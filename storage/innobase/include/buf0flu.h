@@ -43,6 +43,9 @@ Created 11/5/1995 Heikki Tuuri
 /** Flag indicating if the page_cleaner is in active state. */
 extern bool buf_page_cleaner_is_active;
 
+/** true if the LRU manager threads keep the free lists filled */
+extern bool buf_lru_manager_is_active;
+
 #ifdef UNIV_DEBUG
 
 /** Value of MySQL global variable used to disable page cleaner. */
@@ -259,6 +262,43 @@ Initialize page_cleaner. */
 void
 buf_flush_page_cleaner_init(void);
 /*=============================*/
+
+/** LRU manager thread of a buffer pool instance: keeps
+innodb_LRU_scan_depth free blocks in the free list by evicting clean pages
+and flushing dirty pages from the tail of the LRU list, independently of
+the flush_list flushing of the page cleaner threads.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(buf_lru_manager_thread)(
+	void*	arg);	/*!< in: buf_lru_manager_t of the instance */
+
+/** Start one LRU manager thread for each buffer pool instance. From now
+on, the page cleaner threads only flush the flush_list, and the threads
+which find no free block wait for the LRU manager thread instead of
+flushing a single page. */
+void
+buf_lru_manager_start();
+
+/** Stop the LRU manager threads and wait for them to exit. From now on,
+the page cleaner threads flush the tail of the LRU lists again. */
+void
+buf_lru_manager_stop();
+
+/** Free the LRU manager thread state. Called at shutdown, when no thread
+can wait for a free block anymore. */
+void
+buf_lru_manager_free();
+
+/** Wake up the LRU manager thread of a buffer pool instance because its
+free list is empty, and wait until it has completed an LRU batch or for
+a short while. Called by a thread which did not find a free block,
+instead of flushing a single page.
+@param[in]	buf_pool	buffer pool instance
+@return false if the LRU manager threads are not running */
+bool
+buf_lru_manager_wait_for_free_block(
+	buf_pool_t*	buf_pool);
 /*********************************************************************//**
 Clears up tail of the LRU lists:
 * Put replaceable pages at the tail of LRU to the free list
@@ -203,6 +203,69 @@ buf_LRU_old_ratio_update(
 	ibool	adjust);/*!< in: TRUE=adjust the LRU list;
 			FALSE=just assign buf_pool->LRU_old_ratio
 			during the initialization of InnoDB */
+/** Set the replacement policy of the LRU lists.
+@param[in]	policy	buf_LRU_policy_t */
+void
+buf_LRU_policy_set(
+	ulint	policy);
+
+/** Get the statistics of the buffer pool instances under an LRU
+replacement policy, since the start of the server.
+@param[in]	policy	buf_LRU_policy_t
+@param[out]	stat	statistics */
+void
+buf_LRU_policy_get_stat(
+	ulint			policy,
+	buf_LRU_policy_stat_t*	stat);
+
+/** Determine whether a page that is being read into the buffer pool
+is to be added to the old blocks of the LRU list.
+@param[in,out]	buf_pool	buffer pool instance
+@param[in]	page_id		page id
+@return TRUE if the page is to be added to the old blocks */
+ibool
+buf_LRU_add_to_old(
+	buf_pool_t*		buf_pool,
+	const page_id_t&	page_id);
+
+/** Size the table of recently evicted pages of a buffer pool instance
+for its current size, emptying it.
+@param[in,out]	buf_pool	buffer pool instance */
+void
+buf_LRU_ghost_resize(
+	buf_pool_t*	buf_pool);
+
+/** Create a table of recently evicted pages.
+@param[out]	ghost	table
+@param[in]	n_slots	number of slots */
+void
+buf_LRU_ghost_create(
+	buf_LRU_ghost_t*	ghost,
+	ulint			n_slots);
+
+/** Free a table of recently evicted pages.
+@param[in,out]	ghost	table */
+void
+buf_LRU_ghost_free(
+	buf_LRU_ghost_t*	ghost);
+
+/** Remember that a page was evicted.
+@param[in,out]	ghost	table of recently evicted pages
+@param[in]	page_id	page id */
+void
+buf_LRU_ghost_insert(
+	buf_LRU_ghost_t*	ghost,
+	const page_id_t&	page_id);
+
+/** Check whether a page was evicted recently, and forget it.
+@param[in,out]	ghost	table of recently evicted pages
+@param[in]	page_id	page id
+@return whether the page was evicted recently */
+bool
+buf_LRU_ghost_remove(
+	buf_LRU_ghost_t*	ghost,
+	const page_id_t&	page_id);
+
 /********************************************************************//**
 Update the historical stats that we are collecting for LRU eviction
 policy at the end of each interval. */
@@ -53,6 +53,8 @@ struct buf_buddy_stat_t;
 struct buf_dblwr_t;
 /** Flush observer for bulk create index */
 class FlushObserver;
+/** Page identifier */
+class page_id_t;
 
 /** A buffer frame. @see page_t */
 typedef	byte	buf_frame_t;
@@ -88,6 +90,39 @@ enum buf_io_fix {
 					the flush_list */
 };
 
+/** Replacement policies of the LRU list of a buffer pool instance */
+enum buf_LRU_policy_t {
+	BUF_LRU_POLICY_MIDPOINT = 0,	/*!< a page that is read in is
+					added to the old blocks, and is made
+					young when it is accessed at least
+					buf_LRU_old_threshold_ms after the
+					first access */
+	BUF_LRU_POLICY_2Q,		/*!< a page that is read in is
+					added to the old blocks, and is never
+					made young while it is old; it is
+					added to the young blocks if it was
+					evicted recently (2Q) */
+	BUF_LRU_N_POLICIES		/*!< number of policies */
+};
+
+/** Statistics of the buffer pool instances that use an LRU policy */
+struct buf_LRU_policy_stat_t {
+	ulint	n_page_gets;	/*!< number of page gets */
+	ulint	n_pages_read;	/*!< number of pages read */
+	ulint	n_ghost_hits;	/*!< number of pages that were added
+				to the young blocks when they were read,
+				because they were evicted recently */
+};
+
+/** Page ids of the pages that the 2Q policy evicted recently. This is a
+direct-mapped table: a page id replaces the one in the slot it hashes to,
+which approximates the FIFO order of the "A1out" queue of 2Q. */
+struct buf_LRU_ghost_t {
+	ib_uint64_t*	slots;		/*!< 1 + (space_id << 32 | page_no)
+					of an evicted page, or 0 */
+	ulint		n_slots;	/*!< number of slots */
+};
+
 /** Alternatives for srv_checksum_algorithm, which can be changed by
 setting innodb_checksum_algorithm */
 enum srv_checksum_algorithm_t {
@@ -615,6 +615,37 @@ struct dict_v_idx_t {
 /** Index list to put in dict_v_col_t */
 typedef	std::list<dict_v_idx_t, ut_allocator<dict_v_idx_t> >	dict_v_idx_list;
 
+/** Maximum number of buckets in a column histogram */
+#define DICT_HIST_MAX_BUCKETS	100
+
+/** Histogram of the values of an integer column, built from a sample of
+the records of the clustered index. The values are in the format of the
+column in InnoDB records, read as a big-endian unsigned integer, which
+preserves the order of signed values too. If n_distinct == n_buckets,
+each bucket holds a single value (singleton histogram), otherwise the
+buckets hold about the same number of records (equi-height histogram). */
+struct dict_col_hist_t {
+	/** column number, dict_col_t::ind */
+	ulint		col_no;
+	/** ut_fold_string() of the column name. The histogram is
+	saved under the column number, and is ignored when it is read
+	for a column of another name. */
+	ulint		name_fold;
+	/** number of sampled records, including those where the
+	column is NULL */
+	ib_uint64_t	n_rows;
+	/** number of distinct non-NULL values in the sample */
+	ib_uint64_t	n_distinct;
+	/** smallest value in the sample */
+	ib_uint64_t	lower;
+	/** number of buckets */
+	ulint		n_buckets;
+	/** largest value in each bucket, in ascending order */
+	ib_uint64_t	upper[DICT_HIST_MAX_BUCKETS];
+	/** number of sampled records whose value is at most upper[] */
+	ib_uint64_t	n_le[DICT_HIST_MAX_BUCKETS];
+};
+
 /** Data structure for a virtual column in a table */
 struct dict_v_col_t{
 	/** column structure */
@@ -913,6 +944,11 @@ struct dict_index_t{
 	unsigned	n_def:10;/*!< number of fields defined so far */
 	unsigned	n_fields:10;/*!< number of fields in the index */
 	unsigned	n_nullable:10;/*!< number of nullable fields */
+	unsigned	n_memcmp_fields:10;
+				/*!< number of fields from the beginning
+				which have a fixed length and are compared
+				in byte order, without a collation; see
+				cmp_dtuple_rec_with_match_index() */
 	unsigned	cached:1;/*!< TRUE if the index object is in the
 				dictionary cache */
 	unsigned	to_be_dropped:1;
@@ -1008,6 +1044,10 @@ struct dict_index_t{
 				compression failures and successes */
 	rw_lock_t	lock;	/*!< read-write lock protecting the
 				upper levels of the index tree */
+	ulint		smo_seq;/*!< number of page splits in the index
+				tree; incremented while holding lock in
+				SX or X mode, and read without it by
+				inserts that found a leaf page full */
 
 	/** Determine if the index has been committed to the
 	data dictionary.
@@ -1536,6 +1576,7 @@ struct dict_table_t {
 	dict_table_t::stat_clustered_index_size,
 	dict_table_t::stat_sum_of_other_index_sizes,
 	dict_table_t::stat_modified_counter (*),
+	dict_table_t::stat_col_hist,
 	dict_table_t::indexes*::stat_n_diff_key_vals[],
 	dict_table_t::indexes*::stat_index_size,
 	dict_table_t::indexes*::stat_n_leaf_pages.
@@ -1608,6 +1649,14 @@ struct dict_table_t {
 	any latch, because this is only used for heuristics. */
 	ib_uint64_t				stat_modified_counter;
 
+	/** Histograms of integer columns, built with the persistent
+	statistics if innodb_stats_histogram_buckets > 0, or NULL.
+	Allocated with ut_malloc_nokey(). */
+	dict_col_hist_t*			stat_col_hist;
+
+	/** Number of elements in stat_col_hist. */
+	ulint					stat_n_col_hist;
+
 	/** Background stats thread is not working on this table. */
 	#define BG_STAT_NONE			0
 
@@ -1691,9 +1740,22 @@ struct dict_table_t {
 
 	/** Count of the number of record locks on this table. We use this to
 	determine whether we can evict the table from the dictionary cache.
-	It is protected by lock_sys->mutex. */
+	It is modified with atomic operations while holding lock_sys->latch
+	in shared or exclusive mode. */
 	ulint					n_rec_locks;
 
+	/** Number of indexes of this table that were removed from the
+	dictionary cache while pages of them were still in the adaptive
+	hash index; see btr_search_free_index(). Protected by all the
+	adaptive hash index latches. */
+	ulint					n_ahi_freed_indexes;
+
+	/** Whether this table was freed while n_ahi_freed_indexes > 0.
+	The memory heap of the table is then freed together with the
+	last of those indexes. Protected by all the adaptive hash index
+	latches. */
+	bool					ahi_freed;
+
 #ifndef UNIV_DEBUG
 private:
 #endif
@@ -64,6 +64,16 @@ enum dict_stats_upd_option_t {
 				otherwise do nothing */
 };
 
+/** Comparison of a column with a constant, for estimating its
+selectivity with dict_stats_hist_estimate() */
+enum dict_hist_op_t {
+	DICT_HIST_EQ,		/*!< column = constant */
+	DICT_HIST_LT,		/*!< column < constant */
+	DICT_HIST_LE,		/*!< column <= constant */
+	DICT_HIST_GT,		/*!< column > constant */
+	DICT_HIST_GE		/*!< column >= constant */
+};
+
 /*********************************************************************//**
 Calculates new estimates for table and index statistics. This function
 is relatively quick and is used to calculate transient statistics that
@@ -216,6 +226,64 @@ dict_stats_rename_index(
 	const char*		new_index_name)	/*!< in: new index name */
 	MY_ATTRIBUTE((warn_unused_result));
 
+/** Check whether a histogram can be built for a column.
+@param[in]	col	column
+@return whether col is an integer column */
+bool
+dict_stats_hist_col_ok(
+	const dict_col_t*	col)
+	MY_ATTRIBUTE((warn_unused_result));
+
+/** Build the histogram of a column from a sample of its values.
+@param[out]	hist		histogram
+@param[in]	col_no		column number, dict_col_t::ind
+@param[in,out]	values		the non-NULL values in the sample, in the
+format of dict_col_hist_t; will be sorted
+@param[in]	n_values	number of elements in values
+@param[in]	n_rows		number of sampled records, including NULL
+values
+@param[in]	n_buckets	maximum number of buckets, at most
+DICT_HIST_MAX_BUCKETS */
+void
+dict_stats_hist_build(
+	dict_col_hist_t*	hist,
+	ulint			col_no,
+	ib_uint64_t*		values,
+	ulint			n_values,
+	ib_uint64_t		n_rows,
+	ulint			n_buckets);
+
+/** Estimate the fraction of the records where a column compares to a
+constant, from the histogram of the column.
+@param[in]	hist	histogram of the column
+@param[in]	col	the column
+@param[in]	op	comparison
+@param[in]	value	constant
+@return fraction of the records, between 0 and 1 */
+double
+dict_stats_hist_estimate(
+	const dict_col_hist_t*	hist,
+	const dict_col_t*	col,
+	dict_hist_op_t		op,
+	double			value)
+	MY_ATTRIBUTE((warn_unused_result));
+
+/** Estimate the fraction of the records of a table where a column
+compares to a constant, from the histogram of the column.
+@param[in]	table	table
+@param[in]	col_no	column number, dict_col_t::ind
+@param[in]	op	comparison
+@param[in]	value	constant
+@return fraction of the records, or a negative value if the column
+has no histogram */
+double
+dict_stats_hist_filter(
+	dict_table_t*	table,
+	ulint		col_no,
+	dict_hist_op_t	op,
+	double		value)
+	MY_ATTRIBUTE((warn_unused_result));
+
 #ifndef UNIV_NONINL
 #include "dict0stats.ic"
 #endif
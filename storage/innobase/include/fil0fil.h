@@ -277,7 +277,10 @@ struct fil_node_t {
 	ulint		init_size;
 	/** maximum size of the file in database pages (0 if unlimited) */
 	ulint		max_size;
-	/** count of pending i/o's; is_open must be true if nonzero */
+	/** count of pending i/o's; is_open must be true if nonzero.
+	Incremented by fil_io() while holding fil_system->mutex or the
+	fil_system->spaces latch of the tablespace in shared mode;
+	modified with atomic operations */
 	ulint		n_pending;
 	/** count of pending flushes; is_open must be true if nonzero */
 	ulint		n_pending_flushes;
@@ -291,6 +294,10 @@ struct fil_node_t {
 	UT_LIST_NODE_T(fil_node_t) chain;
 	/** link to the fil_system->LRU list (keeping track of open files) */
 	UT_LIST_NODE_T(fil_node_t) LRU;
+	/** whether fil_io() has accessed the file without
+	fil_system->mutex since it was last moved to the start of
+	fil_system->LRU */
+	bool		accessed;
 
 	/** whether the file system of this file supports PUNCH HOLE */
 	bool		punch_hole;
@@ -0,0 +1,74 @@
+/*****************************************************************************
+
+Copyright (c) 2023, Oracle and/or its affiliates.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License, version 2.0,
+as published by the Free Software Foundation.
+
+This program is also distributed with certain software (including
+but not limited to OpenSSL) that is licensed under separate terms,
+as designated in a particular file or component or in included license
+documentation.  The authors of MySQL hereby grant you an additional
+permission to link the program and your derivative works with the
+separately licensed software that they have included with MySQL.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License, version 2.0, for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/fts0ctype.h
+
+Character classification for the full text search tokenizers. This header
+is also included by the full text parser plugins, so it must not depend on
+any other InnoDB header.
+*******************************************************/
+
+#ifndef fts0ctype_h
+#define fts0ctype_h
+
+#include "m_ctype.h"
+
+/** Classify the character at str, like cs->cset->ctype() does, but
+without calling the charset for single-byte characters where the result
+is known.
+@param[in]	cs	charset
+@param[out]	ctype	character type, for true_word_char()
+@param[in]	str	start of the character
+@param[in]	end	end of the string, must be greater than str
+@return length of the character in bytes, see cs->cset->ctype() */
+inline
+int
+fts_get_ctype(
+	const CHARSET_INFO*	cs,
+	int*			ctype,
+	const uchar*		str,
+	const uchar*		end)
+{
+	if (cs->cset->ctype == my_mb_ctype_8bit) {
+		*ctype = cs->ctype[*str + 1];
+		return(1);
+	}
+
+	/* In UTF-8 the bytes below 0x80 are ASCII characters, which
+	my_mb_ctype_mb() would look up in the first page. */
+	if (*str < 0x80
+	    && cs->cset->ctype == my_mb_ctype_mb
+	    && cs->mbminlen == 1
+	    && (cs->state & MY_CS_UNICODE)) {
+		*ctype = my_uni_ctype[0].ctype[*str];
+		return(1);
+	}
+
+	return(cs->cset->ctype(cs, ctype, str, end));
+}
+
+#endif /* fts0ctype_h */
@@ -144,6 +144,9 @@ extern ulong		fts_sort_pll_degree;
 call */
 extern ulong		fts_num_word_optimize;
 
+/** Variable specifying the number of FTS optimize worker threads */
+extern ulong		fts_optimize_threads;
+
 /** Variable specifying whether we do additional FTS diagnostic printout
 in the log */
 extern char		fts_enable_diag_print;
@@ -34,6 +34,7 @@ Created 2014/11/17 Shaohua Wang
 #include "ft_global.h"
 #include "mysql/plugin_ftparser.h"
 #include "m_ctype.h"
+#include "fts0ctype.h"
 
 /* Macros and structs below are from ftdefs.h in MyISAM */
 /** Check a char is true word */
@@ -99,7 +100,7 @@ fts_get_word(
 	while (doc < end) {
 		for (; doc < end;
 		     doc += (mbl > 0 ? mbl : (mbl < 0 ? -mbl : 1))) {
-			mbl = cs->cset->ctype(cs, &ctype, doc, end);
+			mbl = fts_get_ctype(cs, &ctype, doc, end);
 
 			if (true_word_char(ctype, *doc)) {
 				break;
@@ -161,7 +162,7 @@ fts_get_word(
 		for (word->pos = doc;
 		     doc < end;
 		     length++, doc += (mbl > 0 ? mbl : (mbl < 0 ? -mbl : 1))) {
-			mbl = cs->cset->ctype(cs, &ctype, doc, end);
+			mbl = fts_get_ctype(cs, &ctype, doc, end);
 
 			if (true_word_char(ctype, *doc)) {
 				mwc = 0;
@@ -35,6 +35,7 @@ Created 2007-03-27 Sunny Bains
 #define INNOBASE_FTS0TYPES_H
 
 #include "univ.i"
+#include "fts0ctype.h"
 #include "fts0fts.h"
 #include "fut0fut.h"
 #include "pars0pars.h"
@@ -352,6 +353,18 @@ fts_decode_vlc(
 	byte**	ptr);	/*!< in: ptr to decode from, this ptr is
 			incremented by the number of bytes decoded */
 
+/******************************************************************//**
+Skip a list of word positions and the 0x00 byte that terminates it. */
+UNIV_INLINE
+ulint
+fts_skip_positions(
+/*===============*/
+				/*!< out: number of positions in
+				the list */
+	byte**		ptr,	/*!< in/out: start of the list; set
+				to the byte after the terminator */
+	const byte*	end);	/*!< in: end of the ilist */
+
 /******************************************************************//**
 Duplicate a string. */
 UNIV_INLINE
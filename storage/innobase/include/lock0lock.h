@@ -899,6 +899,40 @@ Set the lock system timeout event. */
 void
 lock_set_timeout_event();
 /*====================*/
+
+/** Have the lock wait timeout thread search the waits-for graph for
+deadlocks at its next wake up. */
+void
+lock_wait_request_check_for_cycles();
+
+/** Check that a cycle found by the deadlock detector in a snapshot of the
+waits-for graph still exists, and if so resolve it by rolling back one of
+its transactions.
+@param[in]	cycle	transactions each of which waits for the next one,
+			the last one waiting for the first one
+@param[in]	n_trx	number of transactions in the cycle
+@return true if a transaction was rolled back */
+bool
+lock_resolve_deadlock(
+	trx_t* const*	cycle,
+	ulint		n_trx);
+
+/** An edge of the waits-for graph: a waiting transaction and a
+transaction that it has to wait for */
+typedef std::pair<trx_t*, trx_t*>	lock_wait_edge_t;
+
+typedef std::vector<lock_wait_edge_t, ut_allocator<lock_wait_edge_t> >
+	lock_wait_edges_t;
+
+/** Append the edges of the waits-for graph from a waiting transaction:
+one to each transaction which holds or requests a conflicting lock ahead
+of the lock request that it waits for.
+@param[in]	trx	transaction
+@param[in,out]	edges	edges of the waits-for graph */
+void
+lock_get_wait_edges(
+	trx_t*			trx,
+	lock_wait_edges_t&	edges);
 #ifdef UNIV_DEBUG
 /*********************************************************************//**
 Checks that a transaction id is sensible, i.e., not in the future.
@@ -1005,14 +1039,41 @@ struct lock_op_t{
 
 typedef ib_mutex_t LockMutex;
 
+/** Number of lock_sys shards. The record lock queues of a page belong to
+the shard of their lock hash table cell. */
+#define LOCK_SYS_N_SHARDS	256
+
+/** A lock_sys shard: a mutex protecting the record lock queues which are
+hashed to it, padded to prevent false sharing between the shards */
+struct lock_sys_shard_t {
+	LockMutex	mutex;			/*!< Mutex protecting the
+						record lock queues of the
+						shard when lock_sys->latch
+						is held in shared mode */
+	char		pad[CACHE_LINE_SIZE];	/*!< Padding */
+};
+
 /** The lock system struct */
 struct lock_sys_t{
 	char		pad1[CACHE_LINE_SIZE];	/*!< padding to prevent other
 						memory update hotspots from
 						residing on the same memory
 						cache line */
-	LockMutex	mutex;			/*!< Mutex protecting the
-						locks */
+	rw_lock_t	latch;			/*!< Latch protecting the
+						locks. Table lock operations,
+						deadlock detection and any
+						operation on several page
+						queues hold it in exclusive
+						mode. Record lock requests
+						which do not have to wait and
+						the release of record locks
+						hold it in shared mode
+						together with the shard mutex
+						of the page */
+	lock_sys_shard_t*
+			shards;			/*!< Array of LOCK_SYS_N_SHARDS
+						shards of the record lock
+						queues */
 	hash_table_t*	rec_hash;		/*!< hash table of the record
 						locks */
 	hash_table_t*	prdt_hash;		/*!< hash table of the predicate
@@ -1046,6 +1107,12 @@ struct lock_sys_t{
 
 	bool		timeout_thread_active;	/*!< True if the timeout thread
 						is running */
+
+	volatile bool	deadlock_check_requested;
+						/*!< True if the waits-for
+						graph has changed since the
+						timeout thread last searched
+						it for deadlocks */
 };
 
 /*********************************************************************//**
@@ -1106,23 +1173,72 @@ lock_rec_trx_wait(
 /** The lock system */
 extern lock_sys_t*	lock_sys;
 
-/** Test if lock_sys->mutex can be acquired without waiting. */
+/** Try to acquire lock_sys->latch in exclusive mode without waiting.
+@return 0 if the latch was acquired */
 #define lock_mutex_enter_nowait() 		\
-	(lock_sys->mutex.trylock(__FILE__, __LINE__))
+	(!rw_lock_x_lock_nowait(&lock_sys->latch))
 
-/** Test if lock_sys->mutex is owned. */
-#define lock_mutex_own() (lock_sys->mutex.is_owned())
+/** Test if lock_sys->latch is owned in exclusive mode. */
+#define lock_mutex_own() (rw_lock_own(&lock_sys->latch, RW_LOCK_X))
 
-/** Acquire the lock_sys->mutex. */
+/** Acquire lock_sys->latch in exclusive mode. */
 #define lock_mutex_enter() do {			\
-	mutex_enter(&lock_sys->mutex);		\
+	rw_lock_x_lock(&lock_sys->latch);	\
 } while (0)
 
-/** Release the lock_sys->mutex. */
+/** Release lock_sys->latch from exclusive mode. */
 #define lock_mutex_exit() do {			\
-	lock_sys->mutex.exit();			\
+	rw_lock_x_unlock(&lock_sys->latch);	\
 } while (0)
 
+/** Test if lock_sys->latch is owned in shared or exclusive mode. */
+#define lock_sys_latched()					\
+	(rw_lock_own_flagged(&lock_sys->latch,			\
+			     RW_LOCK_FLAG_X | RW_LOCK_FLAG_S))
+
+/** Get the lock_sys shard of the record lock queues of a page.
+@param[in]	space	tablespace id
+@param[in]	page_no	page number
+@return shard of the page */
+UNIV_INLINE
+lock_sys_shard_t*
+lock_sys_get_shard(
+	ulint	space,
+	ulint	page_no);
+
+/** Acquire lock_sys->latch in shared mode and the shard mutex of the
+record lock queues of a page. This is enough to look up and modify the
+queues of that page, but not to wait for a lock.
+@param[in]	space	tablespace id
+@param[in]	page_no	page number
+@return the acquired shard, to be passed to lock_sys_shard_exit() */
+UNIV_INLINE
+lock_sys_shard_t*
+lock_sys_shard_enter(
+	ulint	space,
+	ulint	page_no);
+
+/** Release a shard mutex and lock_sys->latch acquired by
+lock_sys_shard_enter().
+@param[in,out]	shard	shard returned by lock_sys_shard_enter() */
+UNIV_INLINE
+void
+lock_sys_shard_exit(
+	lock_sys_shard_t*	shard);
+
+#ifdef UNIV_DEBUG
+/** Test if the record lock queues of a page may be accessed: the caller
+holds lock_sys->latch in exclusive mode, or in shared mode together with
+the shard mutex of the page.
+@param[in]	space	tablespace id
+@param[in]	page_no	page number
+@return true if the queues of the page are latched */
+bool
+lock_sys_owns_page(
+	ulint	space,
+	ulint	page_no);
+#endif /* UNIV_DEBUG */
+
 /** Test if lock_sys->wait_mutex is owned. */
 #define lock_wait_mutex_own() (lock_sys->wait_mutex.is_owned())
 
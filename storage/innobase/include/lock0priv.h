@@ -290,14 +290,6 @@ operator<<(std::ostream& out, const lock_t& lock)
 extern ibool	lock_print_waits;
 #endif /* UNIV_DEBUG */
 
-/** Restricts the length of search we will do in the waits-for
-graph of transactions */
-static const ulint	LOCK_MAX_N_STEPS_IN_DEADLOCK_CHECK = 1000000;
-
-/** Restricts the search depth we will do in the waits-for graph of
-transactions */
-static const ulint	LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK = 200;
-
 /** When releasing transaction locks, this specifies how often we release
 the lock mutex for a moment to give also others access to it */
 static const ulint	LOCK_RELEASE_INTERVAL = 1000;
@@ -584,9 +576,6 @@ static const byte lock_strength_matrix[5][5] = {
  /* AI */ {  FALSE, FALSE, FALSE, FALSE,  TRUE}
 };
 
-/** Maximum depth of the DFS stack. */
-static const ulint MAX_STACK_SIZE = 4096;
-
 #define PRDT_HEAPNO	PAGE_HEAP_NO_INFIMUM
 /** Record locking request status */
 enum lock_rec_req_status {
@@ -889,7 +878,8 @@ private:
 	Setup the context from the requirements */
 	void init(const page_t* page)
 	{
-		ut_ad(lock_mutex_own());
+		ut_ad(lock_sys_owns_page(m_rec_id.m_space_id,
+					 m_rec_id.m_page_no));
 		ut_ad(!srv_read_only_mode);
 		ut_ad(dict_index_is_clust(m_index)
 		      || !dict_index_is_online_ddl(m_index));
@@ -1199,6 +1189,17 @@ lock_table_has(
 	const dict_table_t*	table,	/*!< in: table */
 	enum lock_mode		mode);	/*!< in: lock mode */
 
+#ifdef UNIV_DEBUG
+/** Test if the queue of a lock may be accessed: record lock queues are
+covered by lock_sys_owns_page(), table lock queues need lock_sys->latch
+in exclusive mode.
+@param[in]	lock	record or table lock
+@return true if the queue of the lock is latched */
+bool
+lock_sys_owns_lock(
+	const lock_t*	lock);
+#endif /* UNIV_DEBUG */
+
 #ifndef UNIV_NONINL
 #include "lock0priv.ic"
 #endif
@@ -45,6 +45,8 @@ Created 12/9/1995 Heikki Tuuri
 #include "dyn0buf.h"
 #ifndef UNIV_HOTBACKUP
 #include "sync0rw.h"
+#include "os0thread.h"
+#include "ut0link_buf.h"
 #endif /* !UNIV_HOTBACKUP */
 
 /* Type used for all log sequence number storage and arithmetics */
@@ -94,17 +96,21 @@ log_calc_where_lsn_is(
 	int64_t		log_file_size);		/*!< in: log file size
 						(including the header) */
 #ifndef UNIV_HOTBACKUP
-/** Append a string to the log.
-@param[in]	str		string
+/** Reserve space for a string in the current log block, if it fits.
+The string must be copied to the returned position with log_buffer_write()
+and the reserved range reported with log_buffer_write_completed().
+@param[in]	str		string (only its first byte is examined)
 @param[in]	len		string length
 @param[out]	start_lsn	start LSN of the log record
+@param[out]	ptr		where to copy the string in the log buffer
 @return end lsn of the log record, zero if did not succeed */
 UNIV_INLINE
 lsn_t
-log_reserve_and_write_fast(
+log_reserve_fast(
 	const void*	str,
 	ulint		len,
-	lsn_t*		start_lsn);
+	lsn_t*		start_lsn,
+	byte**		ptr);
 /***********************************************************************//**
 Checks if there is need for a log buffer flush or a new checkpoint, and does
 this if yes. Any database operation should call this when it has modified
@@ -144,6 +150,41 @@ log_write_low(
 /*==========*/
 	const byte*	str,		/*!< in: string */
 	ulint		str_len);	/*!< in: string length */
+/** Reserve space for a string in the log buffer without copying it.
+The block headers of the reserved area are initialized, so that the string
+can later be copied with log_buffer_write() without holding the log mutex.
+It is assumed that the caller holds the log mutex.
+@param[in]	str_len	string length
+@return where to copy the string in the log buffer */
+byte*
+log_reserve_low(
+	ulint	str_len);
+/** Copy a string to space reserved with log_reserve_low(), skipping the
+log block trailers and headers. This does not need the log mutex, because
+the log buffer is not written or moved before log_buffer_write_completed()
+has been called for the whole reserved range.
+@param[in]	ptr	where to copy in the log buffer
+@param[in]	str	string
+@param[in]	str_len	string length
+@return position following the copied string */
+byte*
+log_buffer_write(
+	byte*		ptr,
+	const byte*	str,
+	ulint		str_len);
+/** Report that all the log records in the given LSN range have been
+copied to the log buffer.
+@param[in]	start_lsn	start of the range
+@param[in]	end_lsn		end of the range */
+void
+log_buffer_write_completed(
+	lsn_t	start_lsn,
+	lsn_t	end_lsn);
+/** Restart the tracking of the log buffer ranges reserved by
+mini-transactions from log_sys->lsn. This must be called whenever
+log_sys->lsn has been assigned directly, rather than by log_reserve_low(). */
+void
+log_recent_written_reset();
 /************************************************************//**
 Closes the log.
 @return lsn */
@@ -216,6 +257,39 @@ also to be flushed to disk. */
 void
 log_buffer_flush_to_disk(
 	bool sync = true);
+/** Start the log writer and log flusher threads. From now on,
+log_write_up_to() leaves the writes and flushes to them and waits for
+their notification. */
+void
+log_start_background_threads();
+/** Stop the log writer and log flusher threads and wait for them to exit.
+From now on, log_write_up_to() writes and flushes the log itself. */
+void
+log_stop_background_threads();
+/** Wake up the log writer and log flusher threads, so that they notice
+srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS. */
+void
+log_wake_background_threads();
+/******************************************************************//**
+The log writer thread writes the log buffer to the log files on behalf of
+the threads waiting in log_write_up_to().
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(log_writer_thread)(
+/*==============================*/
+	void*	arg);		/*!< in: a dummy parameter required by
+				os_thread_create */
+/******************************************************************//**
+The log flusher thread flushes the written log to disk on behalf of the
+threads waiting in log_write_up_to().
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(log_flusher_thread)(
+/*===============================*/
+	void*	arg);		/*!< in: a dummy parameter required by
+				os_thread_create */
 /****************************************************************//**
 This functions writes the log buffer to the log file and if 'flush'
 is set it forces a flush of the log file as well. This is meant to be
@@ -497,6 +571,11 @@ extern my_bool	innodb_log_checksums;
 
 #define LOG_BUFFER_SIZE		(srv_log_buffer_size * UNIV_PAGE_SIZE)
 
+/** Number of slots in log_sys->recent_written; this limits how far the
+log buffer reservations by mini-transactions may run ahead of the oldest
+one which has not finished copying its log records yet */
+#define LOG_RECENT_WRITTEN_SIZE	(1024 * 1024)
+
 /* Offsets of a log block header */
 #define	LOG_BLOCK_HDR_NO	0	/* block number which must be > 0 and
 					is allowed to wrap around at 2G; the
@@ -638,6 +717,15 @@ struct log_t{
 	lsn_t		lsn;		/*!< log sequence number */
 	ulint		buf_free;	/*!< first free offset within the log
 					buffer in use */
+#ifndef UNIV_HOTBACKUP
+	Link_buf<lsn_t>*
+			recent_written;	/*!< ranges of the log buffer which were
+					reserved with log_reserve_low() and
+					have been filled since; the log buffer
+					is written or moved only when its tail
+					has reached lsn. Its tail is advanced
+					under the log mutex. */
+#endif /* !UNIV_HOTBACKUP */
 #ifndef UNIV_HOTBACKUP
 	char		pad2[CACHE_LINE_SIZE];/*!< Padding */
 	LogSysMutex	mutex;		/*!< mutex protecting the log */
@@ -710,6 +798,41 @@ struct log_t{
 					owning the log mutex, but NOTE that
 					to set this event, the
 					thread MUST own the log mutex! */
+	volatile bool	writer_threads_active;
+					/*!< true while the log writer and
+					log flusher threads serve
+					log_write_up_to(); when false, the
+					callers write and flush the log
+					themselves */
+	volatile bool	writer_thread_alive;
+					/*!< true while log_writer_thread runs */
+	volatile bool	flusher_thread_alive;
+					/*!< true while log_flusher_thread
+					runs */
+	os_event_t	writer_event;	/*!< set to wake up the log writer
+					thread */
+	os_event_t	flusher_event;	/*!< set to wake up the log flusher
+					thread */
+	volatile ulint	n_write_waiters;/*!< number of threads waiting in
+					log_write_up_to() for write_lsn */
+	volatile ulint	n_flush_waiters;/*!< number of threads waiting in
+					log_write_up_to() for
+					flushed_to_disk_lsn */
+	ulint		n_events;	/*!< number of slots in write_events
+					and flush_events, a power of two */
+	os_event_t*	write_events;	/*!< a thread waiting for write_lsn to
+					reach lsn waits on the slot of the
+					log block containing lsn - 1; the
+					writer thread sets the slots of the
+					blocks it has written */
+	os_event_t*	flush_events;	/*!< same as write_events, for
+					flushed_to_disk_lsn */
+	volatile ulint	write_avg_us;	/*!< moving average of the time
+					of a log write done by the log writer
+					thread, in microseconds */
+	volatile ulint	flush_avg_us;	/*!< moving average of the time
+					of a log flush done by the log flusher
+					thread, in microseconds */
 	ulint		n_log_ios;	/*!< number of log i/os initiated thus
 					far */
 	ulint		n_log_ios_old;	/*!< number of log i/o's at the
@@ -311,6 +311,13 @@ struct recv_sys_t{
 	buf_flush_t		flush_type;/*!< type of the flush request.
 				BUF_FLUSH_LRU: flush end of LRU, keeping free blocks.
 				BUF_FLUSH_LIST: flush all of blocks. */
+	ulint			n_apply_threads;/*!< number of threads the
+				pages of the current apply batch are
+				partitioned over */
+	ulint			n_apply_threads_active;/*!< number of
+				recv_apply_thread which have not finished their
+				partition of the current apply batch; protected
+				by mutex */
 #endif /* !UNIV_HOTBACKUP */
 	ibool		apply_log_recs;
 				/*!< this is TRUE when log rec application to
@@ -50,6 +50,9 @@ Created 10/21/1995 Heikki Tuuri
 #include <time.h>
 #endif /* !_WIN32 */
 
+#include <utility>
+#include <vector>
+
 /** File node of a tablespace or the log data space */
 struct fil_node_t;
 
@@ -1996,10 +1999,23 @@ be other, synchronous, pending writes. */
 void
 os_aio_wait_until_no_pending_writes();
 
-/** Wakes up simulated aio i/o-handler threads if they have something to do. */
+/** Wakes up simulated aio i/o-handler threads if they have something to do.
+With io_uring, submits the requests that were queued with
+IORequest::DO_NOT_WAKE. */
 void
 os_aio_simulated_wake_handler_threads();
 
+/** Memory areas as (start, length) pairs */
+typedef std::vector<std::pair<byte*, ulint> > os_aio_buffers_t;
+
+/** Register memory with the io_uring instances, so that asynchronous reads
+and writes of pages in it use registered buffers. Replaces any earlier
+registration. Does nothing if io_uring is not used.
+@param[in]	bufs	memory areas, or empty to unregister */
+void
+os_aio_register_buffers(
+	const os_aio_buffers_t&	bufs);
+
 /** This function can be called if one wants to post a batch of reads and
 prefers an i/o-handler thread to handle them all at once later. You must
 call os_aio_simulated_wake_handler_threads later to ensure the threads
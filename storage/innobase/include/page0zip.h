@@ -61,12 +61,35 @@ Created June 2005 by Marko Makela
 #include "srv0srv.h"
 #include "trx0types.h"
 #include "mem0mem.h"
+#include "zlib.h"
 
 /* Compression level to be used by zlib. Settable by user. */
 extern uint	page_zip_level;
 
 /* Default compression level. */
 #define DEFAULT_COMPRESSION_LEVEL	6
+
+/** Codecs of the compressed data stream of a page. The codec is
+identified by the first byte of the stream, so pages compressed with
+different codecs can coexist in a tablespace. */
+enum page_zip_codec_t {
+	/** zlib (deflate) */
+	PAGE_ZIP_CODEC_ZLIB = 0,
+	/** LZ4 */
+	PAGE_ZIP_CODEC_LZ4,
+	/** number of codecs */
+	PAGE_ZIP_CODEC_N
+};
+
+/* Codec to be used for compressing pages (page_zip_codec_t).
+Settable by user. */
+extern ulong	page_zip_codec;
+
+/** Bit position of the codec in the compression level that is passed to
+page_zip_compress() and written to the redo log, see page_zip_get_level() */
+#define PAGE_ZIP_LEVEL_CODEC_SHIFT	4
+/** Mask of the compression level in the value of page_zip_get_level() */
+#define PAGE_ZIP_LEVEL_MASK		15
 /** Start offset of the area that will be compressed */
 #define PAGE_ZIP_START			PAGE_NEW_SUPREMUM_END
 /** Size of an compressed page directory entry */
@@ -159,6 +182,96 @@ page_zip_set_alloc(
 	void*		stream,		/*!< in/out: zlib stream */
 	mem_heap_t*	heap);		/*!< in: memory heap to use */
 
+/** Get the compression level and codec for page_zip_compress() from
+innodb_compression_level and innodb_compression_codec.
+@return compression level, with the codec in the bits starting at
+PAGE_ZIP_LEVEL_CODEC_SHIFT */
+UNIV_INLINE
+ulint
+page_zip_get_level();
+
+/** Compressed data stream of a page. The zlib stream fields next_in,
+avail_in, next_out, avail_out, total_in and total_out are used with all
+codecs. For the codecs other than zlib, deflate() and inflate() are
+emulated by buffering all uncompressed data of the page. */
+struct page_zip_stream_t : public z_stream {
+	/** codec of the stream */
+	page_zip_codec_t	codec;
+	/** compression level */
+	int			level;
+	/** uncompressed data, if codec != PAGE_ZIP_CODEC_ZLIB */
+	byte*			buf;
+	/** size of buf */
+	ulint			buf_size;
+	/** length of the uncompressed data in buf */
+	ulint			buf_len;
+	/** number of bytes of buf that were inflated so far */
+	ulint			buf_pos;
+	/** length of the uncompressed data up to the first Z_FULL_FLUSH
+	of deflate, which ends at the second Z_BLOCK of inflate, or
+	ULINT_UNDEFINED */
+	ulint			block_len;
+	/** number of inflate(Z_BLOCK) calls so far */
+	ulint			n_block;
+	/** length of the compressed data after inflate initialization */
+	ulint			in_len;
+};
+
+/** Initialize a stream for compressing a page, like deflateInit2().
+page_zip_set_alloc() must have been called on the stream.
+@param[out]	strm	stream
+@param[in]	codec	codec
+@param[in]	level	compression level of the codec
+@return Z_OK or error code */
+int
+page_zip_deflate_init(
+	page_zip_stream_t*	strm,
+	page_zip_codec_t	codec,
+	int			level);
+
+/** Compress data like deflate(). All input is consumed, and the output
+of the codecs other than zlib is produced on Z_FINISH only.
+@param[in,out]	strm	stream
+@param[in]	flush	Z_NO_FLUSH, Z_FULL_FLUSH or Z_FINISH
+@return Z_OK, Z_STREAM_END, or an error code */
+int
+page_zip_deflate(
+	page_zip_stream_t*	strm,
+	int			flush);
+
+/** Free the memory of a compression stream, like deflateEnd().
+@param[in,out]	strm	stream
+@return Z_OK or error code */
+int
+page_zip_deflate_end(
+	page_zip_stream_t*	strm);
+
+/** Initialize a stream for decompressing a page, like inflateInit2().
+page_zip_set_alloc() must have been called, and next_in and avail_in must
+have been set to the compressed data, whose first byte identifies the
+codec.
+@param[in,out]	strm	stream
+@return Z_OK or error code */
+int
+page_zip_inflate_init(
+	page_zip_stream_t*	strm);
+
+/** Decompress data like inflate().
+@param[in,out]	strm	stream
+@param[in]	flush	Z_BLOCK, Z_SYNC_FLUSH or Z_FINISH
+@return Z_OK, Z_STREAM_END, Z_BUF_ERROR, or an error code */
+int
+page_zip_inflate(
+	page_zip_stream_t*	strm,
+	int			flush);
+
+/** Free the memory of a decompression stream, like inflateEnd().
+@param[in,out]	strm	stream
+@return Z_OK or error code */
+int
+page_zip_inflate_end(
+	page_zip_stream_t*	strm);
+
 /**********************************************************************//**
 Compress a page.
 @return TRUE on success, FALSE on failure; page_zip will be left
@@ -114,6 +114,24 @@ private:
 	@return oldest view if found or NULL */
 	inline ReadView* get_oldest_view() const;
 
+	/**
+	Get the oldest shared view that is in use.
+	@return oldest shared view if found or NULL */
+	inline ReadView* get_oldest_shared_view() const;
+
+	/**
+	Get a reference to the shared view of the current snapshot,
+	creating the view if the snapshot has changed since the last one.
+	@return shared view, or NULL if out of memory */
+	ReadView* shared_view_open();
+
+	/**
+	Find a shared view that is neither published nor in use, if none
+	found then allocate a new view. Caller must own the
+	trx_sys_t::mutex.
+	@return a view to use */
+	inline ReadView* get_shared_view();
+
 private:
 	// Prevent copying
 	MVCC(const MVCC&);
@@ -128,6 +146,14 @@ private:
 	/** Active and closed views, the closed views will have the
 	creator trx id set to TRX_ID_MAX */
 	view_list_t		m_views;
+
+	/** Views shared by AC-NL-RO transactions. They are reused once
+	they are not published and not in use anymore. */
+	view_list_t		m_shared_views;
+
+	/** Shared view of the latest snapshot, written under the
+	trx_sys_t::mutex and read without it */
+	ReadView* volatile	m_published;
 };
 
 #endif /* read0read_h */
@@ -329,6 +329,18 @@ private:
 	/** AC-NL-RO transaction view that has been "closed". */
 	bool		m_closed;
 
+	/** true if the view is shared by AC-NL-RO transactions, see
+	MVCC::view_open() */
+	bool		m_shared;
+
+	/** Value of trx_sys_t::snapshot_version when the view was
+	created */
+	ib_uint64_t	m_version;
+
+	/** Number of transactions using a shared view, and of threads
+	trying to use it */
+	volatile ulint	m_n_refs;
+
 	typedef UT_LIST_NODE_T(ReadView) node_t;
 
 	/** List of read views in trx_sys */
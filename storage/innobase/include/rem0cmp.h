@@ -72,6 +72,22 @@ cmp_data_data(
 	ulint		len2)
 	MY_ATTRIBUTE((nonnull, warn_unused_result));
 
+/** Compare two fields of equal length that collate in byte order.
+@param[in] data1 data field
+@param[in] data2 data field
+@param[in] len length of both fields in bytes
+@return the comparison result of data1 and data2
+@retval 0 if data1 is equal to data2
+@retval negative if data1 is less than data2
+@retval positive if data1 is greater than data2 */
+UNIV_INLINE
+int
+cmp_fixed_binary(
+	const byte*	data1,
+	const byte*	data2,
+	ulint		len)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+
 /** Compare two data fields.
 @param[in] dfield1 data field; must have type field set
 @param[in] dfield2 data field
@@ -137,6 +153,30 @@ cmp_dtuple_rec_with_match_low(
 #define cmp_dtuple_rec_with_match(tuple,rec,offsets,fields)		\
 	cmp_dtuple_rec_with_match_low(					\
 		tuple,rec,offsets,dtuple_get_n_fields_cmp(tuple),fields)
+/** Compare a data tuple to a physical record, using the byte order
+comparison of the leading dict_index_t::n_memcmp_fields of the index.
+@param[in] dtuple data tuple whose fields have the types of the index
+@param[in] rec B-tree record
+@param[in] index index of rec
+@param[in] offsets rec_get_offsets(rec)
+@param[in] n_cmp number of fields to compare
+@param[in,out] matched_fields number of completely matched fields
+@return the comparison result of dtuple and rec
+@retval 0 if dtuple is equal to rec
+@retval negative if dtuple is less than rec
+@retval positive if dtuple is greater than rec */
+int
+cmp_dtuple_rec_with_match_low(
+	const dtuple_t*		dtuple,
+	const rec_t*		rec,
+	const dict_index_t*	index,
+	const ulint*		offsets,
+	ulint			n_cmp,
+	ulint*			matched_fields)
+	MY_ATTRIBUTE((nonnull));
+#define cmp_dtuple_rec_with_match_index(tuple,rec,index,offsets,fields)	\
+	cmp_dtuple_rec_with_match_low(					\
+		tuple,rec,index,offsets,dtuple_get_n_fields_cmp(tuple),fields)
 /** Compare a data tuple to a physical record.
 @param[in]	dtuple		data tuple
 @param[in]	rec		B-tree or R-tree index record
@@ -197,7 +237,7 @@ cmp_rec_rec_simple(
 	const dict_index_t*	index,	/*!< in: data dictionary index */
 	struct TABLE*		table)	/*!< in: MySQL table, for reporting
 					duplicate key value if applicable,
-					or NULL */
+					or NULL to only detect duplicates */
 	MY_ATTRIBUTE((nonnull(1,2,3,4), warn_unused_result));
 /** Compare two B-tree records.
 @param[in] rec1 B-tree record
@@ -374,6 +374,7 @@ row_merge_file_create(
 @param[in,out]	stage	performance schema accounting object, used by
 ALTER TABLE. If not NULL, stage->begin_phase_sort() will be called initially
 and then stage->inc() will be called for each record processed.
+@param[in]	n_threads	number of threads merging the runs of a pass
 @return DB_SUCCESS or error code */
 dberr_t
 row_merge_sort(
@@ -382,7 +383,8 @@ row_merge_sort(
 	merge_file_t*		file,
 	row_merge_block_t*	block,
 	int*			tmpfd,
-	ut_stage_alter_t*	stage = NULL);
+	ut_stage_alter_t*	stage = NULL,
+	ulint			n_threads = 1);
 
 /*********************************************************************//**
 Allocate a sort buffer.
@@ -61,6 +61,14 @@ row_mysql_prebuilt_free_blob_heap(
 	row_prebuilt_t*	prebuilt);	/*!< in: prebuilt struct of a
 					ha_innobase:: table handle */
 /*******************************************************************//**
+Frees the fetch cache in prebuilt, after checking the magic numbers
+around it. */
+void
+row_mysql_prebuilt_free_fetch_cache(
+/*================================*/
+	row_prebuilt_t*	prebuilt);	/*!< in/out: prebuilt struct of a
+					ha_innobase:: table handle */
+/*******************************************************************//**
 Stores a >= 5.0.3 format true VARCHAR length to dest, in the MySQL row
 format.
 @return pointer to the data, we skip the 1 or 2 bytes at the start
@@ -585,11 +593,9 @@ row_scan_index_for_mysql(
 	row_prebuilt_t*		prebuilt,	/*!< in: prebuilt struct
 						in MySQL handle */
 	const dict_index_t*	index,		/*!< in: index */
-#ifdef WL6742
 	bool			check_keys,	/*!< in: true=check for mis-
 						ordered or duplicate records,
 						false=count the rows only */
-#endif
 	ulint*			n_rows)		/*!< out: number of entries
 						seen in the consistent read */
 	MY_ATTRIBUTE((warn_unused_result));
@@ -667,6 +673,8 @@ struct mysql_row_templ_t {
 	ulint	is_virtual;		/*!< if a column is a virtual column */
 };
 
+/* Number of rows prefetched in the first batch of a scan. The batches
+grow from this up to innodb_fetch_cache_size bytes while the scan goes on */
 #define MYSQL_FETCH_CACHE_SIZE		8
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
@@ -848,16 +856,22 @@ struct row_prebuilt_t {
 	ulint		n_rows_fetched;	/*!< number of rows fetched after
 					positioning the current cursor */
 	ulint		fetch_direction;/*!< ROW_SEL_NEXT or ROW_SEL_PREV */
-	byte*		fetch_cache[MYSQL_FETCH_CACHE_SIZE];
-					/*!< a cache for fetched rows if we
+	byte*		fetch_cache;	/*!< a cache for fetched rows if we
 					fetch many rows from the same cursor:
 					it saves CPU time to fetch them in a
-					batch; we reserve mysql_row_len
-					bytes for each such row; these
-					pointers point 4 bytes past the
+					batch; the rows are stored back to
+					back, mysql_row_len bytes each; this
+					pointer points 4 bytes past the
 					allocated mem buf start, because
 					there is a 4 byte magic number at the
-					start and at the end */
+					start and at the end; NULL if not
+					allocated yet */
+	ulint		fetch_cache_size;/*!< number of rows which fit in
+					fetch_cache */
+	ulint		fetch_cache_limit;/*!< number of rows to prefetch
+					in the current batch; doubles each
+					time a batch has been consumed by the
+					scan */
 	ibool		keep_other_fields_on_keyread; /*!< when using fetch
 					cache with HA_EXTRA_KEYREAD, don't
 					overwrite other fields in mysql row
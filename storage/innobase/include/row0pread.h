@@ -0,0 +1,143 @@
+/*****************************************************************************
+
+Copyright (c) 2023, Oracle and/or its affiliates.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License, version 2.0,
+as published by the Free Software Foundation.
+
+This program is also distributed with certain software (including
+but not limited to OpenSSL) that is licensed under separate terms,
+as designated in a particular file or component or in included license
+documentation.  The authors of MySQL hereby grant you an additional
+permission to link the program and your derivative works with the
+separately licensed software that they have included with MySQL.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License, version 2.0, for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/row0pread.h
+Parallel scan of an index
+
+The index is split into key ranges at the node pointers of a level of
+the B-tree, and a pool of threads scans the ranges.
+*******************************************************/
+
+#ifndef row0pread_h
+#define row0pread_h
+
+#include "univ.i"
+#include "data0types.h"
+#include "dict0types.h"
+#include "mem0mem.h"
+#include "read0types.h"
+#include "rem0types.h"
+#include "trx0types.h"
+
+/** A key range of an index */
+struct row_pread_range_t {
+	/** first key of the range, or NULL if the range starts at the
+	beginning of the index */
+	const dtuple_t*	start;
+	/** first key after the range, or NULL if the range extends to
+	the end of the index */
+	const dtuple_t*	end;
+};
+
+/** A function that row_pread_run_threads() executes in each thread.
+@param[in,out]	ctx		context shared by the threads
+@param[in]	thread_no	0 in the calling thread, or the number of
+the thread that was created for executing the function */
+typedef void (*row_pread_task_t)(void* ctx, ulint thread_no);
+
+/** Functions called by the threads of row_pread_scan() */
+struct row_pread_func_t {
+	/** Process a record. The record and its offsets are only valid
+	until the function returns.
+	@param[in,out]	ctx		context of the scan
+	@param[in]	thread_no	number of the thread
+	@param[in]	rec		record that is visible in the read view
+	and not delete-marked
+	@param[in]	offsets		rec_get_offsets(rec)
+	@return DB_SUCCESS, or an error code to stop the scan */
+	dberr_t	(*rec)(void* ctx, ulint thread_no,
+		       const rec_t* rec, const ulint* offsets);
+
+	/** Account for records that were read, or NULL. Called at the
+	end of each leaf page.
+	@param[in,out]	ctx		context of the scan
+	@param[in]	thread_no	number of the thread
+	@param[in]	n_recs		number of records read on the page,
+	including those that were not passed to rec() */
+	void	(*page)(void* ctx, ulint thread_no, ulint n_recs);
+
+	/** Finish the scan in a thread, or NULL. Not called in a thread
+	that failed, or after the scan was stopped.
+	@param[in,out]	ctx		context of the scan
+	@param[in]	thread_no	number of the thread
+	@return DB_SUCCESS or error code */
+	dberr_t	(*end)(void* ctx, ulint thread_no);
+};
+
+/** Execute a task in several threads and wait for them to complete.
+The calling thread executes the task as thread 0.
+@param[in]	task		the function to execute
+@param[in,out]	ctx		context shared by the threads
+@param[in]	n_threads	number of threads, including the calling one */
+void
+row_pread_run_threads(
+	row_pread_task_t	task,
+	void*			ctx,
+	ulint			n_threads);
+
+/** Split an index into key ranges for scanning them in parallel. The
+ranges are bounded by the node pointers of the highest non-leaf level
+that has enough of them, or of the level right above the leaves.
+@param[in]	index		index tree
+@param[in]	n_threads	number of threads that will scan the ranges
+@param[in,out]	heap		memory heap for the ranges
+@param[out]	ranges		key ranges, in ascending order
+@return number of ranges; 1 if the index consists of the root page only */
+ulint
+row_pread_split(
+	dict_index_t*		index,
+	ulint			n_threads,
+	mem_heap_t*		heap,
+	row_pread_range_t**	ranges);
+
+/** Scan key ranges of a clustered index in parallel, and call
+func->rec() for each record that is visible in a read view and is not
+delete-marked. The threads yield to the waiters on the index tree lock
+between leaf pages, like a single-threaded scan in
+row_merge_read_clustered_index().
+@param[in]	trx		transaction, for checking interruption
+@param[in]	index		clustered index
+@param[in]	view		read view, or NULL to read the latest version
+@param[in]	ranges		key ranges returned by row_pread_split()
+@param[in]	n_ranges	number of ranges
+@param[in]	n_threads	number of threads
+@param[in]	func		functions to call in the threads
+@param[in,out]	ctx		context passed to the functions
+@return DB_SUCCESS, DB_INTERRUPTED, or the error returned by func */
+dberr_t
+row_pread_scan(
+	trx_t*				trx,
+	dict_index_t*			index,
+	ReadView*			view,
+	const row_pread_range_t*	ranges,
+	ulint				n_ranges,
+	ulint				n_threads,
+	const row_pread_func_t*		func,
+	void*				ctx)
+	MY_ATTRIBUTE((warn_unused_result));
+
+#endif /* row0pread_h */
@@ -180,6 +180,11 @@ enum monitor_id_t {
 	MONITOR_OVLD_PAGES_READ,
 	MONITOR_OVLD_BYTE_READ,
 	MONITOR_OVLD_BYTE_WRITTEN,
+	MONITOR_OVLD_LRU_MIDPOINT_PAGE_GETS,
+	MONITOR_OVLD_LRU_MIDPOINT_PAGES_READ,
+	MONITOR_OVLD_LRU_2Q_PAGE_GETS,
+	MONITOR_OVLD_LRU_2Q_PAGES_READ,
+	MONITOR_OVLD_LRU_2Q_GHOST_HITS,
 	MONITOR_FLUSH_BATCH_SCANNED,
 	MONITOR_FLUSH_BATCH_SCANNED_NUM_CALL,
 	MONITOR_FLUSH_BATCH_SCANNED_PER_CALL,
@@ -312,6 +317,9 @@ enum monitor_id_t {
 	MONITOR_PURGE_INVOKED,
 	MONITOR_PURGE_N_PAGE_HANDLED,
 	MONITOR_DML_PURGE_DELAY,
+	MONITOR_PURGE_BATCH_SIZE,
+	MONITOR_PURGE_N_TABLES,
+	MONITOR_PURGE_N_TABLES_TAKEN,
 	MONITOR_PURGE_STOP_COUNT,
 	MONITOR_PURGE_RESUME_COUNT,
 
@@ -348,6 +356,8 @@ enum monitor_id_t {
 	MONITOR_INDEX_REORG_ATTEMPTS,
 	MONITOR_INDEX_REORG_SUCCESSFUL,
 	MONITOR_INDEX_DISCARD,
+	MONITOR_INDEX_INS_RETRY,
+	MONITOR_INDEX_INS_RETRY_SUCCESSFUL,
 
 	/* Adaptive Hash Index related counters */
 	MONITOR_MODULE_ADAPTIVE_HASH,
@@ -359,6 +369,10 @@ enum monitor_id_t {
 	MONITOR_ADAPTIVE_HASH_ROW_REMOVED,
 	MONITOR_ADAPTIVE_HASH_ROW_REMOVE_NOT_FOUND,
 	MONITOR_ADAPTIVE_HASH_ROW_UPDATED,
+	MONITOR_ADAPTIVE_HASH_SEARCH_FAIL,
+	MONITOR_ADAPTIVE_HASH_INDEX_DISABLED,
+	MONITOR_ADAPTIVE_HASH_INDEX_ENABLED,
+	MONITOR_ADAPTIVE_HASH_PAGE_REMOVED_LAZILY,
 
 	/* Tablespace related counters */
 	MONITOR_MODULE_FIL_SYSTEM,
@@ -374,6 +388,10 @@ enum monitor_id_t {
 	MONITOR_OVLD_IBUF_MERGE_DISCARD_PURGE,
 	MONITOR_OVLD_IBUF_MERGES,
 	MONITOR_OVLD_IBUF_SIZE,
+	MONITOR_IBUF_MERGE_BATCHES,
+	MONITOR_IBUF_MERGE_PAGES_SCHEDULED,
+	MONITOR_IBUF_MERGE_BYTES_SCHEDULED,
+	MONITOR_IBUF_MERGE_SWEEPS,
 
 	/* Counters for server operations */
 	MONITOR_MODULE_SERVER,
@@ -424,6 +442,16 @@ enum monitor_id_t {
 	MONITOR_ICP_OUT_OF_RANGE,
 	MONITOR_ICP_MATCH,
 
+	/* Full-text index related counters */
+	MONITOR_MODULE_FTS,
+	MONITOR_FTS_CACHE_SIZE,
+	MONITOR_FTS_SYNC,
+	MONITOR_FTS_SYNC_PASSES,
+	MONITOR_FTS_SYNC_EXCLUSIVE_PASSES,
+	MONITOR_FTS_SYNC_MICROSECOND,
+	MONITOR_FTS_OPTIMIZE,
+	MONITOR_FTS_OPTIMIZE_MICROSECOND,
+
 	/* Mutex/RW-Lock related counters */
 	MONITOR_MODULE_LATCHES,
 	MONITOR_LATCHES,
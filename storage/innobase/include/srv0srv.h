@@ -228,6 +228,11 @@ extern ibool	srv_locks_unsafe_for_binlog;
 
 /** Sort buffer size in index creation */
 extern ulong	srv_sort_buf_size;
+/** Number of threads scanning, sorting and loading in index creation */
+extern ulong	srv_ddl_threads;
+/** Number of threads checking the records of a clustered index in
+CHECK TABLE */
+extern ulong	srv_parallel_read_threads;
 /** Maximum modification log file size for online index creation */
 extern unsigned long long	srv_online_max_size;
 
@@ -236,6 +241,9 @@ OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 extern my_bool	srv_use_native_aio;
+/** If this flag is TRUE, native aio on Linux uses io_uring instead of
+libaio, provided it was compiled in and the kernel supports it */
+extern my_bool	srv_use_io_uring;
 extern my_bool	srv_numa_interleave;
 #endif /* !UNIV_HOTBACKUP */
 
@@ -295,8 +303,20 @@ extern ib_uint64_t	srv_log_file_size;
 extern ib_uint64_t	srv_log_file_size_requested;
 extern ulint	srv_log_buffer_size;
 extern ulong	srv_flush_log_at_trx_commit;
+/** Whether the commit of a transaction that wrote no redo log waits until
+the commits whose changes it may have read are durable */
+extern my_bool	srv_commit_wait_dependencies;
 extern uint	srv_flush_log_at_timeout;
 extern ulong	srv_log_write_ahead_size;
+/** Whether the log writer and log flusher threads are used */
+extern my_bool	srv_log_writer_threads;
+/** Whether each buffer pool instance has an LRU manager thread */
+extern my_bool	srv_lru_manager_threads;
+/** Maximum spin time in microseconds of a thread waiting for a redo log
+write or flush */
+extern ulong	srv_log_wait_for_flush_spin_hwm;
+/** Number of events that the redo log waiters are spread over */
+extern ulong	srv_log_events;
 extern char	srv_adaptive_flushing;
 extern my_bool	srv_flush_sync;
 
@@ -322,6 +342,8 @@ extern const ulong	srv_buf_pool_instances_default;
 extern ulong	srv_n_page_hash_locks;
 /** Scan depth for LRU flush batch i.e.: number of blocks scanned*/
 extern ulong	srv_LRU_scan_depth;
+/** Replacement policy of the LRU lists, buf_LRU_policy_t */
+extern ulong	srv_buf_pool_LRU_policy;
 /** Whether or not to flush neighbors of a block */
 extern ulong	srv_flush_neighbors;
 /** Previously requested size */
@@ -338,6 +360,7 @@ extern ulint	srv_lock_table_size;
 extern ulint	srv_n_file_io_threads;
 extern my_bool	srv_random_read_ahead;
 extern ulong	srv_read_ahead_threshold;
+extern ulong	srv_fetch_cache_size;
 extern ulint	srv_n_read_io_threads;
 extern ulint	srv_n_write_io_threads;
 
@@ -367,6 +390,9 @@ extern ulint	srv_max_n_open_files;
 
 extern ulong	srv_n_page_cleaners;
 
+/** Number of threads applying redo log records during crash recovery */
+extern ulong	srv_n_recv_apply_threads;
+
 extern double	srv_max_dirty_pages_pct;
 extern double	srv_max_dirty_pages_pct_lwm;
 
@@ -390,6 +416,7 @@ extern ibool	srv_innodb_status;
 extern unsigned long long	srv_stats_transient_sample_pages;
 extern my_bool			srv_stats_persistent;
 extern unsigned long long	srv_stats_persistent_sample_pages;
+extern ulong			srv_stats_histogram_buckets;
 extern my_bool			srv_stats_auto_recalc;
 extern my_bool			srv_stats_include_delete_marked;
 
@@ -475,13 +502,17 @@ extern srv_stats_t	srv_stats;
 # ifdef UNIV_PFS_THREAD
 /* Keys to register InnoDB threads with performance schema */
 extern mysql_pfs_key_t	buf_dump_thread_key;
+extern mysql_pfs_key_t	buf_lru_manager_thread_key;
 extern mysql_pfs_key_t	dict_stats_thread_key;
 extern mysql_pfs_key_t	io_handler_thread_key;
 extern mysql_pfs_key_t	io_ibuf_thread_key;
 extern mysql_pfs_key_t	io_log_thread_key;
 extern mysql_pfs_key_t	io_read_thread_key;
 extern mysql_pfs_key_t	io_write_thread_key;
+extern mysql_pfs_key_t	log_flusher_thread_key;
+extern mysql_pfs_key_t	log_writer_thread_key;
 extern mysql_pfs_key_t	page_cleaner_thread_key;
+extern mysql_pfs_key_t	recv_apply_thread_key;
 extern mysql_pfs_key_t	recv_writer_thread_key;
 extern mysql_pfs_key_t	srv_error_monitor_thread_key;
 extern mysql_pfs_key_t	srv_lock_timeout_thread_key;
@@ -972,6 +1003,7 @@ struct srv_slot_t{
 #else /* !UNIV_HOTBACKUP */
 # define srv_use_adaptive_hash_indexes		FALSE
 # define srv_use_native_aio			FALSE
+# define srv_use_io_uring			FALSE
 # define srv_numa_interleave			FALSE
 # define srv_force_recovery			0UL
 # define srv_set_io_thread_op_info(t,info)	((void) 0)
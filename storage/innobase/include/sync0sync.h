@@ -126,6 +126,8 @@ extern mysql_pfs_key_t	sync_array_mutex_key;
 extern mysql_pfs_key_t	thread_mutex_key;
 extern mysql_pfs_key_t  zip_pad_mutex_key;
 extern mysql_pfs_key_t  row_drop_list_mutex_key;
+extern mysql_pfs_key_t	row_merge_mutex_key;
+extern mysql_pfs_key_t	row_pread_mutex_key;
 extern mysql_pfs_key_t	master_key_id_mutex_key;
 extern mysql_pfs_key_t	analyze_index_mutex_key;
 #endif /* UNIV_PFS_MUTEX */
@@ -134,6 +136,7 @@ extern mysql_pfs_key_t	analyze_index_mutex_key;
 /* Following are rwlock keys used to register with MySQL
 performance schema */
 extern	mysql_pfs_key_t btr_search_latch_key;
+extern	mysql_pfs_key_t btr_search_page_latch_key;
 # ifndef PFS_SKIP_BUFFER_MUTEX_RWLOCK
 extern	mysql_pfs_key_t	buf_block_lock_key;
 # endif /* PFS_SKIP_BUFFER_MUTEX_RWLOCK */
@@ -142,6 +145,7 @@ extern	mysql_pfs_key_t	buf_block_debug_latch_key;
 # endif /* UNIV_DEBUG */
 extern	mysql_pfs_key_t	dict_operation_lock_key;
 extern	mysql_pfs_key_t	checkpoint_lock_key;
+extern	mysql_pfs_key_t	lock_sys_latch_key;
 extern	mysql_pfs_key_t	fil_space_latch_key;
 extern	mysql_pfs_key_t	fts_cache_rw_lock_key;
 extern	mysql_pfs_key_t	fts_cache_init_rw_lock_key;
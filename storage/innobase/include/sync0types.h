@@ -218,6 +218,8 @@ enum latch_level_t {
 
 	SYNC_MONITOR_MUTEX,
 
+	SYNC_FIL_SPACE_HASH,
+
 	SYNC_ANY_LATCH,
 
 	SYNC_DOUBLEWRITE,
@@ -251,6 +253,7 @@ enum latch_level_t {
 	SYNC_THREADS,
 	SYNC_TRX,
 	SYNC_TRX_SYS,
+	SYNC_LOCK_SYS_SHARD,
 	SYNC_LOCK_SYS,
 	SYNC_LOCK_WAIT_SYS,
 
@@ -364,6 +367,7 @@ enum latch_id_t {
 	LATCH_ID_TRX_POOL_MANAGER,
 	LATCH_ID_TRX,
 	LATCH_ID_LOCK_SYS,
+	LATCH_ID_LOCK_SYS_SHARD,
 	LATCH_ID_LOCK_SYS_WAIT,
 	LATCH_ID_TRX_SYS,
 	LATCH_ID_SRV_SYS,
@@ -380,14 +384,18 @@ enum latch_id_t {
 	LATCH_ID_OS_AIO_IBUF_MUTEX,
 	LATCH_ID_OS_AIO_SYNC_MUTEX,
 	LATCH_ID_ROW_DROP_LIST,
+	LATCH_ID_ROW_MERGE,
+	LATCH_ID_ROW_PREAD,
 	LATCH_ID_INDEX_ONLINE_LOG,
 	LATCH_ID_WORK_QUEUE,
 	LATCH_ID_BTR_SEARCH,
+	LATCH_ID_BTR_SEARCH_PAGE,
 	LATCH_ID_BUF_BLOCK_LOCK,
 	LATCH_ID_BUF_BLOCK_DEBUG,
 	LATCH_ID_DICT_OPERATION,
 	LATCH_ID_CHECKPOINT,
 	LATCH_ID_FIL_SPACE,
+	LATCH_ID_FIL_SPACE_HASH,
 	LATCH_ID_FTS_CACHE,
 	LATCH_ID_FTS_CACHE_INIT,
 	LATCH_ID_TRX_I_S_CACHE,
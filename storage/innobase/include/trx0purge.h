@@ -44,6 +44,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "fil0fil.h"
 #include "read0types.h"
 #include "srv0start.h"
+#include "ut0vec.h"
 
 /** The global data structure coordinating a purge */
 extern trx_purge_t*	purge_sys;
@@ -101,6 +102,11 @@ trx_purge(
 	ulint	limit,			/*!< in: the maximum number of
 					records to purge in one batch */
 	bool	truncate);		/*!< in: truncate history if true */
+/** Take the undo records of a table that no purge thread has started
+purging in the current batch.
+@return vector of trx_purge_rec_t, or NULL if none is left */
+ib_vector_t*
+trx_purge_next_group();
 /*******************************************************************//**
 Stop purge and wait for it to stop, move to PURGE_STATE_STOP. */
 void
@@ -392,6 +398,12 @@ namespace undo {
 
 };	/* namespace undo */
 
+/** Undo records of a purge batch, grouped by table. Each element is a
+vector of trx_purge_rec_t, which is purged from the last element to the
+first one. */
+typedef std::vector<ib_vector_t*, ut_allocator<ib_vector_t*> >
+	purge_groups_t;
+
 /** The control structure used in the purge operation */
 struct trx_purge_t{
 	sess_t*		sess;		/*!< System session running the purge
@@ -422,6 +434,14 @@ struct trx_purge_t{
 	volatile ulint	n_submitted;	/*!< Count of total tasks submitted
 					to the task queue */
 	volatile ulint	n_completed;	/*!< Count of total tasks completed */
+	mem_heap_t*	heap;		/*!< Memory heap for the undo records
+					of the current batch */
+	purge_groups_t*	groups;		/*!< Undo records of the current
+					batch, grouped by table. A group is
+					purged by one thread at a time. */
+	volatile ulint	next_group;	/*!< Number of the first element of
+					groups that no purge thread has
+					taken */
 
 	/*------------------------------*/
 	/* The following two fields form the 'purge pointer' which advances
@@ -579,9 +579,27 @@ struct trx_sys_t {
 					volatile because it can be accessed
 					without holding any mutex during
 					AC-NL-RO view creation. */
+	volatile ib_uint64_t
+			snapshot_version;
+					/*!< Incremented whenever max_trx_id,
+					rw_trx_ids or serialisation_list
+					change, that is, whenever a read view
+					created now would differ from the
+					previous one. Read without holding
+					any mutex by MVCC::view_open() to
+					check whether a shared AC-NL-RO view
+					is still current. */
 	trx_ut_list_t	serialisation_list;
 					/*!< Ordered on trx_t::no of all the
 					currenrtly active RW transactions */
+	volatile lsn_t	max_commit_lsn;	/*!< The biggest commit lsn of the
+					read-write transactions that have
+					been removed from rw_trx_ids. Their
+					changes are visible, and their locks
+					may have been released, before the
+					log is flushed up to this lsn. Read
+					without holding any mutex by
+					trx_commit_in_memory(). */
 #ifdef UNIV_DEBUG
 	trx_id_t	rw_max_trx_id;	/*!< Max trx id of read-write
 					transactions which exist or existed */
@@ -738,9 +738,14 @@ struct trx_lock_t {
 					hold lock_sys->mutex, except when
 					they are holding trx->mutex and
 					wait_lock==NULL */
-	ib_uint64_t	deadlock_mark;	/*!< A mark field that is initialized
-					to and checked against lock_mark_counter
-					by lock_deadlock_recursive(). */
+	trx_t* volatile	blocking_trx;	/*!< If this transaction is waiting
+					for a lock, a transaction which
+					holds or requests a conflicting lock
+					ahead in the queue, else NULL; the
+					deadlock detector searches the
+					waits-for graph when it changes.
+					Written under the same latches as
+					the queue of wait_lock */
 	bool		was_chosen_as_deadlock_victim;
 					/*!< when the transaction decides to
 					wait for a lock, it sets this to false;
@@ -987,8 +992,8 @@ struct trx_t {
 	ACTIVE->COMMITTED is possible when the transaction is in
 	rw_trx_list.
 
-	Transitions to COMMITTED are protected by both lock_sys->mutex
-	and trx->mutex.
+	Transitions to COMMITTED are protected by both lock_sys->latch
+	(in shared mode at least) and trx->mutex.
 
 	NOTE: Some of these state change constraints are an overkill,
 	currently only required for a consistent view for printing stats.
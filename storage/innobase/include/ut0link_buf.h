@@ -0,0 +1,216 @@
+/*****************************************************************************
+
+Copyright (c) 2023, Oracle and/or its affiliates.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License, version 2.0,
+as published by the Free Software Foundation.
+
+This program is also distributed with certain software (including
+but not limited to OpenSSL) that is licensed under separate terms,
+as designated in a particular file or component or in included license
+documentation.  The authors of MySQL hereby grant you an additional
+permission to link the program and your derivative works with the
+separately licensed software that they have included with MySQL.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License, version 2.0, for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/ut0link_buf.h
+
+Link buffer: tracks ranges of positions which are completed concurrently
+and possibly out of order, and finds the longest completed prefix.
+*******************************************************/
+
+#ifndef ut0link_buf_h
+#define ut0link_buf_h
+
+#include "univ.i"
+#include "os0atomic.h"
+#include "ut0new.h"
+
+/** Concurrent data structure which tracks ranges [from, to) of positions
+that have been completed by many threads in arbitrary order.
+
+Every completed range is stored as a link in a circular array of slots,
+indexed by the start position of the range modulo the capacity. A single
+thread at a time may then advance the tail over the links: the tail is
+the end of the longest prefix of positions which are all completed.
+
+Contract:
+- add_link() may be called concurrently by any thread, but only for
+  ranges which do not overlap and whose start lies in
+  [tail(), tail() + capacity()), see has_space();
+- advance_tail(), reset() and has_space() must be serialized by the
+  caller (for the redo log buffer this is log_sys->mutex).
+
+@tparam Position	type of positions (e.g. lsn_t) */
+template <typename Position>
+class Link_buf {
+public:
+	/** Constructor.
+	@param[in]	capacity	number of slots, must be a power of two */
+	explicit Link_buf(ulint capacity)
+		:
+		m_capacity(capacity),
+		m_links(NULL),
+		m_tail(0)
+	{
+		ut_a(ut_is_2pow(capacity));
+		ut_a(capacity > 0);
+
+		m_links = UT_NEW_ARRAY_NOKEY(ulint, capacity);
+
+		for (ulint i = 0; i < capacity; ++i) {
+			m_links[i] = 0;
+		}
+	}
+
+	/** Destructor. */
+	~Link_buf()
+	{
+		UT_DELETE_ARRAY(const_cast<ulint*>(m_links));
+	}
+
+	/** Mark the range [from, to) as completed. Everything that was
+	written to the range before this call becomes visible to the thread
+	which later advances the tail over it.
+	@param[in]	from	start of the range
+	@param[in]	to	end of the range, must be greater than from */
+	void add_link(Position from, Position to)
+	{
+		ut_ad(to > from);
+		ut_ad(static_cast<Position>(static_cast<ulint>(to - from))
+		      == to - from);
+
+		volatile ulint*	slot = &m_links[slot_index(from)];
+
+		ut_ad(*slot == 0);
+
+		/* Publish the contents of the range before the link. */
+		os_wmb;
+
+		*slot = static_cast<ulint>(to - from);
+	}
+
+	/** Advance the tail over all the consecutive links.
+	@return true if the tail has moved */
+	bool advance_tail()
+	{
+		Position	tail = m_tail;
+
+		for (;;) {
+			volatile ulint*	slot = &m_links[slot_index(tail)];
+
+			const ulint	distance = *slot;
+
+			if (distance == 0) {
+				break;
+			}
+
+			/* Make sure the contents of the range are read
+			after the link which covers it. */
+			os_rmb;
+
+			*slot = 0;
+
+			tail += distance;
+		}
+
+		if (tail == m_tail) {
+			return(false);
+		}
+
+		m_tail = tail;
+
+		return(true);
+	}
+
+	/** Advance the tail as much as possible and check whether it has
+	reached a given position.
+	@param[in]	position	position to reach
+	@return true if all the positions before the given one are completed */
+	bool advance_tail_until(Position position)
+	{
+		if (m_tail < position) {
+			advance_tail();
+		}
+
+		return(m_tail >= position);
+	}
+
+	/** Check whether a range starting at the given position can be
+	linked without colliding with a range which is not consumed yet.
+	@param[in]	position	start of the range
+	@return true if add_link(position, ...) is allowed */
+	bool has_space(Position position) const
+	{
+		ut_ad(position >= m_tail);
+
+		return(position - m_tail < m_capacity);
+	}
+
+	/** @return the end of the longest completed prefix */
+	Position tail() const
+	{
+		return(m_tail);
+	}
+
+	/** @return number of slots */
+	ulint capacity() const
+	{
+		return(m_capacity);
+	}
+
+	/** Move the tail to a new position. There must be no links which
+	have not been consumed by advance_tail().
+	@param[in]	position	new tail */
+	void reset(Position position)
+	{
+		ut_d(validate_no_links());
+
+		m_tail = position;
+	}
+
+#ifdef UNIV_DEBUG
+	/** Assert that there is no pending link. */
+	void validate_no_links() const
+	{
+		for (ulint i = 0; i < m_capacity; ++i) {
+			ut_a(m_links[i] == 0);
+		}
+	}
+#endif /* UNIV_DEBUG */
+
+private:
+	/** @return slot used by a range starting at the given position */
+	ulint slot_index(Position position) const
+	{
+		return(static_cast<ulint>(position & (m_capacity - 1)));
+	}
+
+	/** Number of slots, a power of two */
+	const ulint		m_capacity;
+
+	/** Length of the completed range which starts at the position
+	mapped to the slot, or 0 if none */
+	volatile ulint*		m_links;
+
+	/** End of the longest completed prefix */
+	Position		m_tail;
+
+	/* Disable copying */
+	Link_buf(const Link_buf&);
+	Link_buf& operator=(const Link_buf&);
+};
+
+#endif /* ut0link_buf_h */
@@ -44,6 +44,21 @@ IF(UNIX)
       LINK_LIBRARIES(aio)
     ENDIF()
 
+    CHECK_C_SOURCE_COMPILES("
+    #include <linux/io_uring.h>
+    #include <sys/syscall.h>
+    int main() {
+      struct io_uring_params p;
+      return __NR_io_uring_setup + __NR_io_uring_enter
+        + __NR_io_uring_register + IORING_FEAT_SINGLE_MMAP
+        + IORING_OP_READ_FIXED + IORING_OP_READV + (int) sizeof(p);
+    }"
+    HAVE_LINUX_IO_URING)
+
+    IF(HAVE_LINUX_IO_URING)
+      ADD_DEFINITIONS(-DLINUX_IO_URING=1)
+    ENDIF()
+
   ELSEIF(CMAKE_SYSTEM_NAME STREQUAL "SunOS")
     ADD_DEFINITIONS("-DUNIV_SOLARIS")
   ENDIF()
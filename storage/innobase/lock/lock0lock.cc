@@ -49,6 +49,7 @@ Created 5/7/1996 Heikki Tuuri
 #include "trx0purge.h"
 #include "trx0sys.h"
 #include "srv0mon.h"
+#include "sync0sync.h"
 #include "ut0vec.h"
 #include "btr0btr.h"
 #include "dict0boot.h"
@@ -57,6 +58,7 @@ Created 5/7/1996 Heikki Tuuri
 #include "row0mysql.h"
 #include "pars0pars.h"
 
+#include <algorithm>
 #include <set>
 
 /* Flag to enable/disable deadlock detector. */
@@ -74,142 +76,86 @@ static const ulint	TABLE_LOCK_CACHE = 8;
 /** Size in bytes, of the table lock instance */
 static const ulint	TABLE_LOCK_SIZE = sizeof(ib_lock_t);
 
-/** Deadlock checker. */
+/** Deadlock checker. The waits-for graph is not searched by the thread
+which requests a lock: lock_wait_timeout_thread() looks for cycles in a
+snapshot of the graph without holding lock_sys->latch, and then resolves
+them here. */
 class DeadlockChecker {
 public:
-	/** Checks if a joining lock request results in a deadlock. If
-	a deadlock is found this function will resolve the deadlock
-	by choosing a victim transaction and rolling it back. It
-	will attempt to resolve all deadlocks. The returned transaction
-	id will be the joining transaction id or 0 if some other
-	transaction was chosen as a victim and rolled back or no
-	deadlock found.
+	/** Checks if a joining lock request must be refused at once. This
+	is the case if the transaction has been marked for asynchronous
+	rollback by a high priority transaction, and must not wait for
+	another lock. Cycles in the waits-for graph are resolved later by
+	resolve_cycle().
 
 	@param lock lock the transaction is requesting
 	@param trx transaction requesting the lock
 
-	@return id of transaction chosen as victim or 0 */
+	@return trx if it is to be rolled back, else NULL */
 	static const trx_t* check_and_resolve(
 		const lock_t*	lock,
 		trx_t*		trx);
 
-private:
-	/** Do a shallow copy. Default destructor OK.
-	@param trx the start transaction (start node)
-	@param wait_lock lock that a transaction wants
-	@param mark_start visited node counter */
-	DeadlockChecker(
-		const trx_t*	trx,
-		const lock_t*	wait_lock,
-		ib_uint64_t	mark_start)
-		:
-		m_cost(),
-		m_start(trx),
-		m_too_deep(),
-		m_wait_lock(wait_lock),
-		m_mark_start(mark_start),
-		m_n_elems()
-	{
-	}
-
-	/** Check if the search is too deep. */
-	bool is_too_deep() const
-	{
-		return(m_n_elems > LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK
-		       || m_cost > LOCK_MAX_N_STEPS_IN_DEADLOCK_CHECK);
-	}
-
-	/** Save current state.
-	@param lock lock to push on the stack.
-	@param heap_no the heap number to push on the stack.
-	@return false if stack is full. */
-	bool push(const lock_t*	lock, ulint heap_no)
-	{
-		ut_ad((lock_get_type_low(lock) & LOCK_REC)
-		      || (lock_get_type_low(lock) & LOCK_TABLE));
-
-		ut_ad(((lock_get_type_low(lock) & LOCK_TABLE) != 0)
-		      == (heap_no == ULINT_UNDEFINED));
-
-		/* Ensure that the stack is bounded. */
-		if (m_n_elems >= UT_ARR_SIZE(s_states)) {
-			return(false);
-		}
-
-		state_t&	state = s_states[m_n_elems++];
-
-		state.m_lock = lock;
-		state.m_wait_lock = m_wait_lock;
-		state.m_heap_no =heap_no;
-
-		return(true);
-	}
-
-	/** Restore state.
-	@param[out] lock current lock
-	@param[out] heap_no current heap_no */
-	void pop(const lock_t*& lock, ulint& heap_no)
-	{
-		ut_a(m_n_elems > 0);
-
-		const state_t&	state = s_states[--m_n_elems];
-
-		lock = state.m_lock;
-		heap_no = state.m_heap_no;
-		m_wait_lock = state.m_wait_lock;
-	}
-
-	/** Check whether the node has been visited.
-	@param lock lock to check
-	@return true if the node has been visited */
-	bool is_visited(const lock_t* lock) const
-	{
-		return(lock->trx->lock.deadlock_mark > m_mark_start);
-	}
-
-	/** Get the next lock in the queue that is owned by a transaction
-	whose sub-tree has not already been searched.
-	Note: "next" here means PREV for table locks.
-	@param lock Lock in queue
-	@param heap_no heap_no if lock is a record lock else ULINT_UNDEFINED
-	@return next lock or NULL if at end of queue */
-	const lock_t* get_next_lock(const lock_t* lock, ulint heap_no) const;
-
-	/** Get the first lock to search. The search starts from the current
-	wait_lock. What we are really interested in is an edge from the
-	current wait_lock's owning transaction to another transaction that has
-	a lock ahead in the queue. We skip locks where the owning transaction's
-	sub-tree has already been searched.
+	/** Check that a cycle found in a snapshot of the waits-for graph
+	still exists, and if so resolve it by rolling back the transaction
+	which has the smallest weight.
 
-	Note: The record locks are traversed from the oldest lock to the
-	latest. For table locks we go from latest to oldest.
+	@param cycle transactions each of which waits for the next one,
+	the last one waiting for the first one
+	@param n_trx number of transactions in the cycle
 
-	For record locks, we first position the iterator on first lock on
-	the page and then reposition on the actual heap_no. This is required
-	due to the way the record lock has is implemented.
+	@return the transaction rolled back, or NULL if the cycle does not
+	exist anymore */
+	static const trx_t* resolve_cycle(
+		trx_t* const*	cycle,
+		ulint		n_trx);
 
-	@param[out] heap_no if rec lock, else ULINT_UNDEFINED.
+	/** Append the edges of the waits-for graph from the transaction
+	of a waiting lock request to every transaction that it has to
+	wait for.
 
-	@return first lock or NULL */
-	const lock_t* get_first_lock(ulint* heap_no) const;
+	@param wait_lock waiting lock request
+	@param edges edges of the waits-for graph */
+	static void get_wait_edges(
+		const lock_t*		wait_lock,
+		lock_wait_edges_t&	edges);
 
-	/** Notify that a deadlock has been detected and print the conflicting
-	transaction info.
-	@param lock lock causing deadlock */
-	void notify(const lock_t* lock) const;
-
-	/** Select the victim transaction that should be rolledback.
-	@return victim transaction */
-	const trx_t* select_victim() const;
-
-	/** Rollback transaction selected as the victim. */
-	void trx_rollback();
-
-	/** Looks iteratively for a deadlock. Note: the joining transaction
-	may have been granted its lock by the deadlock checks.
-
-	@return 0 if no deadlock else the victim transaction.*/
-	const trx_t* search();
+private:
+	/** Get the next lock ahead of a waiting lock request in its
+	queue that the request has to wait for.
+	@param wait_lock waiting lock request
+	@param lock lock to start the search after, or NULL to start
+	from the head of the queue
+	@return the next blocking lock, or NULL if there is none */
+	static const lock_t* next_blocking_lock(
+		const lock_t*	wait_lock,
+		const lock_t*	lock);
+
+	/** Check if a waiting lock request has to wait for a lock of a
+	given transaction ahead in its queue.
+	@param wait_lock waiting lock request
+	@param trx transaction that may block wait_lock
+	@return true if wait_lock has to wait for trx */
+	static bool is_blocked_by(const lock_t* wait_lock, const trx_t* trx);
+
+	/** Select the victim transaction among two transactions of a
+	cycle.
+	@param trx1 transaction
+	@param trx2 transaction
+	@return the one of the two to roll back */
+	static const trx_t* select_victim(
+		const trx_t*	trx1,
+		const trx_t*	trx2);
+
+	/** Notify that a deadlock has been detected and print the
+	transactions of the cycle and the locks they wait for.
+	@param cycle transactions of the cycle
+	@param n_trx number of transactions in the cycle */
+	static void notify(trx_t* const* cycle, ulint n_trx);
+
+	/** Rollback transaction selected as the victim.
+	@param trx transaction to roll back */
+	static void trx_rollback(trx_t* trx);
 
 	/** Print transaction data to the deadlock file and possibly to stderr.
 	@param trx transaction
@@ -228,52 +174,8 @@ private:
 	/** Print a message to the deadlock file and possibly to stderr.
 	@param msg message to print */
 	static void print(const char* msg);
-
-	/** Print info about transaction that was rolled back.
-	@param trx transaction rolled back
-	@param lock lock trx wants */
-	static void rollback_print(const trx_t* trx, const lock_t* lock);
-
-private:
-	/** DFS state information, used during deadlock checking. */
-	struct state_t {
-		const lock_t*	m_lock;		/*!< Current lock */
-		const lock_t*	m_wait_lock;	/*!< Waiting for lock */
-		ulint		m_heap_no;	/*!< heap number if rec lock */
-	};
-
-	/** Used in deadlock tracking. Protected by lock_sys->mutex. */
-	static ib_uint64_t	s_lock_mark_counter;
-
-	/** Calculation steps thus far. It is the count of the nodes visited. */
-	ulint			m_cost;
-
-	/** Joining transaction that is requesting a lock in an
-	incompatible mode */
-	const trx_t*		m_start;
-
-	/** TRUE if search was too deep and was aborted */
-	bool			m_too_deep;
-
-	/** Lock that trx wants */
-	const lock_t*		m_wait_lock;
-
-	/**  Value of lock_mark_count at the start of the deadlock check. */
-	ib_uint64_t		m_mark_start;
-
-	/** Number of states pushed onto the stack */
-	size_t			m_n_elems;
-
-	/** This is to avoid malloc/free calls. */
-	static state_t		s_states[MAX_STACK_SIZE];
 };
 
-/** Counter to mark visited nodes during deadlock search. */
-ib_uint64_t	DeadlockChecker::s_lock_mark_counter = 0;
-
-/** The stack used for deadlock searches. */
-DeadlockChecker::state_t	DeadlockChecker::s_states[MAX_STACK_SIZE];
-
 #ifdef UNIV_DEBUG
 /*********************************************************************//**
 Validates the lock system.
@@ -451,7 +353,15 @@ lock_sys_create(
 
 	lock_sys->last_slot = lock_sys->waiting_threads;
 
-	mutex_create(LATCH_ID_LOCK_SYS, &lock_sys->mutex);
+	rw_lock_create(lock_sys_latch_key, &lock_sys->latch, SYNC_LOCK_SYS);
+
+	lock_sys->shards = static_cast<lock_sys_shard_t*>(
+		ut_zalloc_nokey(LOCK_SYS_N_SHARDS * sizeof(lock_sys_shard_t)));
+
+	for (ulint i = 0; i < LOCK_SYS_N_SHARDS; ++i) {
+		mutex_create(LATCH_ID_LOCK_SYS_SHARD,
+			     &lock_sys->shards[i].mutex);
+	}
 
 	mutex_create(LATCH_ID_LOCK_SYS_WAIT, &lock_sys->wait_mutex);
 
@@ -552,7 +462,13 @@ lock_sys_close(void)
 
 	os_event_destroy(lock_sys->timeout_event);
 
-	mutex_destroy(&lock_sys->mutex);
+	for (ulint i = 0; i < LOCK_SYS_N_SHARDS; ++i) {
+		mutex_destroy(&lock_sys->shards[i].mutex);
+	}
+
+	ut_free(lock_sys->shards);
+
+	rw_lock_free(&lock_sys->latch);
 	mutex_destroy(&lock_sys->wait_mutex);
 
 	srv_slot_t*	slot = lock_sys->waiting_threads;
@@ -568,6 +484,44 @@ lock_sys_close(void)
 	lock_sys = NULL;
 }
 
+#ifdef UNIV_DEBUG
+/** Test if the record lock queues of a page may be accessed: the caller
+holds lock_sys->latch in exclusive mode, or in shared mode together with
+the shard mutex of the page.
+@param[in]	space	tablespace id
+@param[in]	page_no	page number
+@return true if the queues of the page are latched */
+bool
+lock_sys_owns_page(
+	ulint	space,
+	ulint	page_no)
+{
+	if (lock_mutex_own()) {
+		return(true);
+	}
+
+	return(rw_lock_own(&lock_sys->latch, RW_LOCK_S)
+	       && mutex_own(&lock_sys_get_shard(space, page_no)->mutex));
+}
+
+/** Test if the queue of a lock may be accessed: record lock queues are
+covered by lock_sys_owns_page(), table lock queues need lock_sys->latch
+in exclusive mode.
+@param[in]	lock	record or table lock
+@return true if the queue of the lock is latched */
+bool
+lock_sys_owns_lock(
+	const lock_t*	lock)
+{
+	if (lock_get_type_low(lock) == LOCK_REC) {
+		return(lock_sys_owns_page(lock->un_member.rec_lock.space,
+					  lock->un_member.rec_lock.page_no));
+	}
+
+	return(lock_mutex_own());
+}
+#endif /* UNIV_DEBUG */
+
 /*********************************************************************//**
 Gets the size of a lock struct.
 @return size in bytes */
@@ -747,12 +701,34 @@ lock_reset_lock_and_trx_wait(
 {
 	ut_ad(lock->trx->lock.wait_lock == lock);
 	ut_ad(lock_get_wait(lock));
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_sys_owns_lock(lock));
 
 	lock->trx->lock.wait_lock = NULL;
+	lock->trx->lock.blocking_trx = NULL;
 	lock->type_mode &= ~LOCK_WAIT;
 }
 
+/** Record the transaction that a waiting lock request has to wait for,
+and have the deadlock detector look for cycles if that has changed.
+@param[in,out]	wait_lock	waiting lock request
+@param[in]	blocking_lock	lock ahead of wait_lock in its queue */
+UNIV_INLINE
+void
+lock_set_blocking_trx(
+	lock_t*		wait_lock,
+	const lock_t*	blocking_lock)
+{
+	ut_ad(lock_get_wait(wait_lock));
+	ut_ad(lock_sys_owns_lock(wait_lock));
+
+	trx_t*	blocking_trx = blocking_lock->trx;
+
+	if (wait_lock->trx->lock.blocking_trx != blocking_trx) {
+		wait_lock->trx->lock.blocking_trx = blocking_trx;
+		lock_wait_request_check_for_cycles();
+	}
+}
+
 /*********************************************************************//**
 Gets the gap flag of a record lock.
 @return LOCK_GAP or 0 */
@@ -1116,7 +1092,8 @@ lock_rec_has_expl(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_sys_owns_page(block->page.id.space(),
+				 block->page.id.page_no()));
 	ut_ad((precise_mode & LOCK_MODE_MASK) == LOCK_S
 	      || (precise_mode & LOCK_MODE_MASK) == LOCK_X);
 	ut_ad(!(precise_mode & LOCK_INSERT_INTENTION));
@@ -1165,7 +1142,8 @@ lock_rec_other_has_expl_req(
 					are taken into account */
 {
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_sys_owns_page(block->page.id.space(),
+				 block->page.id.page_no()));
 	ut_ad(mode == LOCK_X || mode == LOCK_S);
 
 	/* Only GAP lock can be on SUPREMUM, and we are not looking for
@@ -1211,7 +1189,8 @@ lock_rec_other_has_conflicting(
 {
 	const lock_t*		lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_sys_owns_page(block->page.id.space(),
+				 block->page.id.page_no()));
 
 	bool	is_supremum = (heap_no == PAGE_HEAP_NO_SUPREMUM);
 
@@ -1439,7 +1418,7 @@ RecLock::lock_alloc(
 	const RecID&	rec_id,
 	ulint		size)
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_sys_owns_page(rec_id.m_space_id, rec_id.m_page_no));
 
 	lock_t*	lock;
 
@@ -1489,9 +1468,9 @@ RecLock::lock_alloc(
 
 	lock_rec_set_nth_bit(lock, rec_id.m_heap_no);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK);
 
-	MONITOR_INC(MONITOR_RECLOCK_CREATED);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_CREATED);
 
 	return(lock);
 }
@@ -1503,13 +1482,14 @@ Add the lock to the record lock hash and the transaction's lock list
 void
 RecLock::lock_add(lock_t* lock, bool add_to_hash)
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_sys_owns_page(m_rec_id.m_space_id,
+				 m_rec_id.m_page_no));
 	ut_ad(trx_mutex_own(lock->trx));
 
 	if (add_to_hash) {
 		ulint	key = m_rec_id.fold();
 
-		++lock->index->table->n_rec_locks;
+		os_atomic_increment_ulint(&lock->index->table->n_rec_locks, 1);
 
 		HASH_INSERT(lock_t, hash, lock_hash_get(m_mode), key, lock);
 	}
@@ -1535,7 +1515,8 @@ RecLock::create(
 	bool	add_to_hash,
 	const	lock_prdt_t* prdt)
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_sys_owns_page(m_rec_id.m_space_id,
+				 m_rec_id.m_page_no));
 	ut_ad(owns_trx_mutex == trx_mutex_own(trx));
 
 	/* Create the explicit lock instance and initialise it. */
@@ -1737,6 +1718,8 @@ RecLock::add_to_waitq(const lock_t* wait_for, const lock_prdt_t* prdt)
 
 	ut_ad(lock_get_wait(lock));
 
+	m_trx->lock.blocking_trx = wait_for->trx;
+
 	dberr_t	err = deadlock_check(lock);
 
 	ut_ad(trx_mutex_own(m_trx));
@@ -1773,7 +1756,8 @@ lock_rec_add_to_queue(
 					transaction mutex */
 {
 #ifdef UNIV_DEBUG
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_sys_owns_page(block->page.id.space(),
+				 block->page.id.page_no()));
 	ut_ad(caller_owns_trx_mutex == trx_mutex_own(trx));
 	ut_ad(dict_index_is_clust(index)
 	      || dict_index_get_online_status(index) != ONLINE_INDEX_CREATION);
@@ -1876,7 +1860,8 @@ lock_rec_lock_fast(
 	dict_index_t*		index,	/*!< in: index of record */
 	que_thr_t*		thr)	/*!< in: query thread */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_sys_owns_page(block->page.id.space(),
+				 block->page.id.page_no()));
 	ut_ad(!srv_read_only_mode);
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
@@ -2020,12 +2005,82 @@ lock_rec_lock_slow(
 	return(err);
 }
 
+/** Tries to lock the specified record in the mode requested, while holding
+lock_sys->latch in shared mode and the shard mutex of the page. Does not
+enqueue a waiting lock request, which requires the exclusive latch for the
+deadlock check. This is a low-level function which does NOT look at implicit
+locks!
+@param[in]	impl	if true, no lock is set if no wait is necessary: we
+			assume that the caller will set an implicit lock
+@param[in]	mode	lock mode: LOCK_X or LOCK_S possibly ORed to either
+			LOCK_GAP or LOCK_REC_NOT_GAP
+@param[in]	block	buffer block containing the record
+@param[in]	heap_no	heap number of record
+@param[in]	index	index of record
+@param[in]	thr	query thread
+@return DB_SUCCESS, DB_SUCCESS_LOCKED_REC, or DB_LOCK_WAIT if the request
+has to be retried under the exclusive lock_sys->latch */
+static
+dberr_t
+lock_rec_lock_shared(
+	bool			impl,
+	ulint			mode,
+	const buf_block_t*	block,
+	ulint			heap_no,
+	dict_index_t*		index,
+	que_thr_t*		thr)
+{
+	ut_ad(lock_sys_owns_page(block->page.id.space(),
+				 block->page.id.page_no()));
+
+	switch (lock_rec_lock_fast(impl, mode, block, heap_no, index, thr)) {
+	case LOCK_REC_SUCCESS:
+		return(DB_SUCCESS);
+	case LOCK_REC_SUCCESS_CREATED:
+		return(DB_SUCCESS_LOCKED_REC);
+	case LOCK_REC_FAIL:
+		break;
+	}
+
+	DBUG_EXECUTE_IF("innodb_report_deadlock", return(DB_LOCK_WAIT););
+
+	dberr_t	err;
+	trx_t*	trx = thr_get_trx(thr);
+
+	trx_mutex_enter(trx);
+
+	if (lock_rec_has_expl(mode, block, heap_no, trx)) {
+
+		err = DB_SUCCESS;
+
+	} else if (lock_rec_other_has_conflicting(
+			   mode, block, heap_no, trx) != NULL) {
+
+		err = DB_LOCK_WAIT;
+
+	} else if (!impl) {
+
+		lock_rec_add_to_queue(
+			LOCK_REC | mode, block, heap_no, index, trx, true);
+
+		err = DB_SUCCESS_LOCKED_REC;
+	} else {
+		err = DB_SUCCESS;
+	}
+
+	trx_mutex_exit(trx);
+
+	return(err);
+}
+
 /*********************************************************************//**
 Tries to lock the specified record in the mode requested. If not immediately
 possible, enqueues a waiting lock request. This is a low-level function
 which does NOT look at implicit locks! Checks lock compatibility within
 explicit locks. This function sets a normal next-key lock, or in the case
-of a page supremum record, a gap type lock.
+of a page supremum record, a gap type lock. The request is first tried
+under the shard of the page; only a request which may have to wait takes
+lock_sys->latch in exclusive mode.
 @return DB_SUCCESS, DB_SUCCESS_LOCKED_REC, DB_LOCK_WAIT, DB_DEADLOCK,
 or DB_QUE_THR_SUSPENDED */
 static
@@ -2045,7 +2100,7 @@ lock_rec_lock(
 	dict_index_t*		index,	/*!< in: index of record */
 	que_thr_t*		thr)	/*!< in: query thread */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(!lock_sys_latched());
 	ut_ad(!srv_read_only_mode);
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
@@ -2058,20 +2113,41 @@ lock_rec_lock(
 	      || mode - (LOCK_MODE_MASK & mode) == 0);
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 
+	lock_sys_shard_t*	shard = lock_sys_shard_enter(
+		block->page.id.space(), block->page.id.page_no());
+
+	dberr_t	err = lock_rec_lock_shared(
+		impl, mode, block, heap_no, index, thr);
+
+	lock_sys_shard_exit(shard);
+
+	if (err != DB_LOCK_WAIT) {
+		return(err);
+	}
+
+	/* The queue may have changed while we did not hold any latch,
+	so the request is checked again from scratch. */
+
+	lock_mutex_enter();
+
 	/* We try a simplified and faster subroutine for the most
 	common cases */
 	switch (lock_rec_lock_fast(impl, mode, block, heap_no, index, thr)) {
 	case LOCK_REC_SUCCESS:
-		return(DB_SUCCESS);
+		err = DB_SUCCESS;
+		break;
 	case LOCK_REC_SUCCESS_CREATED:
-		return(DB_SUCCESS_LOCKED_REC);
+		err = DB_SUCCESS_LOCKED_REC;
+		break;
 	case LOCK_REC_FAIL:
-		return(lock_rec_lock_slow(impl, mode, block,
-					  heap_no, index, thr));
+		err = lock_rec_lock_slow(impl, mode, block,
+					 heap_no, index, thr);
+		break;
 	}
 
-	ut_error;
-	return(DB_ERROR);
+	lock_mutex_exit();
+
+	return(err);
 }
 
 /*********************************************************************//**
@@ -2091,7 +2167,7 @@ lock_rec_has_to_wait_in_queue(
 	ulint		bit_offset;
 	hash_table_t*	hash;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_sys_owns_lock(wait_lock));
 	ut_ad(lock_get_wait(wait_lock));
 	ut_ad(lock_get_type_low(wait_lock) == LOCK_REC);
 
@@ -2130,7 +2206,7 @@ lock_grant(
 /*=======*/
 	lock_t*	lock)	/*!< in/out: waiting lock request */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_sys_owns_lock(lock));
 
 	lock_reset_lock_and_trx_wait(lock);
 
@@ -2317,7 +2393,7 @@ RecLock::lock_add_priority(
 	/* Add the lock to lock hash table. */
 	lock->hash = add_position->hash;
 	add_position->hash = lock;
-	++lock->index->table->n_rec_locks;
+	os_atomic_increment_ulint(&lock->index->table->n_rec_locks, 1);
 
 	return(grant_lock);
 }
@@ -2455,12 +2531,20 @@ lock_rec_grant(lock_t* in_lock)
 	     lock != NULL;
 	     lock = lock_rec_get_next_on_page(lock)) {
 
-		if (lock_get_wait(lock)
-		    && !lock_rec_has_to_wait_in_queue(lock)) {
+		if (!lock_get_wait(lock)) {
+			continue;
+		}
+
+		const lock_t*	blocking_lock
+			= lock_rec_has_to_wait_in_queue(lock);
+
+		if (blocking_lock == NULL) {
 
 			/* Grant the lock */
 			ut_ad(lock->trx != in_lock->trx);
 			lock_grant(lock);
+		} else {
+			lock_set_blocking_trx(lock, blocking_lock);
 		}
 	}
 }
@@ -2484,7 +2568,7 @@ lock_rec_dequeue_from_page(
 	trx_lock_t*	trx_lock;
 	hash_table_t*	lock_hash;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_sys_owns_lock(in_lock));
 	ut_ad(lock_get_type_low(in_lock) == LOCK_REC);
 	/* We may or may not be holding in_lock->trx->mutex here. */
 
@@ -2494,7 +2578,7 @@ lock_rec_dequeue_from_page(
 	page_no = in_lock->un_member.rec_lock.page_no;
 
 	ut_ad(in_lock->index->table->n_rec_locks > 0);
-	in_lock->index->table->n_rec_locks--;
+	os_atomic_decrement_ulint(&in_lock->index->table->n_rec_locks, 1);
 
 	lock_hash = lock_hash_get(in_lock->type_mode);
 
@@ -2503,8 +2587,8 @@ lock_rec_dequeue_from_page(
 
 	UT_LIST_REMOVE(trx_lock->trx_locks, in_lock);
 
-	MONITOR_INC(MONITOR_RECLOCK_REMOVED);
-	MONITOR_DEC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_REMOVED);
+	MONITOR_ATOMIC_DEC(MONITOR_NUM_RECLOCK);
 
 	lock_rec_grant(in_lock);
 }
@@ -2531,15 +2615,15 @@ lock_rec_discard(
 	page_no = in_lock->un_member.rec_lock.page_no;
 
 	ut_ad(in_lock->index->table->n_rec_locks > 0);
-	in_lock->index->table->n_rec_locks--;
+	os_atomic_decrement_ulint(&in_lock->index->table->n_rec_locks, 1);
 
 	HASH_DELETE(lock_t, hash, lock_hash_get(in_lock->type_mode),
 			    lock_rec_fold(space, page_no), in_lock);
 
 	UT_LIST_REMOVE(trx_lock->trx_locks, in_lock);
 
-	MONITOR_INC(MONITOR_RECLOCK_REMOVED);
-	MONITOR_DEC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_REMOVED);
+	MONITOR_ATOMIC_DEC(MONITOR_NUM_RECLOCK);
 }
 
 /*************************************************************//**
@@ -3886,6 +3970,8 @@ lock_table_enqueue_waiting(
 	ulint		mode,	/*!< in: lock mode this transaction is
 				requesting */
 	dict_table_t*	table,	/*!< in/out: table */
+	const lock_t*	wait_for,/*!< in: lock that the request has to
+				wait for */
 	que_thr_t*	thr)	/*!< in: query thread */
 {
 	trx_t*		trx;
@@ -3921,6 +4007,8 @@ lock_table_enqueue_waiting(
 	/* Enqueue the lock request that will wait to be granted */
 	lock = lock_table_create(table, mode | LOCK_WAIT, trx);
 
+	trx->lock.blocking_trx = wait_for->trx;
+
 	const trx_t*	victim_trx =
 			DeadlockChecker::check_and_resolve(lock, trx);
 
@@ -4057,7 +4145,8 @@ lock_table(
 	mode: this trx may have to wait */
 
 	if (wait_for != NULL) {
-		err = lock_table_enqueue_waiting(mode | flags, table, thr);
+		err = lock_table_enqueue_waiting(
+			mode | flags, table, wait_for, thr);
 	} else {
 		lock_table_create(table, mode | flags, trx);
 
@@ -4103,9 +4192,9 @@ lock_table_ix_resurrect(
 
 /*********************************************************************//**
 Checks if a waiting table lock request still has to wait in a queue.
-@return TRUE if still has to wait */
+@return lock that is causing the wait */
 static
-bool
+const lock_t*
 lock_table_has_to_wait_in_queue(
 /*============================*/
 	const lock_t*	wait_lock)	/*!< in: waiting table lock */
@@ -4124,11 +4213,11 @@ lock_table_has_to_wait_in_queue(
 
 		if (lock_has_to_wait(wait_lock, lock)) {
 
-			return(true);
+			return(lock);
 		}
 	}
 
-	return(false);
+	return(NULL);
 }
 
 /*************************************************************//**
@@ -4157,12 +4246,20 @@ lock_table_dequeue(
 	     lock != NULL;
 	     lock = UT_LIST_GET_NEXT(un_member.tab_lock.locks, lock)) {
 
-		if (lock_get_wait(lock)
-		    && !lock_table_has_to_wait_in_queue(lock)) {
+		if (!lock_get_wait(lock)) {
+			continue;
+		}
+
+		const lock_t*	blocking_lock
+			= lock_table_has_to_wait_in_queue(lock);
+
+		if (blocking_lock == NULL) {
 
 			/* Grant the lock */
 			ut_ad(in_lock->trx != lock->trx);
 			lock_grant(lock);
+		} else {
+			lock_set_blocking_trx(lock, blocking_lock);
 		}
 	}
 }
@@ -4311,12 +4408,20 @@ released:
 
 	for (lock = first_lock; lock != NULL;
 	     lock = lock_rec_get_next(heap_no, lock)) {
-		if (lock_get_wait(lock)
-		    && !lock_rec_has_to_wait_in_queue(lock)) {
+		if (!lock_get_wait(lock)) {
+			continue;
+		}
+
+		const lock_t*	blocking_lock
+			= lock_rec_has_to_wait_in_queue(lock);
+
+		if (blocking_lock == NULL) {
 
 			/* Grant the lock */
 			ut_ad(trx != lock->trx);
 			lock_grant(lock);
+		} else {
+			lock_set_blocking_trx(lock, blocking_lock);
 		}
 	}
 
@@ -4462,6 +4567,77 @@ lock_trx_release_read_locks(
 	lock_mutex_exit();
 }
 
+/** Release the record locks of a committing transaction while holding
+lock_sys->latch in shared mode. Each lock is removed under the shard mutex
+of its page, and the waiting requests on that page which no longer
+conflict are granted. The table locks are left for lock_release().
+@param[in,out]	trx	transaction */
+static
+void
+lock_release_rec_locks(
+	trx_t*	trx)
+{
+	lock_t*			lock;
+	lock_t*			prev_lock;
+	lock_sys_shard_t*	shard = NULL;
+	ulint			count = 0;
+
+	ut_ad(rw_lock_own(&lock_sys->latch, RW_LOCK_S));
+	ut_ad(!trx_mutex_own(trx));
+	ut_ad(!trx->is_dd_trx);
+
+	for (lock = UT_LIST_GET_LAST(trx->lock.trx_locks);
+	     lock != NULL;
+	     lock = prev_lock) {
+
+		prev_lock = UT_LIST_GET_PREV(trx_locks, lock);
+
+		if (lock_get_type_low(lock) != LOCK_REC) {
+			continue;
+		}
+
+		ut_d(lock_check_dict_lock(lock));
+
+		lock_sys_shard_t*	lock_shard = lock_sys_get_shard(
+			lock->un_member.rec_lock.space,
+			lock->un_member.rec_lock.page_no);
+
+		if (lock_shard != shard) {
+			if (shard != NULL) {
+				mutex_exit(&shard->mutex);
+			}
+
+			shard = lock_shard;
+			mutex_enter(&shard->mutex);
+		}
+
+		lock_rec_dequeue_from_page(lock);
+
+		if (++count == LOCK_RELEASE_INTERVAL) {
+			/* Release the latch for a while, so that we do
+			not block the exclusive lock_sys->latch requests.
+			The locks of the transaction may be moved between
+			pages meanwhile: start again from the end of the
+			list. */
+
+			mutex_exit(&shard->mutex);
+			shard = NULL;
+
+			rw_lock_s_unlock(&lock_sys->latch);
+
+			rw_lock_s_lock(&lock_sys->latch);
+
+			prev_lock = UT_LIST_GET_LAST(trx->lock.trx_locks);
+
+			count = 0;
+		}
+	}
+
+	if (shard != NULL) {
+		mutex_exit(&shard->mutex);
+	}
+}
+
 /*********************************************************************//**
 Releases transaction locks, and releases possible other transactions waiting
 because of these locks. */
@@ -5925,7 +6101,9 @@ lock_rec_insert_check_and_lock(
 	const rec_t*	next_rec = page_rec_get_next_const(rec);
 	ulint		heap_no = page_rec_get_heap_no(next_rec);
 
-	lock_mutex_enter();
+	lock_sys_shard_t*	shard = lock_sys_shard_enter(
+		block->page.id.space(), block->page.id.page_no());
+
 	/* Because this code is invoked for a running transaction by
 	the thread that is serving the transaction, it is not necessary
 	to hold trx->mutex here. */
@@ -5940,7 +6118,7 @@ lock_rec_insert_check_and_lock(
 	if (lock == NULL) {
 		/* We optimize CPU time usage in the simplest case */
 
-		lock_mutex_exit();
+		lock_sys_shard_exit(shard);
 
 		if (inherit_in && !dict_index_is_clust(index)) {
 			/* Update the page max trx id field */
@@ -5957,6 +6135,7 @@ lock_rec_insert_check_and_lock(
 	/* Spatial index does not use GAP lock protection. It uses
 	"predicate lock" to protect the "range" */
 	if (dict_index_is_spatial(index)) {
+		lock_sys_shard_exit(shard);
 		return(DB_SUCCESS);
 	}
 
@@ -5977,21 +6156,39 @@ lock_rec_insert_check_and_lock(
 	const lock_t*	wait_for = lock_rec_other_has_conflicting(
 				type_mode, block, heap_no, trx);
 
-	if (wait_for != NULL) {
+	lock_sys_shard_exit(shard);
 
-		RecLock	rec_lock(thr, index, block, heap_no, type_mode);
+	if (wait_for == NULL) {
 
-		trx_mutex_enter(trx);
+		err = DB_SUCCESS;
 
-		err = rec_lock.add_to_waitq(wait_for);
+	} else {
+		/* Waiting requires the exclusive latch. The queue may
+		have changed in the meantime, so look for the conflicting
+		lock again. */
 
-		trx_mutex_exit(trx);
+		lock_mutex_enter();
 
-	} else {
-		err = DB_SUCCESS;
-	}
+		wait_for = lock_rec_other_has_conflicting(
+			type_mode, block, heap_no, trx);
 
-	lock_mutex_exit();
+		if (wait_for != NULL) {
+
+			RecLock	rec_lock(thr, index, block, heap_no,
+					 type_mode);
+
+			trx_mutex_enter(trx);
+
+			err = rec_lock.add_to_waitq(wait_for);
+
+			trx_mutex_exit(trx);
+
+		} else {
+			err = DB_SUCCESS;
+		}
+
+		lock_mutex_exit();
+	}
 
 	switch (err) {
 	case DB_SUCCESS_LOCKED_REC:
@@ -6178,16 +6375,12 @@ lock_clust_rec_modify_check_and_lock(
 
 	lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 
-	lock_mutex_enter();
-
 	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
 	err = lock_rec_lock(TRUE, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6239,16 +6432,12 @@ lock_sec_rec_modify_check_and_lock(
 	index record, and this would not have been possible if another active
 	transaction had modified this secondary index record. */
 
-	lock_mutex_enter();
-
 	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
 	err = lock_rec_lock(TRUE, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 #ifdef UNIV_DEBUG
 	{
@@ -6339,8 +6528,6 @@ lock_sec_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	lock_mutex_enter();
-
 	ut_ad(mode != LOCK_X
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 	ut_ad(mode != LOCK_S
@@ -6349,9 +6536,7 @@ lock_sec_rec_read_check_and_lock(
 	err = lock_rec_lock(FALSE, mode | gap_mode,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6412,8 +6597,6 @@ lock_clust_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	lock_mutex_enter();
-
 	ut_ad(mode != LOCK_X
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 	ut_ad(mode != LOCK_S
@@ -6421,9 +6604,7 @@ lock_clust_rec_read_check_and_lock(
 
 	err = lock_rec_lock(FALSE, mode | gap_mode, block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6857,12 +7038,14 @@ lock_trx_release_locks(
 
 	release_lock = (UT_LIST_GET_LEN(trx->lock.trx_locks) > 0);
 
-	/* Don't take lock_sys mutex if trx didn't acquire any lock. */
+	/* Don't take lock_sys latch if trx didn't acquire any lock. */
 	if (release_lock) {
 
 		/* The transition of trx->state to TRX_STATE_COMMITTED_IN_MEMORY
-		is protected by both the lock_sys->mutex and the trx->mutex. */
-		lock_mutex_enter();
+		is protected by both the lock_sys->latch and the trx->mutex.
+		The shared latch is enough to exclude the implicit to
+		explicit lock conversion. */
+		rw_lock_s_lock(&lock_sys->latch);
 	}
 
 	trx_mutex_enter(trx);
@@ -6889,7 +7072,7 @@ lock_trx_release_locks(
 
 		ut_a(release_lock);
 
-		lock_mutex_exit();
+		rw_lock_s_unlock(&lock_sys->latch);
 
 		while (trx_is_referenced(trx)) {
 
@@ -6906,7 +7089,7 @@ lock_trx_release_locks(
 
 		trx_mutex_exit(trx);
 
-		lock_mutex_enter();
+		rw_lock_s_lock(&lock_sys->latch);
 
 		trx_mutex_enter(trx);
 	}
@@ -6930,9 +7113,23 @@ lock_trx_release_locks(
 
 	if (release_lock) {
 
-		lock_release(trx);
+		lock_release_rec_locks(trx);
 
-		lock_mutex_exit();
+		rw_lock_s_unlock(&lock_sys->latch);
+
+		/* The remaining table locks are released under the
+		exclusive latch. No other thread can add record locks
+		to the transaction any more, because it does not have
+		any left to be moved or inherited. */
+
+		if (UT_LIST_GET_LEN(trx->lock.trx_locks) > 0) {
+
+			lock_mutex_enter();
+
+			lock_release(trx);
+
+			lock_mutex_exit();
+		}
 	}
 
 	trx->lock.n_rec_locks = 0;
@@ -7278,158 +7475,156 @@ DeadlockChecker::print(const lock_t* lock)
 	}
 }
 
-/** Get the next lock in the queue that is owned by a transaction whose
-sub-tree has not already been searched.
-Note: "next" here means PREV for table locks.
-
-@param lock Lock in queue
-@param heap_no heap_no if lock is a record lock else ULINT_UNDEFINED
-
-@return next lock or NULL if at end of queue */
+/** Get the next lock ahead of a waiting lock request in its queue that
+the request has to wait for.
+@param wait_lock waiting lock request
+@param lock lock to start the search after, or NULL to start from the
+head of the queue
+@return the next blocking lock, or NULL if there is none */
 const lock_t*
-DeadlockChecker::get_next_lock(const lock_t* lock, ulint heap_no) const
+DeadlockChecker::next_blocking_lock(
+	const lock_t*	wait_lock,
+	const lock_t*	lock)
 {
 	ut_ad(lock_mutex_own());
+	ut_ad(lock_get_wait(wait_lock));
 
-	do {
-		if (lock_get_type_low(lock) == LOCK_REC) {
-			ut_ad(heap_no != ULINT_UNDEFINED);
-			lock = lock_rec_get_next_const(heap_no, lock);
-		} else {
-			ut_ad(heap_no == ULINT_UNDEFINED);
-			ut_ad(lock_get_type_low(lock) == LOCK_TABLE);
+	if (lock_get_type_low(wait_lock) == LOCK_REC) {
 
-			lock = UT_LIST_GET_NEXT(
-				un_member.tab_lock.locks, lock);
-		}
+		ulint	heap_no = lock_rec_find_set_bit(wait_lock);
 
-	} while (lock != NULL && is_visited(lock));
+		for (lock = lock == NULL
+			     ? lock_rec_get_first_on_page_addr(
+				     lock_hash_get(wait_lock->type_mode),
+				     wait_lock->un_member.rec_lock.space,
+				     wait_lock->un_member.rec_lock.page_no)
+			     : lock_rec_get_next_on_page_const(lock);
+		     lock != wait_lock;
+		     lock = lock_rec_get_next_on_page_const(lock)) {
 
-	ut_ad(lock == NULL
-	      || lock_get_type_low(lock) == lock_get_type_low(m_wait_lock));
+			if (lock_rec_get_nth_bit(lock, heap_no)
+			    && lock_has_to_wait(wait_lock, lock)) {
 
-	return(lock);
-}
+				return(lock);
+			}
+		}
+	} else {
+		ut_ad(lock_get_type_low(wait_lock) == LOCK_TABLE);
 
-/** Get the first lock to search. The search starts from the current
-wait_lock. What we are really interested in is an edge from the
-current wait_lock's owning transaction to another transaction that has
-a lock ahead in the queue. We skip locks where the owning transaction's
-sub-tree has already been searched.
+		const dict_table_t*	table
+			= wait_lock->un_member.tab_lock.table;
 
-Note: The record locks are traversed from the oldest lock to the
-latest. For table locks we go from latest to oldest.
+		for (lock = lock == NULL
+			     ? UT_LIST_GET_FIRST(table->locks)
+			     : UT_LIST_GET_NEXT(un_member.tab_lock.locks, lock);
+		     lock != wait_lock;
+		     lock = UT_LIST_GET_NEXT(un_member.tab_lock.locks, lock)) {
 
-For record locks, we first position the "iterator" on the first lock on
-the page and then reposition on the actual heap_no. This is required
-due to the way the record lock has is implemented.
+			if (lock_has_to_wait(wait_lock, lock)) {
 
-@param[out] heap_no if rec lock, else ULINT_UNDEFINED.
-@return first lock or NULL */
-const lock_t*
-DeadlockChecker::get_first_lock(ulint* heap_no) const
+				return(lock);
+			}
+		}
+	}
+
+	return(NULL);
+}
+
+/** Check if a waiting lock request has to wait for a lock of a given
+transaction ahead in its queue.
+@param wait_lock waiting lock request
+@param trx transaction that may block wait_lock
+@return true if wait_lock has to wait for trx */
+bool
+DeadlockChecker::is_blocked_by(const lock_t* wait_lock, const trx_t* trx)
 {
-	ut_ad(lock_mutex_own());
+	for (const lock_t* lock = next_blocking_lock(wait_lock, NULL);
+	     lock != NULL;
+	     lock = next_blocking_lock(wait_lock, lock)) {
 
-	const lock_t*	lock = m_wait_lock;
+		if (lock->trx == trx) {
+			return(true);
+		}
+	}
 
-	if (lock_get_type_low(lock) == LOCK_REC) {
-		hash_table_t*	lock_hash;
+	return(false);
+}
 
-		lock_hash = lock->type_mode & LOCK_PREDICATE
-			? lock_sys->prdt_hash
-			: lock_sys->rec_hash;
+/** Append the edges of the waits-for graph from the transaction of a
+waiting lock request to every transaction that it has to wait for.
+@param wait_lock waiting lock request
+@param edges edges of the waits-for graph */
+void
+DeadlockChecker::get_wait_edges(
+	const lock_t*		wait_lock,
+	lock_wait_edges_t&	edges)
+{
+	const ulint	first = edges.size();
 
-		/* We are only interested in records that match the heap_no. */
-		*heap_no = lock_rec_find_set_bit(lock);
+	for (const lock_t* lock = next_blocking_lock(wait_lock, NULL);
+	     lock != NULL;
+	     lock = next_blocking_lock(wait_lock, lock)) {
 
-		ut_ad(*heap_no <= 0xffff);
-		ut_ad(*heap_no != ULINT_UNDEFINED);
+		/* A transaction can have several locks in the queue. */
 
-		/* Find the locks on the page. */
-		lock = lock_rec_get_first_on_page_addr(
-			lock_hash,
-			lock->un_member.rec_lock.space,
-			lock->un_member.rec_lock.page_no);
+		if (lock->trx == wait_lock->trx
+		    || std::find(edges.begin() + first, edges.end(),
+				 lock_wait_edge_t(wait_lock->trx, lock->trx))
+		    != edges.end()) {
 
-		/* Position on the first lock on the physical record.*/
-		if (!lock_rec_get_nth_bit(lock, *heap_no)) {
-			lock = lock_rec_get_next_const(*heap_no, lock);
+			continue;
 		}
 
-		ut_a(!lock_get_wait(lock));
-	} else {
-		/* Table locks don't care about the heap_no. */
-		*heap_no = ULINT_UNDEFINED;
-		ut_ad(lock_get_type_low(lock) == LOCK_TABLE);
-		dict_table_t*	table = lock->un_member.tab_lock.table;
-		lock = UT_LIST_GET_FIRST(table->locks);
+		edges.push_back(lock_wait_edge_t(wait_lock->trx, lock->trx));
 	}
-
-	/* Must find at least two locks, otherwise there cannot be a
-	waiting lock, secondly the first lock cannot be the wait_lock. */
-	ut_a(lock != NULL);
-	ut_a(lock != m_wait_lock);
-
-	/* Check that the lock type doesn't change. */
-	ut_ad(lock_get_type_low(lock) == lock_get_type_low(m_wait_lock));
-
-	return(lock);
 }
 
-/** Notify that a deadlock has been detected and print the conflicting
-transaction info.
-@param lock lock causing deadlock */
+/** Notify that a deadlock has been detected and print the transactions
+of the cycle and the locks they wait for.
+@param cycle transactions of the cycle
+@param n_trx number of transactions in the cycle */
 void
-DeadlockChecker::notify(const lock_t* lock) const
+DeadlockChecker::notify(trx_t* const* cycle, ulint n_trx)
 {
 	ut_ad(lock_mutex_own());
 
 	start_print();
 
-	print("\n*** (1) TRANSACTION:\n");
-
-	print(m_wait_lock->trx, 3000);
-
-	print("*** (1) WAITING FOR THIS LOCK TO BE GRANTED:\n");
+	for (ulint i = 0; i < n_trx; ++i) {
+		char	buf[64];
 
-	print(m_wait_lock);
+		snprintf(buf, sizeof(buf), "\n*** (%lu) TRANSACTION:\n",
+			 (ulong) (i + 1));
+		print(buf);
 
-	print("*** (2) TRANSACTION:\n");
+		print(cycle[i], 3000);
 
-	print(lock->trx, 3000);
+		snprintf(buf, sizeof(buf),
+			 "*** (%lu) WAITING FOR THIS LOCK TO BE GRANTED:\n",
+			 (ulong) (i + 1));
+		print(buf);
 
-	print("*** (2) HOLDS THE LOCK(S):\n");
-
-	print(lock);
-
-	/* It is possible that the joining transaction was granted its
-	lock when we rolled back some other waiting transaction. */
-
-	if (m_start->lock.wait_lock != 0) {
-		print("*** (2) WAITING FOR THIS LOCK TO BE GRANTED:\n");
-
-		print(m_start->lock.wait_lock);
+		print(cycle[i]->lock.wait_lock);
 	}
 
 	DBUG_PRINT("ib_lock", ("deadlock detected"));
 }
 
-/** Select the victim transaction that should be rolledback.
-@return victim transaction */
+/** Select the victim transaction among two transactions of a cycle.
+@param trx1 transaction
+@param trx2 transaction
+@return the one of the two to roll back */
 const trx_t*
-DeadlockChecker::select_victim() const
+DeadlockChecker::select_victim(const trx_t* trx1, const trx_t* trx2)
 {
 	ut_ad(lock_mutex_own());
-	ut_ad(m_start->lock.wait_lock != 0);
-	ut_ad(m_wait_lock->trx != m_start);
 
-	if (thd_trx_priority(m_start->mysql_thd) > 0
-	    || thd_trx_priority(m_wait_lock->trx->mysql_thd) > 0) {
+	if (thd_trx_priority(trx1->mysql_thd) > 0
+	    || thd_trx_priority(trx2->mysql_thd) > 0) {
 
 		const trx_t*	victim;
 
-		victim = trx_arbitrate(m_start, m_wait_lock->trx);
+		victim = trx_arbitrate(trx1, trx2);
 
 		if (victim != NULL) {
 
@@ -7437,153 +7632,24 @@ DeadlockChecker::select_victim() const
 		}
 	}
 
-	if (trx_weight_ge(m_wait_lock->trx, m_start)) {
+	if (trx_weight_ge(trx1, trx2)) {
 
-		/* The joining transaction is 'smaller',
+		/* The second transaction is 'smaller',
 		choose it as the victim and roll it back. */
 
-		return(m_start);
-	}
-
-	return(m_wait_lock->trx);
-}
-
-/** Looks iteratively for a deadlock. Note: the joining transaction may
-have been granted its lock by the deadlock checks.
-@return 0 if no deadlock else the victim transaction instance.*/
-const trx_t*
-DeadlockChecker::search()
-{
-	ut_ad(lock_mutex_own());
-	ut_ad(!trx_mutex_own(m_start));
-
-	ut_ad(m_start != NULL);
-	ut_ad(m_wait_lock != NULL);
-	check_trx_state(m_wait_lock->trx);
-	ut_ad(m_mark_start <= s_lock_mark_counter);
-
-	/* Look at the locks ahead of wait_lock in the lock queue. */
-	ulint		heap_no;
-	const lock_t*	lock = get_first_lock(&heap_no);
-
-	for (;;) {
-
-		/* We should never visit the same sub-tree more than once. */
-		ut_ad(lock == NULL || !is_visited(lock));
-
-		while (m_n_elems > 0 && lock == NULL) {
-
-			/* Restore previous search state. */
-
-			pop(lock, heap_no);
-
-			lock = get_next_lock(lock, heap_no);
-		}
-
-		if (lock == NULL) {
-			break;
-		} else if (lock == m_wait_lock) {
-
-			/* We can mark this subtree as searched */
-			ut_ad(lock->trx->lock.deadlock_mark <= m_mark_start);
-
-			lock->trx->lock.deadlock_mark = ++s_lock_mark_counter;
-
-			/* We are not prepared for an overflow. This 64-bit
-			counter should never wrap around. At 10^9 increments
-			per second, it would take 10^3 years of uptime. */
-
-			ut_ad(s_lock_mark_counter > 0);
-
-			/* Backtrack */
-			lock = NULL;
-
-		} else if (!lock_has_to_wait(m_wait_lock, lock)) {
-
-			/* No conflict, next lock */
-			lock = get_next_lock(lock, heap_no);
-
-		} else if (lock->trx == m_start) {
-
-			/* Found a cycle. */
-
-			notify(lock);
-
-			return(select_victim());
-
-		} else if (is_too_deep()) {
-
-			/* Search too deep to continue. */
-			m_too_deep = true;
-			return(m_start);
-
-		} else if (lock->trx->lock.que_state == TRX_QUE_LOCK_WAIT) {
-
-			/* Another trx ahead has requested a lock in an
-			incompatible mode, and is itself waiting for a lock. */
-
-			++m_cost;
-
-			if (!push(lock, heap_no)) {
-				m_too_deep = true;
-				return(m_start);
-			}
-
-
-			m_wait_lock = lock->trx->lock.wait_lock;
-
-			lock = get_first_lock(&heap_no);
-
-			if (is_visited(lock)) {
-				lock = get_next_lock(lock, heap_no);
-			}
-
-		} else {
-			lock = get_next_lock(lock, heap_no);
-		}
+		return(trx2);
 	}
 
-	ut_a(lock == NULL && m_n_elems == 0);
-
-	/* No deadlock found. */
-	return(0);
-}
-
-/** Print info about transaction that was rolled back.
-@param trx transaction rolled back
-@param lock lock trx wants */
-void
-DeadlockChecker::rollback_print(const trx_t*	trx, const lock_t* lock)
-{
-	ut_ad(lock_mutex_own());
-
-	/* If the lock search exceeds the max step
-	or the max depth, the current trx will be
-	the victim. Print its information. */
-	start_print();
-
-	print("TOO DEEP OR LONG SEARCH IN THE LOCK TABLE"
-	      " WAITS-FOR GRAPH, WE WILL ROLL BACK"
-	      " FOLLOWING TRANSACTION \n\n"
-	      "*** TRANSACTION:\n");
-
-	print(trx, 3000);
-
-	print("*** WAITING FOR THIS LOCK TO BE GRANTED:\n");
-
-	print(lock);
+	return(trx1);
 }
 
-/** Rollback transaction selected as the victim. */
+/** Rollback transaction selected as the victim.
+@param trx transaction to roll back */
 void
-DeadlockChecker::trx_rollback()
+DeadlockChecker::trx_rollback(trx_t* trx)
 {
 	ut_ad(lock_mutex_own());
 
-	trx_t*	trx = m_wait_lock->trx;
-
-	print("*** WE ROLL BACK TRANSACTION (1)\n");
-
 	trx_mutex_enter(trx);
 
 	trx->lock.was_chosen_as_deadlock_victim = true;
@@ -7593,21 +7659,19 @@ DeadlockChecker::trx_rollback()
 	trx_mutex_exit(trx);
 }
 
-/** Checks if a joining lock request results in a deadlock. If a deadlock is
-found this function will resolve the deadlock by choosing a victim transaction
-and rolling it back. It will attempt to resolve all deadlocks. The returned
-transaction id will be the joining transaction instance or NULL if some other
-transaction was chosen as a victim and rolled back or no deadlock found.
+/** Checks if a joining lock request must be refused at once. Cycles in the
+waits-for graph are resolved later by resolve_cycle().
 
 @param[in]	lock lock the transaction is requesting
 @param[in,out]	trx transaction requesting the lock
 
-@return transaction instanace chosen as victim or 0 */
+@return trx if it is to be rolled back, else NULL */
 const trx_t*
 DeadlockChecker::check_and_resolve(const lock_t* lock, trx_t* trx)
 {
 	ut_ad(lock_mutex_own());
 	ut_ad(trx_mutex_own(trx));
+	ut_ad(lock->trx == trx);
 	check_trx_state(trx);
 	ut_ad(!srv_read_only_mode);
 
@@ -7616,67 +7680,107 @@ DeadlockChecker::check_and_resolve(const lock_t* lock, trx_t* trx)
 	We return current transaction as deadlock victim here. */
 	if (trx->in_innodb & TRX_FORCE_ROLLBACK_ASYNC) {
 		return(trx);
-	} else if (!innobase_deadlock_detect) {
-		return(NULL);
 	}
 
-	/*  Release the mutex to obey the latching order.
-	This is safe, because DeadlockChecker::check_and_resolve()
-	is invoked when a lock wait is enqueued for the currently
-	running transaction. Because m_trx is a running transaction
-	(it is not currently suspended because of a lock wait),
-	its state can only be changed by this thread, which is
-	currently associated with the transaction. */
+	return(NULL);
+}
 
-	trx_mutex_exit(trx);
+/** Check that a cycle found in a snapshot of the waits-for graph still
+exists, and if so resolve it by rolling back the transaction which has the
+smallest weight.
 
-	const trx_t*	victim_trx;
+@param[in]	cycle	transactions each of which waits for the next one,
+			the last one waiting for the first one
+@param[in]	n_trx	number of transactions in the cycle
 
-	/* Try and resolve as many deadlocks as possible. */
-	do {
-		DeadlockChecker	checker(trx, lock, s_lock_mark_counter);
+@return the transaction rolled back, or NULL if the cycle does not exist
+anymore */
+const trx_t*
+DeadlockChecker::resolve_cycle(trx_t* const* cycle, ulint n_trx)
+{
+	ut_ad(lock_mutex_own());
+	ut_ad(n_trx > 1);
 
-		victim_trx = checker.search();
+	/* The snapshot was taken without any latch: the transactions
+	may have been granted their locks, or even committed, since. */
 
-		/* Search too deep, we rollback the joining transaction only
-		if it is possible to rollback. Otherwise we rollback the
-		transaction that is holding the lock that the joining
-		transaction wants. */
-		if (checker.is_too_deep()) {
+	for (ulint i = 0; i < n_trx; ++i) {
+		const trx_t*	trx = cycle[i];
+		const lock_t*	wait_lock = trx->lock.wait_lock;
 
-			ut_ad(trx == checker.m_start);
-			ut_ad(trx == victim_trx);
+		if (wait_lock == NULL
+		    || trx->lock.que_state != TRX_QUE_LOCK_WAIT
+		    || !is_blocked_by(wait_lock, cycle[(i + 1) % n_trx])) {
 
-			rollback_print(victim_trx, lock);
+			return(NULL);
+		}
+	}
 
-			MONITOR_INC(MONITOR_DEADLOCK);
+	ulint	victim_no = 0;
 
-			break;
+	for (ulint i = 1; i < n_trx; ++i) {
+		if (select_victim(cycle[victim_no], cycle[i]) == cycle[i]) {
+			victim_no = i;
+		}
+	}
 
-		} else if (victim_trx != NULL && victim_trx != trx) {
+	notify(cycle, n_trx);
 
-			ut_ad(victim_trx == checker.m_wait_lock->trx);
+	char	buf[64];
 
-			checker.trx_rollback();
+	snprintf(buf, sizeof(buf), "*** WE ROLL BACK TRANSACTION (%lu)\n",
+		 (ulong) (victim_no + 1));
+	print(buf);
 
-			lock_deadlock_found = true;
+	trx_t*	victim = cycle[victim_no];
 
-			MONITOR_INC(MONITOR_DEADLOCK);
-		}
+	trx_rollback(victim);
 
-	} while (victim_trx != NULL && victim_trx != trx);
+	lock_deadlock_found = true;
 
-	/* If the joining transaction was selected as the victim. */
-	if (victim_trx != NULL) {
+	MONITOR_INC(MONITOR_DEADLOCK);
 
-		print("*** WE ROLL BACK TRANSACTION (2)\n");
+	return(victim);
+}
 
-		lock_deadlock_found = true;
-	}
+/** Check that a cycle found by the deadlock detector in a snapshot of the
+waits-for graph still exists, and if so resolve it by rolling back one of
+its transactions.
+@param[in]	cycle	transactions each of which waits for the next one,
+			the last one waiting for the first one
+@param[in]	n_trx	number of transactions in the cycle
+@return true if a transaction was rolled back */
+bool
+lock_resolve_deadlock(
+	trx_t* const*	cycle,
+	ulint		n_trx)
+{
+	lock_mutex_enter();
 
-	trx_mutex_enter(trx);
+	bool	resolved = DeadlockChecker::resolve_cycle(cycle, n_trx) != NULL;
+
+	lock_mutex_exit();
+
+	return(resolved);
+}
 
-	return(victim_trx);
+/** Append the edges of the waits-for graph from a waiting transaction:
+one to each transaction which holds or requests a conflicting lock ahead
+of the lock request that it waits for.
+@param[in]	trx	transaction
+@param[in,out]	edges	edges of the waits-for graph */
+void
+lock_get_wait_edges(
+	trx_t*			trx,
+	lock_wait_edges_t&	edges)
+{
+	ut_ad(lock_mutex_own());
+
+	const lock_t*	wait_lock = trx->lock.wait_lock;
+
+	if (wait_lock != NULL && trx->lock.que_state == TRX_QUE_LOCK_WAIT) {
+		DeadlockChecker::get_wait_edges(wait_lock, edges);
+	}
 }
 
 /**
@@ -43,6 +43,9 @@ Created 25/5/2010 Sunny Bains
 #include "srv0start.h"
 #include "lock0priv.h"
 
+#include <algorithm>
+#include <vector>
+
 /*********************************************************************//**
 Print the contents of the lock_sys_t::waiting_threads array. */
 static
@@ -252,9 +255,10 @@ lock_wait_suspend_thread(
 		start_time = ut_time_monotonic_us();
 	}
 
-	/* Wake the lock timeout monitor thread, if it is suspended */
+	/* Wake the lock timeout monitor thread, if it is suspended,
+	and have it look for a deadlock that this wait may close */
 
-	os_event_set(lock_sys->timeout_event);
+	lock_wait_request_check_for_cycles();
 
 	lock_wait_mutex_exit();
 	trx_mutex_exit(trx);
@@ -391,13 +395,14 @@ lock_wait_release_thread_if_suspended(
 	que_thr_t*	thr)	/*!< in: query thread associated with the
 				user OS thread	 */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_sys_latched());
 	ut_ad(trx_mutex_own(thr_get_trx(thr)));
 
-	/* We own both the lock mutex and the trx_t::mutex but not the
-	lock wait mutex. This is OK because other threads will see the state
-	of this slot as being in use and no other thread can change the state
-	of the slot to free unless that thread also owns the lock mutex. */
+	/* We own both lock_sys->latch (in shared or exclusive mode) and
+	the trx_t::mutex but not the lock wait mutex. This is OK because
+	other threads will see the state of this slot as being in use and no
+	other thread can change the state of the slot to free unless that
+	thread also owns lock_sys->latch in exclusive mode. */
 
 	if (thr->slot != NULL && thr->slot->in_use && thr->slot->thr == thr) {
 		trx_t*	trx = thr_get_trx(thr);
@@ -466,6 +471,150 @@ lock_wait_check_and_cancel(
 
 }
 
+/** Have the lock wait timeout thread search the waits-for graph for
+deadlocks at its next wake up. */
+void
+lock_wait_request_check_for_cycles()
+{
+	lock_sys->deadlock_check_requested = true;
+
+	os_event_set(lock_sys->timeout_event);
+}
+
+/** Search the waits-for graph for deadlocks and resolve them. A waiting
+transaction has an edge to every transaction which holds or requests a
+conflicting lock ahead of it in the queue. The graph is copied from the
+lock queues of the suspended threads, and searched after releasing
+lock_sys->latch, so that the lock requests are only delayed for the time
+of the copy. The cycles are validated by lock_resolve_deadlock(). */
+static
+void
+lock_wait_check_for_deadlocks()
+{
+	lock_wait_edges_t	edges;
+
+	/* A slot can't be freed or reserved without the lock wait mutex,
+	and the lock queues can't change without lock_sys->latch. */
+
+	lock_wait_mutex_enter();
+
+	lock_mutex_enter();
+
+	for (const srv_slot_t* slot = lock_sys->waiting_threads;
+	     slot < lock_sys->last_slot;
+	     ++slot) {
+
+		if (slot->in_use) {
+			lock_get_wait_edges(thr_get_trx(slot->thr), edges);
+		}
+	}
+
+	lock_mutex_exit();
+
+	lock_wait_mutex_exit();
+
+	if (edges.size() < 2) {
+		return;
+	}
+
+	/* Sort the edges by waiting transaction, so that a transaction
+	is identified by the index of its first outgoing edge. */
+
+	std::sort(edges.begin(), edges.end());
+
+	/* Search state of each transaction of the snapshot: 0 if not
+	visited yet, 1 if on the current path, 2 if done. */
+
+	std::vector<byte, ut_allocator<byte> >	state(edges.size(), 0);
+
+	/* The current path of the depth-first search: for each
+	transaction on it, its first edge and the next edge to follow. */
+
+	typedef std::pair<ulint, ulint>	frame_t;
+
+	std::vector<frame_t, ut_allocator<frame_t> >	path;
+	std::vector<trx_t*, ut_allocator<trx_t*> >	cycle;
+
+	for (ulint start = 0; start < edges.size(); ++start) {
+
+		if (state[start] != 0
+		    || (start > 0
+			&& edges[start - 1].first == edges[start].first)) {
+
+			continue;
+		}
+
+		state[start] = 1;
+		path.push_back(frame_t(start, start));
+
+		while (!path.empty()) {
+
+			frame_t&	top = path.back();
+
+			if (top.second == edges.size()
+			    || edges[top.second].first
+			    != edges[top.first].first) {
+
+				/* All the edges have been followed. */
+				state[top.first] = 2;
+				path.pop_back();
+				continue;
+			}
+
+			trx_t*	blocking_trx = edges[top.second++].second;
+
+			lock_wait_edges_t::const_iterator	next
+				= std::lower_bound(
+					edges.begin(), edges.end(),
+					lock_wait_edge_t(blocking_trx, NULL));
+
+			if (next == edges.end()
+			    || next->first != blocking_trx) {
+
+				/* The transaction does not wait. */
+				continue;
+			}
+
+			ulint	i = next - edges.begin();
+
+			if (state[i] == 0) {
+
+				state[i] = 1;
+				path.push_back(frame_t(i, i));
+
+			} else if (state[i] == 1) {
+
+				/* The path has closed a cycle, starting
+				from i. */
+
+				cycle.clear();
+
+				ulint	j = path.size();
+
+				do {
+					--j;
+				} while (path[j].first != i);
+
+				for (; j < path.size(); ++j) {
+					cycle.push_back(
+						edges[path[j].first].first);
+				}
+
+				if (lock_resolve_deadlock(
+					    &cycle[0], cycle.size())) {
+
+					/* Rolling back the victim may
+					have left other cycles, which
+					were hidden by the visited
+					transactions. */
+
+					lock_wait_request_check_for_cycles();
+				}
+			}
+		}
+	}
+}
+
 /*********************************************************************//**
 A thread which wakes up threads whose lock wait may have lasted too long.
 @return a dummy parameter */
@@ -524,6 +673,15 @@ DECLARE_THREAD(lock_wait_timeout_thread)(
 
 		lock_wait_mutex_exit();
 
+		if (lock_sys->deadlock_check_requested) {
+
+			lock_sys->deadlock_check_requested = false;
+
+			if (innobase_deadlock_detect) {
+				lock_wait_check_for_deadlocks();
+			}
+		}
+
 	} while (srv_shutdown_state < SRV_SHUTDOWN_CLEANUP);
 
 	lock_sys->timeout_thread_active = false;
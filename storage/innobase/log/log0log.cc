@@ -100,6 +100,11 @@ my_bool	innodb_log_checksums;
 /** Pointer to the log checksum calculation function */
 log_checksum_func_t log_checksum_algorithm_ptr;
 
+#ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t	log_writer_thread_key;
+mysql_pfs_key_t	log_flusher_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
 /* These control how often we print warnings if the last checkpoint is too
 old */
 bool	log_has_printed_chkp_warning = false;
@@ -163,6 +168,28 @@ log_buf_pool_get_oldest_modification(void)
 }
 #endif  /* !UNIV_HOTBACKUP */
 
+/** Wait until all the log buffer space reserved by log_reserve_low() so
+far has been filled, so that the log buffer contents up to log_sys->lsn
+can be written to the log files or moved. The mini-transactions filling
+the reserved space do not need the log mutex. */
+static
+void
+log_buffer_wait_for_recent_written()
+{
+	ut_ad(log_mutex_own());
+
+	ulint	n_spins = 0;
+
+	while (!log_sys->recent_written->advance_tail_until(log_sys->lsn)) {
+
+		if (n_spins++ < srv_n_spin_wait_rounds) {
+			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+		} else {
+			os_thread_yield();
+		}
+	}
+}
+
 /** Extends the log buffer.
 @param[in]	len	requested minimum size in bytes */
 void
@@ -215,6 +242,10 @@ log_buffer_extend(
 		log_mutex_enter_all();
 	}
 
+	/* The last block may still be being filled by
+	mini-transactions which reserved space in it. */
+	log_buffer_wait_for_recent_written();
+
 	move_start = ut_calc_align_down(
 		log_sys->buf_free,
 		OS_FILE_LOG_BLOCK_SIZE);
@@ -400,6 +431,15 @@ loop:
 		goto loop;
 	}
 
+	/* Wait until the mini-transactions which reserved log buffer
+	space long ago have filled it, so that the range starting at
+	log_sys->lsn can be tracked in log_sys->recent_written. */
+	while (!log_sys->recent_written->has_space(log_sys->lsn)) {
+		if (!log_sys->recent_written->advance_tail()) {
+			os_thread_yield();
+		}
+	}
+
 	return(log_sys->lsn);
 }
 
@@ -411,11 +451,25 @@ log_write_low(
 /*==========*/
 	const byte*	str,		/*!< in: string */
 	ulint		str_len)	/*!< in: string length */
+{
+	log_buffer_write(log_reserve_low(str_len), str, str_len);
+}
+
+/** Reserve space for a string in the log buffer without copying it.
+The block headers of the reserved area are initialized, so that the string
+can later be copied with log_buffer_write() without holding the log mutex.
+It is assumed that the caller holds the log mutex.
+@param[in]	str_len	string length
+@return where to copy the string in the log buffer */
+byte*
+log_reserve_low(
+	ulint	str_len)
 {
 	log_t*	log	= log_sys;
 	ulint	len;
 	ulint	data_len;
 	byte*	log_block;
+	byte*	ptr	= log->buf + log->buf_free;
 
 	ut_ad(log_mutex_own());
 part_loop:
@@ -437,10 +491,7 @@ part_loop:
 			- LOG_BLOCK_TRL_SIZE;
 	}
 
-	ut_memcpy(log->buf + log->buf_free, str, len);
-
 	str_len -= len;
-	str = str + len;
 
 	log_block = static_cast<byte*>(
 		ut_align_down(
@@ -472,6 +523,73 @@ part_loop:
 	}
 
 	srv_stats.log_write_requests.inc();
+
+	return(ptr);
+}
+
+/** Copy a string to space reserved with log_reserve_low(), skipping the
+log block trailers and headers. This does not need the log mutex, because
+the log buffer is not written or moved before log_buffer_write_completed()
+has been called for the whole reserved range.
+@param[in]	ptr	where to copy in the log buffer
+@param[in]	str	string
+@param[in]	str_len	string length
+@return position following the copied string */
+byte*
+log_buffer_write(
+	byte*		ptr,
+	const byte*	str,
+	ulint		str_len)
+{
+	while (str_len > 0) {
+		const ulint	offset = ut_align_offset(
+			ptr, OS_FILE_LOG_BLOCK_SIZE);
+
+		ut_ad(offset >= LOG_BLOCK_HDR_SIZE);
+		ut_ad(offset < OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE);
+
+		const ulint	len = ut_min(
+			str_len,
+			OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE - offset);
+
+		ut_memcpy(ptr, str, len);
+
+		str += len;
+		str_len -= len;
+		ptr += len;
+
+		if (offset + len
+		    == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+			/* Skip the trailer of this block and the
+			header of the next one */
+			ptr += LOG_BLOCK_TRL_SIZE + LOG_BLOCK_HDR_SIZE;
+		}
+	}
+
+	return(ptr);
+}
+
+/** Report that all the log records in the given LSN range have been
+copied to the log buffer.
+@param[in]	start_lsn	start of the range
+@param[in]	end_lsn		end of the range */
+void
+log_buffer_write_completed(
+	lsn_t	start_lsn,
+	lsn_t	end_lsn)
+{
+	ut_ad(end_lsn > start_lsn);
+
+	log_sys->recent_written->add_link(start_lsn, end_lsn);
+}
+
+/** Restart the tracking of the log buffer ranges reserved by
+mini-transactions from log_sys->lsn. This must be called whenever
+log_sys->lsn has been assigned directly, rather than by log_reserve_low(). */
+void
+log_recent_written_reset()
+{
+	log_sys->recent_written->reset(log_sys->lsn);
 }
 
 /************************************************************//**
@@ -859,6 +977,25 @@ log_init(void)
 	log_sys->buf_free = LOG_BLOCK_HDR_SIZE;
 	log_sys->lsn = LOG_START_LSN + LOG_BLOCK_HDR_SIZE;
 
+	log_sys->recent_written = UT_NEW_NOKEY(
+		Link_buf<lsn_t>(LOG_RECENT_WRITTEN_SIZE));
+
+	log_sys->writer_event = os_event_create(0);
+	log_sys->flusher_event = os_event_create(0);
+
+	log_sys->n_events = ut_2_power_up(srv_log_events);
+	log_sys->write_events = UT_NEW_ARRAY_NOKEY(
+		os_event_t, log_sys->n_events);
+	log_sys->flush_events = UT_NEW_ARRAY_NOKEY(
+		os_event_t, log_sys->n_events);
+
+	for (ulint i = 0; i < log_sys->n_events; ++i) {
+		log_sys->write_events[i] = os_event_create(0);
+		log_sys->flush_events[i] = os_event_create(0);
+	}
+
+	log_recent_written_reset();
+
 	MONITOR_SET(MONITOR_LSN_CHECKPOINT_AGE,
 		    log_sys->lsn - log_sys->last_checkpoint_lsn);
 }
@@ -1209,12 +1346,15 @@ log_buffer_switch()
 /** Ensure that the log has been written to the log file up to a given
 log entry (such as that of a transaction commit). Start a new write, or
 wait and check if an already running write is covering the request.
+This is done by the log writer and log flusher threads, or by the callers
+of log_write_up_to() when those threads are not running.
 @param[in]	lsn		log sequence number that should be
 included in the redo log file write
 @param[in]	flush_to_disk	whether the written log should also
 be flushed to the file system */
+static
 void
-log_write_up_to(
+log_write_up_to_low(
 	lsn_t	lsn,
 	bool	flush_to_disk)
 {
@@ -1301,6 +1441,12 @@ loop:
 	}
 
 	log_mutex_enter();
+
+	/* The log records up to log_sys->lsn might still be being copied
+	to the log buffer by the mini-transactions which reserved the
+	space for them. */
+	log_buffer_wait_for_recent_written();
+
 	if (!flush_to_disk
 	    && log_sys->buf_free == log_sys->buf_next_to_write) {
 		/* Nothing to write and no flush to disk requested */
@@ -1415,6 +1561,450 @@ loop:
 	}
 }
 
+/** Flush the log that the log writer thread has written, without writing
+anything, so that the flush and the next write can overlap. Used by the
+log flusher thread. */
+static
+void
+log_flush_written_low()
+{
+	log_write_mutex_enter();
+
+	if (log_sys->n_pending_flushes > 0
+	    || !os_event_is_set(log_sys->flush_event)) {
+		/* A flush by log_write_up_to_low() is running. */
+		log_write_mutex_exit();
+		os_event_wait(log_sys->flush_event);
+		return;
+	}
+
+	if (log_sys->flushed_to_disk_lsn >= log_sys->write_lsn) {
+		log_write_mutex_exit();
+		return;
+	}
+
+	log_sys->n_pending_flushes++;
+	log_sys->current_flush_lsn = log_sys->write_lsn;
+	MONITOR_INC(MONITOR_PENDING_LOG_FLUSH);
+	os_event_reset(log_sys->flush_event);
+
+	log_write_mutex_exit();
+
+	log_write_flush_to_disk_low();
+}
+
+/** Maximum time in microseconds that the log writer and flusher threads
+sleep when they are not requested anything */
+static const ulint	LOG_THREAD_IDLE_TIMEOUT_US = 100000;
+
+/** @return the event slot of the threads waiting for the log block which
+contains the given lsn - 1 to be written or flushed
+@param[in]	events	log_sys->write_events or log_sys->flush_events
+@param[in]	lsn	lsn which is waited for, must be positive */
+static inline
+os_event_t
+log_wait_event(
+	os_event_t*	events,
+	lsn_t		lsn)
+{
+	ut_ad(lsn > 0);
+
+	return(events[static_cast<ulint>((lsn - 1) / OS_FILE_LOG_BLOCK_SIZE)
+		      & (log_sys->n_events - 1)]);
+}
+
+/** Wake up the threads waiting for the log blocks in the given range.
+@param[in]	events	log_sys->write_events or log_sys->flush_events
+@param[in]	old_lsn	write_lsn or flushed_to_disk_lsn before the i/o
+@param[in]	new_lsn	write_lsn or flushed_to_disk_lsn after the i/o */
+static
+void
+log_notify_waiters(
+	os_event_t*	events,
+	lsn_t		old_lsn,
+	lsn_t		new_lsn)
+{
+	if (new_lsn <= old_lsn) {
+		return;
+	}
+
+	const lsn_t	first = old_lsn / OS_FILE_LOG_BLOCK_SIZE;
+	const lsn_t	last = (new_lsn - 1) / OS_FILE_LOG_BLOCK_SIZE;
+
+	if (last - first >= log_sys->n_events) {
+		for (ulint i = 0; i < log_sys->n_events; ++i) {
+			os_event_set(events[i]);
+		}
+		return;
+	}
+
+	for (lsn_t block = first; block <= last; ++block) {
+		os_event_set(events[static_cast<ulint>(block)
+				    & (log_sys->n_events - 1)]);
+	}
+}
+
+/** Update a moving average of i/o times.
+@param[in,out]	avg_us		average in microseconds
+@param[in]	start_us	when the i/o was started */
+static inline
+void
+log_update_avg_us(
+	volatile ulint*		avg_us,
+	ib_time_monotonic_us_t	start_us)
+{
+	const ib_time_monotonic_us_t	now = ut_time_monotonic_us();
+	const ulint			time_us = now > start_us
+		? static_cast<ulint>(now - start_us) : 0;
+
+	*avg_us = (*avg_us * 7 + time_us) / 8;
+}
+
+/** Wake up all threads waiting in log_write_up_to(), when the log writer
+and log flusher threads stop. */
+static
+void
+log_wake_all_waiters()
+{
+	for (ulint i = 0; i < log_sys->n_events; ++i) {
+		os_event_set(log_sys->write_events[i]);
+		os_event_set(log_sys->flush_events[i]);
+	}
+}
+
+/** Wake up the log writer thread, and the log flusher thread if a flush is
+requested. The log up to the requested lsn may already have been written,
+in which case the writer has nothing to do and would not wake the flusher.
+@param[in]	flush_to_disk	whether a flush is requested */
+static
+void
+log_wake_writer_threads(
+	bool	flush_to_disk)
+{
+	os_event_set(log_sys->writer_event);
+
+	if (flush_to_disk) {
+		os_event_set(log_sys->flusher_event);
+	}
+}
+
+/** Wait until the log writer or log flusher thread has advanced write_lsn
+or flushed_to_disk_lsn up to a given lsn. Spin first if the i/o is expected
+to complete soon, then sleep on the event slot of the lsn until the thread
+that advanced the lsn past it sets the event.
+@param[in]	lsn		lsn to wait for
+@param[in]	flush_to_disk	whether to wait for flushed_to_disk_lsn
+@return false if the threads were stopped before lsn was reached */
+static
+bool
+log_wait_for_writer_threads(
+	lsn_t	lsn,
+	bool	flush_to_disk)
+{
+	volatile lsn_t*	target = flush_to_disk
+		? &log_sys->flushed_to_disk_lsn
+		: &log_sys->write_lsn;
+	volatile ulint*	n_waiters = flush_to_disk
+		? &log_sys->n_flush_waiters
+		: &log_sys->n_write_waiters;
+	os_event_t	event = log_wait_event(
+		flush_to_disk ? log_sys->flush_events : log_sys->write_events,
+		lsn);
+	bool		success = true;
+
+	/* The threads reset their event before they look at the number
+	of waiters, so they either see us or are woken up by us. */
+	os_atomic_increment_ulint(n_waiters, 1);
+
+	log_wake_writer_threads(flush_to_disk);
+
+	const ulint	spin_hwm = srv_log_wait_for_flush_spin_hwm;
+	const ulint	avg_us = flush_to_disk
+		? log_sys->flush_avg_us + log_sys->write_avg_us
+		: log_sys->write_avg_us;
+
+	if (avg_us <= spin_hwm) {
+		const ib_time_monotonic_us_t	deadline
+			= ut_time_monotonic_us() + spin_hwm;
+
+		for (ulint i = 0; *target < lsn; ++i) {
+			if ((i & 63) == 63
+			    && ut_time_monotonic_us() >= deadline) {
+				break;
+			}
+
+			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+			os_rmb;
+		}
+	}
+
+	for (;;) {
+		int64_t	sig_count = os_event_reset(event);
+
+		os_rmb;
+
+		if (*target >= lsn) {
+			break;
+		}
+
+		if (!log_sys->writer_threads_active) {
+			success = false;
+			break;
+		}
+
+		os_event_wait_low(event, sig_count);
+	}
+
+	os_atomic_decrement_ulint(n_waiters, 1);
+
+	return(success);
+}
+
+/** Ensure that the log has been written to the log file up to a given
+log entry (such as that of a transaction commit). When the log writer and
+log flusher threads are running, request the write and wait for their
+notification, otherwise write and flush the log here.
+@param[in]	lsn		log sequence number that should be
+included in the redo log file write
+@param[in]	flush_to_disk	whether the written log should also
+be flushed to the file system */
+void
+log_write_up_to(
+	lsn_t	lsn,
+	bool	flush_to_disk)
+{
+	ut_ad(!srv_read_only_mode);
+
+	if (recv_no_ibuf_operations) {
+		/* Recovery is running and no operations on the log files are
+		allowed yet (the variable name .._no_ibuf_.. is misleading) */
+
+		return;
+	}
+
+	if (log_sys->writer_threads_active) {
+
+		os_rmb;
+
+		if ((flush_to_disk
+		     ? log_sys->flushed_to_disk_lsn
+		     : log_sys->write_lsn) >= lsn) {
+			return;
+		}
+
+		if (log_wait_for_writer_threads(lsn, flush_to_disk)) {
+			return;
+		}
+	}
+
+	log_write_up_to_low(lsn, flush_to_disk);
+}
+
+/******************************************************************//**
+The log writer thread writes the log buffer to the log files on behalf of
+the threads waiting in log_write_up_to().
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(log_writer_thread)(
+/*==============================*/
+	void*	arg MY_ATTRIBUTE((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+	my_thread_init();
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(log_writer_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	while (log_sys->writer_threads_active
+	       && srv_shutdown_state != SRV_SHUTDOWN_EXIT_THREADS) {
+
+		int64_t	sig_count = os_event_reset(log_sys->writer_event);
+
+		os_rmb;
+
+		const lsn_t	lsn = log_get_lsn();
+		const lsn_t	old_write_lsn = log_sys->write_lsn;
+		const lsn_t	old_flushed_lsn = log_sys->flushed_to_disk_lsn;
+
+		if ((log_sys->n_write_waiters == 0
+		     && log_sys->n_flush_waiters == 0)
+		    || old_write_lsn >= lsn) {
+
+			/* Everything is written, but the flush waiters
+			may still be waiting for the flusher. */
+			if (log_sys->n_flush_waiters > 0
+			    && old_flushed_lsn < old_write_lsn) {
+				os_event_set(log_sys->flusher_event);
+			}
+
+			os_event_wait_time_low(
+				log_sys->writer_event,
+				LOG_THREAD_IDLE_TIMEOUT_US, sig_count);
+			continue;
+		}
+
+		const ib_time_monotonic_us_t	start_us
+			= ut_time_monotonic_us();
+
+		log_write_up_to_low(lsn, false);
+
+		log_update_avg_us(&log_sys->write_avg_us, start_us);
+
+		os_rmb;
+
+		log_notify_waiters(
+			log_sys->write_events, old_write_lsn,
+			log_sys->write_lsn);
+
+		/* With O_DSYNC, the write flushed the log as well. */
+		log_notify_waiters(
+			log_sys->flush_events, old_flushed_lsn,
+			log_sys->flushed_to_disk_lsn);
+
+		if (log_sys->n_flush_waiters > 0) {
+			os_event_set(log_sys->flusher_event);
+		}
+	}
+
+	log_sys->writer_threads_active = false;
+
+	os_wmb;
+
+	log_wake_all_waiters();
+
+	log_sys->writer_thread_alive = false;
+
+	os_wmb;
+
+	my_thread_end();
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/******************************************************************//**
+The log flusher thread flushes the written log to disk on behalf of the
+threads waiting in log_write_up_to().
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(log_flusher_thread)(
+/*===============================*/
+	void*	arg MY_ATTRIBUTE((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+	my_thread_init();
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(log_flusher_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	while (log_sys->writer_threads_active
+	       && srv_shutdown_state != SRV_SHUTDOWN_EXIT_THREADS) {
+
+		int64_t	sig_count = os_event_reset(log_sys->flusher_event);
+
+		os_rmb;
+
+		/* Flush only what the writer thread has written, so that
+		the flush and the next write can overlap. */
+		const lsn_t	lsn = log_sys->write_lsn;
+		const lsn_t	old_flushed_lsn = log_sys->flushed_to_disk_lsn;
+
+		if (log_sys->n_flush_waiters == 0 || old_flushed_lsn >= lsn) {
+
+			os_event_wait_time_low(
+				log_sys->flusher_event,
+				LOG_THREAD_IDLE_TIMEOUT_US, sig_count);
+			continue;
+		}
+
+		const ib_time_monotonic_us_t	start_us
+			= ut_time_monotonic_us();
+
+		log_flush_written_low();
+
+		log_update_avg_us(&log_sys->flush_avg_us, start_us);
+
+		os_rmb;
+
+		log_notify_waiters(
+			log_sys->flush_events, old_flushed_lsn,
+			log_sys->flushed_to_disk_lsn);
+	}
+
+	log_sys->writer_threads_active = false;
+
+	os_wmb;
+
+	log_wake_all_waiters();
+
+	log_sys->flusher_thread_alive = false;
+
+	os_wmb;
+
+	my_thread_end();
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Start the log writer and log flusher threads. From now on,
+log_write_up_to() leaves the writes and flushes to them and waits for
+their notification. */
+void
+log_start_background_threads()
+{
+	ut_ad(!srv_read_only_mode);
+	ut_ad(!log_sys->writer_threads_active);
+
+	log_sys->writer_thread_alive = true;
+	log_sys->flusher_thread_alive = true;
+	log_sys->writer_threads_active = true;
+
+	os_wmb;
+
+	os_thread_create(log_writer_thread, NULL, NULL);
+	os_thread_create(log_flusher_thread, NULL, NULL);
+}
+
+/** Wake up the log writer and log flusher threads, so that they notice
+srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS. */
+void
+log_wake_background_threads()
+{
+	if (log_sys != NULL && log_sys->writer_event != NULL) {
+		os_event_set(log_sys->writer_event);
+		os_event_set(log_sys->flusher_event);
+	}
+}
+
+/** Stop the log writer and log flusher threads and wait for them to exit.
+From now on, log_write_up_to() writes and flushes the log itself. */
+void
+log_stop_background_threads()
+{
+	log_sys->writer_threads_active = false;
+
+	os_wmb;
+
+	while (log_sys->writer_thread_alive || log_sys->flusher_thread_alive) {
+		log_wake_background_threads();
+		os_thread_sleep(1000);
+	}
+
+	/* Let the remaining waiters notice that they are on their own. */
+	log_wake_all_waiters();
+}
+
 /** write to the log file up to the last log entry.
 @param[in]	sync	whether we want the written log
 also to be flushed to disk. */
@@ -2096,6 +2686,16 @@ logs_empty_and_mark_files_at_shutdown(void)
 
 	ib::info() << "Starting shutdown...";
 
+	/* Write and flush the log in the shutting down threads from now
+	on, rather than leaving it to the log writer and flusher threads. */
+	if (!srv_read_only_mode) {
+		log_stop_background_threads();
+	}
+
+	/* Let the page cleaner threads flush the LRU lists during the
+	shutdown, which must not wait for the LRU manager threads. */
+	buf_lru_manager_stop();
+
 	if (srv_fast_shutdown == 0) {
 		/* we should wait until rollback after recovery end
 		for slow shutdown */
@@ -2494,12 +3094,30 @@ log_shutdown(void)
 	ut_free(log_sys->buf_ptr);
 	log_sys->buf_ptr = NULL;
 	log_sys->buf = NULL;
+	UT_DELETE(log_sys->recent_written);
+	log_sys->recent_written = NULL;
 	ut_free(log_sys->checkpoint_buf_ptr);
 	log_sys->checkpoint_buf_ptr = NULL;
 	log_sys->checkpoint_buf = NULL;
 
 	os_event_destroy(log_sys->flush_event);
 
+	ut_ad(!log_sys->writer_thread_alive);
+	ut_ad(!log_sys->flusher_thread_alive);
+
+	os_event_destroy(log_sys->writer_event);
+	os_event_destroy(log_sys->flusher_event);
+
+	for (ulint i = 0; i < log_sys->n_events; ++i) {
+		os_event_destroy(log_sys->write_events[i]);
+		os_event_destroy(log_sys->flush_events[i]);
+	}
+
+	UT_DELETE_ARRAY(log_sys->write_events);
+	UT_DELETE_ARRAY(log_sys->flush_events);
+	log_sys->write_events = NULL;
+	log_sys->flush_events = NULL;
+
 	rw_lock_free(&log_sys->checkpoint_lock);
 
 	mutex_free(&log_sys->mutex);
@@ -166,6 +166,7 @@ mysql_pfs_key_t	trx_rollback_clean_thread_key;
 #ifndef UNIV_HOTBACKUP
 # ifdef UNIV_PFS_THREAD
 mysql_pfs_key_t	recv_writer_thread_key;
+mysql_pfs_key_t	recv_apply_thread_key;
 # endif /* UNIV_PFS_THREAD */
 
 /** Flag indicating if recv_writer thread is active. */
@@ -2618,48 +2619,42 @@ recv_read_in_area(
 	return(n);
 }
 
-/*******************************************************************//**
-Empties the hash table of stored log records, applying them to appropriate
-pages. */
-void
-recv_apply_hashed_log_recs(
-/*=======================*/
-	ibool	allow_ibuf)	/*!< in: if TRUE, also ibuf operations are
-				allowed during the application; if FALSE,
-				no ibuf operations are allowed, and after
-				the application all file pages are flushed to
-				disk and invalidated in buffer pool: this
-				alternative means that no new log records
-				can be generated during the application;
-				the caller must in this case own the log
-				mutex */
+/** @return the recv_apply_thread in charge of a page. All the pages of
+a read-ahead area are assigned to the same thread, so that the pages read
+by recv_read_in_area() mostly belong to the partition of the caller.
+@param[in]	space		tablespace id
+@param[in]	page_no		page number
+@param[in]	n_threads	number of apply threads */
+static inline
+ulint
+recv_apply_thread_no(
+	ulint	space,
+	ulint	page_no,
+	ulint	n_threads)
 {
-	recv_addr_t* recv_addr;
-	ulint	i;
-	ibool	has_printed	= FALSE;
-	mtr_t	mtr;
-loop:
-	mutex_enter(&(recv_sys->mutex));
-
-	if (recv_sys->apply_batch_on) {
-
-		mutex_exit(&(recv_sys->mutex));
-
-		os_thread_sleep(500000);
-
-		goto loop;
-	}
-
-	ut_ad(!allow_ibuf == log_mutex_own());
+	return(ut_fold_ulint_pair(space, page_no / RECV_READ_AHEAD_AREA)
+	       % n_threads);
+}
 
-	if (!allow_ibuf) {
-		recv_no_ibuf_operations = true;
-	}
+/** Apply the hashed log records to the pages of one partition of the
+current apply batch. The pages which are in the buffer pool are recovered
+here, the others are read in with recv_read_in_area() and recovered by the
+i/o handler threads. The caller must own recv_sys->mutex, which is
+released while applying the log records.
+@param[in]	thread_no	partition to apply
+@param[in]	n_threads	number of partitions */
+static
+void
+recv_apply_partition(
+	ulint	thread_no,
+	ulint	n_threads)
+{
+	recv_addr_t*	recv_addr;
+	mtr_t		mtr;
 
-	recv_sys->apply_log_recs = TRUE;
-	recv_sys->apply_batch_on = TRUE;
+	ut_ad(mutex_own(&recv_sys->mutex));
 
-	for (i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
+	for (ulint i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
 
 		for (recv_addr = static_cast<recv_addr_t*>(
 				HASH_GET_FIRST(recv_sys->addr_hash, i));
@@ -2667,6 +2662,12 @@ loop:
 		     recv_addr = static_cast<recv_addr_t*>(
 				HASH_GET_NEXT(addr_hash, recv_addr))) {
 
+			if (recv_apply_thread_no(recv_addr->space,
+						 recv_addr->page_no,
+						 n_threads) != thread_no) {
+				continue;
+			}
+
 			if (srv_is_tablespace_truncated(recv_addr->space)) {
 				/* Avoid applying REDO log for the tablespace
 				that is schedule for TRUNCATE. */
@@ -2692,15 +2693,6 @@ loop:
 			ut_ad(found);
 
 			if (recv_addr->state == RECV_NOT_PROCESSED) {
-				if (!has_printed) {
-					ib::info() << "Starting an apply batch"
-						" of log records"
-						" to the database...";
-					fputs("InnoDB: Progress in percent: ",
-					      stderr);
-					has_printed = TRUE;
-				}
-
 				mutex_exit(&(recv_sys->mutex));
 
 				if (buf_page_peek(page_id)) {
@@ -2724,29 +2716,135 @@ loop:
 				mutex_enter(&(recv_sys->mutex));
 			}
 		}
+	}
+}
 
-		if (has_printed
-		    && (i * 100) / hash_get_n_cells(recv_sys->addr_hash)
-		    != ((i + 1) * 100)
-		    / hash_get_n_cells(recv_sys->addr_hash)) {
+/******************************************************************//**
+Thread applying one partition of the hashed log records, in parallel with
+recv_apply_hashed_log_recs() which applies the first partition.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(recv_apply_thread)(
+/*==============================*/
+	void*	arg)	/*!< in: pointer to the partition number */
+{
+	const ulint	thread_no = *static_cast<ulint*>(arg);
 
-			fprintf(stderr, "%lu ", (ulong)
-				((i * 100)
-				 / hash_get_n_cells(recv_sys->addr_hash)));
-		}
+	my_thread_init();
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(recv_apply_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	mutex_enter(&recv_sys->mutex);
+
+	recv_apply_partition(thread_no, recv_sys->n_apply_threads);
+
+	ut_a(recv_sys->n_apply_threads_active > 0);
+	recv_sys->n_apply_threads_active--;
+
+	mutex_exit(&recv_sys->mutex);
+
+	my_thread_end();
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*******************************************************************//**
+Empties the hash table of stored log records, applying them to appropriate
+pages. The pages are partitioned by (space, page_no) over
+srv_n_recv_apply_threads threads, which read their pages ahead and apply the
+log records of each page in LSN order. */
+void
+recv_apply_hashed_log_recs(
+/*=======================*/
+	ibool	allow_ibuf)	/*!< in: if TRUE, also ibuf operations are
+				allowed during the application; if FALSE,
+				no ibuf operations are allowed, and after
+				the application all file pages are flushed to
+				disk and invalidated in buffer pool: this
+				alternative means that no new log records
+				can be generated during the application;
+				the caller must in this case own the log
+				mutex */
+{
+	ibool	has_printed	= FALSE;
+loop:
+	mutex_enter(&(recv_sys->mutex));
+
+	if (recv_sys->apply_batch_on) {
+
+		mutex_exit(&(recv_sys->mutex));
+
+		os_thread_sleep(500000);
+
+		goto loop;
+	}
+
+	ut_ad(!allow_ibuf == log_mutex_own());
+
+	if (!allow_ibuf) {
+		recv_no_ibuf_operations = true;
+	}
+
+	recv_sys->apply_log_recs = TRUE;
+	recv_sys->apply_batch_on = TRUE;
+
+	const ulint		n_pages = recv_sys->n_addrs;
+	const ulint		n_threads = n_pages == 0
+		? 1 : ut_max(srv_n_recv_apply_threads, 1UL);
+	const ib_time_monotonic_ms_t	start_time = ut_time_monotonic_ms();
+	ulint			last_percent = 0;
+
+	if (n_pages > 0) {
+		ib::info() << "Starting an apply batch of log records to "
+			<< n_pages << " pages with " << n_threads
+			<< " threads...";
+		fputs("InnoDB: Progress in percent: ", stderr);
+		has_printed = TRUE;
 	}
 
+	ulint*	thread_nos = UT_NEW_ARRAY_NOKEY(ulint, n_threads);
+
+	recv_sys->n_apply_threads = n_threads;
+	recv_sys->n_apply_threads_active = n_threads - 1;
+
+	for (ulint t = 1; t < n_threads; ++t) {
+		thread_nos[t] = t;
+		os_thread_create(recv_apply_thread, thread_nos + t, NULL);
+	}
+
+	recv_apply_partition(0, n_threads);
+
 	/* Wait until all the pages have been processed */
 
-	while (recv_sys->n_addrs != 0) {
+	while (recv_sys->n_addrs != 0
+	       || recv_sys->n_apply_threads_active != 0) {
+
+		if (has_printed) {
+			ulint	percent = (n_pages - recv_sys->n_addrs)
+				* 100 / n_pages;
+
+			if (percent != last_percent) {
+				fprintf(stderr, "%lu ", (ulong) percent);
+				last_percent = percent;
+			}
+		}
 
 		mutex_exit(&(recv_sys->mutex));
 
-		os_thread_sleep(500000);
+		os_thread_sleep(100000);
 
 		mutex_enter(&(recv_sys->mutex));
 	}
 
+	UT_DELETE_ARRAY(thread_nos);
+
 	if (has_printed) {
 
 		fprintf(stderr, "\n");
@@ -2791,7 +2889,14 @@ loop:
 	recv_sys_empty_hash();
 
 	if (has_printed) {
-		ib::info() << "Apply batch completed";
+		const ib_time_monotonic_ms_t	elapsed_ms
+			= ut_time_monotonic_ms() - start_time;
+
+		ib::info() << "Apply batch completed: " << n_pages
+			<< " pages in " << elapsed_ms / 1000 << "."
+			<< (elapsed_ms % 1000) / 100 << " seconds ("
+			<< n_pages * 1000 / (elapsed_ms + 1)
+			<< " pages/s)";
 	}
 
 	mutex_exit(&(recv_sys->mutex));
@@ -4283,6 +4388,8 @@ recv_recovery_from_checkpoint_start(
 	log_sys->buf_next_to_write = log_sys->buf_free;
 	log_sys->write_lsn = log_sys->lsn;
 
+	log_recent_written_reset();
+
 	log_sys->last_checkpoint_lsn = checkpoint_lsn;
 
 	if (!srv_read_only_mode) {
@@ -4346,6 +4453,9 @@ recv_recovery_from_checkpoint_finish(void)
 
 	recv_sys_debug_free();
 
+	/* The doublewrite copies are not needed after recovery. */
+	buf_dblwr_free_recovered_pages();
+
 	/* Free up the flush_rbt. */
 	buf_flush_free_flush_rbt();
 
@@ -4460,6 +4570,8 @@ recv_reset_logs(
 	log_sys->buf_free = LOG_BLOCK_HDR_SIZE;
 	log_sys->lsn += LOG_BLOCK_HDR_SIZE;
 
+	log_recent_written_reset();
+
 	MONITOR_SET(MONITOR_LSN_CHECKPOINT_AGE,
 		    (log_sys->lsn - log_sys->last_checkpoint_lsn));
 
@@ -314,7 +314,8 @@ public:
 	@param[in,out]	mtr	mini-transaction */
 	explicit Command(mtr_t* mtr)
 		:
-		m_locks_released()
+		m_locks_released(),
+		m_log_ptr()
 	{
 		init(mtr);
 	}
@@ -344,10 +345,14 @@ public:
 	/** Release the resources */
 	void release_resources();
 
-	/** Append the redo log records to the redo log buffer.
+	/** Reserve space for the redo log records in the redo log buffer.
 	@param[in]	len	number of bytes to write */
 	void finish_write(ulint len);
 
+	/** Copy the redo log records to the space reserved by
+	finish_write(). This does not need the log mutex. */
+	void copy_log();
+
 private:
 	/** Prepare to write the mini-transaction log to the redo log buffer.
 	@return number of bytes to write in finish_write() */
@@ -368,6 +373,9 @@ private:
 
 	/** End lsn of the possible log entry for this mtr */
 	lsn_t			m_end_lsn;
+
+	/** Where to copy the log entry in the log buffer, or NULL */
+	byte*			m_log_ptr;
 };
 
 /** Check if a mini-transaction is dirtying a clean page.
@@ -395,6 +403,24 @@ struct mtr_write_log_t {
 	}
 };
 
+/** Copy the block contents to space reserved in the REDO log buffer */
+struct mtr_copy_log_t {
+	/** Constructor.
+	@param[in,out]	ptr	where to copy in the log buffer */
+	explicit mtr_copy_log_t(byte** ptr) : m_ptr(ptr) {}
+
+	/** Copy a block to the reserved space.
+	@return whether the copying should continue */
+	bool operator()(const mtr_buf_t::block_t* block) const
+	{
+		*m_ptr = log_buffer_write(*m_ptr, block->begin(), block->used());
+		return(true);
+	}
+
+	/** Current position in the log buffer */
+	byte**	m_ptr;
+};
+
 /** Append records to the system-wide redo log buffer.
 @param[in]	log	redo log records */
 void
@@ -408,9 +434,9 @@ mtr_write_log(
 		   (ULINTPF " extra bytes written at " LSN_PF,
 		    len, log_sys->lsn));
 
-	log_reserve_and_open(len);
+	const lsn_t	start_lsn = log_reserve_and_open(len);
 	log->for_each_block(write_log);
-	log_close();
+	log_buffer_write_completed(start_lsn, log_close());
 }
 
 /** Start a mini-transaction.
@@ -549,6 +575,7 @@ mtr_t::commit_checkpoint(
 
 	Command	cmd(this);
 	cmd.finish_write(m_impl.m_log.size());
+	cmd.copy_log();
 	cmd.release_resources();
 
 	if (write_mlog_checkpoint) {
@@ -800,7 +827,7 @@ mtr_t::Command::prepare_write()
 	return(len);
 }
 
-/** Append the redo log records to the redo log buffer
+/** Reserve space for the redo log records in the redo log buffer
 @param[in] len	number of bytes to write */
 void
 mtr_t::Command::finish_write(
@@ -815,23 +842,37 @@ mtr_t::Command::finish_write(
 		const mtr_buf_t::block_t*	front = m_impl->m_log.front();
 		ut_ad(len <= front->used());
 
-		m_end_lsn = log_reserve_and_write_fast(
-			front->begin(), len, &m_start_lsn);
+		m_end_lsn = log_reserve_fast(
+			front->begin(), len, &m_start_lsn, &m_log_ptr);
 
 		if (m_end_lsn > 0) {
 			return;
 		}
 	}
 
-	/* Open the database log for log_write_low */
+	/* Open the database log for log_reserve_low */
 	m_start_lsn = log_reserve_and_open(len);
 
-	mtr_write_log_t	write_log;
-	m_impl->m_log.for_each_block(write_log);
+	m_log_ptr = log_reserve_low(len);
 
 	m_end_lsn = log_close();
 }
 
+/** Copy the redo log records to the space reserved by finish_write() */
+void
+mtr_t::Command::copy_log()
+{
+	ut_ad(m_impl->m_log_mode == MTR_LOG_ALL);
+	ut_ad(m_log_ptr != NULL);
+
+	mtr_copy_log_t	copy_log(&m_log_ptr);
+	m_impl->m_log.for_each_block(copy_log);
+
+	log_buffer_write_completed(m_start_lsn, m_end_lsn);
+
+	m_log_ptr = NULL;
+}
+
 /** Release the latches and blocks acquired by this mini-transaction */
 void
 mtr_t::Command::release_all()
@@ -862,7 +903,9 @@ mtr_t::Command::execute()
 {
 	ut_ad(m_impl->m_log_mode != MTR_LOG_NONE);
 
-	if (const ulint len = prepare_write()) {
+	const ulint	len = prepare_write();
+
+	if (len > 0) {
 		finish_write(len);
 	}
 
@@ -883,6 +926,14 @@ mtr_t::Command::execute()
 		log_flush_order_mutex_exit();
 	}
 
+	/* The log records are copied only now, outside of the log
+	mutex and the flush order mutex, so that mini-transactions
+	commit in parallel. The log buffer will not be written past
+	m_start_lsn before this is completed. */
+	if (len > 0) {
+		copy_log();
+	}
+
 	release_all();
 
 	release_resources();
@@ -66,6 +66,7 @@ Created 10/21/1995 Heikki Tuuri
 # endif /* _WIN32 */
 #endif /* !UNIV_HOTBACKUP */
 
+#include <algorithm>
 #include <vector>
 #include <functional>
 
@@ -73,6 +74,14 @@ Created 10/21/1995 Heikki Tuuri
 #include <libaio.h>
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif /* LINUX_IO_URING */
+
 #ifdef HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE
 # include <fcntl.h>
 # include <linux/falloc.h>
@@ -205,6 +214,19 @@ If an AIO request is made the calling thread not only queues it in the
 array but also submits the requests. The helper thread then collects
 the completed IO request and calls completion routine on it.
 
+Linux io_uring:
+===============
+
+If the kernel headers define io_uring and innodb_use_io_uring is set
+together with innodb_use_native_aio, each segment of the arrays gets an
+io_uring instance instead of a libaio io_context. The slots and the
+helper threads are the same as in Linux native AIO. Requests that are
+posted in batches (IORequest::DO_NOT_WAKE) are only queued to the
+submission ring, and os_aio_simulated_wake_handler_threads() submits
+them with one system call. The buffer pool chunks are registered with
+the rings, so that page reads and writes do not have to map the user
+pages for every request.
+
 **********************************************************************/
 
 
@@ -275,9 +297,17 @@ struct Slot {
 	/** length of the block to read or write */
 	DWORD			len;
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+# ifdef LINUX_NATIVE_AIO
 	/** Linux control block for aio */
 	struct iocb		control;
+# endif /* LINUX_NATIVE_AIO */
+
+# ifdef LINUX_IO_URING
+	/** io_uring buffer descriptor, unless a registered buffer
+	is used */
+	struct iovec		iov;
+# endif /* LINUX_IO_URING */
 
 	/** AIO return code */
 	int			ret;
@@ -305,6 +335,131 @@ struct Slot {
 	bool			skip_punch_hole;
 };
 
+#ifdef LINUX_IO_URING
+/** An io_uring instance: a submission and a completion ring shared
+with the kernel. The submission ring is filled by the threads that
+hold the mutex of the owning AIO array, and the completion ring is
+consumed by the only i/o handler thread of the segment. */
+class IoUring {
+public:
+	IoUring()
+	{
+		memset(this, 0x0, sizeof(*this));
+		m_fd = -1;
+	}
+
+	~IoUring()
+	{
+		close();
+	}
+
+	/** Create the rings.
+	@param[in]	entries	number of submission queue entries
+	@return 0 or errno */
+	int create(ulint entries);
+
+	/** Destroy the rings. */
+	void close();
+
+	/** @return an empty submission queue entry, or NULL if the
+	submission ring is full */
+	io_uring_sqe* get_sqe();
+
+	/** Pass the queued submission entries to the kernel.
+	@return 0 or errno */
+	int submit();
+
+	/** Wait for at least one completion. */
+	void wait();
+
+	/** @return the oldest completion entry, or NULL if none */
+	io_uring_cqe* peek_cqe()
+	{
+		unsigned	head = *m_cq_head;
+
+		if (head == __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE)) {
+			return(NULL);
+		}
+
+		return(&m_cqes[head & *m_cq_mask]);
+	}
+
+	/** Release the entry returned by peek_cqe() to the kernel. */
+	void cqe_seen()
+	{
+		__atomic_store_n(m_cq_head, *m_cq_head + 1, __ATOMIC_RELEASE);
+	}
+
+	/** Register buffers for IORING_OP_READ_FIXED and
+	IORING_OP_WRITE_FIXED, replacing any earlier registration.
+	@param[in]	iov	buffers
+	@param[in]	n	number of buffers, or 0 to unregister
+	@return 0 or errno */
+	int register_buffers(const iovec* iov, ulint n);
+
+private:
+	/** Enter the kernel.
+	@return number of consumed submissions, or -1 and errno */
+	int enter(unsigned to_submit, unsigned min_complete, unsigned flags)
+	{
+		return(static_cast<int>(syscall(
+			__NR_io_uring_enter, m_fd, to_submit,
+			min_complete, flags, NULL, 0)));
+	}
+
+	/** The ring file descriptor */
+	int		m_fd;
+
+	/** Number of submission queue entries */
+	unsigned	m_sq_entries;
+
+	/** Submission ring head, advanced by the kernel */
+	unsigned*	m_sq_head;
+
+	/** Submission ring tail */
+	unsigned*	m_sq_tail;
+
+	/** Submission ring index mask */
+	unsigned*	m_sq_mask;
+
+	/** Tail of the queued, not yet published entries */
+	unsigned	m_sqe_tail;
+
+	/** Submission queue entries */
+	io_uring_sqe*	m_sqes;
+
+	/** Completion ring head */
+	unsigned*	m_cq_head;
+
+	/** Completion ring tail, advanced by the kernel */
+	unsigned*	m_cq_tail;
+
+	/** Completion ring index mask */
+	unsigned*	m_cq_mask;
+
+	/** Completion queue entries */
+	io_uring_cqe*	m_cqes;
+
+	/** Mapping of the submission ring */
+	void*		m_sq_ptr;
+
+	/** Size of m_sq_ptr */
+	size_t		m_sq_size;
+
+	/** Mapping of the completion ring, or m_sq_ptr */
+	void*		m_cq_ptr;
+
+	/** Size of m_cq_ptr */
+	size_t		m_cq_size;
+
+	/** Size of the m_sqes mapping */
+	size_t		m_sqes_size;
+
+	/** true if buffers are registered */
+	bool		m_has_buffers;
+};
+#endif /* LINUX_IO_URING */
+
 /** The asynchronous i/o array structure */
 class AIO {
 public:
@@ -421,13 +576,77 @@ public:
 	@param[in, out]	file	File to write to */
 	void to_file(FILE* file) const;
 
-#ifdef LINUX_NATIVE_AIO
+#if defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 	/** Dispatch an AIO request to the kernel.
 	@param[in,out]	slot	an already reserved slot
+	@param[in]	submit	false to only queue an io_uring request
+				until os_aio_simulated_wake_handler_threads()
 	@return true on success. */
-	bool linux_dispatch(Slot* slot)
+	bool linux_dispatch(Slot* slot, bool submit)
+		MY_ATTRIBUTE((warn_unused_result));
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING */
+
+#ifdef LINUX_IO_URING
+	/** Queue a request to the io_uring of a segment. The caller
+	must own the mutex.
+	@param[in,out]	slot	an already reserved slot
+	@param[in]	segment	local segment of the slot
+	@param[in]	submit	true to also submit the queued requests
+	@return true on success */
+	bool uring_queue(Slot* slot, ulint segment, bool submit)
 		MY_ATTRIBUTE((warn_unused_result));
 
+	/** Accessor for the io_uring of a segment
+	@param[in]	segment	local segment
+	@return the io_uring of the segment */
+	IoUring* uring(ulint segment)
+		MY_ATTRIBUTE((warn_unused_result))
+	{
+		ut_ad(segment < get_n_segments());
+
+		return(&m_rings[segment]);
+	}
+
+	/** Submit the queued io_uring requests of all the segments. */
+	void uring_submit();
+
+	/** Post a no-op to the io_uring of each segment, to wake up
+	the i/o handler threads. */
+	void uring_wake();
+
+	/** Register buffers with the io_uring of each segment.
+	@param[in]	bufs	buffers, or empty to unregister */
+	void uring_register_buffers(const os_aio_buffers_t& bufs);
+
+	/** Register buffers with the io_uring instances of the arrays
+	for normal page reads and writes. Each registration pins the
+	buffers and is charged to RLIMIT_MEMLOCK separately, so the
+	change buffer array, which is rarely used, is left out, and
+	nothing is registered if the limit does not allow all of them.
+	@param[in]	bufs	buffers, or empty to unregister */
+	static void uring_register_page_buffers(const os_aio_buffers_t& bufs);
+
+	/** Apply a function to each AIO array that has io_uring instances.
+	@param[in]	f	function to apply */
+	template <typename F>
+	static void for_each_uring_array(F f)
+	{
+		AIO*	arrays[] = { s_ibuf, s_log, s_reads, s_writes };
+
+		for (ulint i = 0; i < UT_ARR_SIZE(arrays); ++i) {
+			if (arrays[i] != NULL) {
+				f(arrays[i]);
+			}
+		}
+	}
+
+	/** Check if the kernel supports io_uring.
+	@return true if supported */
+	static bool is_io_uring_supported()
+		MY_ATTRIBUTE((warn_unused_result));
+#endif /* LINUX_IO_URING */
+
+#ifdef LINUX_NATIVE_AIO
 	/** Accessor for an AIO event
 	@param[in]	index	Index into the array
 	@return the event at the index */
@@ -659,6 +878,20 @@ private:
 		MY_ATTRIBUTE((warn_unused_result));
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+	/** Initialise the io_uring instances
+	@return DB_SUCCESS or error code */
+	dberr_t init_io_uring()
+		MY_ATTRIBUTE((warn_unused_result));
+
+	/** Find the registered buffer that contains a request buffer.
+	@param[in]	ptr	request buffer
+	@param[in]	len	request length
+	@return index of the registered buffer, or ULINT_UNDEFINED */
+	ulint find_fixed_buffer(const byte* ptr, ulint len) const
+		MY_ATTRIBUTE((warn_unused_result));
+#endif /* LINUX_IO_URING */
+
 private:
 	typedef std::vector<Slot> Slots;
 
@@ -707,6 +940,16 @@ private:
 	IOEvents		m_events;
 #endif /* LINUX_NATIV_AIO */
 
+#ifdef LINUX_IO_URING
+	typedef std::vector<iovec> IOVecs;
+
+	/** One io_uring per segment, or NULL if io_uring is not used */
+	IoUring*		m_rings;
+
+	/** The buffers registered with m_rings, ordered by address */
+	IOVecs			m_fixed_bufs;
+#endif /* LINUX_IO_URING */
+
 	/** The aio arrays for non-ibuf i/o and ibuf i/o, as well as
 	sync AIO. These are NULL when the module has not yet been
 	initialized. */
@@ -1602,10 +1845,12 @@ AIO::release(Slot* slot)
 
 	ResetEvent(slot->handle);
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
 	if (srv_use_native_aio) {
+# ifdef LINUX_NATIVE_AIO
 		memset(&slot->control, 0x0, sizeof(slot->control));
+# endif /* LINUX_NATIVE_AIO */
 		slot->ret = 0;
 		slot->n_bytes = 0;
 	} else {
@@ -2247,9 +2492,9 @@ os_file_punch_hole_posix(
 	return(DB_IO_NO_PUNCH_HOLE);
 }
 
-#if defined(LINUX_NATIVE_AIO)
+#if defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
-/** Linux native AIO handler */
+/** Linux native AIO and io_uring handler */
 class LinuxAIOHandler {
 public:
 	/**
@@ -2321,6 +2566,17 @@ private:
 	each wakeup and that is why we use timed wait in io_getevents(). */
 	void collect();
 
+#ifdef LINUX_IO_URING
+	/** Collect completed requests from the io_uring of the segment.
+	The io-thread is woken up at shutdown by a no-op request. */
+	void uring_collect();
+#endif /* LINUX_IO_URING */
+
+	/** Mark a slot completed.
+	@param[in,out]	slot	completed request
+	@param[in]	res	number of bytes transferred, or -errno */
+	void complete(Slot* slot, long res);
+
 private:
 	/** Slot array */
 	AIO*			m_array;
@@ -2364,6 +2620,14 @@ LinuxAIOHandler::resubmit(Slot* slot)
 	/* make sure that slot->offset fits in off_t */
 	ut_ad(sizeof(off_t) >= sizeof(os_offset_t));
 
+#ifdef LINUX_IO_URING
+	if (srv_use_io_uring) {
+		return(m_array->uring_queue(slot, m_segment, true)
+		       ? DB_SUCCESS : DB_IO_PARTIAL_FAILED);
+	}
+#endif /* LINUX_IO_URING */
+
+#ifdef LINUX_NATIVE_AIO
 	struct iocb*	iocb = &slot->control;
 	if (slot->type.is_read()) {
 		io_prep_pread(
@@ -2395,6 +2659,10 @@ LinuxAIOHandler::resubmit(Slot* slot)
 	}
 
 	return(ret < 0 ? DB_IO_PARTIAL_FAILED : DB_SUCCESS);
+#else
+	ut_error;
+	return(DB_IO_PARTIAL_FAILED);
+#endif /* LINUX_NATIVE_AIO */
 }
 
 /** Check if the AIO succeeded
@@ -2491,6 +2759,14 @@ LinuxAIOHandler::collect()
 	ut_ad(m_array != NULL);
 	ut_ad(m_segment < m_array->get_n_segments());
 
+#ifdef LINUX_IO_URING
+	if (srv_use_io_uring) {
+		uring_collect();
+		return;
+	}
+#endif /* LINUX_IO_URING */
+
+#ifdef LINUX_NATIVE_AIO
 	/* Which io_context we are going to use. */
 	io_context*	io_ctx = m_array->io_ctx(m_segment);
 
@@ -2539,44 +2815,15 @@ LinuxAIOHandler::collect()
 			/* We have not overstepped to next segment. */
 			ut_a(slot->pos < end_pos);
 
-			/* We never compress/decompress the first page */
-
-			if (slot->offset > 0
-			    && !slot->skip_punch_hole
-			    && slot->type.is_compression_enabled()
-			    && !slot->type.is_log()
-			    && slot->type.is_write()
-			    && slot->type.is_compressed()
-			    && slot->type.punch_hole()) {
-
-				slot->err = AIOHandler::io_complete(slot);
-			} else {
-				slot->err = DB_SUCCESS;
-			}
-
-			/* Mark this request as completed. The error handling
-			will be done in the calling function. */
-			m_array->acquire();
-
 			/* events[i].res2 should always be ZERO */
 			ut_ad(events[i].res2 == 0);
-			slot->io_already_done = true;
 
 			/*Even though events[i].res is an unsigned number
 			in libaio, it is used to return a negative value
 			(negated errno value) to indicate error and a positive
 			value to indicate number of bytes read or written. */
 
-			if (events[i].res > slot->len) {
-				/* failure */
-				slot->n_bytes = 0;
-				slot->ret = events[i].res;
-			} else {
-				/* success */
-				slot->n_bytes = events[i].res;
-				slot->ret = 0;
-			}
-			m_array->release();
+			complete(slot, static_cast<long>(events[i].res));
 		}
 
 		if (srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS
@@ -2614,8 +2861,99 @@ LinuxAIOHandler::collect()
 
 		break;
 	}
+#endif /* LINUX_NATIVE_AIO */
 }
 
+/** Mark a slot completed.
+@param[in,out]	slot	completed request
+@param[in]	res	number of bytes transferred, or -errno */
+void
+LinuxAIOHandler::complete(Slot* slot, long res)
+{
+	/* We never compress/decompress the first page */
+
+	if (slot->offset > 0
+	    && !slot->skip_punch_hole
+	    && slot->type.is_compression_enabled()
+	    && !slot->type.is_log()
+	    && slot->type.is_write()
+	    && slot->type.is_compressed()
+	    && slot->type.punch_hole()) {
+
+		slot->err = AIOHandler::io_complete(slot);
+	} else {
+		slot->err = DB_SUCCESS;
+	}
+
+	/* Mark this request as completed. The error handling
+	will be done in the calling function. */
+	m_array->acquire();
+
+	slot->io_already_done = true;
+
+	if (res < 0 || static_cast<ulint>(res) > slot->len) {
+		/* failure */
+		slot->n_bytes = 0;
+		slot->ret = static_cast<int>(res);
+	} else {
+		/* success */
+		slot->n_bytes = res;
+		slot->ret = 0;
+	}
+
+	m_array->release();
+}
+
+#ifdef LINUX_IO_URING
+/** Collect completed requests from the io_uring of the segment.
+The io-thread is woken up at shutdown by a no-op request. */
+void
+LinuxAIOHandler::uring_collect()
+{
+	IoUring*	ring = m_array->uring(m_segment);
+
+	/* Starting point of the m_segment we will be working on. */
+	ulint	start_pos = m_segment * m_n_slots;
+
+	/* End point. */
+	ulint	end_pos = start_pos + m_n_slots;
+
+	for (;;) {
+		ulint		n_completed = 0;
+		bool		woken = false;
+		io_uring_cqe*	cqe;
+
+		while ((cqe = ring->peek_cqe()) != NULL) {
+
+			Slot*	slot = reinterpret_cast<Slot*>(cqe->user_data);
+			long	res = cqe->res;
+
+			ring->cqe_seen();
+
+			if (slot == NULL) {
+				/* A no-op from AIO::uring_wake() */
+				woken = true;
+				continue;
+			}
+
+			ut_a(slot->is_reserved);
+			ut_a(slot->pos >= start_pos);
+			ut_a(slot->pos < end_pos);
+
+			complete(slot, res);
+
+			++n_completed;
+		}
+
+		if (n_completed > 0 || woken) {
+			break;
+		}
+
+		ring->wait();
+	}
+}
+#endif /* LINUX_IO_URING */
+
 /** Process a Linux AIO request
 @param[out]	m1		the messages passed with the
 @param[out]	m2		AIO request; note that in case the
@@ -2746,9 +3084,11 @@ os_aio_linux_handler(
 
 /** Dispatch an AIO request to the kernel.
 @param[in,out]	slot		an already reserved slot
+@param[in]	submit		false to only queue an io_uring request
+				until os_aio_simulated_wake_handler_threads()
 @return true on success. */
 bool
-AIO::linux_dispatch(Slot* slot)
+AIO::linux_dispatch(Slot* slot, bool submit)
 {
 	ut_a(slot->is_reserved);
 	ut_ad(slot->type.validate());
@@ -2758,10 +3098,24 @@ AIO::linux_dispatch(Slot* slot)
 	The io_context is one per segment. */
 
 	ulint		io_ctx_index;
-	struct iocb*	iocb = &slot->control;
 
 	io_ctx_index = (slot->pos * m_n_segments) / m_slots.size();
 
+#ifdef LINUX_IO_URING
+	if (srv_use_io_uring) {
+		acquire();
+
+		bool	success = uring_queue(slot, io_ctx_index, submit);
+
+		release();
+
+		return(success);
+	}
+#endif /* LINUX_IO_URING */
+
+#ifdef LINUX_NATIVE_AIO
+	struct iocb*	iocb = &slot->control;
+
 	int	ret = io_submit(m_aio_ctx[io_ctx_index], 1, &iocb);
 
 	/* io_submit() returns number of successfully queued requests
@@ -2772,8 +3126,13 @@ AIO::linux_dispatch(Slot* slot)
 	}
 
 	return(ret == 1);
+#else
+	ut_error;
+	return(false);
+#endif /* LINUX_NATIVE_AIO */
 }
 
+#ifdef LINUX_NATIVE_AIO
 /** Creates an io_context for native linux AIO.
 @param[in]	max_events	number of events
 @param[out]	io_ctx		io_ctx to initialize.
@@ -2978,9 +3337,544 @@ AIO::is_linux_native_aio_supported()
 
 	return(false);
 }
-
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+/** Create the rings.
+@param[in]	entries	number of submission queue entries
+@return 0 or errno */
+int
+IoUring::create(ulint entries)
+{
+	ut_ad(m_fd == -1);
+
+	io_uring_params	params;
+
+	memset(&params, 0x0, sizeof(params));
+
+	m_fd = static_cast<int>(syscall(
+		__NR_io_uring_setup, static_cast<unsigned>(entries),
+		&params));
+
+	if (m_fd < 0) {
+		int	err = errno;
+
+		m_fd = -1;
+
+		return(err);
+	}
+
+	m_sq_entries = params.sq_entries;
+
+	m_sq_size = params.sq_off.array
+		+ params.sq_entries * sizeof(unsigned);
+	m_cq_size = params.cq_off.cqes
+		+ params.cq_entries * sizeof(io_uring_cqe);
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		m_sq_size = m_cq_size = std::max(m_sq_size, m_cq_size);
+	}
+
+	m_sq_ptr = mmap(NULL, m_sq_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+
+	if (m_sq_ptr == MAP_FAILED) {
+		int	err = errno;
+
+		m_sq_ptr = NULL;
+		close();
+
+		return(err);
+	}
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		m_cq_ptr = m_sq_ptr;
+	} else {
+		m_cq_ptr = mmap(NULL, m_cq_size, PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_POPULATE, m_fd,
+				IORING_OFF_CQ_RING);
+
+		if (m_cq_ptr == MAP_FAILED) {
+			int	err = errno;
+
+			m_cq_ptr = NULL;
+			close();
+
+			return(err);
+		}
+	}
+
+	m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+	void*	sqes = mmap(NULL, m_sqes_size, PROT_READ | PROT_WRITE,
+			    MAP_SHARED | MAP_POPULATE, m_fd,
+			    IORING_OFF_SQES);
+
+	if (sqes == MAP_FAILED) {
+		int	err = errno;
+
+		close();
+
+		return(err);
+	}
+
+	m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+	byte*	sq = static_cast<byte*>(m_sq_ptr);
+	byte*	cq = static_cast<byte*>(m_cq_ptr);
+
+	m_sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+	m_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+	m_sq_mask = reinterpret_cast<unsigned*>(
+		sq + params.sq_off.ring_mask);
+
+	m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+	m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+	m_cq_mask = reinterpret_cast<unsigned*>(
+		cq + params.cq_off.ring_mask);
+	m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+	/* The submission queue entries are used in ring order. */
+	unsigned*	array = reinterpret_cast<unsigned*>(
+		sq + params.sq_off.array);
+
+	for (unsigned i = 0; i < m_sq_entries; ++i) {
+		array[i] = i;
+	}
+
+	m_sqe_tail = *m_sq_tail;
+
+	return(0);
+}
+
+/** Destroy the rings. */
+void
+IoUring::close()
+{
+	if (m_sqes != NULL) {
+		munmap(m_sqes, m_sqes_size);
+	}
+
+	if (m_cq_ptr != NULL && m_cq_ptr != m_sq_ptr) {
+		munmap(m_cq_ptr, m_cq_size);
+	}
+
+	if (m_sq_ptr != NULL) {
+		munmap(m_sq_ptr, m_sq_size);
+	}
+
+	if (m_fd != -1) {
+		::close(m_fd);
+	}
+
+	memset(this, 0x0, sizeof(*this));
+	m_fd = -1;
+}
+
+/** @return an empty submission queue entry, or NULL if the submission
+ring is full */
+io_uring_sqe*
+IoUring::get_sqe()
+{
+	unsigned	head = __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+
+	if (m_sqe_tail - head >= m_sq_entries) {
+		return(NULL);
+	}
+
+	io_uring_sqe*	sqe = &m_sqes[m_sqe_tail & *m_sq_mask];
+
+	++m_sqe_tail;
+
+	memset(sqe, 0x0, sizeof(*sqe));
+
+	return(sqe);
+}
+
+/** Pass the queued submission entries to the kernel.
+@return 0 or errno */
+int
+IoUring::submit()
+{
+	__atomic_store_n(m_sq_tail, m_sqe_tail, __ATOMIC_RELEASE);
+
+	for (;;) {
+		unsigned	n = m_sqe_tail
+			- __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+
+		if (n == 0) {
+			return(0);
+		}
+
+		int	ret = enter(n, 0, 0);
+
+		if (ret > 0) {
+			continue;
+		}
+
+		if (ret == 0) {
+			/* The kernel consumed no entry and reported no
+			error, so errno is stale. Let the i/o handler
+			threads reap completions before retrying. */
+			os_thread_sleep(100);
+			continue;
+		}
+
+		switch (errno) {
+		case EINTR:
+			continue;
+		case EAGAIN:
+		case EBUSY:
+			/* Out of kernel resources, or too many
+			completions are pending. */
+			os_thread_sleep(100);
+			continue;
+		}
+
+		return(errno);
+	}
+}
+
+/** Wait for at least one completion. */
+void
+IoUring::wait()
+{
+	if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+		ib::fatal()
+			<< "io_uring_enter() failed to wait for"
+			" completions, errno " << errno;
+	}
+}
+
+/** Register buffers for IORING_OP_READ_FIXED and IORING_OP_WRITE_FIXED,
+replacing any earlier registration.
+@param[in]	iov	buffers
+@param[in]	n	number of buffers, or 0 to unregister
+@return 0 or errno */
+int
+IoUring::register_buffers(const iovec* iov, ulint n)
+{
+	if (m_has_buffers) {
+		syscall(__NR_io_uring_register, m_fd,
+			IORING_UNREGISTER_BUFFERS, NULL, 0);
+
+		m_has_buffers = false;
+	}
+
+	if (n == 0) {
+		return(0);
+	}
+
+	if (syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS,
+		    iov, static_cast<unsigned>(n)) < 0) {
+		return(errno);
+	}
+
+	m_has_buffers = true;
+
+	return(0);
+}
+
+/** Queue a request to the io_uring of a segment. The caller must own
+the mutex.
+@param[in,out]	slot	an already reserved slot
+@param[in]	segment	local segment of the slot
+@param[in]	submit	true to also submit the queued requests
+@return true on success */
+bool
+AIO::uring_queue(Slot* slot, ulint segment, bool submit)
+{
+	ut_ad(is_mutex_owned());
+
+	IoUring*	ring = uring(segment);
+	io_uring_sqe*	sqe;
+
+	while ((sqe = ring->get_sqe()) == NULL) {
+		/* The kernel has not consumed the earlier entries. */
+		int	err = ring->submit();
+
+		if (err != 0) {
+			errno = err;
+			return(false);
+		}
+	}
+
+	ulint	buf_index = find_fixed_buffer(slot->ptr, slot->len);
+
+	sqe->fd = slot->file.m_file;
+	sqe->off = slot->offset;
+	sqe->user_data = reinterpret_cast<uintptr_t>(slot);
+
+	if (buf_index != ULINT_UNDEFINED) {
+		sqe->opcode = slot->type.is_read()
+			? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+		sqe->addr = reinterpret_cast<uintptr_t>(slot->ptr);
+		sqe->len = static_cast<unsigned>(slot->len);
+		sqe->buf_index = static_cast<uint16_t>(buf_index);
+	} else {
+		slot->iov.iov_base = slot->ptr;
+		slot->iov.iov_len = slot->len;
+
+		sqe->opcode = slot->type.is_read()
+			? IORING_OP_READV : IORING_OP_WRITEV;
+		sqe->addr = reinterpret_cast<uintptr_t>(&slot->iov);
+		sqe->len = 1;
+	}
+
+	ut_ad(slot->type.is_read() || slot->type.is_write());
+
+	if (!submit) {
+		return(true);
+	}
+
+	int	err = ring->submit();
+
+	if (err != 0) {
+		errno = err;
+		return(false);
+	}
+
+	return(true);
+}
+
+/** Submit the queued io_uring requests of all the segments. */
+void
+AIO::uring_submit()
+{
+	acquire();
+
+	for (ulint i = 0; i < m_n_segments; ++i) {
+		int	err = m_rings[i].submit();
+
+		if (err != 0) {
+			ib::fatal()
+				<< "io_uring_enter() failed to submit"
+				" requests, errno " << err;
+		}
+	}
+
+	release();
+}
+
+/** Post a no-op to the io_uring of each segment, to wake up the i/o
+handler threads. */
+void
+AIO::uring_wake()
+{
+	acquire();
+
+	for (ulint i = 0; i < m_n_segments; ++i) {
+		io_uring_sqe*	sqe = m_rings[i].get_sqe();
+
+		if (sqe != NULL) {
+			sqe->opcode = IORING_OP_NOP;
+			sqe->user_data = 0;
+		}
+
+		m_rings[i].submit();
+	}
+
+	release();
+}
+
+/** Find the registered buffer that contains a request buffer.
+@param[in]	ptr	request buffer
+@param[in]	len	request length
+@return index of the registered buffer, or ULINT_UNDEFINED */
+ulint
+AIO::find_fixed_buffer(const byte* ptr, ulint len) const
+{
+	ut_ad(is_mutex_owned());
+
+	/* Find the last buffer that starts at or before ptr. */
+	ulint	low = 0;
+	ulint	high = m_fixed_bufs.size();
+
+	while (low < high) {
+		ulint	mid = (low + high) / 2;
+
+		if (static_cast<const byte*>(m_fixed_bufs[mid].iov_base)
+		    <= ptr) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	if (low == 0) {
+		return(ULINT_UNDEFINED);
+	}
+
+	const iovec&	iov = m_fixed_bufs[low - 1];
+	const byte*	start = static_cast<const byte*>(iov.iov_base);
+
+	return(ptr + len <= start + iov.iov_len ? low - 1 : ULINT_UNDEFINED);
+}
+
+/** Order buffers by their start address.
+@param[in]	a	buffer
+@param[in]	b	buffer
+@return true if a starts before b */
+static
+bool
+iovec_less(const iovec& a, const iovec& b)
+{
+	return(a.iov_base < b.iov_base);
+}
+
+/** Register buffers with the io_uring of each segment.
+@param[in]	bufs	buffers, or empty to unregister */
+void
+AIO::uring_register_buffers(const os_aio_buffers_t& bufs)
+{
+	/* A registered buffer may not exceed 1 GiB. */
+	static const ulint	MAX_LEN = 1 << 30;
+
+	IOVecs	iovs;
+
+	for (os_aio_buffers_t::const_iterator it = bufs.begin();
+	     it != bufs.end();
+	     ++it) {
+
+		for (ulint off = 0; off < it->second; off += MAX_LEN) {
+			iovec	iov;
+
+			iov.iov_base = it->first + off;
+			iov.iov_len = std::min(MAX_LEN, it->second - off);
+
+			iovs.push_back(iov);
+		}
+	}
+
+	std::sort(iovs.begin(), iovs.end(), iovec_less);
+
+	acquire();
+
+	/* Queued requests may refer to the old buffer indexes. */
+	for (ulint i = 0; i < m_n_segments; ++i) {
+		m_rings[i].submit();
+	}
+
+	m_fixed_bufs.clear();
+
+	int	err = 0;
+
+	for (ulint i = 0; i < m_n_segments && err == 0; ++i) {
+		err = m_rings[i].register_buffers(
+			iovs.empty() ? NULL : &iovs[0], iovs.size());
+	}
+
+	if (err == 0) {
+		m_fixed_bufs.swap(iovs);
+	} else {
+		for (ulint i = 0; i < m_n_segments; ++i) {
+			m_rings[i].register_buffers(NULL, 0);
+		}
+	}
+
+	release();
+
+	if (err != 0) {
+		ib::warn()
+			<< "Failed to register the buffer pool with"
+			" io_uring, errno " << err << ". Page I/O will not"
+			" use registered buffers.";
+	}
+}
+
+/** Register buffers with the io_uring instances of the arrays for normal
+page reads and writes. Each registration pins the buffers and is charged
+to RLIMIT_MEMLOCK separately, so the change buffer array, which is rarely
+used, is left out, and nothing is registered if the limit does not allow
+all of them.
+@param[in]	bufs	buffers, or empty to unregister */
+void
+AIO::uring_register_page_buffers(const os_aio_buffers_t& bufs)
+{
+	AIO*		arrays[] = { s_reads, s_writes };
+	ulint		n_rings = 0;
+	ulonglong	size = 0;
+
+	for (ulint i = 0; i < UT_ARR_SIZE(arrays); ++i) {
+		if (arrays[i] != NULL) {
+			n_rings += arrays[i]->get_n_segments();
+		}
+	}
+
+	for (os_aio_buffers_t::const_iterator it = bufs.begin();
+	     it != bufs.end();
+	     ++it) {
+
+		size += it->second;
+	}
+
+	struct rlimit	limit;
+
+	if (size > 0
+	    && n_rings > 0
+	    && getrlimit(RLIMIT_MEMLOCK, &limit) == 0
+	    && limit.rlim_cur != RLIM_INFINITY
+	    && limit.rlim_cur / n_rings < size) {
+
+		ib::info()
+			<< "Not registering the buffer pool with io_uring:"
+			" the " << n_rings << " rings would lock "
+			<< n_rings * size << " bytes of memory, more than"
+			" RLIMIT_MEMLOCK " << limit.rlim_cur << " allows.";
+
+		os_aio_buffers_t	none;
+
+		uring_register_page_buffers(none);
+
+		return;
+	}
+
+	for (ulint i = 0; i < UT_ARR_SIZE(arrays); ++i) {
+		if (arrays[i] != NULL) {
+			arrays[i]->uring_register_buffers(bufs);
+		}
+	}
+}
+
+/** Check if the kernel supports io_uring.
+@return true if supported */
+bool
+AIO::is_io_uring_supported()
+{
+	IoUring	ring;
+	int	err = ring.create(1);
+
+	if (err == 0) {
+		io_uring_sqe*	sqe = ring.get_sqe();
+
+		sqe->opcode = IORING_OP_NOP;
+
+		err = ring.submit();
+
+		if (err == 0) {
+			ring.wait();
+
+			if (ring.peek_cqe() == NULL) {
+				err = EIO;
+			}
+		}
+	}
+
+	if (err != 0) {
+		ib::error()
+			<< "io_uring is not available, errno " << err
+			<< ". You can set innodb_use_io_uring to FALSE"
+			" to avoid this message.";
+
+		return(false);
+	}
+
+	return(true);
+}
+#endif /* LINUX_IO_URING */
+
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING */
+
 /** Retrieves the last error number if an error occurs in a file io function.
 The number should be retrieved before any other OS calls (because they may
 overwrite the error number). If the number is not known to this program,
@@ -6278,7 +7172,7 @@ os_aio_handler(
 
 		err = os_aio_windows_handler(segment, 0, m1, m2, request);
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
 		err = os_aio_linux_handler(segment, m1, m2, request);
 
@@ -6316,6 +7210,9 @@ AIO::AIO(
 # elif defined(_WIN32)
 	,m_handles()
 # endif /* LINUX_NATIVE_AIO */
+# ifdef LINUX_IO_URING
+	,m_rings()
+# endif /* LINUX_IO_URING */
 {
 	ut_a(n > 0);
 	ut_a(m_n_segments > 0);
@@ -6354,13 +7251,15 @@ AIO::init_slots()
 
 		(*m_handles)[i] = over->hEvent;
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
 		slot.ret = 0;
 
 		slot.n_bytes = 0;
 
+# ifdef LINUX_NATIVE_AIO
 		memset(&slot.control, 0x0, sizeof(slot.control));
+# endif /* LINUX_NATIVE_AIO */
 
 #endif /* WIN_ASYNC_IO */
 	}
@@ -6405,6 +7304,37 @@ AIO::init_linux_native_aio()
 }
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+/** Initialise the io_uring instances
+@return DB_SUCCESS or error code */
+dberr_t
+AIO::init_io_uring()
+{
+	ut_a(m_rings == NULL);
+
+	m_rings = UT_NEW_ARRAY_NOKEY(IoUring, m_n_segments);
+
+	if (m_rings == NULL) {
+		return(DB_OUT_OF_MEMORY);
+	}
+
+	for (ulint i = 0; i < m_n_segments; ++i) {
+
+		int	err = m_rings[i].create(slots_per_segment());
+
+		if (err != 0) {
+			ib::error()
+				<< "io_uring_setup() failed with errno "
+				<< err;
+
+			return(DB_IO_ERROR);
+		}
+	}
+
+	return(DB_SUCCESS);
+}
+#endif /* LINUX_IO_URING */
+
 /** Initialise the array */
 dberr_t
 AIO::init()
@@ -6418,6 +7348,18 @@ AIO::init()
 #endif /* _WIN32 */
 
 	if (srv_use_native_aio) {
+#ifdef LINUX_IO_URING
+		if (srv_use_io_uring) {
+			dberr_t	err = init_io_uring();
+
+			if (err != DB_SUCCESS) {
+				return(err);
+			}
+
+			return(init_slots());
+		}
+#endif /* LINUX_IO_URING */
+
 #ifdef LINUX_NATIVE_AIO
 		dberr_t	err = init_linux_native_aio();
 
@@ -6491,6 +7433,12 @@ AIO::~AIO()
 	}
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_IO_URING
+	if (m_rings != NULL) {
+		UT_DELETE_ARRAY(m_rings);
+	}
+#endif /* LINUX_IO_URING */
+
 	m_slots.clear();
 }
 
@@ -6513,9 +7461,23 @@ AIO::start(
 	ulint		n_writers,
 	ulint		n_slots_sync)
 {
+#if defined(LINUX_IO_URING)
+	if (srv_use_io_uring && !is_io_uring_supported()) {
+
+		ib::warn() << "Linux io_uring disabled.";
+
+		srv_use_io_uring = FALSE;
+
+# ifndef LINUX_NATIVE_AIO
+		srv_use_native_aio = FALSE;
+# endif /* !LINUX_NATIVE_AIO */
+	}
+#endif /* LINUX_IO_URING */
+
 #if defined(LINUX_NATIVE_AIO)
 	/* Check if native aio is supported on this system and tmpfs */
-	if (srv_use_native_aio && !is_linux_native_aio_supported()) {
+	if (srv_use_native_aio && !srv_use_io_uring
+	    && !is_linux_native_aio_supported()) {
 
 		ib::warn() << "Linux Native AIO disabled.";
 
@@ -6815,7 +7777,17 @@ os_aio_wake_all_threads_at_shutdown()
 
 	AIO::wake_at_shutdown();
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+
+# ifdef LINUX_IO_URING
+	/* The io helper threads wait for io_uring completions
+	without a timeout: post a no-op to each of them. */
+
+	if (srv_use_io_uring) {
+		AIO::for_each_uring_array(std::mem_fun(&AIO::uring_wake));
+		return;
+	}
+# endif /* LINUX_IO_URING */
 
 	/* When using native AIO interface the io helper threads
 	wait on io_getevents with a timeout value of 500ms. At
@@ -6940,9 +7912,10 @@ AIO::reserve_slot(
 
 		release();
 
-		if (!srv_use_native_aio) {
+		if (!srv_use_native_aio || srv_use_io_uring) {
 			/* If the handler threads are suspended,
-			wake them so that we get more slots */
+			wake them so that we get more slots. With
+			io_uring, submit the queued requests. */
 
 			os_aio_simulated_wake_handler_threads();
 		}
@@ -7079,11 +8052,12 @@ AIO::reserve_slot(
 
 		ResetEvent(slot->handle);
 	}
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 
 	/* If we are not using native AIO skip this part. */
 	if (srv_use_native_aio) {
 
+# ifdef LINUX_NATIVE_AIO
 		off_t		aio_offset;
 
 		/* Check if we are dealing with 64 bit arch.
@@ -7105,11 +8079,12 @@ AIO::reserve_slot(
 		}
 
 		iocb->data = slot;
+# endif /* LINUX_NATIVE_AIO */
 
 		slot->n_bytes = 0;
 		slot->ret = 0;
 	}
-#endif /* LINUX_NATIVE_AIO */
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING */
 
 	release();
 
@@ -7168,10 +8143,20 @@ AIO::wake_simulated_handler_thread(ulint global_segment, ulint segment)
 	release();
 }
 
-/** Wakes up simulated aio i/o-handler threads if they have something to do. */
+/** Wakes up simulated aio i/o-handler threads if they have something to do.
+With io_uring, submits the requests that were queued with
+IORequest::DO_NOT_WAKE. */
 void
 os_aio_simulated_wake_handler_threads()
 {
+#ifdef LINUX_IO_URING
+	if (srv_use_io_uring) {
+		AIO::for_each_uring_array(std::mem_fun(&AIO::uring_submit));
+
+		return;
+	}
+#endif /* LINUX_IO_URING */
+
 	if (srv_use_native_aio) {
 		/* We do not use simulated aio: do nothing */
 
@@ -7185,6 +8170,21 @@ os_aio_simulated_wake_handler_threads()
 	}
 }
 
+/** Register memory with the io_uring instances, so that asynchronous reads
+and writes of pages in it use registered buffers. Replaces any earlier
+registration. Does nothing if io_uring is not used.
+@param[in]	bufs	memory areas, or empty to unregister */
+void
+os_aio_register_buffers(
+	const os_aio_buffers_t&	bufs)
+{
+#ifdef LINUX_IO_URING
+	if (srv_use_io_uring) {
+		AIO::uring_register_page_buffers(bufs);
+	}
+#endif /* LINUX_IO_URING */
+}
+
 /** Select the IO slot array
 @param[in]	type		Type of IO, READ or WRITE
 @param[in]	read_only	true if running in read-only mode
@@ -7222,10 +8222,10 @@ AIO::select_slot_array(IORequest& type, bool read_only, ulint mode)
 	case OS_AIO_SYNC:
 
 		array = AIO::s_sync;
-#if defined(LINUX_NATIVE_AIO)
+#if defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
 		/* In Linux native AIO we don't use sync IO array. */
 		ut_a(!srv_use_native_aio);
-#endif /* LINUX_NATIVE_AIO */
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING */
 		break;
 
 	default:
@@ -7496,8 +8496,8 @@ try_again:
 			ret = ReadFile(
 				file.m_file, slot->ptr, slot->len,
 				&slot->n_bytes, &slot->control);
-#elif defined(LINUX_NATIVE_AIO)
-			if (!array->linux_dispatch(slot)) {
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+			if (!array->linux_dispatch(slot, type.is_wake())) {
 				goto err_exit;
 			}
 #endif /* WIN_ASYNC_IO */
@@ -7514,8 +8514,8 @@ try_again:
 			ret = WriteFile(
 				file.m_file, slot->ptr, slot->len,
 				&slot->n_bytes, &slot->control);
-#elif defined(LINUX_NATIVE_AIO)
-			if (!array->linux_dispatch(slot)) {
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+			if (!array->linux_dispatch(slot, type.is_wake())) {
 				goto err_exit;
 			}
 #endif /* WIN_ASYNC_IO */
@@ -7560,9 +8560,9 @@ try_again:
 	/* AIO request was queued successfully! */
 	return(DB_SUCCESS);
 
-#if defined LINUX_NATIVE_AIO || defined WIN_ASYNC_IO
+#if defined LINUX_NATIVE_AIO || defined LINUX_IO_URING || defined WIN_ASYNC_IO
 err_exit:
-#endif /* LINUX_NATIVE_AIO || WIN_ASYNC_IO */
+#endif /* LINUX_NATIVE_AIO || LINUX_IO_URING || WIN_ASYNC_IO */
 
 	array->release_with_mutex(slot);
 
@@ -131,7 +131,8 @@ page_cur_try_search_shortcut(
 	low_match = up_match = std::min(*ilow_matched_fields,
 					*iup_matched_fields);
 
-	if (cmp_dtuple_rec_with_match(tuple, rec, offsets, &low_match) < 0) {
+	if (cmp_dtuple_rec_with_match_index(tuple, rec, index, offsets,
+					    &low_match) < 0) {
 		goto exit_func;
 	}
 
@@ -140,8 +141,9 @@ page_cur_try_search_shortcut(
 		offsets = rec_get_offsets(next_rec, index, offsets,
 					  dtuple_get_n_fields(tuple), &heap);
 
-		if (cmp_dtuple_rec_with_match(tuple, next_rec, offsets,
-					      &up_match) >= 0) {
+		if (cmp_dtuple_rec_with_match_index(
+			    tuple, next_rec, index, offsets,
+			    &up_match) >= 0) {
 			goto exit_func;
 		}
 
@@ -542,8 +544,8 @@ page_cur_search_with_match(
 
 		}
 
-		cmp = cmp_dtuple_rec_with_match(
-			tuple, mid_rec, offsets, &cur_matched_fields);
+		cmp = cmp_dtuple_rec_with_match_index(
+			tuple, mid_rec, index, offsets, &cur_matched_fields);
 
 		if (cmp > 0) {
 low_slot_match:
@@ -604,8 +606,8 @@ up_slot_match:
 
 		}
 
-		cmp = cmp_dtuple_rec_with_match(
-			tuple, mid_rec, offsets, &cur_matched_fields);
+		cmp = cmp_dtuple_rec_with_match_index(
+			tuple, mid_rec, index, offsets, &cur_matched_fields);
 
 		if (cmp > 0) {
 low_rec_match:
@@ -1832,7 +1834,7 @@ page_cur_insert_rec_zip(
 	    || reorg_before_insert) {
 		/* The values can change dynamically. */
 		bool	log_compressed	= page_zip_log_pages;
-		ulint	level		= page_zip_level;
+		ulint	level		= page_zip_get_level();
 #ifdef UNIV_DEBUG
 		rec_t*	cursor_rec	= page_cur_get_rec(cursor);
 #endif /* UNIV_DEBUG */
@@ -469,7 +469,8 @@ page_create_zip(
 	if (truncate_t::s_fix_up_active) {
 		/* Compress the index page created when applying
 		TRUNCATE log during recovery */
-		if (!page_zip_compress(page_zip, page, index, page_zip_level,
+		if (!page_zip_compress(page_zip, page, index,
+				       page_zip_get_level(),
 				       page_comp_info, NULL)) {
 			/* The compression of a newly created
 			page should always succeed. */
@@ -477,7 +478,7 @@ page_create_zip(
 		}
 
 	} else if (!page_zip_compress(page_zip, page, index,
-				      page_zip_level, NULL, mtr)) {
+				      page_zip_get_level(), NULL, mtr)) {
 		/* The compression of a newly created
 		page should always succeed. */
 		ut_error;
@@ -693,7 +694,7 @@ page_copy_rec_list_end(
 		if (!page_zip_compress(new_page_zip,
 				       new_page,
 				       index,
-				       page_zip_level,
+				       page_zip_get_level(),
 				       NULL, mtr)) {
 			/* Before trying to reorganize the page,
 			store the number of preceding records on the page. */
@@ -853,7 +854,7 @@ page_copy_rec_list_start(
 				goto zip_reorganize;);
 
 		if (!page_zip_compress(new_page_zip, new_page, index,
-				       page_zip_level, NULL, mtr)) {
+				       page_zip_get_level(), NULL, mtr)) {
 			ulint	ret_pos;
 #ifndef NDEBUG
 zip_reorganize:
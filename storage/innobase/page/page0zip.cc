@@ -57,6 +57,7 @@ const byte field_ref_zero[FIELD_REF_SIZE] = {
 #include "log0recv.h"
 #include "row0trunc.h"
 #include "zlib.h"
+#include <lz4.h>
 #ifndef UNIV_HOTBACKUP
 # include "buf0buf.h"
 # include "buf0lru.h"
@@ -85,6 +86,19 @@ page_zip_stat_per_index_t	page_zip_stat_per_index;
 /* Compression level to be used by zlib. Settable by user. */
 uint	page_zip_level = DEFAULT_COMPRESSION_LEVEL;
 
+/* Codec to be used for compressing pages (page_zip_codec_t).
+Settable by user. */
+ulong	page_zip_codec = PAGE_ZIP_CODEC_ZLIB;
+
+/** First byte of an LZ4 compressed page stream. The first byte of a zlib
+stream has Z_DEFLATED in its low 4 bits. */
+#define PAGE_ZIP_LZ4_TAG	0x01
+
+/** Size of the header of an LZ4 compressed page stream: PAGE_ZIP_LZ4_TAG,
+the length of the compressed data (2 bytes) and the length of the first
+block of the uncompressed data (2 bytes) */
+#define PAGE_ZIP_LZ4_HDR_SIZE	5
+
 /* Whether or not to log compressed page images to avoid possible
 compression algorithm changes in zlib. */
 my_bool	page_zip_log_pages = true;
@@ -821,6 +835,316 @@ page_zip_set_alloc(
 	strm->opaque = heap;
 }
 
+/** Initialize a stream for compressing a page, like deflateInit2().
+page_zip_set_alloc() must have been called on the stream.
+@param[out]	strm	stream
+@param[in]	codec	codec
+@param[in]	level	compression level of the codec
+@return Z_OK or error code */
+int
+page_zip_deflate_init(
+	page_zip_stream_t*	strm,
+	page_zip_codec_t	codec,
+	int			level)
+{
+	strm->codec = codec;
+	strm->level = level;
+	strm->buf = NULL;
+	strm->buf_size = 0;
+	strm->buf_len = 0;
+	strm->buf_pos = 0;
+	strm->block_len = ULINT_UNDEFINED;
+	strm->n_block = 0;
+	strm->in_len = 0;
+
+	if (codec == PAGE_ZIP_CODEC_ZLIB) {
+		return(deflateInit2(strm, level, Z_DEFLATED,
+				    UNIV_PAGE_SIZE_SHIFT, MAX_MEM_LEVEL,
+				    Z_DEFAULT_STRATEGY));
+	}
+
+	strm->msg = NULL;
+	strm->total_in = 0;
+	strm->total_out = 0;
+	strm->buf_size = 2 * UNIV_PAGE_SIZE;
+	strm->buf = static_cast<byte*>(mem_heap_alloc(
+		static_cast<mem_heap_t*>(strm->opaque), strm->buf_size));
+
+	return(Z_OK);
+}
+
+/** Compress the buffered data of a stream with zlib, after it did not
+fit in the output with another codec. This makes a page compress at
+least as well as with zlib.
+@param[in,out]	strm	stream
+@return Z_STREAM_END, Z_OK, Z_BUF_ERROR, or an error code */
+static
+int
+page_zip_deflate_fallback(
+	page_zip_stream_t*	strm)
+{
+	int	err;
+
+	strm->codec = PAGE_ZIP_CODEC_ZLIB;
+
+	err = deflateInit2(strm, strm->level, Z_DEFLATED,
+			   UNIV_PAGE_SIZE_SHIFT, MAX_MEM_LEVEL,
+			   Z_DEFAULT_STRATEGY);
+
+	if (err != Z_OK) {
+		return(err);
+	}
+
+	strm->next_in = strm->buf;
+
+	if (strm->block_len != ULINT_UNDEFINED) {
+		/* Let inflate(Z_BLOCK) stop at the same position. */
+		strm->avail_in = static_cast<uInt>(strm->block_len);
+
+		err = deflate(strm, Z_FULL_FLUSH);
+
+		if (err != Z_OK) {
+			return(err);
+		}
+	}
+
+	strm->avail_in = static_cast<uInt>(
+		strm->buf + strm->buf_len - strm->next_in);
+
+	return(deflate(strm, Z_FINISH));
+}
+
+/** Compress data like deflate(). All input is consumed, and the output
+of the codecs other than zlib is produced on Z_FINISH only.
+@param[in,out]	strm	stream
+@param[in]	flush	Z_NO_FLUSH, Z_FULL_FLUSH or Z_FINISH
+@return Z_OK, Z_STREAM_END, or an error code */
+int
+page_zip_deflate(
+	page_zip_stream_t*	strm,
+	int			flush)
+{
+	if (strm->codec == PAGE_ZIP_CODEC_ZLIB) {
+		return(deflate(strm, flush));
+	}
+
+	if (strm->avail_in > strm->buf_size - strm->buf_len) {
+		return(Z_STREAM_ERROR);
+	}
+
+	memcpy(strm->buf + strm->buf_len, strm->next_in, strm->avail_in);
+	strm->buf_len += strm->avail_in;
+	strm->next_in += strm->avail_in;
+	strm->total_in += strm->avail_in;
+	strm->avail_in = 0;
+
+	if (flush == Z_FULL_FLUSH && strm->block_len == ULINT_UNDEFINED) {
+		strm->block_len = strm->buf_len;
+	}
+
+	if (flush != Z_FINISH) {
+		return(Z_OK);
+	}
+
+	ut_ad(strm->codec == PAGE_ZIP_CODEC_LZ4);
+
+	int	len = 0;
+
+	if (strm->avail_out > PAGE_ZIP_LZ4_HDR_SIZE) {
+		len = LZ4_compress_default(
+			reinterpret_cast<const char*>(strm->buf),
+			reinterpret_cast<char*>(strm->next_out
+						+ PAGE_ZIP_LZ4_HDR_SIZE),
+			static_cast<int>(strm->buf_len),
+			static_cast<int>(ut_min(
+				ulint(strm->avail_out - PAGE_ZIP_LZ4_HDR_SIZE),
+				ulint(0xFFFF))));
+	}
+
+	if (len <= 0) {
+		return(page_zip_deflate_fallback(strm));
+	}
+
+	mach_write_to_1(strm->next_out, PAGE_ZIP_LZ4_TAG);
+	mach_write_to_2(strm->next_out + 1, len);
+	mach_write_to_2(strm->next_out + 3,
+			strm->block_len == ULINT_UNDEFINED
+			? 0 : strm->block_len);
+
+	len += PAGE_ZIP_LZ4_HDR_SIZE;
+	strm->next_out += len;
+	strm->avail_out -= len;
+	strm->total_out += len;
+
+	return(Z_STREAM_END);
+}
+
+/** Free the memory of a compression stream, like deflateEnd().
+@param[in,out]	strm	stream
+@return Z_OK or error code */
+int
+page_zip_deflate_end(
+	page_zip_stream_t*	strm)
+{
+	if (strm->codec == PAGE_ZIP_CODEC_ZLIB) {
+		return(deflateEnd(strm));
+	}
+
+	/* The buffer was allocated from the heap of the stream. */
+	return(Z_OK);
+}
+
+/** Initialize a stream for decompressing a page, like inflateInit2().
+page_zip_set_alloc() must have been called, and next_in and avail_in must
+have been set to the compressed data, whose first byte identifies the
+codec.
+@param[in,out]	strm	stream
+@return Z_OK or error code */
+int
+page_zip_inflate_init(
+	page_zip_stream_t*	strm)
+{
+	strm->buf = NULL;
+	strm->buf_size = 0;
+	strm->buf_len = 0;
+	strm->buf_pos = 0;
+	strm->block_len = ULINT_UNDEFINED;
+	strm->n_block = 0;
+	strm->in_len = 0;
+
+	if (strm->avail_in == 0 || *strm->next_in != PAGE_ZIP_LZ4_TAG) {
+		strm->codec = PAGE_ZIP_CODEC_ZLIB;
+		return(inflateInit2(strm, UNIV_PAGE_SIZE_SHIFT));
+	}
+
+	strm->codec = PAGE_ZIP_CODEC_LZ4;
+	strm->msg = NULL;
+	strm->total_in = 0;
+	strm->total_out = 0;
+
+	if (strm->avail_in < PAGE_ZIP_LZ4_HDR_SIZE) {
+		return(Z_DATA_ERROR);
+	}
+
+	const ulint	len = mach_read_from_2(strm->next_in + 1);
+
+	strm->block_len = mach_read_from_2(strm->next_in + 3);
+	strm->in_len = PAGE_ZIP_LZ4_HDR_SIZE + len;
+
+	if (strm->in_len > strm->avail_in) {
+		return(Z_DATA_ERROR);
+	}
+
+	strm->buf_size = 2 * UNIV_PAGE_SIZE;
+	strm->buf = static_cast<byte*>(mem_heap_alloc(
+		static_cast<mem_heap_t*>(strm->opaque), strm->buf_size));
+
+	int	buf_len = LZ4_decompress_safe(
+		reinterpret_cast<const char*>(
+			strm->next_in + PAGE_ZIP_LZ4_HDR_SIZE),
+		reinterpret_cast<char*>(strm->buf),
+		static_cast<int>(len), static_cast<int>(strm->buf_size));
+
+	if (buf_len < 0 || strm->block_len > ulint(buf_len)) {
+		return(Z_DATA_ERROR);
+	}
+
+	strm->buf_len = buf_len;
+
+	return(Z_OK);
+}
+
+/** Consume the compressed data of a stream that was decompressed by a
+codec other than zlib, like inflate() does at the end of the stream.
+@param[in,out]	strm	stream
+@return Z_STREAM_END or Z_DATA_ERROR */
+static
+int
+page_zip_inflate_stream_end(
+	page_zip_stream_t*	strm)
+{
+	if (strm->total_in == 0) {
+		/* The caller may have reserved the end of the input
+		for uncompressed data. */
+		if (strm->avail_in < strm->in_len) {
+			return(Z_DATA_ERROR);
+		}
+
+		strm->next_in += strm->in_len;
+		strm->avail_in -= static_cast<uInt>(strm->in_len);
+		strm->total_in = strm->in_len;
+	}
+
+	return(Z_STREAM_END);
+}
+
+/** Decompress data like inflate().
+@param[in,out]	strm	stream
+@param[in]	flush	Z_BLOCK, Z_SYNC_FLUSH or Z_FINISH
+@return Z_OK, Z_STREAM_END, Z_BUF_ERROR, or an error code */
+int
+page_zip_inflate(
+	page_zip_stream_t*	strm,
+	int			flush)
+{
+	if (strm->codec == PAGE_ZIP_CODEC_ZLIB) {
+		return(inflate(strm, flush));
+	}
+
+	ulint	limit = strm->buf_len;
+
+	if (flush == Z_BLOCK) {
+		/* The first call decodes the stream header, the second
+		one the first block. */
+		if (strm->n_block++ == 0) {
+			return(Z_OK);
+		}
+
+		if (strm->buf_pos < strm->block_len) {
+			limit = strm->block_len;
+		}
+	}
+
+	if (strm->buf_pos == strm->buf_len) {
+		return(page_zip_inflate_stream_end(strm));
+	}
+
+	const ulint	n = ut_min(ulint(strm->avail_out),
+				   limit - strm->buf_pos);
+
+	if (n == 0) {
+		return(Z_BUF_ERROR);
+	}
+
+	memcpy(strm->next_out, strm->buf + strm->buf_pos, n);
+	strm->buf_pos += n;
+	strm->next_out += n;
+	strm->avail_out -= static_cast<uInt>(n);
+	strm->total_out += n;
+
+	if (strm->buf_pos == strm->buf_len
+	    && (strm->avail_out > 0 || flush == Z_FINISH)) {
+		return(page_zip_inflate_stream_end(strm));
+	}
+
+	return(flush == Z_FINISH ? Z_BUF_ERROR : Z_OK);
+}
+
+/** Free the memory of a decompression stream, like inflateEnd().
+@param[in,out]	strm	stream
+@return Z_OK or error code */
+int
+page_zip_inflate_end(
+	page_zip_stream_t*	strm)
+{
+	if (strm->codec == PAGE_ZIP_CODEC_ZLIB) {
+		return(inflateEnd(strm));
+	}
+
+	/* The buffer was allocated from the heap of the stream. */
+	return(Z_OK);
+}
+
 #if 0 || defined UNIV_DEBUG || defined UNIV_ZIP_DEBUG
 /** Symbol for enabling compression and decompression diagnostics */
 # define PAGE_ZIP_COMPRESS_DBG
@@ -844,7 +1168,7 @@ int
 page_zip_compress_deflate(
 /*======================*/
 	FILE*		logfile,/*!< in: log file, or NULL */
-	z_streamp	strm,	/*!< in/out: compressed stream for deflate() */
+	page_zip_stream_t*	strm,	/*!< in/out: compressed stream */
 	int		flush)	/*!< in: deflate() flushing method */
 {
 	int	status;
@@ -857,21 +1181,21 @@ page_zip_compress_deflate(
 			perror("fwrite");
 		}
 	}
-	status = deflate(strm, flush);
+	status = page_zip_deflate(strm, flush);
 	if (UNIV_UNLIKELY(page_zip_compress_dbg)) {
 		fprintf(stderr, " -> %d\n", status);
 	}
 	return(status);
 }
 
-/* Redefine deflate(). */
-# undef deflate
-/** Debug wrapper for the zlib compression routine deflate().
+/* Redefine page_zip_deflate(). */
+/** Debug wrapper for the compression routine page_zip_deflate().
 Log the operation if page_zip_compress_dbg is set.
 @param strm in/out: compressed stream
 @param flush in: flushing method
 @return deflate() status: Z_OK, Z_BUF_ERROR, ... */
-# define deflate(strm, flush) page_zip_compress_deflate(logfile, strm, flush)
+# define page_zip_deflate(strm, flush)				\
+	page_zip_compress_deflate(logfile, strm, flush)
 /** Declaration of the logfile parameter */
 # define FILE_LOGFILE FILE* logfile,
 /** The logfile parameter */
@@ -891,7 +1215,8 @@ int
 page_zip_compress_node_ptrs(
 /*========================*/
 	FILE_LOGFILE
-	z_stream*	c_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	c_stream,	/*!< in/out: compressed
+						page stream */
 	const rec_t**	recs,		/*!< in: dense page directory
 					sorted by address */
 	ulint		n_dense,	/*!< in: size of recs[] */
@@ -919,7 +1244,7 @@ page_zip_compress_node_ptrs(
 			rec - REC_N_NEW_EXTRA_BYTES - c_stream->next_in);
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 				break;
 			}
@@ -932,7 +1257,7 @@ page_zip_compress_node_ptrs(
 			rec_offs_data_size(offsets) - REC_NODE_PTR_SIZE);
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 				break;
 			}
@@ -957,7 +1282,8 @@ int
 page_zip_compress_sec(
 /*==================*/
 	FILE_LOGFILE
-	z_stream*	c_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	c_stream,	/*!< in/out: compressed
+						page stream */
 	const rec_t**	recs,		/*!< in: dense page directory
 					sorted by address */
 	ulint		n_dense)	/*!< in: size of recs[] */
@@ -977,7 +1303,7 @@ page_zip_compress_sec(
 		if (UNIV_LIKELY(c_stream->avail_in)) {
 			UNIV_MEM_ASSERT_RW(c_stream->next_in,
 					   c_stream->avail_in);
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 				break;
 			}
@@ -1003,7 +1329,8 @@ int
 page_zip_compress_clust_ext(
 /*========================*/
 	FILE_LOGFILE
-	z_stream*	c_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	c_stream,	/*!< in/out: compressed
+						page stream */
 	const rec_t*	rec,		/*!< in: record */
 	const ulint*	offsets,	/*!< in: rec_get_offsets(rec) */
 	ulint		trx_id_col,	/*!< in: position of of DB_TRX_ID */
@@ -1041,7 +1368,7 @@ page_zip_compress_clust_ext(
 				src - c_stream->next_in);
 
 			if (c_stream->avail_in) {
-				err = deflate(c_stream, Z_NO_FLUSH);
+				err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 				if (UNIV_UNLIKELY(err != Z_OK)) {
 
 					return(err);
@@ -1070,7 +1397,7 @@ page_zip_compress_clust_ext(
 			c_stream->avail_in = static_cast<uInt>(
 				src - c_stream->next_in);
 			if (UNIV_LIKELY(c_stream->avail_in)) {
-				err = deflate(c_stream, Z_NO_FLUSH);
+				err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 				if (UNIV_UNLIKELY(err != Z_OK)) {
 
 					return(err);
@@ -1130,7 +1457,8 @@ int
 page_zip_compress_clust(
 /*====================*/
 	FILE_LOGFILE
-	z_stream*	c_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	c_stream,	/*!< in/out: compressed
+						page stream */
 	const rec_t**	recs,		/*!< in: dense page directory
 					sorted by address */
 	ulint		n_dense,	/*!< in: size of recs[] */
@@ -1168,7 +1496,7 @@ page_zip_compress_clust(
 			- c_stream->next_in);
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 
 				goto func_exit;
@@ -1216,7 +1544,7 @@ page_zip_compress_clust(
 				src - c_stream->next_in);
 
 			if (c_stream->avail_in) {
-				err = deflate(c_stream, Z_NO_FLUSH);
+				err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 				if (UNIV_UNLIKELY(err != Z_OK)) {
 
 					return(err);
@@ -1244,7 +1572,7 @@ page_zip_compress_clust(
 			rec + rec_offs_data_size(offsets) - c_stream->next_in);
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 
 				goto func_exit;
@@ -1269,7 +1597,10 @@ page_zip_compress(
 	const page_t*		page,		/*!< in: uncompressed page */
 	dict_index_t*		index,		/*!< in: index of the B-tree
 						node */
-	ulint			level,		/*!< in: commpression level */
+	ulint			level,		/*!< in: compression
+						level, and the codec in
+						the bits starting at
+						PAGE_ZIP_LEVEL_CODEC_SHIFT */
 	const redo_page_compress_t* page_comp_info,
 						/*!< in: used for applying
 						TRUNCATE log
@@ -1277,7 +1608,7 @@ page_zip_compress(
 	mtr_t*			mtr)		/*!< in/out: mini-transaction,
 						or NULL */
 {
-	z_stream		c_stream;
+	page_zip_stream_t	c_stream;
 	int			err;
 	ulint			n_fields;	/* number of index fields
 						needed */
@@ -1419,9 +1750,12 @@ page_zip_compress(
 	/* Compress the data payload. */
 	page_zip_set_alloc(&c_stream, heap);
 
-	err = deflateInit2(&c_stream, static_cast<int>(level),
-			   Z_DEFLATED, UNIV_PAGE_SIZE_SHIFT,
-			   MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+	ut_a(level >> PAGE_ZIP_LEVEL_CODEC_SHIFT < PAGE_ZIP_CODEC_N);
+
+	err = page_zip_deflate_init(
+		&c_stream,
+		page_zip_codec_t(level >> PAGE_ZIP_LEVEL_CODEC_SHIFT),
+		static_cast<int>(level & PAGE_ZIP_LEVEL_MASK));
 	ut_a(err == Z_OK);
 
 	c_stream.next_out = buf;
@@ -1490,7 +1824,7 @@ page_zip_compress(
 	}
 
 	UNIV_MEM_ASSERT_RW(c_stream.next_in, c_stream.avail_in);
-	err = deflate(&c_stream, Z_FULL_FLUSH);
+	err = page_zip_deflate(&c_stream, Z_FULL_FLUSH);
 	if (err != Z_OK) {
 		goto zlib_error;
 	}
@@ -1544,11 +1878,11 @@ page_zip_compress(
 	ut_a(c_stream.avail_in <= UNIV_PAGE_SIZE - PAGE_ZIP_START - PAGE_DIR);
 
 	UNIV_MEM_ASSERT_RW(c_stream.next_in, c_stream.avail_in);
-	err = deflate(&c_stream, Z_FINISH);
+	err = page_zip_deflate(&c_stream, Z_FINISH);
 
 	if (UNIV_UNLIKELY(err != Z_STREAM_END)) {
 zlib_error:
-		deflateEnd(&c_stream);
+		page_zip_deflate_end(&c_stream);
 		mem_heap_free(heap);
 err_exit:
 #ifdef PAGE_ZIP_COMPRESS_DBG
@@ -1574,7 +1908,7 @@ err_exit:
 		return(FALSE);
 	}
 
-	err = deflateEnd(&c_stream);
+	err = page_zip_deflate_end(&c_stream);
 	ut_a(err == Z_OK);
 
 	ut_ad(buf + c_stream.total_out == c_stream.next_out);
@@ -2276,7 +2610,8 @@ static
 ibool
 page_zip_decompress_heap_no(
 /*========================*/
-	z_stream*	d_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	d_stream,	/*!< in/out: compressed
+						page stream */
 	rec_t*		rec,		/*!< in/out: record */
 	ulint&		heap_status)	/*!< in/out: heap_no and status bits */
 {
@@ -2302,7 +2637,8 @@ ibool
 page_zip_decompress_node_ptrs(
 /*==========================*/
 	page_zip_des_t*	page_zip,	/*!< in/out: compressed page */
-	z_stream*	d_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	d_stream,	/*!< in/out: compressed
+						page stream */
 	rec_t**		recs,		/*!< in: dense page directory
 					sorted by address */
 	ulint		n_dense,	/*!< in: size of recs[] */
@@ -2328,7 +2664,7 @@ page_zip_decompress_node_ptrs(
 
 		ut_ad(d_stream->avail_out < UNIV_PAGE_SIZE
 		      - PAGE_ZIP_START - PAGE_DIR);
-		switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+		switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 		case Z_STREAM_END:
 			page_zip_decompress_heap_no(
 				d_stream, rec, heap_status);
@@ -2363,7 +2699,7 @@ page_zip_decompress_node_ptrs(
 		d_stream->avail_out =static_cast<uInt>(
 			rec_offs_data_size(offsets) - REC_NODE_PTR_SIZE);
 
-		switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+		switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 		case Z_STREAM_END:
 			goto zlib_done;
 		case Z_OK:
@@ -2402,12 +2738,13 @@ page_zip_decompress_node_ptrs(
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(d_stream, Z_FINISH)
+			  != Z_STREAM_END)) {
 		page_zip_fail(("page_zip_decompress_node_ptrs:"
 			       " inflate(Z_FINISH)=%s\n",
 			       d_stream->msg));
 zlib_error:
-		inflateEnd(d_stream);
+		page_zip_inflate_end(d_stream);
 		return(FALSE);
 	}
 
@@ -2415,7 +2752,7 @@ zlib_error:
 	if the modification log is nonempty. */
 
 zlib_done:
-	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate_end(d_stream) != Z_OK)) {
 		ut_error;
 	}
 
@@ -2491,7 +2828,8 @@ ibool
 page_zip_decompress_sec(
 /*====================*/
 	page_zip_des_t*	page_zip,	/*!< in/out: compressed page */
-	z_stream*	d_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	d_stream,	/*!< in/out: compressed
+						page stream */
 	rec_t**		recs,		/*!< in: dense page directory
 					sorted by address */
 	ulint		n_dense,	/*!< in: size of recs[] */
@@ -2516,7 +2854,7 @@ page_zip_decompress_sec(
 			rec - REC_N_NEW_EXTRA_BYTES - d_stream->next_out);
 
 		if (UNIV_LIKELY(d_stream->avail_out)) {
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 				page_zip_decompress_heap_no(
 					d_stream, rec, heap_status);
@@ -2556,12 +2894,13 @@ page_zip_decompress_sec(
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(d_stream, Z_FINISH)
+			  != Z_STREAM_END)) {
 		page_zip_fail(("page_zip_decompress_sec:"
 			       " inflate(Z_FINISH)=%s\n",
 			       d_stream->msg));
 zlib_error:
-		inflateEnd(d_stream);
+		page_zip_inflate_end(d_stream);
 		return(FALSE);
 	}
 
@@ -2569,7 +2908,7 @@ zlib_error:
 	if the modification log is nonempty. */
 
 zlib_done:
-	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate_end(d_stream) != Z_OK)) {
 		ut_error;
 	}
 
@@ -2628,7 +2967,8 @@ static
 ibool
 page_zip_decompress_clust_ext(
 /*==========================*/
-	z_stream*	d_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	d_stream,	/*!< in/out: compressed
+						page stream */
 	rec_t*		rec,		/*!< in/out: record */
 	const ulint*	offsets,	/*!< in: rec_get_offsets(rec) */
 	ulint		trx_id_col)	/*!< in: position of of DB_TRX_ID */
@@ -2662,7 +3002,7 @@ page_zip_decompress_clust_ext(
 			d_stream->avail_out = static_cast<uInt>(
 				dst - d_stream->next_out);
 
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 			case Z_OK:
 			case Z_BUF_ERROR:
@@ -2693,7 +3033,7 @@ page_zip_decompress_clust_ext(
 
 			d_stream->avail_out = static_cast<uInt>(
 				dst - d_stream->next_out);
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 			case Z_OK:
 			case Z_BUF_ERROR:
@@ -2739,7 +3079,8 @@ ibool
 page_zip_decompress_clust(
 /*======================*/
 	page_zip_des_t*	page_zip,	/*!< in/out: compressed page */
-	z_stream*	d_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	d_stream,	/*!< in/out: compressed
+						page stream */
 	rec_t**		recs,		/*!< in: dense page directory
 					sorted by address */
 	ulint		n_dense,	/*!< in: size of recs[] */
@@ -2770,7 +3111,7 @@ page_zip_decompress_clust(
 
 		ut_ad(d_stream->avail_out < UNIV_PAGE_SIZE
 		      - PAGE_ZIP_START - PAGE_DIR);
-		err = inflate(d_stream, Z_SYNC_FLUSH);
+		err = page_zip_inflate(d_stream, Z_SYNC_FLUSH);
 		switch (err) {
 		case Z_STREAM_END:
 			page_zip_decompress_heap_no(
@@ -2827,7 +3168,7 @@ page_zip_decompress_clust(
 			d_stream->avail_out = static_cast<uInt>(
 				dst - d_stream->next_out);
 
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 			case Z_OK:
 			case Z_BUF_ERROR:
@@ -2857,7 +3198,7 @@ page_zip_decompress_clust(
 		d_stream->avail_out = static_cast<uInt>(
 			rec_get_end(rec, offsets) - d_stream->next_out);
 
-		switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+		switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 		case Z_STREAM_END:
 		case Z_OK:
 		case Z_BUF_ERROR:
@@ -2887,12 +3228,13 @@ page_zip_decompress_clust(
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(d_stream, Z_FINISH)
+			  != Z_STREAM_END)) {
 		page_zip_fail(("page_zip_decompress_clust:"
 			       " inflate(Z_FINISH)=%s\n",
 			       d_stream->msg));
 zlib_error:
-		inflateEnd(d_stream);
+		page_zip_inflate_end(d_stream);
 		return(FALSE);
 	}
 
@@ -2900,7 +3242,7 @@ zlib_error:
 	if the modification log is nonempty. */
 
 zlib_done:
-	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate_end(d_stream) != Z_OK)) {
 		ut_error;
 	}
 
@@ -3044,7 +3386,7 @@ page_zip_decompress_low(
 				page header fields that should not change
 				after page creation */
 {
-	z_stream	d_stream;
+	page_zip_stream_t	d_stream;
 	dict_index_t*	index	= NULL;
 	rec_t**		recs;	/*!< dense page directory, sorted by address */
 	ulint		n_dense;/* number of user records on the page */
@@ -3135,20 +3477,26 @@ zlib_error:
 	d_stream.next_out = page + PAGE_ZIP_START;
 	d_stream.avail_out = UNIV_PAGE_SIZE - PAGE_ZIP_START;
 
-	if (UNIV_UNLIKELY(inflateInit2(&d_stream, UNIV_PAGE_SIZE_SHIFT)
-			  != Z_OK)) {
+	switch (page_zip_inflate_init(&d_stream)) {
+	case Z_OK:
+		break;
+	case Z_DATA_ERROR:
+		page_zip_fail(("page_zip_decompress:"
+			       " corrupted stream header\n"));
+		goto zlib_error;
+	default:
 		ut_error;
 	}
 
 	/* Decode the zlib header and the index information. */
-	if (UNIV_UNLIKELY(inflate(&d_stream, Z_BLOCK) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(&d_stream, Z_BLOCK) != Z_OK)) {
 
 		page_zip_fail(("page_zip_decompress:"
 			       " 1 inflate(Z_BLOCK)=%s\n", d_stream.msg));
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(&d_stream, Z_BLOCK) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(&d_stream, Z_BLOCK) != Z_OK)) {
 
 		page_zip_fail(("page_zip_decompress:"
 			       " 2 inflate(Z_BLOCK)=%s\n", d_stream.msg));
@@ -4749,7 +5097,7 @@ page_zip_reorganize(
 	mtr_set_log_mode(mtr, log_mode);
 
 	if (!page_zip_compress(page_zip, page, index,
-			       page_zip_level, NULL, mtr)) {
+			       page_zip_get_level(), NULL, mtr)) {
 
 #ifndef UNIV_HOTBACKUP
 		buf_block_free(temp_block);
@@ -175,8 +175,28 @@ try to open read_view at same time. Only one can acquire trx_sys->mutex.
 In which order will the views be opened? Should it matter? If no, why?
 
 The order does not matter. No new transactions can be created and no running
-RW transaction can commit or rollback (or free views). AC-NL-RO transactions
+RW transactions can commit or rollback (or free views). AC-NL-RO transactions
 will mark their views as closed but not actually free their views.
+
+Shared views of AC-NL-RO transactions:
+
+An AC-NL-RO transaction never modifies its view, therefore all the AC-NL-RO
+transactions that start while the snapshot does not change can use the same
+view. The view of the latest snapshot is published in MVCC::m_published and
+it is current as long as trx_sys->snapshot_version does not change. Opening
+a view then only takes a reference to the published view, without acquiring
+trx_sys->mutex and without copying the active transaction ids. The first
+transaction that finds the published view stale creates a new one under
+trx_sys->mutex, for all the following ones.
+
+A thread increments ReadView::m_n_refs of the published view before checking
+that the view is still published and current. The shared views are never
+freed before shutdown: they are reused under trx_sys->mutex once they are
+neither published nor referenced. A thread that holds a reference while the
+view is being reused for a newer snapshot will fail the check, unless the
+view has been published again, in which case it is current. Purge sees a
+view as soon as the reference is taken: until the check succeeds, the view
+is the current snapshot or the reference is dropped.
 */
 
 /** Minimum number of elements to reserve in ReadView::ids_t */
@@ -333,7 +353,10 @@ ReadView::ReadView()
 	m_up_limit_id(),
 	m_creator_trx_id(),
 	m_ids(),
-	m_low_limit_no()
+	m_low_limit_no(),
+	m_shared(),
+	m_version(),
+	m_n_refs()
 {
 	ut_d(::memset(&m_view_list, 0x0, sizeof(m_view_list)));
 }
@@ -348,9 +371,12 @@ ReadView::~ReadView()
 /** Constructor
 @param size		Number of views to pre-allocate */
 MVCC::MVCC(ulint size)
+	:
+	m_published()
 {
 	UT_LIST_INIT(m_free, &ReadView::m_view_list);
 	UT_LIST_INIT(m_views, &ReadView::m_view_list);
+	UT_LIST_INIT(m_shared_views, &ReadView::m_view_list);
 
 	for (ulint i = 0; i < size; ++i) {
 		ReadView*	view = UT_NEW_NOKEY(ReadView());
@@ -370,6 +396,17 @@ MVCC::~MVCC()
 		UT_DELETE(view);
 	}
 
+	for (ReadView* view = UT_LIST_GET_FIRST(m_shared_views);
+	     view != NULL;
+	     view = UT_LIST_GET_FIRST(m_shared_views)) {
+
+		ut_a(view->m_n_refs == 0);
+
+		UT_LIST_REMOVE(m_shared_views, view);
+
+		UT_DELETE(view);
+	}
+
 	ut_a(UT_LIST_GET_LEN(m_views) == 0);
 }
 
@@ -456,6 +493,8 @@ ReadView::prepare(trx_id_t id)
 
 	m_creator_trx_id = id;
 
+	m_version = trx_sys->snapshot_version;
+
 	m_low_limit_no = m_low_limit_id = trx_sys->max_trx_id;
 
 	if (!trx_sys->rw_trx_ids.empty()) {
@@ -545,6 +584,97 @@ MVCC::view_release(ReadView*& view)
 	view = NULL;
 }
 
+/**
+Find a shared view that is neither published nor in use, if none found
+then allocate a new view. Caller must own the trx_sys_t::mutex.
+@return a view to use */
+
+ReadView*
+MVCC::get_shared_view()
+{
+	ut_ad(mutex_own(&trx_sys->mutex));
+
+	for (ReadView* view = UT_LIST_GET_FIRST(m_shared_views);
+	     view != NULL;
+	     view = UT_LIST_GET_NEXT(m_view_list, view)) {
+
+		if (view != m_published && view->m_n_refs == 0) {
+			return(view);
+		}
+	}
+
+	ReadView*	view = UT_NEW_NOKEY(ReadView());
+
+	if (view == NULL) {
+		ib::error() << "Failed to allocate MVCC view";
+	} else {
+		view->m_shared = true;
+
+		UT_LIST_ADD_LAST(m_shared_views, view);
+	}
+
+	return(view);
+}
+
+/**
+Get a reference to the shared view of the current snapshot, creating
+the view if the snapshot has changed since the last one.
+@return shared view, or NULL if out of memory */
+
+ReadView*
+MVCC::shared_view_open()
+{
+	ReadView*	view = m_published;
+
+	if (view != NULL) {
+
+		/* The increment is a full memory barrier: purge
+		sees the reference before we check the view. */
+
+		os_atomic_increment_ulint(&view->m_n_refs, 1);
+
+		if (view == m_published
+		    && view->m_version == trx_sys->snapshot_version) {
+
+			/* Read the view after the checks. */
+			os_rmb;
+
+			return(view);
+		}
+
+		os_atomic_decrement_ulint(&view->m_n_refs, 1);
+	}
+
+	trx_sys_mutex_enter();
+
+	view = m_published;
+
+	if (view == NULL || view->m_version != trx_sys->snapshot_version) {
+
+		view = get_shared_view();
+
+		if (view == NULL) {
+			trx_sys_mutex_exit();
+			return(NULL);
+		}
+
+		view->prepare(0);
+
+		view->complete();
+
+		/* Write the view before publishing it. */
+		os_wmb;
+
+		m_published = view;
+	}
+
+	os_atomic_increment_ulint(&view->m_n_refs, 1);
+
+	trx_sys_mutex_exit();
+
+	return(view);
+}
+
 /**
 Allocate and create a view.
 @param view		view owned by this class created for the
@@ -555,34 +685,32 @@ MVCC::view_open(ReadView*& view, trx_t* trx)
 {
 	ut_ad(!srv_read_only_mode);
 
-	/** If no new RW transaction has been started since the last view
-	was created then reuse the the existing view. */
-	if (view != NULL) {
+	if (trx_is_autocommit_non_locking(trx)) {
 
-		uintptr_t	p = reinterpret_cast<uintptr_t>(view);
+		if (view != NULL) {
 
-		view = reinterpret_cast<ReadView*>(p & ~1);
+			/* Free the closed view of a previous statement
+			that was not run as an AC-NL-RO transaction. */
 
-		ut_ad(view->m_closed);
+			trx_sys_mutex_enter();
 
-		/* NOTE: This can be optimised further, for now we only
-		resuse the view iff there are no active RW transactions.
+			view_close(view, true);
 
-		There is an inherent race here between purge and this
-		thread. Purge will skip views that are marked as closed.
-		Therefore we must set the low limit id after we reset the
-		closed status after the check. */
+			trx_sys_mutex_exit();
+		}
 
-		if (trx_is_autocommit_non_locking(trx) && view->empty()) {
+		view = shared_view_open();
 
-			view->m_closed = false;
+		return;
+	}
 
-			if (view->m_low_limit_id == trx_sys_get_max_trx_id()) {
-				return;
-			} else {
-				view->m_closed = true;
-			}
-		}
+	if (view != NULL) {
+
+		uintptr_t	p = reinterpret_cast<uintptr_t>(view);
+
+		view = reinterpret_cast<ReadView*>(p & ~1);
+
+		ut_ad(view->m_closed);
 
 		mutex_enter(&trx_sys->mutex);
 
@@ -633,6 +761,32 @@ MVCC::get_oldest_view() const
 	return(view);
 }
 
+/**
+Get the oldest shared view that is in use.
+@return oldest shared view if found or NULL */
+
+ReadView*
+MVCC::get_oldest_shared_view() const
+{
+	ut_ad(mutex_own(&trx_sys->mutex));
+
+	ReadView*	oldest_view = NULL;
+
+	for (ReadView* view = UT_LIST_GET_FIRST(m_shared_views);
+	     view != NULL;
+	     view = UT_LIST_GET_NEXT(m_view_list, view)) {
+
+		if (view->m_n_refs > 0
+		    && (oldest_view == NULL
+			|| view->m_version < oldest_view->m_version)) {
+
+			oldest_view = view;
+		}
+	}
+
+	return(oldest_view);
+}
+
 /**
 Copy state from another view. Must call copy_complete() to finish.
 @param other		view to copy from */
@@ -696,6 +850,15 @@ MVCC::clone_oldest_view(ReadView* view)
 
 	ReadView*	oldest_view = get_oldest_view();
 
+	ReadView*	oldest_shared_view = get_oldest_shared_view();
+
+	if (oldest_shared_view != NULL
+	    && (oldest_view == NULL
+		|| oldest_shared_view->m_version < oldest_view->m_version)) {
+
+		oldest_view = oldest_shared_view;
+	}
+
 	if (oldest_view == NULL) {
 
 		view->prepare(0);
@@ -732,6 +895,13 @@ MVCC::size() const
 		}
 	}
 
+	for (const ReadView* view = UT_LIST_GET_FIRST(m_shared_views);
+	     view != NULL;
+	     view = UT_LIST_GET_NEXT(m_view_list, view)) {
+
+		size += view->m_n_refs;
+	}
+
 	trx_sys_mutex_exit();
 
 	return(size);
@@ -747,9 +917,18 @@ MVCC::view_close(ReadView*& view, bool own_mutex)
 {
 	uintptr_t	p = reinterpret_cast<uintptr_t>(view);
 
+	if (reinterpret_cast<ReadView*>(p & ~1)->m_shared) {
+
+		/* Shared views are never marked as closed: drop the
+		reference, the view is reused by MVCC::get_shared_view(). */
+
+		os_atomic_decrement_ulint(&view->m_n_refs, 1);
+
+		view = NULL;
+
 	/* Note: The assumption here is that AC-NL-RO transactions will
 	call this function with own_mutex == false. */
-	if (!own_mutex) {
+	} else if (!own_mutex) {
 		/* Sanitise the pointer first. */
 		ReadView*	ptr = reinterpret_cast<ReadView*>(p & ~1);
 
@@ -789,6 +789,83 @@ cmp_get_pad_char(
 	}
 }
 
+/** Compare a data tuple to a physical record, using the byte order
+comparison of the leading dict_index_t::n_memcmp_fields of the index.
+@param[in] dtuple data tuple whose fields have the types of the index
+@param[in] rec B-tree record
+@param[in] index index of rec
+@param[in] offsets rec_get_offsets(rec)
+@param[in] n_cmp number of fields to compare
+@param[in,out] matched_fields number of completely matched fields
+@return the comparison result of dtuple and rec
+@retval 0 if dtuple is equal to rec
+@retval negative if dtuple is less than rec
+@retval positive if dtuple is greater than rec */
+int
+cmp_dtuple_rec_with_match_low(
+	const dtuple_t*		dtuple,
+	const rec_t*		rec,
+	const dict_index_t*	index,
+	const ulint*		offsets,
+	ulint			n_cmp,
+	ulint*			matched_fields)
+{
+	ulint	cur_field = *matched_fields;
+	ulint	n_memcmp = std::min(n_cmp, ulint(index->n_memcmp_fields));
+
+	ut_ad(rec_offs_validate(rec, NULL, offsets));
+	ut_ad(n_cmp <= dtuple_get_n_fields(dtuple));
+
+	if (cur_field >= n_memcmp
+	    || (cur_field == 0
+		&& ((rec_get_info_bits(rec, rec_offs_comp(offsets))
+		     | dtuple_get_info_bits(dtuple))
+		    & REC_INFO_MIN_REC_FLAG))) {
+
+		return(cmp_dtuple_rec_with_match_low(
+			       dtuple, rec, offsets, n_cmp, matched_fields));
+	}
+
+	for (; cur_field < n_memcmp; cur_field++) {
+		const dfield_t*	dtuple_field
+			= dtuple_get_nth_field(dtuple, cur_field);
+		ulint		dtuple_f_len
+			= dfield_get_len(dtuple_field);
+		ulint		rec_f_len;
+		const byte*	rec_b_ptr
+			= rec_get_nth_field(rec, offsets, cur_field,
+					    &rec_f_len);
+
+		ut_ad(cmp_get_pad_char(dfield_get_type(dtuple_field))
+		      == ULINT_UNDEFINED);
+
+		if (dtuple_f_len != rec_f_len
+		    || dtuple_f_len == UNIV_SQL_NULL) {
+			/* SQL NULL, or a search key shorter than the
+			column: let cmp_data() handle this field. */
+			break;
+		}
+
+		int	ret = cmp_fixed_binary(
+			static_cast<const byte*>(dfield_get_data(dtuple_field)),
+			rec_b_ptr, rec_f_len);
+
+		if (ret) {
+			*matched_fields = cur_field;
+			return(ret);
+		}
+	}
+
+	*matched_fields = cur_field;
+
+	if (cur_field == n_cmp) {
+		return(0);
+	}
+
+	return(cmp_dtuple_rec_with_match_low(
+		       dtuple, rec, offsets, n_cmp, matched_fields));
+}
+
 /** Compare a data tuple to a physical record.
 @param[in]	dtuple		data tuple
 @param[in]	rec		B-tree or R-tree index record
@@ -1052,7 +1129,7 @@ cmp_rec_rec_simple(
 	const dict_index_t*	index,	/*!< in: data dictionary index */
 	struct TABLE*		table)	/*!< in: MySQL table, for reporting
 					duplicate key value if applicable,
-					or NULL */
+					or NULL to only detect duplicates */
 {
 	ulint		n;
 	ulint		n_uniq	= dict_index_get_n_unique(index);
@@ -1086,9 +1163,13 @@ cmp_rec_rec_simple(
 	/* If we ran out of fields, the ordering columns of rec1 were
 	equal to rec2. Issue a duplicate key error if needed. */
 
-	if (!null_eq && table && dict_index_is_unique(index)) {
-		/* Report erroneous row using new version of table. */
-		innobase_rec_to_mysql(table, rec1, index, offsets1);
+	if (!null_eq && dict_index_is_unique(index)) {
+		if (table != NULL) {
+			/* Report erroneous row using new version of
+			table. */
+			innobase_rec_to_mysql(table, rec1, index, offsets1);
+		}
+
 		return(0);
 	}
 
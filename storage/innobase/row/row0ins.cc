@@ -62,6 +62,7 @@ Created 4/20/1996 Heikki Tuuri
 #include "fts0types.h"
 #include "m_string.h"
 #include "gis0geo.h"
+#include "srv0mon.h"
 
 /*************************************************************************
 IMPORTANT NOTE: Any operation that generates redo MUST check that there
@@ -1241,7 +1242,7 @@ row_ins_foreign_check_on_constraint(
 					tmp_heap);
 		btr_pcur_open_with_no_init(clust_index, ref,
 					   PAGE_CUR_LE, BTR_SEARCH_LEAF,
-					   cascade->pcur, 0, mtr);
+					   cascade->pcur, mtr);
 
 		clust_rec = btr_pcur_get_rec(cascade->pcur);
 		clust_block = btr_pcur_get_block(cascade->pcur);
@@ -2996,7 +2997,7 @@ row_ins_sec_index_entry_low(
 		btr_cur_search_to_nth_level(
 			index, 0, entry, PAGE_CUR_RTREE_INSERT,
 			search_mode,
-			&cursor, 0, __FILE__, __LINE__, &mtr);
+			&cursor, __FILE__, __LINE__, &mtr);
 
 		if (mode == BTR_MODIFY_LEAF && rtr_info.mbr_adj) {
 			mtr_commit(&mtr);
@@ -3011,7 +3012,7 @@ row_ins_sec_index_entry_low(
 			btr_cur_search_to_nth_level(
 				index, 0, entry, PAGE_CUR_RTREE_INSERT,
 				search_mode,
-				&cursor, 0, __FILE__, __LINE__, &mtr);
+				&cursor, __FILE__, __LINE__, &mtr);
 			mode = BTR_MODIFY_TREE;
 		}
 
@@ -3030,7 +3031,7 @@ row_ins_sec_index_entry_low(
 			btr_cur_search_to_nth_level(
 				index, 0, entry, PAGE_CUR_LE,
 				search_mode,
-				&cursor, 0, __FILE__, __LINE__, &mtr);
+				&cursor, __FILE__, __LINE__, &mtr);
 		}
 	}
 
@@ -3119,7 +3120,7 @@ row_ins_sec_index_entry_low(
 				index, 0, entry, PAGE_CUR_LE,
 				(search_mode
 				 & ~(BTR_INSERT | BTR_IGNORE_SEC_UNIQUE)),
-				&cursor, 0, __FILE__, __LINE__, &mtr);
+				&cursor, __FILE__, __LINE__, &mtr);
 		}
 	}
 
@@ -3267,6 +3268,44 @@ row_ins_index_entry_big_rec_func(
 	return(error);
 }
 
+/** Determine whether an insert that did not fit in a leaf page is worth
+trying again in the leaf before modifying the tree. When several threads
+insert at the same end of an index, they find the same page full, and
+all but the first would wait for the index lock only to find that the
+first one already split the page. Instead, they wait for the split that
+is in progress without holding any page latch, and retry in the leaf if
+the index was split since they tried.
+@param[in,out]	index	index tree
+@param[in]	smo_seq	index->smo_seq before the insert was tried
+@return whether to retry the insert with BTR_MODIFY_LEAF */
+static
+bool
+row_ins_index_entry_retry_leaf(
+	dict_index_t*	index,
+	ulint		smo_seq)
+{
+	if (dict_table_is_intrinsic(index->table)) {
+		return(false);
+	}
+
+	DEBUG_SYNC_C("row_ins_index_entry_retry_leaf");
+
+	rw_lock_t*	lock = dict_index_get_lock(index);
+
+	if (rw_lock_get_writer(lock) != RW_LOCK_NOT_LOCKED) {
+		/* Wait for the page split or merge to finish. */
+		rw_lock_sx_lock(lock);
+		rw_lock_sx_unlock(lock);
+	}
+
+	if (index->smo_seq == smo_seq) {
+		return(false);
+	}
+
+	MONITOR_INC(MONITOR_INDEX_INS_RETRY);
+	return(true);
+}
+
 /***************************************************************//**
 Inserts an entry into a clustered index. Tries first optimistic,
 then pessimistic descent down the tree. If the entry matches enough
@@ -3323,9 +3362,22 @@ row_ins_clust_index_entry(
 		err = row_ins_sorted_clust_index_entry(
 			BTR_MODIFY_LEAF, index, entry, n_ext, thr);
 	} else {
+		const ulint	smo_seq = index->smo_seq;
+
 		err = row_ins_clust_index_entry_low(
 			flags, BTR_MODIFY_LEAF, index, n_uniq, entry,
 			n_ext, thr, dup_chk_only);
+
+		if (err == DB_FAIL
+		    && row_ins_index_entry_retry_leaf(index, smo_seq)) {
+			err = row_ins_clust_index_entry_low(
+				flags, BTR_MODIFY_LEAF, index, n_uniq, entry,
+				n_ext, thr, dup_chk_only);
+
+			if (err != DB_FAIL) {
+				MONITOR_INC(MONITOR_INDEX_INS_RETRY_SUCCESSFUL);
+			}
+		}
 	}
 
 
@@ -3412,9 +3464,25 @@ row_ins_sec_index_entry(
 		flags = BTR_NO_LOCKING_FLAG | BTR_NO_UNDO_LOG_FLAG;
 	}
 
+	const ulint	smo_seq = index->smo_seq;
+
 	err = row_ins_sec_index_entry_low(
 		flags, BTR_MODIFY_LEAF, index, offsets_heap, heap, entry,
 		0, thr, dup_chk_only);
+
+	if (err == DB_FAIL
+	    && row_ins_index_entry_retry_leaf(index, smo_seq)) {
+		mem_heap_empty(heap);
+
+		err = row_ins_sec_index_entry_low(
+			flags, BTR_MODIFY_LEAF, index, offsets_heap, heap,
+			entry, 0, thr, dup_chk_only);
+
+		if (err != DB_FAIL) {
+			MONITOR_INC(MONITOR_INDEX_INS_RETRY_SUCCESSFUL);
+		}
+	}
+
 	if (err == DB_FAIL) {
 		mem_heap_empty(heap);
 
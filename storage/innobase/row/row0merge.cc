@@ -39,6 +39,7 @@ Completed by Sunny Bains and Marko Makela
 #include "row0merge.h"
 #include "row0ext.h"
 #include "row0log.h"
+#include "row0pread.h"
 #include "row0ins.h"
 #include "row0sel.h"
 #include "dict0crea.h"
@@ -169,7 +170,7 @@ public:
 			btr_cur_search_to_nth_level(m_index, 0, dtuple,
 						    PAGE_CUR_RTREE_INSERT,
 						    BTR_MODIFY_LEAF, &ins_cur,
-						    0, __FILE__, __LINE__,
+						    __FILE__, __LINE__,
 						    &mtr);
 
 			/* It need to update MBR in parent entry,
@@ -185,7 +186,7 @@ public:
 				btr_cur_search_to_nth_level(
 					m_index, 0, dtuple,
 					PAGE_CUR_RTREE_INSERT,
-					BTR_MODIFY_TREE, &ins_cur, 0,
+					BTR_MODIFY_TREE, &ins_cur,
 					__FILE__, __LINE__, &mtr);
 			}
 
@@ -208,8 +209,7 @@ public:
 					m_index, 0, dtuple,
 					PAGE_CUR_RTREE_INSERT,
 					BTR_MODIFY_TREE,
-					&ins_cur, 0,
-					__FILE__, __LINE__, &mtr);
+					&ins_cur, __FILE__, __LINE__, &mtr);
 
 
 				error = btr_cur_pessimistic_insert(
@@ -853,7 +853,7 @@ row_merge_dup_report(
 	row_merge_dup_t*	dup,	/*!< in/out: for reporting duplicates */
 	const dfield_t*		entry)	/*!< in: duplicate index entry */
 {
-	if (!dup->n_dup++) {
+	if (!dup->n_dup++ && dup->table != NULL) {
 		/* Only report the first duplicate record,
 		but count all duplicate records. */
 		innobase_fields_to_mysql(dup->table, dup->index, entry);
@@ -1612,6 +1612,440 @@ row_geo_field_is_valid(
 	return(true);
 }
 
+/** Get the number of threads that build indexes.
+@return the number of threads */
+static
+ulint
+row_merge_get_n_threads()
+{
+	return(ut_max(srv_ddl_threads, ulong(1)));
+}
+
+/** Check if the clustered index can be scanned by several threads.
+This is the case when secondary indexes are created without rebuilding
+the table, none of which is a FULLTEXT or SPATIAL index or contains
+virtual columns.
+@param[in]	old_table	table where rows are read from
+@param[in]	new_table	table where indexes are created
+@param[in]	index		indexes to be created
+@param[in]	n_index		number of indexes to create
+@param[in]	fts_sort_idx	full-text index to be created, or NULL
+@param[in]	add_v		newly added virtual columns, or NULL
+@return whether row_merge_read_clustered_index_parallel() can be used */
+static
+bool
+row_merge_scan_is_parallel(
+	const dict_table_t*	old_table,
+	const dict_table_t*	new_table,
+	dict_index_t**		index,
+	ulint			n_index,
+	const dict_index_t*	fts_sort_idx,
+	const dict_add_v_col_t*	add_v)
+{
+	if (old_table != new_table || fts_sort_idx != NULL || add_v != NULL) {
+		return(false);
+	}
+
+	for (ulint i = 0; i < n_index; i++) {
+		if ((index[i]->type & (DICT_FTS | DICT_SPATIAL))
+		    || dict_index_has_virtual(index[i])) {
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/** State of a thread of row_merge_read_clustered_index_parallel() */
+struct row_merge_scan_thread_t {
+	/** sort buffers, one for each index to create */
+	row_merge_buf_t**	merge_buf;
+	/** file buffer */
+	row_merge_block_t*	block;
+	/** allocation of block, if it is not the buffer of the calling
+	thread */
+	ut_new_pfx_t		block_pfx;
+	/** memory heap for the rows */
+	mem_heap_t*		row_heap;
+	/** memory heap for the virtual columns, or NULL */
+	mem_heap_t*		v_heap;
+	/** error that stopped the thread */
+	dberr_t			error;
+	/** the index for which error occurred */
+	ulint			error_index;
+};
+
+/** Context of the threads of row_merge_read_clustered_index_parallel().
+Each thread scans key ranges of the clustered index into its own sort
+buffers, and writes the sorted buffers as runs of one block to the
+temporary files that all threads share. */
+struct row_merge_scan_t {
+	/** transaction */
+	trx_t*				trx;
+	/** table where rows are read from and indexes are created */
+	const dict_table_t*		table;
+	/** indexes to be created */
+	dict_index_t**			index;
+	/** number of indexes to create */
+	ulint				n_index;
+	/** temporary files, one for each index */
+	merge_file_t*			files;
+	/** temporary file handle */
+	int*				tmpfd;
+	/** directory of the temporary files */
+	const char*			path;
+	/** performance schema accounting object */
+	ut_stage_alter_t*		stage;
+	/** state of each thread */
+	row_merge_scan_thread_t*	threads;
+	/** mutex protecting files, tmpfd and stage */
+	ib_mutex_t			mutex;
+};
+
+/** Sort the entries of a sort buffer of a row_merge_read_clustered_index_
+parallel() thread and write them to the temporary file of the index.
+@param[in,out]	scan	scan context
+@param[in,out]	thread	state of the thread
+@param[in]	i	number of the index
+@return DB_SUCCESS or error code */
+static MY_ATTRIBUTE((warn_unused_result))
+dberr_t
+row_merge_scan_write(
+	row_merge_scan_t*		scan,
+	row_merge_scan_thread_t*	thread,
+	ulint				i)
+{
+	row_merge_buf_t*	buf = thread->merge_buf[i];
+	merge_file_t*		file = &scan->files[i];
+
+	ut_ad(buf->n_tuples > 0);
+
+	if (dict_index_is_unique(buf->index)) {
+		/* Only detect duplicates here. The record is reported
+		to MySQL by the calling thread after the scan. */
+		row_merge_dup_t	dup = {buf->index, NULL, NULL, 0};
+
+		row_merge_buf_sort(buf, &dup);
+
+		if (dup.n_dup) {
+			return(DB_DUPLICATE_KEY);
+		}
+	} else {
+		row_merge_buf_sort(buf, NULL);
+	}
+
+	mutex_enter(&scan->mutex);
+
+	if (row_merge_file_create_if_needed(
+		    file, scan->tmpfd, 0, scan->path) < 0) {
+		mutex_exit(&scan->mutex);
+		return(DB_OUT_OF_MEMORY);
+	}
+
+	const ulint	offset = file->offset++;
+
+	file->n_rec += buf->n_tuples;
+
+	mutex_exit(&scan->mutex);
+
+	row_merge_buf_write(buf, file, thread->block);
+
+	if (!row_merge_write(file->fd, offset, thread->block)) {
+		return(DB_TEMP_FILE_WRITE_FAIL);
+	}
+
+	UNIV_MEM_INVALID(&thread->block[0], srv_sort_buf_size);
+
+	thread->merge_buf[i] = row_merge_buf_empty(buf);
+
+	return(DB_SUCCESS);
+}
+
+/** Add the index entries of a clustered index record to the sort
+buffers of a row_merge_read_clustered_index_parallel() thread.
+@see row_pread_func_t::rec */
+static
+dberr_t
+row_merge_scan_rec(
+	void*		ctx,
+	ulint		thread_no,
+	const rec_t*	rec,
+	const ulint*	offsets)
+{
+	row_merge_scan_t*		scan = static_cast<row_merge_scan_t*>(
+		ctx);
+	row_merge_scan_thread_t*	thread = &scan->threads[thread_no];
+	const dict_table_t*		table = scan->table;
+	doc_id_t			doc_id = 0;
+	dberr_t				err = DB_SUCCESS;
+	row_ext_t*			ext;
+
+	ut_ad(!rec_offs_any_null_extern(rec, offsets));
+
+	mem_heap_empty(thread->row_heap);
+
+	const dtuple_t*	row = row_build_w_add_vcol(
+		ROW_COPY_POINTERS, dict_table_get_first_index(table), rec,
+		offsets, table, NULL, NULL, NULL, &ext, thread->row_heap);
+
+	for (ulint i = 0; i < scan->n_index; i++) {
+		ulint	rows_added = row_merge_buf_add(
+			thread->merge_buf[i], NULL, table, table, NULL, row,
+			ext, &doc_id, NULL, &err, &thread->v_heap, NULL,
+			scan->trx);
+
+		if (rows_added == 0 && err == DB_SUCCESS) {
+			/* The buffer is full. */
+			err = row_merge_scan_write(scan, thread, i);
+
+			if (err == DB_SUCCESS
+			    && !row_merge_buf_add(
+				    thread->merge_buf[i], NULL, table, table,
+				    NULL, row, ext, &doc_id, NULL, &err,
+				    &thread->v_heap, NULL, scan->trx)) {
+				/* An empty buffer should have enough room
+				for at least one record. */
+				ut_error;
+			}
+		}
+
+		if (err != DB_SUCCESS) {
+			thread->error = err;
+			thread->error_index = i;
+			break;
+		}
+	}
+
+	if (thread->v_heap != NULL) {
+		mem_heap_empty(thread->v_heap);
+	}
+
+	return(err);
+}
+
+/** Account for the clustered index records read by a
+row_merge_read_clustered_index_parallel() thread.
+@see row_pread_func_t::page */
+static
+void
+row_merge_scan_page(
+	void*	ctx,
+	ulint	thread_no,
+	ulint	n_recs)
+{
+	row_merge_scan_t*	scan = static_cast<row_merge_scan_t*>(ctx);
+
+	mutex_enter(&scan->mutex);
+
+	for (; n_recs > 0; n_recs--) {
+		scan->stage->n_pk_recs_inc();
+	}
+
+	scan->stage->inc();
+
+	mutex_exit(&scan->mutex);
+}
+
+/** Write the remaining index entries of a
+row_merge_read_clustered_index_parallel() thread.
+@see row_pread_func_t::end */
+static
+dberr_t
+row_merge_scan_end(
+	void*	ctx,
+	ulint	thread_no)
+{
+	row_merge_scan_t*		scan = static_cast<row_merge_scan_t*>(
+		ctx);
+	row_merge_scan_thread_t*	thread = &scan->threads[thread_no];
+
+	for (ulint i = 0; i < scan->n_index; i++) {
+		if (thread->merge_buf[i]->n_tuples == 0) {
+			continue;
+		}
+
+		dberr_t	err = row_merge_scan_write(scan, thread, i);
+
+		if (err != DB_SUCCESS) {
+			thread->error = err;
+			thread->error_index = i;
+			return(err);
+		}
+	}
+
+	return(DB_SUCCESS);
+}
+
+/** Read the clustered index with several threads and create temporary
+files containing the index entries for the indexes to be built. Each
+thread scans key ranges of the index, and sorts and writes its own
+buffers. Unlike row_merge_read_clustered_index(), this never inserts
+the entries directly from the sort buffer.
+@param[in]	trx		transaction
+@param[in,out]	table		MySQL table object, for reporting erroneous
+records
+@param[in]	old_table	table where rows are read from and indexes
+are created
+@param[in]	online		true if creating indexes online
+@param[in]	index		indexes to be created
+@param[in]	files		temporary files
+@param[in]	key_numbers	MySQL key numbers to create
+@param[in]	n_index		number of indexes to create
+@param[in]	ranges		key ranges of the clustered index
+@param[in]	n_ranges	number of ranges
+@param[in,out]	block		file buffer
+@param[in,out]	tmpfd		temporary file handle
+@param[in,out]	stage		performance schema accounting object, used by
+ALTER TABLE. stage->n_pk_recs_inc() will be called for each record read and
+stage->inc() will be called for each page read.
+@param[in]	n_threads	number of threads
+@return DB_SUCCESS or error */
+static MY_ATTRIBUTE((warn_unused_result))
+dberr_t
+row_merge_read_clustered_index_parallel(
+	trx_t*				trx,
+	struct TABLE*			table,
+	const dict_table_t*		old_table,
+	bool				online,
+	dict_index_t**			index,
+	merge_file_t*			files,
+	const ulint*			key_numbers,
+	ulint				n_index,
+	const row_pread_range_t*	ranges,
+	ulint				n_ranges,
+	row_merge_block_t*		block,
+	int*				tmpfd,
+	ut_stage_alter_t*		stage,
+	ulint				n_threads)
+{
+	static const row_pread_func_t	func = {
+		row_merge_scan_rec, row_merge_scan_page, row_merge_scan_end};
+
+	row_merge_scan_t		scan;
+	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+	dberr_t				err;
+
+	scan.trx = trx;
+	scan.table = old_table;
+	scan.index = index;
+	scan.n_index = n_index;
+	scan.files = files;
+	scan.tmpfd = tmpfd;
+	scan.path = thd_innodb_tmpdir(trx->mysql_thd);
+	scan.stage = stage;
+	scan.threads = UT_NEW_ARRAY_NOKEY(row_merge_scan_thread_t, n_threads);
+
+	for (ulint t = 0; t < n_threads; t++) {
+		row_merge_scan_thread_t*	thread = &scan.threads[t];
+
+		thread->block = t == 0
+			? block
+			: alloc.allocate_large(
+				3 * srv_sort_buf_size, &thread->block_pfx);
+
+		if (thread->block == NULL) {
+			/* Use fewer threads. */
+			n_threads = t;
+			break;
+		}
+
+		thread->merge_buf = static_cast<row_merge_buf_t**>(
+			ut_malloc_nokey(n_index * sizeof *thread->merge_buf));
+
+		for (ulint i = 0; i < n_index; i++) {
+			thread->merge_buf[i] = row_merge_buf_create(index[i]);
+		}
+
+		thread->row_heap = mem_heap_create(sizeof(mrec_buf_t));
+		thread->v_heap = NULL;
+		thread->error = DB_SUCCESS;
+		thread->error_index = 0;
+	}
+
+	mutex_create(LATCH_ID_ROW_MERGE, &scan.mutex);
+
+	/* Perform a REPEATABLE READ when creating indexes online, see
+	row_merge_read_clustered_index(). */
+	ut_ad(!online || MVCC::is_view_active(trx->read_view));
+
+	err = row_pread_scan(trx, dict_table_get_first_index(old_table),
+			     online ? trx->read_view : NULL,
+			     ranges, n_ranges, n_threads, &func, &scan);
+
+	mutex_free(&scan.mutex);
+
+	if (err == DB_INTERRUPTED) {
+		trx->error_key_num = 0;
+	} else if (err != DB_SUCCESS) {
+		trx->error_key_num = 0;
+
+		for (ulint t = 0; t < n_threads; t++) {
+			row_merge_scan_thread_t*	thread = &scan.threads[t];
+			const ulint			i = thread->error_index;
+
+			if (thread->error != err) {
+				continue;
+			}
+
+			if (err == DB_DUPLICATE_KEY) {
+				/* Sort the buffer again, to report the
+				duplicate record to MySQL. */
+				row_merge_dup_t	dup = {index[i], table, NULL, 0};
+
+				row_merge_buf_sort(thread->merge_buf[i], &dup);
+				ut_ad(dup.n_dup > 0);
+
+				trx->error_key_num = key_numbers[i];
+			} else {
+				trx->error_key_num = i;
+			}
+
+			break;
+		}
+	}
+
+	for (ulint i = 0; err == DB_SUCCESS && online && i < n_index; i++) {
+		/* Note the newest transaction that modified this index
+		when the scan was completed. We prevent older readers
+		from accessing this index, to ensure read consistency. */
+		rw_lock_x_lock(dict_index_get_lock(index[i]));
+		ut_a(dict_index_get_online_status(index[i])
+		     == ONLINE_INDEX_CREATION);
+
+		const trx_id_t	max_trx_id = row_log_get_max_trx(index[i]);
+
+		if (max_trx_id > index[i]->trx_id) {
+			index[i]->trx_id = max_trx_id;
+		}
+
+		rw_lock_x_unlock(dict_index_get_lock(index[i]));
+	}
+
+	for (ulint t = 0; t < n_threads; t++) {
+		row_merge_scan_thread_t*	thread = &scan.threads[t];
+
+		for (ulint i = 0; i < n_index; i++) {
+			row_merge_buf_free(thread->merge_buf[i]);
+		}
+
+		ut_free(thread->merge_buf);
+		mem_heap_free(thread->row_heap);
+
+		if (thread->v_heap != NULL) {
+			mem_heap_free(thread->v_heap);
+		}
+
+		if (t > 0) {
+			alloc.deallocate_large(
+				thread->block, &thread->block_pfx);
+		}
+	}
+
+	UT_DELETE_ARRAY(scan.threads);
+
+	return(err);
+}
+
 /** Reads clustered index of the table and create temporary files
 containing the index entries for the indexes to be built.
 @param[in]	trx		transaction
@@ -1710,6 +2144,40 @@ row_merge_read_clustered_index(
 	DEBUG_FTS_SORT_PRINT("FTS_SORT: Start Create Index\n");
 #endif
 
+	const ulint	n_threads = row_merge_get_n_threads();
+	bool		parallel = n_threads > 1;
+
+	/* These debug injections are only in the single-threaded scan. */
+	DBUG_EXECUTE_IF("ib_purge_on_create_index_page_switch",
+			parallel = false;);
+	DBUG_EXECUTE_IF("row_merge_write_failure", parallel = false;);
+	DBUG_EXECUTE_IF("row_merge_tmpfile_fail", parallel = false;);
+	DBUG_EXECUTE_IF("row_merge_insert_big_row", parallel = false;);
+
+	if (parallel
+	    && row_merge_scan_is_parallel(old_table, new_table, index,
+					  n_index, fts_sort_idx, add_v)) {
+		mem_heap_t*		range_heap = mem_heap_create(1024);
+		row_pread_range_t*	ranges;
+		const ulint		n_ranges = row_pread_split(
+			dict_table_get_first_index(old_table),
+			n_threads, range_heap, &ranges);
+
+		if (n_ranges > 1) {
+			err = row_merge_read_clustered_index_parallel(
+				trx, table, old_table, online, index, files,
+				key_numbers, n_index, ranges, n_ranges, block,
+				tmpfd, stage, ut_min(n_threads, n_ranges));
+		}
+
+		mem_heap_free(range_heap);
+
+		if (n_ranges > 1) {
+			trx->op_info = "";
+			DBUG_RETURN(err);
+		}
+	}
+
 	/* Create and initialize memory for record buffers */
 
 	merge_buf = static_cast<row_merge_buf_t**>(
@@ -2879,6 +3347,279 @@ done0:
 		    != NULL);
 }
 
+/** Determine the blocks of a pair of runs that are merged in one pass.
+Like in row_merge(), run k of the first half of the input file is merged
+with run k of the second half, and the last run of the second half is
+copied if it has no pair. The output of a pair is written to the blocks
+where its input runs start in the input file; merging never makes index
+entries occupy more blocks than they did in the input runs.
+@param[in]	run_offset	first block of each input run
+@param[in]	num_run		number of input runs
+@param[in]	k		number of the pair
+@param[out]	foffs0		first block of the run of the first half,
+or the first block of the second half if the run is copied
+@param[out]	foffs1		first block of the run of the second half
+@return first block of the output run */
+static
+ulint
+row_merge_pair_offsets(
+	const ulint*	run_offset,
+	ulint		num_run,
+	ulint		k,
+	ulint*		foffs0,
+	ulint*		foffs1)
+{
+	const ulint	half = num_run / 2;
+	const ulint	ihalf = run_offset[half];
+
+	ut_ad(k < num_run - half);
+
+	*foffs0 = k < half ? run_offset[k] : ihalf;
+	*foffs1 = run_offset[half + k];
+
+	return(*foffs0 + *foffs1 - ihalf);
+}
+
+/** Context of the threads of row_merge_parallel() */
+struct row_merge_pass_t {
+	/** transaction */
+	trx_t*			trx;
+	/** descriptor of index being created, for only detecting
+	duplicates */
+	row_merge_dup_t		dup;
+	/** file containing index entries */
+	const merge_file_t*	file;
+	/** file buffer of the calling thread */
+	row_merge_block_t*	block;
+	/** output file handle */
+	int			out_fd;
+	/** number of input runs */
+	ulint			num_run;
+	/** first block of each input run */
+	const ulint*		run_offset;
+	/** mutex protecting the fields below */
+	ib_mutex_t		mutex;
+	/** next pair of runs to merge */
+	ulint			next;
+	/** number of records written */
+	ulint			n_rec;
+	/** first pair for which merging failed, or ULINT_UNDEFINED */
+	ulint			err_pair;
+	/** error of err_pair */
+	dberr_t			error;
+};
+
+/** Merge pairs of runs until none is left.
+@param[in,out]	ctx		row_merge_pass_t
+@param[in]	thread_no	number of the thread */
+static
+void
+row_merge_pass_task(
+	void*	ctx,
+	ulint	thread_no)
+{
+	row_merge_pass_t*		pass = static_cast<row_merge_pass_t*>(
+		ctx);
+	const ulint			half = pass->num_run / 2;
+	const ulint			n_pairs = pass->num_run - half;
+	row_merge_block_t*		block = pass->block;
+	ut_new_pfx_t			block_pfx;
+	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+
+	if (thread_no > 0) {
+		block = alloc.allocate_large(3 * srv_sort_buf_size, &block_pfx);
+
+		if (block == NULL) {
+			/* Leave the work to the other threads. */
+			return;
+		}
+	}
+
+	for (;;) {
+		mutex_enter(&pass->mutex);
+
+		const ulint	k = pass->next++;
+		const bool	stop = pass->error != DB_SUCCESS;
+
+		mutex_exit(&pass->mutex);
+
+		if (stop || k >= n_pairs) {
+			break;
+		}
+
+		ulint		foffs0;
+		ulint		foffs1;
+		merge_file_t	of;
+		dberr_t		error;
+
+		of.fd = pass->out_fd;
+		of.offset = row_merge_pair_offsets(
+			pass->run_offset, pass->num_run, k, &foffs0, &foffs1);
+		of.n_rec = 0;
+
+		if (trx_is_interrupted(pass->trx)) {
+			error = DB_INTERRUPTED;
+		} else if (k < half) {
+			error = row_merge_blocks(&pass->dup, pass->file, block,
+						 &foffs0, &foffs1, &of, NULL);
+		} else {
+			error = row_merge_blocks_copy(
+				pass->dup.index, pass->file, block,
+				&foffs1, &of, NULL)
+				? DB_SUCCESS : DB_CORRUPTION;
+		}
+
+		ut_ad(error != DB_SUCCESS
+		      || of.offset <= (k + 1 < n_pairs
+				       ? row_merge_pair_offsets(
+					       pass->run_offset,
+					       pass->num_run, k + 1,
+					       &foffs0, &foffs1)
+				       : pass->file->offset));
+
+		mutex_enter(&pass->mutex);
+
+		pass->n_rec += of.n_rec;
+
+		if (error != DB_SUCCESS && k < pass->err_pair) {
+			pass->err_pair = k;
+			pass->error = error;
+		}
+
+		mutex_exit(&pass->mutex);
+	}
+
+	if (thread_no > 0) {
+		alloc.deallocate_large(block, &block_pfx);
+	}
+}
+
+/** Merge disk files with several threads. Unlike row_merge(), each
+pair of runs is merged by its own thread, to the blocks where its input
+runs start (see row_merge_pair_offsets()).
+@param[in]	trx		transaction
+@param[in]	dup		descriptor of index being created
+@param[in,out]	file		file containing index entries
+@param[in,out]	block		3 buffers
+@param[in,out]	tmpfd		temporary file handle
+@param[in,out]	num_run		Number of runs that remain to be merged
+@param[in,out]	run_offset	Array that contains the first offset number
+for each merge run
+@param[in,out]	stage		performance schema accounting object, used by
+ALTER TABLE. If not NULL stage->inc() will be called for each record
+processed.
+@param[in]	n_threads	number of threads
+@return DB_SUCCESS or error code */
+static
+dberr_t
+row_merge_parallel(
+	trx_t*			trx,
+	const row_merge_dup_t*	dup,
+	merge_file_t*		file,
+	row_merge_block_t*	block,
+	int*			tmpfd,
+	ulint*			num_run,
+	ulint*			run_offset,
+	ut_stage_alter_t*	stage,
+	ulint			n_threads)
+{
+	row_merge_pass_t	pass;
+	const ulint		n_pairs = *num_run - *num_run / 2;
+	dberr_t			error;
+
+	UNIV_MEM_ASSERT_W(&block[0], 3 * srv_sort_buf_size);
+
+	pass.trx = trx;
+	pass.dup = *dup;
+	/* Only detect duplicates in the threads. A duplicate is
+	reported to MySQL by merging its pair again below. */
+	pass.dup.table = NULL;
+	pass.file = file;
+	pass.block = block;
+	pass.out_fd = *tmpfd;
+	pass.num_run = *num_run;
+	pass.run_offset = run_offset;
+	pass.next = 0;
+	pass.n_rec = 0;
+	pass.err_pair = ULINT_UNDEFINED;
+	pass.error = DB_SUCCESS;
+
+#ifdef POSIX_FADV_SEQUENTIAL
+	/* Each run of the input file will be read sequentially. Each
+	block will be read exactly once. */
+	posix_fadvise(file->fd, 0, 0,
+		      POSIX_FADV_SEQUENTIAL | POSIX_FADV_NOREUSE);
+#endif /* POSIX_FADV_SEQUENTIAL */
+
+	mutex_create(LATCH_ID_ROW_MERGE, &pass.mutex);
+
+	row_pread_run_threads(row_merge_pass_task, &pass,
+			      ut_min(n_threads, n_pairs));
+
+	mutex_free(&pass.mutex);
+
+	error = pass.error;
+
+	if (error == DB_DUPLICATE_KEY && dup->table != NULL) {
+		ulint		foffs0;
+		ulint		foffs1;
+		merge_file_t	of;
+
+		of.fd = *tmpfd;
+		of.offset = row_merge_pair_offsets(
+			run_offset, *num_run, pass.err_pair, &foffs0, &foffs1);
+		of.n_rec = 0;
+
+		ut_ad(pass.err_pair < *num_run / 2);
+
+		error = row_merge_blocks(dup, file, block,
+					 &foffs0, &foffs1, &of, NULL);
+		ut_ad(error == DB_DUPLICATE_KEY);
+	}
+
+	if (error != DB_SUCCESS) {
+		return(error);
+	}
+
+	if (UNIV_UNLIKELY(pass.n_rec != file->n_rec)) {
+		return(DB_CORRUPTION);
+	}
+
+	if (stage != NULL) {
+		for (ulint i = 0; i < pass.n_rec; i++) {
+			stage->inc();
+		}
+	}
+
+	/* Each output run starts at the first block of its input runs.
+	Computing the offset of a pair does not access the run_offset[]
+	entries of the preceding pairs, nor the middle one before the
+	last pair. */
+	for (ulint k = 0; k < n_pairs; k++) {
+		ulint	foffs0;
+		ulint	foffs1;
+
+		run_offset[k] = row_merge_pair_offsets(
+			run_offset, *num_run, k, &foffs0, &foffs1);
+	}
+
+	*num_run = n_pairs;
+
+	merge_file_t	of;
+
+	of.fd = *tmpfd;
+	of.offset = file->offset;
+	of.n_rec = file->n_rec;
+
+	/* Swap file descriptors for the next pass. */
+	*tmpfd = file->fd;
+	*file = of;
+
+	UNIV_MEM_INVALID(&block[0], 3 * srv_sort_buf_size);
+
+	return(DB_SUCCESS);
+}
+
 /** Merge disk files.
 @param[in]	trx		transaction
 @param[in]	dup		descriptor of index being created
@@ -3023,6 +3764,7 @@ row_merge(
 @param[in,out]	stage	performance schema accounting object, used by
 ALTER TABLE. If not NULL, stage->begin_phase_sort() will be called initially
 and then stage->inc() will be called for each record processed.
+@param[in]	n_threads	number of threads merging the runs of a pass
 @return DB_SUCCESS or error code */
 dberr_t
 row_merge_sort(
@@ -3031,9 +3773,9 @@ row_merge_sort(
 	merge_file_t*		file,
 	row_merge_block_t*	block,
 	int*			tmpfd,
-	ut_stage_alter_t*	stage /* = NULL */)
+	ut_stage_alter_t*	stage /* = NULL */,
+	ulint			n_threads /* = 1 */)
 {
-	const ulint	half	= file->offset / 2;
 	ulint		num_runs;
 	ulint*		run_offset;
 	dberr_t		error	= DB_SUCCESS;
@@ -3054,9 +3796,11 @@ row_merge_sort(
 	/* "run_offset" records each run's first offset number */
 	run_offset = (ulint*) ut_malloc_nokey(file->offset * sizeof(ulint));
 
-	/* This tells row_merge() where to start for the first round
-	of merge. */
-	run_offset[half] = half;
+	/* Each block is a run in the first round of merge.
+	row_merge() only needs to know where the second half starts. */
+	for (ulint i = 0; i < num_runs; i++) {
+		run_offset[i] = i;
+	}
 
 	/* The file should always contain at least one byte (the end
 	of file marker).  Thus, it must be at least one block. */
@@ -3064,8 +3808,15 @@ row_merge_sort(
 
 	/* Merge the runs until we have one big run */
 	do {
-		error = row_merge(trx, dup, file, block, tmpfd,
-				  &num_runs, run_offset, stage);
+		/* Once a pass has been run in parallel, the runs
+		are not adjacent in the file, and row_merge() cannot
+		merge them. */
+		error = n_threads > 1
+			? row_merge_parallel(trx, dup, file, block, tmpfd,
+					     &num_runs, run_offset, stage,
+					     n_threads)
+			: row_merge(trx, dup, file, block, tmpfd,
+				    &num_runs, run_offset, stage);
 
 		if (error != DB_SUCCESS) {
 			break;
@@ -4282,6 +5033,255 @@ row_merge_write_redo(
 	mtr.commit();
 }
 
+/** Context of the threads of row_merge_build_parallel(). The calling
+thread (thread 0) builds the UNIQUE indexes, because only it may report
+a duplicate key value in the MySQL table; any thread builds the other
+indexes. */
+struct row_merge_build_t {
+	/** transaction */
+	trx_t*			trx;
+	/** table where rows are read from */
+	const dict_table_t*	old_table;
+	/** indexes to be created */
+	dict_index_t**		indexes;
+	/** number of indexes to create */
+	ulint			n_indexes;
+	/** temporary files, one for each index */
+	merge_file_t*		files;
+	/** MySQL table, for reporting erroneous key value */
+	struct TABLE*		table;
+	/** mapping of old column numbers to new ones, or NULL */
+	const ulint*		col_map;
+	/** file buffer of the calling thread */
+	row_merge_block_t*	block;
+	/** temporary file handle of the calling thread */
+	int*			tmpfd;
+	/** directory of the temporary files */
+	const char*		path;
+	/** flush observer of the bulk loads */
+	FlushObserver*		observer;
+	/** performance schema accounting object, used by the calling
+	thread only */
+	ut_stage_alter_t*	stage;
+	/** number of threads merging the runs of each index */
+	ulint			n_sort_threads;
+	/** mutex protecting the fields below */
+	ib_mutex_t		mutex;
+	/** whether each index has been taken by a thread */
+	bool*			taken;
+	/** the result of building each index */
+	dberr_t*		errors;
+	/** whether building an index failed */
+	bool			stop;
+};
+
+/** Take the next index for a row_merge_build_task() thread.
+@param[in,out]	build		build context
+@param[in]	thread_no	number of the thread
+@return the number of the index, or ULINT_UNDEFINED if none is left */
+static
+ulint
+row_merge_build_next(
+	row_merge_build_t*	build,
+	ulint			thread_no)
+{
+	ulint	next = ULINT_UNDEFINED;
+
+	mutex_enter(&build->mutex);
+
+	for (ulint i = 0; !build->stop && i < build->n_indexes; i++) {
+		if (build->taken[i]) {
+			continue;
+		}
+
+		if (!dict_index_is_unique(build->indexes[i])) {
+			if (next == ULINT_UNDEFINED) {
+				next = i;
+			}
+		} else if (thread_no == 0) {
+			/* Prefer the indexes that only the calling
+			thread can build. */
+			next = i;
+			break;
+		}
+	}
+
+	if (next != ULINT_UNDEFINED) {
+		build->taken[next] = true;
+	}
+
+	mutex_exit(&build->mutex);
+
+	return(next);
+}
+
+/** Sort and load indexes until none is left.
+@param[in,out]	ctx		row_merge_build_t
+@param[in]	thread_no	number of the thread */
+static
+void
+row_merge_build_task(
+	void*	ctx,
+	ulint	thread_no)
+{
+	row_merge_build_t*		build = static_cast<row_merge_build_t*>(
+		ctx);
+	row_merge_block_t*		block = build->block;
+	int*				tmpfd = build->tmpfd;
+	int				own_tmpfd = -1;
+	ut_stage_alter_t*		stage = NULL;
+	ut_new_pfx_t			block_pfx;
+	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+
+	if (thread_no == 0) {
+		stage = build->stage;
+	} else {
+		block = alloc.allocate_large(3 * srv_sort_buf_size, &block_pfx);
+
+		if (block == NULL) {
+			/* Leave the work to the other threads. */
+			return;
+		}
+
+		tmpfd = &own_tmpfd;
+	}
+
+	for (;;) {
+		const ulint	i = row_merge_build_next(build, thread_no);
+
+		if (i == ULINT_UNDEFINED) {
+			break;
+		}
+
+		dict_index_t*	index = build->indexes[i];
+		row_merge_dup_t	dup = {
+			index, build->table, build->col_map, 0};
+		dberr_t		error = DB_SUCCESS;
+
+		if (row_merge_tmpfile_if_needed(tmpfd, build->path) < 0) {
+			error = DB_OUT_OF_MEMORY;
+		} else {
+			error = row_merge_sort(
+				build->trx, &dup, &build->files[i], block,
+				tmpfd, stage, build->n_sort_threads);
+		}
+
+		if (error == DB_SUCCESS) {
+			BtrBulk	btr_bulk(index, build->trx->id,
+					 build->observer);
+			btr_bulk.init();
+
+			error = row_merge_insert_index_tuples(
+				build->trx->id, index, build->old_table,
+				build->files[i].fd, block, NULL,
+				&btr_bulk, stage);
+
+			error = btr_bulk.finish(error);
+		}
+
+		mutex_enter(&build->mutex);
+
+		build->errors[i] = error;
+
+		if (error != DB_SUCCESS) {
+			build->stop = true;
+		}
+
+		mutex_exit(&build->mutex);
+	}
+
+	if (thread_no > 0) {
+		row_merge_file_destroy_low(own_tmpfd);
+		alloc.deallocate_large(block, &block_pfx);
+	}
+}
+
+/** Sort and load the indexes that have a temporary file with several
+threads, each building one index at a time.
+@param[in]	trx		transaction
+@param[in]	old_table	table where rows are read from
+@param[in]	indexes		indexes to be created
+@param[in]	n_indexes	size of indexes[]
+@param[in,out]	merge_files	temporary files, one for each index
+@param[in,out]	table		MySQL table, for reporting erroneous key value
+if applicable
+@param[in]	col_map		mapping of old column numbers to new ones, or
+NULL if old_table == new_table
+@param[in,out]	block		file buffer
+@param[in,out]	tmpfd		temporary file handle
+@param[in]	observer	flush observer of the bulk loads
+@param[in,out]	stage		performance schema accounting object, used by
+ALTER TABLE for the indexes built by the calling thread
+@param[in]	n_threads	number of threads
+@param[out]	errors		the result of building each index
+@return whether the indexes were built */
+static
+bool
+row_merge_build_parallel(
+	trx_t*			trx,
+	const dict_table_t*	old_table,
+	dict_index_t**		indexes,
+	ulint			n_indexes,
+	merge_file_t*		merge_files,
+	struct TABLE*		table,
+	const ulint*		col_map,
+	row_merge_block_t*	block,
+	int*			tmpfd,
+	FlushObserver*		observer,
+	ut_stage_alter_t*	stage,
+	ulint			n_threads,
+	dberr_t*		errors)
+{
+	row_merge_build_t	build;
+	ulint			n_build = 0;
+
+	build.taken = static_cast<bool*>(
+		ut_malloc_nokey(n_indexes * sizeof *build.taken));
+
+	for (ulint i = 0; i < n_indexes; i++) {
+		errors[i] = DB_SUCCESS;
+		build.taken[i] = (indexes[i]->type & (DICT_FTS | DICT_SPATIAL))
+			|| merge_files[i].fd < 0;
+
+		if (!build.taken[i]) {
+			n_build++;
+		}
+	}
+
+	if (n_threads <= 1 || n_build <= 1) {
+		ut_free(build.taken);
+		return(false);
+	}
+
+	const ulint	n_builders = ut_min(n_threads, n_build);
+
+	build.trx = trx;
+	build.old_table = old_table;
+	build.indexes = indexes;
+	build.n_indexes = n_indexes;
+	build.files = merge_files;
+	build.table = table;
+	build.col_map = col_map;
+	build.block = block;
+	build.tmpfd = tmpfd;
+	build.path = thd_innodb_tmpdir(trx->mysql_thd);
+	build.observer = observer;
+	build.stage = stage;
+	build.n_sort_threads = ut_max(n_threads / n_builders, ulint(1));
+	build.errors = errors;
+	build.stop = false;
+
+	mutex_create(LATCH_ID_ROW_MERGE, &build.mutex);
+
+	row_pread_run_threads(row_merge_build_task, &build, n_builders);
+
+	mutex_free(&build.mutex);
+
+	ut_free(build.taken);
+
+	return(true);
+}
+
 /** Build indexes on a table by reading a clustered index, creating a temporary
 file containing index entries, merge sorting these index entries and inserting
 sorted index entries to indexes.
@@ -4341,6 +5341,9 @@ row_merge_build_indexes(
 	fts_psort_t*		merge_info = NULL;
 	int64_t			sig_count = 0;
 	bool			fts_psort_initiated = false;
+	const ulint		n_threads = row_merge_get_n_threads();
+	dberr_t*		build_errors = NULL;
+	bool			built;
 	DBUG_ENTER("row_merge_build_indexes");
 
 	ut_ad(!srv_read_only_mode);
@@ -4456,6 +5459,23 @@ row_merge_build_indexes(
 	/* Now we have files containing index entries ready for
 	sorting and inserting. */
 
+	build_errors = static_cast<dberr_t*>(
+		ut_malloc_nokey(n_indexes * sizeof *build_errors));
+
+	built = old_table == new_table
+		&& row_merge_build_parallel(
+			trx, old_table, indexes, n_indexes, merge_files,
+			table, col_map, block, &tmpfd, flush_observer, stage,
+			n_threads, build_errors);
+
+	for (i = 0; built && i < n_indexes; i++) {
+		if (build_errors[i] != DB_SUCCESS) {
+			error = build_errors[i];
+			trx->error_key_num = key_numbers[i];
+			goto func_exit;
+		}
+	}
+
 	for (i = 0; i < n_indexes; i++) {
 		dict_index_t*	sort_idx = indexes[i];
 
@@ -4535,13 +5555,13 @@ wait_again:
 #ifdef FTS_INTERNAL_DIAG_PRINT
 			DEBUG_FTS_SORT_PRINT("FTS_SORT: Complete Insert\n");
 #endif
-		} else if (merge_files[i].fd >= 0) {
+		} else if (merge_files[i].fd >= 0 && !built) {
 			row_merge_dup_t	dup = {
 				sort_idx, table, col_map, 0};
 
 			error = row_merge_sort(
 				trx, &dup, &merge_files[i],
-				block, &tmpfd, stage);
+				block, &tmpfd, stage, n_threads);
 
 			if (error == DB_SUCCESS) {
 				BtrBulk	btr_bulk(sort_idx, trx->id,
@@ -4614,6 +5634,7 @@ func_exit:
 	}
 
 	ut_free(merge_files);
+	ut_free(build_errors);
 
 	alloc.deallocate_large(block, &block_pfx);
 
@@ -69,6 +69,7 @@ Created 9/17/2000 Heikki Tuuri
 #include "row0import.h"
 #include "row0ins.h"
 #include "row0merge.h"
+#include "row0pread.h"
 #include "row0row.h"
 #include "row0sel.h"
 #include "row0upd.h"
@@ -191,6 +192,31 @@ row_mysql_prebuilt_free_blob_heap(
 	DBUG_VOID_RETURN;
 }
 
+/*******************************************************************//**
+Frees the fetch cache in prebuilt, after checking the magic numbers
+around it. */
+void
+row_mysql_prebuilt_free_fetch_cache(
+/*================================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct of a
+					ha_innobase:: table handle */
+{
+	byte*	base = prebuilt->fetch_cache - 4;
+
+	ulint	magic1 = mach_read_from_4(base);
+	ut_a(magic1 == ROW_PREBUILT_FETCH_MAGIC_N);
+
+	ulint	magic2 = mach_read_from_4(
+		prebuilt->fetch_cache
+		+ prebuilt->fetch_cache_size * prebuilt->mysql_row_len);
+	ut_a(magic2 == ROW_PREBUILT_FETCH_MAGIC_N);
+
+	ut_free(base);
+
+	prebuilt->fetch_cache = NULL;
+	prebuilt->fetch_cache_size = 0;
+}
+
 /*******************************************************************//**
 Stores a >= 5.0.3 format true VARCHAR length to dest, in the MySQL row
 format.
@@ -976,6 +1002,8 @@ row_create_prebuilt(
 	prebuilt->select_lock_type = LOCK_NONE;
 	prebuilt->stored_select_lock_type = LOCK_NONE_UNSET;
 
+	prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
+
 	prebuilt->search_tuple = dtuple_create(heap, search_tuple_n_fields);
 
 	ref = dtuple_create(heap, ref_len);
@@ -1051,25 +1079,8 @@ row_prebuilt_free(
 		mem_heap_free(prebuilt->old_vers_heap);
 	}
 
-	if (prebuilt->fetch_cache[0] != NULL) {
-		byte*	base = prebuilt->fetch_cache[0] - 4;
-		byte*	ptr = base;
-
-		for (ulint i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
-			ulint	magic1 = mach_read_from_4(ptr);
-			ut_a(magic1 == ROW_PREBUILT_FETCH_MAGIC_N);
-			ptr += 4;
-
-			byte*	row = ptr;
-			ut_a(row == prebuilt->fetch_cache[i]);
-			ptr += prebuilt->mysql_row_len;
-
-			ulint	magic2 = mach_read_from_4(ptr);
-			ut_a(magic2 == ROW_PREBUILT_FETCH_MAGIC_N);
-			ptr += 4;
-		}
-
-		ut_free(base);
+	if (prebuilt->fetch_cache != NULL) {
+		row_mysql_prebuilt_free_fetch_cache(prebuilt);
 	}
 
 	if (prebuilt->rtr_info) {
@@ -5881,6 +5892,143 @@ row_rename_partitions_for_mysql(
 	return(error);
 }
 
+/** State of a thread of row_scan_index_parallel() */
+struct row_scan_thread_t {
+	/** number of records counted */
+	ulint		n_rows;
+	/** memory heap for prev_entry, or NULL if not checking keys */
+	mem_heap_t*	heap;
+	/** the previous record read by the thread, or NULL */
+	const dtuple_t*	prev_entry;
+};
+
+/** Context of the threads of row_scan_index_parallel() */
+struct row_scan_t {
+	/** clustered index being scanned */
+	const dict_index_t*	index;
+	/** state of each thread */
+	row_scan_thread_t*	threads;
+};
+
+/** Count a record in row_scan_index_parallel(), and check it against
+the previous record of the thread, if requested. The key ranges are
+handed out to the threads in ascending order, so the records that one
+thread reads are in ascending order too.
+@see row_pread_func_t::rec */
+static
+dberr_t
+row_scan_rec(
+	void*		ctx,
+	ulint		thread_no,
+	const rec_t*	rec,
+	const ulint*	offsets)
+{
+	row_scan_t*		scan = static_cast<row_scan_t*>(ctx);
+	row_scan_thread_t*	thread = &scan->threads[thread_no];
+	const dict_index_t*	index = scan->index;
+	ulint			n_ext;
+
+	thread->n_rows++;
+
+	if (thread->heap == NULL) {
+		return(DB_SUCCESS);
+	}
+
+	if (thread->prev_entry != NULL) {
+		ulint		matched_fields = 0;
+		const char*	msg = NULL;
+
+		/* The PRIMARY KEY never contains SQL NULLs. */
+		if (cmp_dtuple_rec_with_match(thread->prev_entry, rec,
+					      offsets, &matched_fields) > 0) {
+			msg = "index records in a wrong order in ";
+		} else if (matched_fields
+			   >= dict_index_get_n_ordering_defined_by_user(
+				   index)) {
+			msg = "duplicate key in ";
+		}
+
+		if (msg != NULL) {
+			ib::error()
+				<< msg << index->name
+				<< " of table " << index->table->name
+				<< ": " << *thread->prev_entry << ", "
+				<< rec_offsets_print(rec, offsets);
+			/* Continue reading */
+		}
+	}
+
+	mem_heap_empty(thread->heap);
+
+	thread->prev_entry = row_rec_to_index_entry(
+		rec, index, offsets, &n_ext, thread->heap);
+
+	return(DB_SUCCESS);
+}
+
+/** Count the records of a clustered index that are visible to a
+transaction with several threads, like the single-threaded scan of
+row_scan_index_for_mysql() does.
+@param[in,out]	trx		transaction
+@param[in]	index		clustered index
+@param[in]	check_keys	true=check for misordered or duplicate
+records, false=count the rows only
+@param[in]	ranges		key ranges returned by row_pread_split()
+@param[in]	n_ranges	number of ranges
+@param[in]	n_threads	number of threads
+@param[out]	n_rows		number of records seen in the read view
+@return DB_SUCCESS or DB_INTERRUPTED */
+static MY_ATTRIBUTE((warn_unused_result))
+dberr_t
+row_scan_index_parallel(
+	trx_t*				trx,
+	const dict_index_t*		index,
+	bool				check_keys,
+	const row_pread_range_t*	ranges,
+	ulint				n_ranges,
+	ulint				n_threads,
+	ulint*				n_rows)
+{
+	static const row_pread_func_t	func = {row_scan_rec, NULL, NULL};
+
+	row_scan_t	scan;
+	ReadView*	view = NULL;
+
+	/* Assign a read view for the query, like row_search_mvcc(). */
+	if (!srv_read_only_mode) {
+		trx_assign_read_view(trx);
+	}
+
+	if (trx->isolation_level > TRX_ISO_READ_UNCOMMITTED) {
+		view = trx->read_view;
+	}
+
+	scan.index = index;
+	scan.threads = UT_NEW_ARRAY_NOKEY(row_scan_thread_t, n_threads);
+
+	for (ulint t = 0; t < n_threads; t++) {
+		scan.threads[t].n_rows = 0;
+		scan.threads[t].heap = check_keys ? mem_heap_create(100) : NULL;
+		scan.threads[t].prev_entry = NULL;
+	}
+
+	dberr_t	err = row_pread_scan(
+		trx, const_cast<dict_index_t*>(index), view,
+		ranges, n_ranges, n_threads, &func, &scan);
+
+	for (ulint t = 0; t < n_threads; t++) {
+		*n_rows += scan.threads[t].n_rows;
+
+		if (scan.threads[t].heap != NULL) {
+			mem_heap_free(scan.threads[t].heap);
+		}
+	}
+
+	UT_DELETE_ARRAY(scan.threads);
+
+	return(err);
+}
+
 /*********************************************************************//**
 Scans an index for either COUNT(*) or CHECK TABLE.
 If CHECK TABLE; Checks that the index contains entries in an ascending order,
@@ -5893,13 +6041,9 @@ row_scan_index_for_mysql(
 	row_prebuilt_t*		prebuilt,	/*!< in: prebuilt struct
 						in MySQL handle */
 	const dict_index_t*	index,		/*!< in: index */
-#ifdef WL6742
-	/* Removing WL6742 as part of Bug 23046302 */
-
 	bool			check_keys,	/*!< in: true=check for mis-
 						ordered or duplicate records,
 						false=count the rows only */
-#endif
 	ulint*			n_rows)		/*!< out: number of entries
 						seen in the consistent read */
 {
@@ -5939,6 +6083,45 @@ row_scan_index_for_mysql(
 		return(DB_SUCCESS);
 	}
 
+	const ulint	n_threads = srv_parallel_read_threads;
+
+	if (dict_index_is_clust(index)
+	    && prebuilt->select_lock_type == LOCK_NONE
+	    && !dict_table_is_temporary(index->table)
+	    && n_threads > 1) {
+		/* Scan disjoint key ranges of the clustered index in
+		parallel. Locking reads and secondary indexes are
+		scanned by row_search_for_mysql() below. */
+		mem_heap_t*		range_heap = mem_heap_create(1024);
+		row_pread_range_t*	ranges;
+		const ulint		n_ranges = row_pread_split(
+			const_cast<dict_index_t*>(index), n_threads,
+			range_heap, &ranges);
+
+		if (n_ranges > 1) {
+			DBUG_EXECUTE_IF(
+				"row_scan_index_parallel_print",
+				ib::info() << "Scanning " << n_ranges
+				<< " key ranges of index " << index->name
+				<< " of table " << index->table->name
+				<< " with " << n_threads << " threads";);
+
+			trx_start_if_not_started(prebuilt->trx, false);
+
+			ret = row_scan_index_parallel(
+				prebuilt->trx, index, check_keys, ranges,
+				n_ranges, n_threads, n_rows);
+
+			prebuilt->sql_stat_start = FALSE;
+		}
+
+		mem_heap_free(range_heap);
+
+		if (n_ranges > 1) {
+			return(ret);
+		}
+	}
+
 	ulint bufsize = ut_max(UNIV_PAGE_SIZE, prebuilt->mysql_row_len);
 	buf = static_cast<byte*>(ut_malloc_nokey(bufsize));
 	heap = mem_heap_create(100);
@@ -5982,12 +6165,9 @@ func_exit:
 
 	*n_rows = *n_rows + 1;
 
-#ifdef WL6742
-	/*Removing WL6742 as part of Bug 23046302 */
 	if (!check_keys) {
 		goto next_rec;
 	}
-#endif
 	/* else this code is doing handler::check() for CHECK TABLE */
 
 	/* row_search... returns the index record in buf, record origin offset
@@ -6068,10 +6248,7 @@ not_ok:
 			mem_heap_free(tmp_heap);
 		}
 	}
-#ifdef WL6742
-/* Removed WL6742 as part of Bug 23046302 */
 next_rec:
-#endif
 	ret = row_search_for_mysql(
 		buf, PAGE_CUR_G, prebuilt, 0, ROW_SEL_NEXT);
 
@@ -0,0 +1,543 @@
+/*****************************************************************************
+
+Copyright (c) 2023, Oracle and/or its affiliates.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License, version 2.0,
+as published by the Free Software Foundation.
+
+This program is also distributed with certain software (including
+but not limited to OpenSSL) that is licensed under separate terms,
+as designated in a particular file or component or in included license
+documentation.  The authors of MySQL hereby grant you an additional
+permission to link the program and your derivative works with the
+separately licensed software that they have included with MySQL.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License, version 2.0, for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file row/row0pread.cc
+Parallel scan of an index
+*******************************************************/
+
+#include "ha_prototypes.h"
+
+#include "row0pread.h"
+#include "btr0btr.h"
+#include "btr0pcur.h"
+#include "os0thread.h"
+#include "read0read.h"
+#include "rem0cmp.h"
+#include "row0row.h"
+#include "row0vers.h"
+#include "sync0sync.h"
+#include "trx0trx.h"
+#include "ut0new.h"
+
+#include <vector>
+
+/** Number of key ranges to create for each thread, so that the threads
+finish at about the same time even if the ranges differ in size */
+#define ROW_PREAD_RANGES_PER_THREAD	8
+
+/** A thread created by row_pread_run_threads() */
+struct row_pread_thread_t {
+	/** the function to execute */
+	row_pread_task_t	task;
+	/** context shared by the threads */
+	void*			ctx;
+	/** number of the thread */
+	ulint			thread_no;
+	/** identifier of the thread, for os_thread_join() */
+	os_thread_id_t		id;
+#ifndef DBUG_OFF
+	/** debug settings of the calling thread */
+	const char*		dbug;
+#endif /* !DBUG_OFF */
+};
+
+/** Execute a row_pread_run_threads() task in a created thread.
+@param[in]	arg	row_pread_thread_t
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(row_pread_thread)(
+	void*	arg)
+{
+	row_pread_thread_t*	thread = static_cast<row_pread_thread_t*>(arg);
+
+	my_thread_init();
+
+	DBUG_SET(thread->dbug);
+
+	thread->task(thread->ctx, thread->thread_no);
+
+	my_thread_end();
+
+	os_thread_exit(false);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Execute a task in several threads and wait for them to complete.
+The calling thread executes the task as thread 0.
+@param[in]	task		the function to execute
+@param[in,out]	ctx		context shared by the threads
+@param[in]	n_threads	number of threads, including the calling one */
+void
+row_pread_run_threads(
+	row_pread_task_t	task,
+	void*			ctx,
+	ulint			n_threads)
+{
+	ut_ad(n_threads > 0);
+
+	row_pread_thread_t*	threads = UT_NEW_ARRAY_NOKEY(
+		row_pread_thread_t, n_threads);
+
+#ifndef DBUG_OFF
+	/* Let DBUG_EXECUTE_IF() of the calling session fire in the
+	created threads too. */
+	char	dbug[256];
+	DBUG_EXPLAIN(dbug, sizeof dbug);
+#endif /* !DBUG_OFF */
+
+	for (ulint i = 1; i < n_threads; i++) {
+		threads[i].task = task;
+		threads[i].ctx = ctx;
+		threads[i].thread_no = i;
+#ifndef DBUG_OFF
+		threads[i].dbug = dbug;
+#endif /* !DBUG_OFF */
+
+		os_thread_create(row_pread_thread, &threads[i],
+				 &threads[i].id);
+	}
+
+	task(ctx, 0);
+
+	for (ulint i = 1; i < n_threads; i++) {
+		os_thread_join(threads[i].id);
+	}
+
+	UT_DELETE_ARRAY(threads);
+}
+
+/** Split an index into key ranges for scanning them in parallel. The
+ranges are bounded by the node pointers of the highest non-leaf level
+that has enough of them, or of the level right above the leaves.
+@param[in]	index		index tree
+@param[in]	n_threads	number of threads that will scan the ranges
+@param[in,out]	heap		memory heap for the ranges
+@param[out]	ranges		key ranges, in ascending order
+@return number of ranges; 1 if the index consists of the root page only */
+ulint
+row_pread_split(
+	dict_index_t*		index,
+	ulint			n_threads,
+	mem_heap_t*		heap,
+	row_pread_range_t**	ranges)
+{
+	typedef std::vector<const dtuple_t*, ut_allocator<const dtuple_t*> >
+		keys_t;
+
+	keys_t		keys;
+	mtr_t		mtr;
+	mem_heap_t*	offsets_heap = NULL;
+	ulint*		offsets = NULL;
+	const ulint	n_ranges = n_threads * ROW_PREAD_RANGES_PER_THREAD;
+	const ulint	n_fields = dict_index_get_n_unique_in_tree(index);
+	const ulint	comp = dict_table_is_comp(index->table);
+	const page_size_t	page_size(dict_table_page_size(index->table));
+
+	ut_ad(!dict_index_is_spatial(index));
+
+	mtr_start(&mtr);
+	mtr_s_lock(dict_index_get_lock(index), &mtr);
+
+	buf_block_t*	block = btr_root_block_get(index, RW_S_LATCH, &mtr);
+	ulint		level = btr_page_get_level(
+		buf_block_get_frame(block), &mtr);
+
+	while (level > 0) {
+		ulint	child = FIL_NULL;
+
+		keys.clear();
+
+		/* Collect the node pointers of the level from left to
+		right. They are the smallest keys of the pages of the
+		next level, except for the leftmost one. */
+		for (;;) {
+			const page_t*	page = buf_block_get_frame(block);
+
+			for (const rec_t* rec = page_rec_get_next_const(
+				     page_get_infimum_rec(page));
+			     !page_rec_is_supremum(rec);
+			     rec = page_rec_get_next_const(rec)) {
+
+				offsets = rec_get_offsets(
+					rec, index, offsets, ULINT_UNDEFINED,
+					&offsets_heap);
+
+				if (child == FIL_NULL) {
+					child = btr_node_ptr_get_child_page_no(
+						rec, offsets);
+				}
+
+				if (rec_get_info_bits(rec, comp)
+				    & REC_INFO_MIN_REC_FLAG) {
+					continue;
+				}
+
+				keys.push_back(dict_index_build_data_tuple(
+					index, const_cast<rec_t*>(rec),
+					n_fields, heap));
+			}
+
+			const ulint	next = btr_page_get_next(page, &mtr);
+
+			if (next == FIL_NULL) {
+				break;
+			}
+
+			block = btr_block_get(
+				page_id_t(index->space, next), page_size,
+				RW_S_LATCH, index, &mtr);
+		}
+
+		if (keys.size() + 1 >= n_ranges || level == 1) {
+			break;
+		}
+
+		/* Descend to the leftmost page of the next level. */
+		block = btr_block_get(
+			page_id_t(index->space, child), page_size,
+			RW_S_LATCH, index, &mtr);
+		level--;
+	}
+
+	mtr_commit(&mtr);
+
+	if (offsets_heap != NULL) {
+		mem_heap_free(offsets_heap);
+	}
+
+	/* Pick evenly spaced keys for the range boundaries. */
+	const ulint	n_keys = keys.size();
+	const ulint	n = ut_min(n_keys + 1, n_ranges);
+
+	*ranges = static_cast<row_pread_range_t*>(
+		mem_heap_alloc(heap, n * sizeof **ranges));
+
+	for (ulint r = 0; r < n; r++) {
+		(*ranges)[r].start = r == 0 ? NULL : (*ranges)[r - 1].end;
+		(*ranges)[r].end = r + 1 == n
+			? NULL : keys[(r + 1) * (n_keys + 1) / n - 1];
+	}
+
+	return(n);
+}
+
+/** Context of the threads of row_pread_scan() */
+struct row_pread_scan_t {
+	/** transaction */
+	trx_t*				trx;
+	/** clustered index */
+	dict_index_t*			index;
+	/** read view, or NULL */
+	ReadView*			view;
+	/** key ranges to scan */
+	const row_pread_range_t*	ranges;
+	/** number of ranges */
+	ulint				n_ranges;
+	/** functions to call */
+	const row_pread_func_t*		func;
+	/** context passed to func */
+	void*				ctx;
+	/** mutex protecting the fields below */
+	ib_mutex_t			mutex;
+	/** next range to scan */
+	ulint				next_range;
+	/** the error that stopped the scan */
+	dberr_t				error;
+};
+
+/** Check if a row_pread_scan() has been stopped.
+@param[in,out]	scan	scan context
+@return whether a thread failed */
+static
+bool
+row_pread_scan_stopped(
+	row_pread_scan_t*	scan)
+{
+	mutex_enter(&scan->mutex);
+	const bool	stopped = scan->error != DB_SUCCESS;
+	mutex_exit(&scan->mutex);
+
+	return(stopped);
+}
+
+/** Scan a key range in a row_pread_scan() thread.
+@param[in,out]	scan		scan context
+@param[in]	thread_no	number of the thread
+@param[in]	range		key range to scan
+@return DB_SUCCESS or error code */
+static MY_ATTRIBUTE((warn_unused_result))
+dberr_t
+row_pread_scan_range(
+	row_pread_scan_t*		scan,
+	ulint				thread_no,
+	const row_pread_range_t*	range)
+{
+	dict_index_t*	index = scan->index;
+	const ulint	comp = dict_table_is_comp(index->table);
+	mem_heap_t*	heap = mem_heap_create(UNIV_PAGE_SIZE / 4);
+	btr_pcur_t	pcur;
+	mtr_t		mtr;
+	ulint		n_recs = 0;
+	dberr_t		err = DB_SUCCESS;
+
+	mtr_start(&mtr);
+
+	if (range->start == NULL) {
+		btr_pcur_open_at_index_side(
+			true, index, BTR_SEARCH_LEAF, &pcur, true, 0, &mtr);
+	} else {
+		btr_pcur_open(index, range->start, PAGE_CUR_GE,
+			      BTR_SEARCH_LEAF, &pcur, &mtr);
+
+		/* Position the cursor before the first record of the
+		range, like btr_pcur_open_at_index_side() does. */
+		ut_ad(!page_cur_is_before_first(btr_pcur_get_page_cur(&pcur)));
+		page_cur_move_to_prev(btr_pcur_get_page_cur(&pcur));
+	}
+
+	for (;;) {
+		page_cur_t*	cur = btr_pcur_get_page_cur(&pcur);
+
+		mem_heap_empty(heap);
+
+		page_cur_move_to_next(cur);
+
+		if (page_cur_is_after_last(cur)) {
+			if (scan->func->page != NULL) {
+				scan->func->page(scan->ctx, thread_no, n_recs);
+			}
+
+			n_recs = 0;
+
+			if (row_pread_scan_stopped(scan)) {
+				break;
+			}
+
+			if (UNIV_UNLIKELY(trx_is_interrupted(scan->trx))) {
+				err = DB_INTERRUPTED;
+				break;
+			}
+
+			if (rw_lock_get_waiters(dict_index_get_lock(index))) {
+				/* There are waiters on the index tree
+				lock, likely the purge thread. Store and
+				restore the cursor position, and yield
+				so that scanning a large table will not
+				starve other threads. */
+				btr_pcur_move_to_prev_on_page(&pcur);
+				btr_pcur_store_position(&pcur, &mtr);
+				mtr_commit(&mtr);
+
+				os_thread_yield();
+
+				mtr_start(&mtr);
+				btr_pcur_restore_position(
+					BTR_SEARCH_LEAF, &pcur, &mtr);
+
+				if (!btr_pcur_move_to_next_user_rec(
+					    &pcur, &mtr)) {
+					break;
+				}
+			} else {
+				const ulint	next_page_no
+					= btr_page_get_next(
+						page_cur_get_page(cur), &mtr);
+
+				if (next_page_no == FIL_NULL) {
+					break;
+				}
+
+				buf_block_t*	block = page_cur_get_block(cur);
+
+				block = btr_block_get(
+					page_id_t(block->page.id.space(),
+						  next_page_no),
+					block->page.size,
+					BTR_SEARCH_LEAF, index, &mtr);
+
+				btr_leaf_page_release(page_cur_get_block(cur),
+						      BTR_SEARCH_LEAF, &mtr);
+				page_cur_set_before_first(block, cur);
+				page_cur_move_to_next(cur);
+
+				ut_ad(!page_cur_is_after_last(cur));
+			}
+		}
+
+		const rec_t*	rec = page_cur_get_rec(cur);
+		ulint*		offsets = rec_get_offsets(
+			rec, index, NULL, ULINT_UNDEFINED, &heap);
+
+		if (range->end != NULL
+		    && cmp_dtuple_rec(range->end, rec, offsets) <= 0) {
+			/* The record belongs to the next range. */
+			break;
+		}
+
+		n_recs++;
+
+		if (scan->view != NULL
+		    && !scan->view->changes_visible(
+			    row_get_rec_trx_id(rec, index, offsets),
+			    index->table->name)) {
+			rec_t*	old_vers;
+
+			row_vers_build_for_consistent_read(
+				rec, &mtr, index, &offsets, scan->view,
+				&heap, heap, &old_vers, NULL);
+
+			rec = old_vers;
+
+			if (rec == NULL) {
+				continue;
+			}
+		}
+
+		if (rec_get_deleted_flag(rec, comp)) {
+			continue;
+		}
+
+		err = scan->func->rec(scan->ctx, thread_no, rec, offsets);
+
+		if (err != DB_SUCCESS) {
+			break;
+		}
+	}
+
+	if (n_recs > 0 && scan->func->page != NULL) {
+		scan->func->page(scan->ctx, thread_no, n_recs);
+	}
+
+	if (mtr.is_active()) {
+		mtr_commit(&mtr);
+	}
+
+	btr_pcur_close(&pcur);
+	mem_heap_free(heap);
+
+	return(err);
+}
+
+/** Scan key ranges until none is left.
+@param[in,out]	ctx		row_pread_scan_t
+@param[in]	thread_no	number of the thread */
+static
+void
+row_pread_scan_task(
+	void*	ctx,
+	ulint	thread_no)
+{
+	row_pread_scan_t*	scan = static_cast<row_pread_scan_t*>(ctx);
+	dberr_t			err = DB_SUCCESS;
+
+	for (;;) {
+		mutex_enter(&scan->mutex);
+
+		const ulint	r = scan->next_range++;
+		const bool	stopped = scan->error != DB_SUCCESS;
+
+		mutex_exit(&scan->mutex);
+
+		if (stopped || r >= scan->n_ranges) {
+			break;
+		}
+
+		err = row_pread_scan_range(scan, thread_no, &scan->ranges[r]);
+
+		if (err != DB_SUCCESS) {
+			break;
+		}
+	}
+
+	if (err == DB_SUCCESS && scan->func->end != NULL
+	    && !row_pread_scan_stopped(scan)) {
+		err = scan->func->end(scan->ctx, thread_no);
+	}
+
+	if (err != DB_SUCCESS) {
+		mutex_enter(&scan->mutex);
+
+		if (scan->error == DB_SUCCESS) {
+			scan->error = err;
+		}
+
+		mutex_exit(&scan->mutex);
+	}
+}
+
+/** Scan key ranges of a clustered index in parallel, and call
+func->rec() for each record that is visible in a read view and is not
+delete-marked. The threads yield to the waiters on the index tree lock
+between leaf pages, like a single-threaded scan in
+row_merge_read_clustered_index().
+@param[in]	trx		transaction, for checking interruption
+@param[in]	index		clustered index
+@param[in]	view		read view, or NULL to read the latest version
+@param[in]	ranges		key ranges returned by row_pread_split()
+@param[in]	n_ranges	number of ranges
+@param[in]	n_threads	number of threads
+@param[in]	func		functions to call in the threads
+@param[in,out]	ctx		context passed to the functions
+@return DB_SUCCESS, DB_INTERRUPTED, or the error returned by func */
+dberr_t
+row_pread_scan(
+	trx_t*				trx,
+	dict_index_t*			index,
+	ReadView*			view,
+	const row_pread_range_t*	ranges,
+	ulint				n_ranges,
+	ulint				n_threads,
+	const row_pread_func_t*		func,
+	void*				ctx)
+{
+	row_pread_scan_t	scan;
+
+	ut_ad(dict_index_is_clust(index));
+	ut_ad(n_threads > 0);
+	ut_ad(n_ranges > 0);
+
+	scan.trx = trx;
+	scan.index = index;
+	scan.view = view;
+	scan.ranges = ranges;
+	scan.n_ranges = n_ranges;
+	scan.func = func;
+	scan.ctx = ctx;
+	scan.next_range = 0;
+	scan.error = DB_SUCCESS;
+
+	mutex_create(LATCH_ID_ROW_PREAD, &scan.mutex);
+
+	row_pread_run_threads(row_pread_scan_task, &scan,
+			      ut_min(n_threads, n_ranges));
+
+	mutex_free(&scan.mutex);
+
+	return(scan.error);
+}
@@ -1140,7 +1140,23 @@ row_purge_step(
 
 	ut_ad(que_node_get_type(node) == QUE_NODE_PURGE);
 
-	if (!(node->undo_recs == NULL || ib_vector_is_empty(node->undo_recs))) {
+	if (node->undo_recs == NULL || ib_vector_is_empty(node->undo_recs)) {
+		/* Take the undo records of another table. */
+		node->undo_recs = trx_purge_next_group();
+
+		DBUG_EXECUTE_IF("row_purge_group_taken",
+			if (node->undo_recs != NULL) {
+				const char act[] =
+					"now SIGNAL purge_group_taken "
+					"WAIT_FOR purge_group_continue";
+				assert(opt_debug_sync_timeout > 0);
+				assert(!debug_sync_set_action(
+					       current_thd,
+					       STRING_WITH_LEN(act)));
+			});
+	}
+
+	if (node->undo_recs != NULL) {
 		trx_purge_rec_t*purge_rec;
 
 		purge_rec = static_cast<trx_purge_rec_t*>(
@@ -1150,11 +1166,7 @@ row_purge_step(
 
 		row_purge(node, purge_rec->undo_rec, thr);
 
-		if (ib_vector_is_empty(node->undo_recs)) {
-			row_purge_end(thr);
-		} else {
-			thr->run_node = node;
-		}
+		thr->run_node = node;
 	} else {
 		row_purge_end(thr);
 	}
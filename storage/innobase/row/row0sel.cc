@@ -922,7 +922,7 @@ row_sel_get_clust_rec(
 
 	btr_pcur_open_with_no_init(index, plan->clust_ref, PAGE_CUR_LE,
 				   BTR_SEARCH_LEAF, &plan->clust_pcur,
-				   0, mtr);
+				   mtr);
 
 	clust_rec = btr_pcur_get_rec(&(plan->clust_pcur));
 
@@ -1288,23 +1288,14 @@ void
 row_sel_open_pcur(
 /*==============*/
 	plan_t*		plan,		/*!< in: table plan */
-	ibool		search_latch_locked,
-					/*!< in: TRUE if the thread currently
-					has the search latch locked in
-					s-mode */
 	mtr_t*		mtr)		/*!< in: mtr */
 {
 	dict_index_t*	index;
 	func_node_t*	cond;
 	que_node_t*	exp;
 	ulint		n_fields;
-	ulint		has_search_latch = 0;	/* RW_S_LATCH or 0 */
 	ulint		i;
 
-	if (search_latch_locked) {
-		has_search_latch = RW_S_LATCH;
-	}
-
 	index = plan->index;
 
 	/* Calculate the value of the search tuple: the exact match columns
@@ -1340,7 +1331,7 @@ row_sel_open_pcur(
 
 		btr_pcur_open_with_no_init(index, plan->tuple, plan->mode,
 					   BTR_SEARCH_LEAF, &plan->pcur,
-					   has_search_latch, mtr);
+					   mtr);
 	} else {
 		/* Open the cursor to the start or the end of the index
 		(FALSE: no init) */
@@ -1476,9 +1467,6 @@ row_sel_try_search_shortcut(
 	sel_node_t*	node,	/*!< in: select node for a consistent read */
 	plan_t*		plan,	/*!< in: plan for a unique search in clustered
 				index */
-	ibool		search_latch_locked,
-				/*!< in: whether the search holds latch on
-				search system. */
 	mtr_t*		mtr)	/*!< in: mtr */
 {
 	dict_index_t*	index;
@@ -1494,13 +1482,8 @@ row_sel_try_search_shortcut(
 	ut_ad(node->read_view);
 	ut_ad(plan->unique_search);
 	ut_ad(!plan->must_get_clust);
-#ifdef UNIV_DEBUG
-	if (search_latch_locked) {
-		ut_ad(rw_lock_own(btr_get_search_latch(index), RW_LOCK_S));
-	}
-#endif /* UNIV_DEBUG */
 
-	row_sel_open_pcur(plan, search_latch_locked, mtr);
+	row_sel_open_pcur(plan, mtr);
 
 	rec = btr_pcur_get_rec(&(plan->pcur));
 
@@ -1591,7 +1574,6 @@ row_sel(
 	rec_t*		rec;
 	rec_t*		old_vers;
 	rec_t*		clust_rec;
-	ibool		search_latch_locked;
 	ibool		consistent_read;
 
 	/* The following flag becomes TRUE when we are doing a
@@ -1619,15 +1601,9 @@ row_sel(
 
 	ut_ad(thr->run_node == node);
 
-	search_latch_locked = FALSE;
-
 	if (node->read_view) {
-		/* In consistent reads, we try to do with the hash index and
-		not to use the buffer page get. This is to reduce memory bus
-		load resulting from semaphore operations. The search latch
-		will be s-locked when we access an index with a unique search
-		condition, but not locked when we access an index with a
-		less selective search condition. */
+		/* In consistent reads, we try to do with the hash index
+		when we access an index with a unique search condition. */
 
 		consistent_read = TRUE;
 	} else {
@@ -1669,27 +1645,7 @@ table_loop:
 	if (consistent_read && plan->unique_search && !plan->pcur_is_open
 	    && !plan->must_get_clust
 	    && !plan->table->big_rows) {
-		if (!search_latch_locked) {
-			rw_lock_s_lock(btr_get_search_latch(index));
-
-			search_latch_locked = TRUE;
-		} else if (rw_lock_get_writer(btr_get_search_latch(index))
-				== RW_LOCK_X_WAIT) {
-
-			/* There is an x-latch request waiting: release the
-			s-latch for a moment; as an s-latch here is often
-			kept for some 10 searches before being released,
-			a waiting x-latch request would block other threads
-			from acquiring an s-latch for a long time, lowering
-			performance significantly in multiprocessors. */
-
-			rw_lock_s_unlock(btr_get_search_latch(index));
-			rw_lock_s_lock(btr_get_search_latch(index));
-		}
-
-		found_flag = row_sel_try_search_shortcut(node, plan,
-							 search_latch_locked,
-							 &mtr);
+		found_flag = row_sel_try_search_shortcut(node, plan, &mtr);
 
 		if (found_flag == SEL_FOUND) {
 
@@ -1708,17 +1664,11 @@ table_loop:
 		mtr_start(&mtr);
 	}
 
-	if (search_latch_locked) {
-		rw_lock_s_unlock(btr_get_search_latch(index));
-
-		search_latch_locked = FALSE;
-	}
-
 	if (!plan->pcur_is_open) {
 		/* Evaluate the expressions to build the search tuple and
 		open the cursor */
 
-		row_sel_open_pcur(plan, search_latch_locked, &mtr);
+		row_sel_open_pcur(plan, &mtr);
 
 		cursor_just_opened = TRUE;
 
@@ -2111,7 +2061,6 @@ skip_lock:
 	}
 
 next_rec:
-	ut_ad(!search_latch_locked);
 
 	if (mtr_has_extra_clust_latch) {
 
@@ -2150,8 +2099,7 @@ next_table:
 
 		plan->cursor_at_end = TRUE;
 	} else {
-		ut_ad(!search_latch_locked);
-
+	
 		plan->stored_cursor_rec_processed = TRUE;
 
 		btr_pcur_store_position(&(plan->pcur), &mtr);
@@ -2242,7 +2190,6 @@ stop_for_a_while:
 	inserted new records which should have appeared in the result set,
 	which would result in the phantom problem. */
 
-	ut_ad(!search_latch_locked);
 
 	plan->stored_cursor_rec_processed = FALSE;
 	btr_pcur_store_position(&(plan->pcur), &mtr);
@@ -2267,7 +2214,6 @@ commit_mtr_for_a_while:
 
 	plan->stored_cursor_rec_processed = TRUE;
 
-	ut_ad(!search_latch_locked);
 	btr_pcur_store_position(&(plan->pcur), &mtr);
 
 	mtr_commit(&mtr);
@@ -2288,7 +2234,6 @@ lock_wait_or_error:
 	/* See the note at stop_for_a_while: the same holds for this case */
 
 	ut_ad(!btr_pcur_is_before_first_on_page(&plan->pcur) || !node->asc);
-	ut_ad(!search_latch_locked);
 
 	plan->stored_cursor_rec_processed = FALSE;
 	btr_pcur_store_position(&(plan->pcur), &mtr);
@@ -2304,10 +2249,6 @@ lock_wait_or_error:
 #endif /* UNIV_DEBUG */
 
 func_exit:
-	if (search_latch_locked) {
-		rw_lock_s_unlock(btr_get_search_latch(index));
-	}
-
 	if (heap != NULL) {
 		mem_heap_free(heap);
 	}
@@ -3523,7 +3464,7 @@ row_sel_get_clust_rec_for_mysql(
 
 	btr_pcur_open_with_no_init(clust_index, prebuilt->clust_ref,
 				   PAGE_CUR_LE, BTR_SEARCH_LEAF,
-				   prebuilt->clust_pcur, 0, mtr);
+				   prebuilt->clust_pcur, mtr);
 
 	clust_rec = btr_pcur_get_rec(prebuilt->clust_pcur);
 
@@ -3904,6 +3845,21 @@ row_sel_copy_cached_fields_for_mysql(
 	}
 }
 
+/********************************************************************//**
+Get a row of the fetch cache.
+@return pointer to the row, mysql_row_len bytes */
+UNIV_INLINE
+byte*
+row_sel_fetch_cache_row(
+/*====================*/
+	const row_prebuilt_t*	prebuilt,	/*!< in: prebuilt struct */
+	ulint			n)		/*!< in: row number */
+{
+	ut_ad(n < prebuilt->fetch_cache_size);
+
+	return(prebuilt->fetch_cache + n * prebuilt->mysql_row_len);
+}
+
 /********************************************************************//**
 Pops a cached row for MySQL from the fetch cache. */
 UNIV_INLINE
@@ -3922,7 +3878,8 @@ row_sel_dequeue_cached_row_for_mysql(
 
 	UNIV_MEM_ASSERT_W(buf, prebuilt->mysql_row_len);
 
-	cached_rec = prebuilt->fetch_cache[prebuilt->fetch_cache_first];
+	cached_rec = row_sel_fetch_cache_row(
+		prebuilt, prebuilt->fetch_cache_first);
 
 	if (UNIV_UNLIKELY(prebuilt->keep_other_fields_on_keyread)) {
 		row_sel_copy_cached_fields_for_mysql(buf, cached_rec, prebuilt);
@@ -3962,36 +3919,61 @@ row_sel_dequeue_cached_row_for_mysql(
 }
 
 /********************************************************************//**
-Initialise the prefetch cache. */
+Initialise the prefetch cache, so that it can hold fetch_cache_limit rows.
+The rows are stored in one buffer without any padding between them. */
 UNIV_INLINE
 void
 row_sel_prefetch_cache_init(
 /*========================*/
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
-	ulint	i;
 	ulint	sz;
 	byte*	ptr;
 
-	/* Reserve space for the magic number. */
-	sz = UT_ARR_SIZE(prebuilt->fetch_cache) * (prebuilt->mysql_row_len + 8);
+	ut_ad(prebuilt->n_fetch_cached == 0);
+
+	if (prebuilt->fetch_cache != NULL) {
+		row_mysql_prebuilt_free_fetch_cache(prebuilt);
+	}
+
+	/* Reserve space for the magic numbers. */
+	sz = prebuilt->fetch_cache_limit * prebuilt->mysql_row_len + 8;
 	ptr = static_cast<byte*>(ut_malloc_nokey(sz));
 
-	for (i = 0; i < UT_ARR_SIZE(prebuilt->fetch_cache); i++) {
+	/* A user has reported memory corruption in these
+	buffers in Linux. Put magic numbers there to help
+	to track a possible bug. */
 
-		/* A user has reported memory corruption in these
-		buffers in Linux. Put magic numbers there to help
-		to track a possible bug. */
+	mach_write_to_4(ptr, ROW_PREBUILT_FETCH_MAGIC_N);
+	mach_write_to_4(ptr + sz - 4, ROW_PREBUILT_FETCH_MAGIC_N);
 
-		mach_write_to_4(ptr, ROW_PREBUILT_FETCH_MAGIC_N);
-		ptr += 4;
+	prebuilt->fetch_cache = ptr + 4;
+	prebuilt->fetch_cache_size = prebuilt->fetch_cache_limit;
+}
+
+/********************************************************************//**
+Grows the number of rows to prefetch in the next batch, because the
+current batch was filled up. A long scan thus fetches more rows per
+latching of the index page and per restoration of the persistent cursor,
+while short scans keep a small cache. The batch size is bounded by
+innodb_fetch_cache_size bytes. The cache itself is reallocated by the
+next batch, once the cached rows have been consumed. */
+UNIV_INLINE
+void
+row_sel_prefetch_cache_grow(
+/*========================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+{
+	ut_ad(prebuilt->mysql_row_len > 0);
 
-		prebuilt->fetch_cache[i] = ptr;
-		ptr += prebuilt->mysql_row_len;
+	ulint	max_rows = srv_fetch_cache_size / prebuilt->mysql_row_len;
 
-		mach_write_to_4(ptr, ROW_PREBUILT_FETCH_MAGIC_N);
-		ptr += 4;
+	if (max_rows < MYSQL_FETCH_CACHE_SIZE) {
+		max_rows = MYSQL_FETCH_CACHE_SIZE;
 	}
+
+	prebuilt->fetch_cache_limit = ut_min(
+		2 * prebuilt->fetch_cache_limit, max_rows);
 }
 
 /********************************************************************//**
@@ -4004,20 +3986,24 @@ row_sel_fetch_last_buf(
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
 	ut_ad(!prebuilt->templ_contains_blob);
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 
-	if (prebuilt->fetch_cache[0] == NULL) {
-		/* Allocate memory for the fetch cache */
+	if (prebuilt->fetch_cache_size < prebuilt->fetch_cache_limit) {
+		/* Allocate memory for the fetch cache. The limit only
+		changes between batches, when the cache is empty. */
 		ut_ad(prebuilt->n_fetch_cached == 0);
 
 		row_sel_prefetch_cache_init(prebuilt);
 	}
 
 	ut_ad(prebuilt->fetch_cache_first == 0);
-	UNIV_MEM_INVALID(prebuilt->fetch_cache[prebuilt->n_fetch_cached],
-			 prebuilt->mysql_row_len);
 
-	return(prebuilt->fetch_cache[prebuilt->n_fetch_cached]);
+	byte*	row = row_sel_fetch_cache_row(
+		prebuilt, prebuilt->n_fetch_cached);
+
+	UNIV_MEM_INVALID(row, prebuilt->mysql_row_len);
+
+	return(row);
 }
 
 /********************************************************************//**
@@ -4044,8 +4030,7 @@ row_sel_enqueue_cache_row_for_mysql(
 /*********************************************************************//**
 Tries to do a shortcut to fetch a clustered index record with a unique key,
 using the hash index if possible (not always). We assume that the search
-mode is PAGE_CUR_GE, it is a consistent read, there is a read view in trx,
-btr search latch has been locked in S-mode if AHI is enabled.
+mode is PAGE_CUR_GE, it is a consistent read, there is a read view in trx.
 @return SEL_FOUND, SEL_EXHAUSTED, SEL_RETRY */
 static
 ulint
@@ -4068,9 +4053,6 @@ row_sel_try_search_shortcut_for_mysql(
 
 	btr_pcur_open_with_no_init(index, search_tuple, PAGE_CUR_GE,
 				   BTR_SEARCH_LEAF, pcur,
-				   (trx->has_search_latch)
-				    ? RW_S_LATCH
-				    : 0,
 				   mtr);
 	rec = btr_pcur_get_rec(pcur);
 
@@ -4382,7 +4364,7 @@ row_search_no_mvcc(
 
 			btr_pcur_open_with_no_init(
 				index, tuple, pcur->search_mode,
-				BTR_SEARCH_LEAF, pcur, 0, mtr);
+				BTR_SEARCH_LEAF, pcur, mtr);
 
 			mem_heap_free(heap);
 		} else {
@@ -4418,7 +4400,7 @@ row_search_no_mvcc(
 
 			btr_pcur_open_with_no_init(
 				index, search_tuple, mode, BTR_SEARCH_LEAF,
-				pcur, 0, mtr);
+				pcur, mtr);
 
 		} else if (mode == PAGE_CUR_G || mode == PAGE_CUR_L) {
 
@@ -4768,24 +4750,6 @@ row_search_mvcc(
 		    || prebuilt->m_read_virtual_key);
 
 	/*-------------------------------------------------------------*/
-	/* PHASE 0: Release a possible s-latch we are holding on the
-	adaptive hash index latch if there is someone waiting behind */
-
-	if (trx->has_search_latch
-#ifndef INNODB_RW_LOCKS_USE_ATOMICS
-	    && rw_lock_get_writer(
-		btr_get_search_latch(index)) != RW_LOCK_NOT_LOCKED
-#endif /* !INNODB_RW_LOCKS_USE_ATOMICS */
-	    ) {
-
-		/* There is an x-latch request on the adaptive hash index:
-		release the s-latch to reduce starvation and wait for
-		BTR_SEA_TIMEOUT rounds before trying to keep it again over
-		calls from MySQL */
-
-		trx_search_latch_release_if_reserved(trx);
-	}
-
 	/* Reset the new record lock info if srv_locks_unsafe_for_binlog
 	is set or session is using a READ COMMITED isolation level. Then
 	we are able to remove the record locks set here on an individual
@@ -4801,6 +4765,7 @@ row_search_mvcc(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
 		prebuilt->m_end_range = false;
 
 		if (prebuilt->sel_graph == NULL) {
@@ -4826,6 +4791,7 @@ row_search_mvcc(
 			prebuilt->n_rows_fetched = 0;
 			prebuilt->n_fetch_cached = 0;
 			prebuilt->fetch_cache_first = 0;
+			prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
 
 		} else if (UNIV_LIKELY(prebuilt->n_fetch_cached > 0)) {
 			row_sel_dequeue_cached_row_for_mysql(buf, prebuilt);
@@ -4842,17 +4808,6 @@ row_search_mvcc(
 			goto func_exit;
 		}
 
-		if (prebuilt->fetch_cache_first > 0
-		    && prebuilt->fetch_cache_first < MYSQL_FETCH_CACHE_SIZE) {
-
-			/* The previous returned row was popped from the fetch
-			cache, but the cache was not full at the time of the
-			popping: no more rows can exist in the result set */
-
-			err = DB_RECORD_NOT_FOUND;
-			goto func_exit;
-		}
-
 		prebuilt->n_rows_fetched++;
 
 		if (prebuilt->n_rows_fetched > 1000000000) {
@@ -4923,6 +4878,7 @@ row_search_mvcc(
 	    && unique_search
 	    && btr_search_enabled
 	    && dict_index_is_clust(index)
+	    && !index->search_info->auto_disabled
 	    && !prebuilt->templ_contains_blob
 	    && !prebuilt->used_in_HANDLER
 	    && (prebuilt->mysql_row_len < UNIV_PAGE_SIZE / 8)
@@ -4948,10 +4904,6 @@ row_search_mvcc(
 			and if we try that, we can deadlock on the adaptive
 			hash index semaphore! */
 
-			ut_a(!trx->has_search_latch);
-			rw_lock_s_lock(btr_get_search_latch(index));
-			trx->has_search_latch = true;
-
 			switch (row_sel_try_search_shortcut_for_mysql(
 					&rec, prebuilt, &offsets, &heap,
 					&mtr)) {
@@ -5002,9 +4954,6 @@ row_search_mvcc(
 
 				err = DB_SUCCESS;
 
-				rw_lock_s_unlock(btr_get_search_latch(index));
-				trx->has_search_latch = false;
-
 				goto func_exit;
 
 			case SEL_EXHAUSTED:
@@ -5013,9 +4962,6 @@ row_search_mvcc(
 
 				err = DB_RECORD_NOT_FOUND;
 
-				rw_lock_s_unlock(btr_get_search_latch(index));
-				trx->has_search_latch = false;
-
 				/* NOTE that we do NOT store the cursor
 				position */
 
@@ -5030,17 +4976,12 @@ row_search_mvcc(
 
 			mtr_commit(&mtr);
 			mtr_start(&mtr);
-
-                        rw_lock_s_unlock(btr_get_search_latch(index));
-                        trx->has_search_latch = false;
 		}
 	}
 
 	/*-------------------------------------------------------------*/
 	/* PHASE 3: Open or restore index cursor position */
 
-	trx_search_latch_release_if_reserved(trx);
-
 	spatial_search = dict_index_is_spatial(index)
 			 && mode >= PAGE_CUR_CONTAIN;
 
@@ -5200,7 +5141,7 @@ wait_table_again:
 
 		btr_pcur_open_with_no_init(index, search_tuple, mode,
 					   BTR_SEARCH_LEAF,
-					   pcur, 0, &mtr);
+					   pcur, &mtr);
 
 		pcur->trx_if_known = trx;
 
@@ -5976,7 +5917,7 @@ requires_clust_rec:
 		not cache rows because there the cursor is a scrollable
 		cursor. */
 
-		ut_a(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+		ut_a(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 
 		/* We only convert from InnoDB row format to MySQL row
 		format when ICP is disabled. */
@@ -6029,10 +5970,26 @@ requires_clust_rec:
 			row_sel_enqueue_cache_row_for_mysql(buf, prebuilt);
 		}
 
-		if (prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE) {
+		/* Once the batches have grown, end them at the end of
+		the leaf page, so that the next batch starts on a fresh
+		page and can prefetch all of its records under a single
+		latch. */
+
+		if (prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit
+		    && (prebuilt->fetch_cache_limit <= MYSQL_FETCH_CACHE_SIZE
+			|| !(moves_up
+			     ? page_rec_is_supremum(page_rec_get_next_const(rec))
+			     : page_rec_is_infimum(
+				     page_rec_get_prev_const(rec))))) {
 			goto next_rec;
 		}
 
+		if (prebuilt->n_fetch_cached == prebuilt->fetch_cache_limit) {
+			/* The scan did not end within the batch: prefetch
+			more rows in the next one. */
+			row_sel_prefetch_cache_grow(prebuilt);
+		}
+
 	} else {
 		if (UNIV_UNLIKELY
 		    (prebuilt->template_type == ROW_MYSQL_DUMMY_TEMPLATE)) {
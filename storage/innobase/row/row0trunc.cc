@@ -954,7 +954,9 @@ DropIndex::operator()(mtr_t* mtr, btr_pcur_t* pcur) const
 {
 	rec_t*	rec = btr_pcur_get_rec(pcur);
 
-	bool	freed = dict_drop_index_tree(rec, pcur, mtr);
+	/* TRUNCATE TABLE reuses the index ids, so the adaptive hash
+	index entries of the freed pages must be dropped now. */
+	bool	freed = dict_drop_index_tree(rec, pcur, true, mtr);
 
 #ifdef UNIV_DEBUG
 	{
@@ -2922,7 +2924,8 @@ truncate_t::drop_indexes(
 			const page_id_t	root_page_id(space_id, root_page_no);
 
 			btr_free_if_exists(
-				root_page_id, page_size, it->m_id, &mtr);
+				root_page_id, page_size, it->m_id, true,
+				&mtr);
 		}
 
 		/* If tree is already freed then we might return immediately
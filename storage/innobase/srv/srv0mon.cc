@@ -34,6 +34,7 @@ Created 12/9/2009 Jimmy Yang
 
 #ifndef UNIV_HOTBACKUP
 #include "buf0buf.h"
+#include "buf0lru.h"
 #include "dict0mem.h"
 #include "ibuf0ibuf.h"
 #include "lock0lock.h"
@@ -310,6 +311,36 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DEFAULT_ON),
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_BYTE_WRITTEN},
 
+	{"buffer_LRU_midpoint_page_gets", "buffer",
+	 "Number of page gets in buffer pool instances whose LRU list used"
+	 " the midpoint policy (innodb_buffer_pool_lru_policy)",
+	 MONITOR_EXISTING,
+	 MONITOR_DEFAULT_START, MONITOR_OVLD_LRU_MIDPOINT_PAGE_GETS},
+
+	{"buffer_LRU_midpoint_pages_read", "buffer",
+	 "Number of pages read in buffer pool instances whose LRU list used"
+	 " the midpoint policy (innodb_buffer_pool_lru_policy)",
+	 MONITOR_EXISTING,
+	 MONITOR_DEFAULT_START, MONITOR_OVLD_LRU_MIDPOINT_PAGES_READ},
+
+	{"buffer_LRU_2q_page_gets", "buffer",
+	 "Number of page gets in buffer pool instances whose LRU list used"
+	 " the 2q policy (innodb_buffer_pool_lru_policy)",
+	 MONITOR_EXISTING,
+	 MONITOR_DEFAULT_START, MONITOR_OVLD_LRU_2Q_PAGE_GETS},
+
+	{"buffer_LRU_2q_pages_read", "buffer",
+	 "Number of pages read in buffer pool instances whose LRU list used"
+	 " the 2q policy (innodb_buffer_pool_lru_policy)",
+	 MONITOR_EXISTING,
+	 MONITOR_DEFAULT_START, MONITOR_OVLD_LRU_2Q_PAGES_READ},
+
+	{"buffer_LRU_2q_ghost_hits", "buffer",
+	 "Number of pages read again soon after the 2q policy evicted them,"
+	 " and made young",
+	 MONITOR_EXISTING,
+	 MONITOR_DEFAULT_START, MONITOR_OVLD_LRU_2Q_GHOST_HITS},
+
 	/* Cumulative counter for scanning in flush batches */
 	{"buffer_flush_batch_scanned", "buffer",
 	 "Total pages scanned as part of flush batch",
@@ -846,6 +877,22 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_DISPLAY_CURRENT,
 	 MONITOR_DEFAULT_START, MONITOR_DML_PURGE_DELAY},
 
+	{"purge_batch_size", "purge",
+	 "Maximum number of undo log pages handled in a purge batch",
+	 MONITOR_DISPLAY_CURRENT,
+	 MONITOR_DEFAULT_START, MONITOR_PURGE_BATCH_SIZE},
+
+	{"purge_batch_tables", "purge",
+	 "Number of tables whose undo log records were purged in batches",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_PURGE_N_TABLES},
+
+	{"purge_tables_taken", "purge",
+	 "Number of tables taken by purge threads that had purged the"
+	 " records of their first table in a batch",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_PURGE_N_TABLES_TAKEN},
+
 	{"purge_stop_count", "purge",
 	 "Number of times purge was stopped",
 	 MONITOR_DISPLAY_CURRENT,
@@ -996,6 +1043,18 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_INDEX_DISCARD},
 
+	{"index_leaf_insert_retries", "index",
+	 "Number of inserts retried in a leaf page after a concurrent page"
+	 " split, instead of splitting the page again",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_INDEX_INS_RETRY},
+
+	{"index_leaf_insert_retries_successful", "index",
+	 "Number of inserts that fit in a leaf page when they were retried"
+	 " after a concurrent page split",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_INDEX_INS_RETRY_SUCCESSFUL},
+
 	/* ========== Counters for Adaptive Hash Index ========== */
 	{"module_adaptive_hash", "adaptive_hash_index", "Adpative Hash Index",
 	 MONITOR_MODULE,
@@ -1045,6 +1104,29 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_ROW_UPDATED},
 
+	{"adaptive_hash_searches_failed", "adaptive_hash_index",
+	 "Number of searches that failed to use the Adaptive Hash Index",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_SEARCH_FAIL},
+
+	{"adaptive_hash_index_auto_disabled", "adaptive_hash_index",
+	 "Number of times the hash searches on an index were disabled"
+	 " because of a low hit rate",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_INDEX_DISABLED},
+
+	{"adaptive_hash_index_auto_enabled", "adaptive_hash_index",
+	 "Number of times the hash searches on an index were enabled again"
+	 " after being disabled because of a low hit rate",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_INDEX_ENABLED},
+
+	{"adaptive_hash_pages_removed_lazily", "adaptive_hash_index",
+	 "Number of index pages whose Adaptive Hash Index entries were removed"
+	 " when the page was searched after the hash searches were disabled",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_PAGE_REMOVED_LAZILY},
+
 	/* ========== Counters for tablespace ========== */
 	{"module_file", "file_system", "Tablespace and File System Manager",
 	 MONITOR_MODULE,
@@ -1107,6 +1189,29 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DEFAULT_ON),
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_IBUF_SIZE},
 
+	{"ibuf_merge_batches", "change_buffer",
+	 "Number of batches of pages read by the background change buffer"
+	 " merge",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_IBUF_MERGE_BATCHES},
+
+	{"ibuf_merge_pages_scheduled", "change_buffer",
+	 "Number of pages read by the background change buffer merge",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_IBUF_MERGE_PAGES_SCHEDULED},
+
+	{"ibuf_merge_bytes_scheduled", "change_buffer",
+	 "Size in bytes of the change buffer entries scheduled for merging"
+	 " by the background change buffer merge",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_IBUF_MERGE_BYTES_SCHEDULED},
+
+	{"ibuf_merge_sweeps", "change_buffer",
+	 "Number of complete passes of the background change buffer merge"
+	 " over the change buffer",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_IBUF_MERGE_SWEEPS},
+
 	/* ========== Counters for server operations ========== */
 	{"module_innodb", "innodb",
 	 "Counter for general InnoDB server wide operations and properties",
@@ -1329,6 +1434,48 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_ICP_MATCH},
 
+	/* ========== Counters for Full-text Indexes ========== */
+	{"module_fts", "fts", "Full-text index caches, sync and optimize",
+	 MONITOR_MODULE,
+	 MONITOR_DEFAULT_START, MONITOR_MODULE_FTS},
+
+	{"fts_cache_size", "fts",
+	 "Memory used by the full-text index caches of all tables, in bytes",
+	 MONITOR_DISPLAY_CURRENT,
+	 MONITOR_DEFAULT_START, MONITOR_FTS_CACHE_SIZE},
+
+	{"fts_syncs", "fts",
+	 "Number of full-text index cache syncs",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FTS_SYNC},
+
+	{"fts_sync_passes", "fts",
+	 "Number of passes over a full-text index cache during syncs",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FTS_SYNC_PASSES},
+
+	{"fts_sync_exclusive_passes", "fts",
+	 "Number of sync passes that blocked inserts into the full-text index"
+	 " cache until they finished",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FTS_SYNC_EXCLUSIVE_PASSES},
+
+	{"fts_sync_usec", "fts",
+	 "Time spent in full-text index cache syncs (in microseconds)",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FTS_SYNC_MICROSECOND},
+
+	{"fts_optimize_tables", "fts",
+	 "Number of tables optimized by the full-text optimize threads",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FTS_OPTIMIZE},
+
+	{"fts_optimize_usec", "fts",
+	 "Time spent by the full-text optimize threads optimizing tables"
+	 " (in microseconds)",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FTS_OPTIMIZE_MICROSECOND},
+
 	/* ========== Mutex monitoring on/off ========== */
 	{"latch_status", "Latch counters",
 	 "Collect latch counters to display via SHOW ENGING INNODB MUTEX",
@@ -1545,6 +1692,7 @@ srv_mon_process_existing_counter(
 	monitor_info_t*		monitor_info;
 	ibool			update_min = FALSE;
 	buf_pool_stat_t		stat;
+	buf_LRU_policy_stat_t	LRU_stat;
 	buf_pools_list_size_t	buf_pools_list_size;
 	ulint			LRU_len;
 	ulint			free_len;
@@ -1663,6 +1811,32 @@ srv_mon_process_existing_counter(
 		value = srv_stats.data_written;
 		break;
 
+	/* Page gets and reads under each LRU replacement policy */
+	case MONITOR_OVLD_LRU_MIDPOINT_PAGE_GETS:
+		buf_LRU_policy_get_stat(BUF_LRU_POLICY_MIDPOINT, &LRU_stat);
+		value = LRU_stat.n_page_gets;
+		break;
+
+	case MONITOR_OVLD_LRU_MIDPOINT_PAGES_READ:
+		buf_LRU_policy_get_stat(BUF_LRU_POLICY_MIDPOINT, &LRU_stat);
+		value = LRU_stat.n_pages_read;
+		break;
+
+	case MONITOR_OVLD_LRU_2Q_PAGE_GETS:
+		buf_LRU_policy_get_stat(BUF_LRU_POLICY_2Q, &LRU_stat);
+		value = LRU_stat.n_page_gets;
+		break;
+
+	case MONITOR_OVLD_LRU_2Q_PAGES_READ:
+		buf_LRU_policy_get_stat(BUF_LRU_POLICY_2Q, &LRU_stat);
+		value = LRU_stat.n_pages_read;
+		break;
+
+	case MONITOR_OVLD_LRU_2Q_GHOST_HITS:
+		buf_LRU_policy_get_stat(BUF_LRU_POLICY_2Q, &LRU_stat);
+		value = LRU_stat.n_ghost_hits;
+		break;
+
 	/* innodb_data_reads, the total number of data reads. */
 	case MONITOR_OVLD_OS_FILE_READ:
 		value = os_n_file_reads;
@@ -187,6 +187,11 @@ on duplicate key checking and foreign key checking */
 ibool	srv_locks_unsafe_for_binlog = FALSE;
 /** Sort buffer size in index creation */
 ulong	srv_sort_buf_size = 1048576;
+/** Number of threads scanning, sorting and loading in index creation */
+ulong	srv_ddl_threads = 4;
+/** Number of threads checking the records of a clustered index in
+CHECK TABLE */
+ulong	srv_parallel_read_threads = 4;
 /** Maximum modification log file size for online index creation */
 unsigned long long	srv_online_max_size;
 
@@ -195,6 +200,9 @@ OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 my_bool	srv_use_native_aio = TRUE;
+/** If this flag is TRUE, native aio on Linux uses io_uring instead of
+libaio, provided it was compiled in and the kernel supports it */
+my_bool	srv_use_io_uring = FALSE;
 
 #ifdef UNIV_DEBUG
 /** Force all user tables to use page compression. */
@@ -226,10 +234,17 @@ ib_uint64_t	srv_log_file_size_requested;
 /* size in database pages */
 ulint		srv_log_buffer_size = ULINT_MAX;
 ulong		srv_flush_log_at_trx_commit = 1;
+/** Whether the commit of a transaction that wrote no redo log waits until
+the commits whose changes it may have read are durable */
+my_bool		srv_commit_wait_dependencies = FALSE;
 uint		srv_flush_log_at_timeout = 1;
 ulong		srv_page_size = UNIV_PAGE_SIZE_DEF;
 ulong		srv_page_size_shift = UNIV_PAGE_SIZE_SHIFT_DEF;
 ulong		srv_log_write_ahead_size = 0;
+my_bool		srv_log_writer_threads = TRUE;
+my_bool		srv_lru_manager_threads = TRUE;
+ulong		srv_log_wait_for_flush_spin_hwm = 400;
+ulong		srv_log_events = 2048;
 
 page_size_t	univ_page_size(0, 0, false);
 
@@ -267,6 +282,8 @@ const ulong	srv_buf_pool_instances_default = 0;
 ulong	srv_n_page_hash_locks = 16;
 /** Scan depth for LRU flush batch i.e.: number of blocks scanned*/
 ulong	srv_LRU_scan_depth	= 1024;
+/** Replacement policy of the LRU lists, buf_LRU_policy_t */
+ulong	srv_buf_pool_LRU_policy	= 0;
 /** Whether or not to flush neighbors of a block */
 ulong	srv_flush_neighbors	= 1;
 /** Previously requested size */
@@ -292,6 +309,10 @@ in the buffer cache and accessed sequentially for InnoDB to trigger a
 readahead request. */
 ulong	srv_read_ahead_threshold	= 56;
 
+/** Maximum number of bytes of rows prefetched by a batch of a scan, see
+row_sel_prefetch_cache_grow() */
+ulong	srv_fetch_cache_size		= 1024 * 1024;
+
 /** Maximum on-disk size of change buffer in terms of percentage
 of the buffer pool. */
 uint	srv_change_buffer_max_size = CHANGE_BUFFER_DEFAULT_SIZE;
@@ -322,6 +343,9 @@ ulong	srv_max_io_capacity     = 400;
 /* The number of page cleaner threads to use.*/
 ulong	srv_n_page_cleaners = 4;
 
+/* The number of threads applying redo log records during crash recovery.*/
+ulong	srv_n_recv_apply_threads = 4;
+
 /* The InnoDB main thread tries to keep the ratio of modified pages
 in the buffer pool to all database pages in the buffer pool smaller than
 the following number. But it is not guaranteed that the value stays below
@@ -390,6 +414,9 @@ unsigned long long	srv_stats_transient_sample_pages = 8;
 my_bool		srv_stats_persistent = TRUE;
 my_bool		srv_stats_include_delete_marked = FALSE;
 unsigned long long	srv_stats_persistent_sample_pages = 20;
+/** Maximum number of buckets in the histograms of integer columns that
+are built with the persistent statistics, or 0 to not build them */
+ulong		srv_stats_histogram_buckets = 0;
 my_bool		srv_stats_auto_recalc = TRUE;
 
 ibool	srv_use_doublewrite_buf	= TRUE;
@@ -626,6 +653,10 @@ static const ulint	SRV_PURGE_SLOT	= 1;
 /** Slot index in the srv_sys->sys_threads array for the master thread. */
 static const ulint	SRV_MASTER_SLOT = 0;
 
+/** Maximum size of a purge batch, relative to innodb_purge_batch_size,
+when the history list keeps growing */
+static const ulint	SRV_PURGE_MAX_BATCH_FACTOR = 4;
+
 #ifdef HAVE_PSI_STAGE_INTERFACE
 /** Performance schema stage event for monitoring ALTER TABLE progress
 everything after flush log_make_checkpoint_at(). */
@@ -2585,6 +2616,7 @@ srv_do_purge(
 	static ulint	count = 0;
 	static ulint	n_use_threads = 0;
 	static ulint	rseg_history_len = 0;
+	static ulint	batch_size = 0;
 	ulint		old_activity_count = srv_get_activity_count();
 
 	ut_a(n_threads > 0);
@@ -2623,12 +2655,33 @@ srv_do_purge(
 			old_activity_count = srv_get_activity_count();
 		}
 
+		DBUG_EXECUTE_IF("srv_purge_use_all_threads",
+				n_use_threads = n_threads;);
+
 		/* Ensure that the purge threads are less than what
 		was configured. */
 
 		ut_a(n_use_threads > 0);
 		ut_a(n_use_threads <= n_threads);
 
+		/* If the history list length keeps growing while all
+		threads are in use, handle more undo log pages in each
+		batch, up to SRV_PURGE_MAX_BATCH_FACTOR times the
+		configured size. Shrink the batches back when purge
+		catches up. */
+		if (n_use_threads == n_threads
+		    && trx_sys->rseg_history_len > rseg_history_len) {
+			batch_size *= 2;
+		} else {
+			batch_size /= 2;
+		}
+
+		batch_size = ut_min(
+			ut_max(batch_size, ulint(srv_purge_batch_size)),
+			SRV_PURGE_MAX_BATCH_FACTOR * srv_purge_batch_size);
+
+		MONITOR_SET(MONITOR_PURGE_BATCH_SIZE, batch_size);
+
 		/* Take a snapshot of the history list before purge. */
 		if ((rseg_history_len = trx_sys->rseg_history_len) == 0) {
 			break;
@@ -2642,7 +2695,7 @@ srv_do_purge(
 			undo_trunc_freq);
 
 		n_pages_purged = trx_purge(
-			n_use_threads, srv_purge_batch_size,
+			n_use_threads, batch_size,
 			(++count % rseg_truncate_frequency) == 0);
 
 		*n_total_purged += n_pages_purged;
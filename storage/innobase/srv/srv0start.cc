@@ -1281,6 +1281,10 @@ srv_shutdown_all_bg_threads()
 				/* d. Wakeup purge threads. */
 				srv_purge_wakeup();
 			}
+
+			/* Wake up the log writer and flusher threads,
+			if they are running */
+			log_wake_background_threads();
 		}
 
 		if (srv_start_state_is_set(SRV_START_STATE_IO)) {
@@ -1572,9 +1576,20 @@ innobase_start_or_create_for_mysql(void)
 #ifdef _WIN32
 	srv_use_native_aio = TRUE;
 
-#elif defined(LINUX_NATIVE_AIO)
+#elif defined(LINUX_NATIVE_AIO) || defined(LINUX_IO_URING)
+
+	if (!srv_use_native_aio) {
+		srv_use_io_uring = FALSE;
+	}
 
-	if (srv_use_native_aio) {
+# ifndef LINUX_NATIVE_AIO
+	/* Only io_uring was compiled in. */
+	srv_use_native_aio = srv_use_io_uring;
+# endif /* !LINUX_NATIVE_AIO */
+
+	if (srv_use_io_uring) {
+		ib::info() << "Using Linux io_uring";
+	} else if (srv_use_native_aio) {
 		ib::info() << "Using Linux native AIO";
 	}
 #else
@@ -1584,6 +1599,10 @@ innobase_start_or_create_for_mysql(void)
 	srv_use_native_aio = FALSE;
 #endif /* _WIN32 */
 
+#ifndef LINUX_IO_URING
+	srv_use_io_uring = FALSE;
+#endif /* !LINUX_IO_URING */
+
 	/* Register performance schema stages before any real work has been
 	started which may need to be instrumented. */
 	mysql_stage_register("innodb", srv_stages, UT_ARR_SIZE(srv_stages));
@@ -1648,6 +1667,7 @@ innobase_start_or_create_for_mysql(void)
 			    + 1 /* buf_dump_thread */
 			    + 1 /* dict_stats_thread */
 			    + 1 /* fts_optimize_thread */
+			    + fts_optimize_threads /* fts_optimize_worker */
 			    + 1 /* recv_writer_thread */
 			    + 1 /* trx_rollback_or_clean_all_recovered */
 			    + 128 /* added as margin, for use of
@@ -1657,6 +1677,7 @@ innobase_start_or_create_for_mysql(void)
 			    + srv_n_write_io_threads
 			    + srv_n_purge_threads
 			    + srv_n_page_cleaners
+			    + srv_buf_pool_instances /* LRU managers */
 			    /* FTS Parallel Sort */
 			    + fts_sort_pll_degree * FTS_NUM_AUX_INDEX
 			      * max_connections;
@@ -2503,6 +2524,18 @@ files_checked:
 	srv_startup_is_before_trx_rollback_phase = false;
 
 	if (!srv_read_only_mode) {
+		if (srv_log_writer_threads) {
+			/* Leave the redo log writes and flushes requested
+			by the committing threads to dedicated threads */
+			log_start_background_threads();
+		}
+
+		if (srv_lru_manager_threads) {
+			/* Keep the free lists filled independently of
+			the flush_list flushing */
+			buf_lru_manager_start();
+		}
+
 		/* Create the thread which watches the timeouts
 		for lock waits */
 		os_thread_create(
@@ -2816,6 +2849,7 @@ innobase_shutdown_for_mysql(void)
 
 	pars_lexer_close();
 	log_mem_free();
+	buf_lru_manager_free();
 	buf_pool_free(srv_buf_pool_instances);
 
 	/* 6. Free the thread management resoruces. */
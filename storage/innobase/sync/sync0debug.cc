@@ -476,6 +476,7 @@ LatchDebug::LatchDebug()
 	LEVEL_MAP_INSERT(RW_LOCK_X);
 	LEVEL_MAP_INSERT(RW_LOCK_NOT_LOCKED);
 	LEVEL_MAP_INSERT(SYNC_MONITOR_MUTEX);
+	LEVEL_MAP_INSERT(SYNC_FIL_SPACE_HASH);
 	LEVEL_MAP_INSERT(SYNC_ANY_LATCH);
 	LEVEL_MAP_INSERT(SYNC_DOUBLEWRITE);
 	LEVEL_MAP_INSERT(SYNC_BUF_FLUSH_LIST);
@@ -501,6 +502,7 @@ LatchDebug::LatchDebug()
 	LEVEL_MAP_INSERT(SYNC_THREADS);
 	LEVEL_MAP_INSERT(SYNC_TRX);
 	LEVEL_MAP_INSERT(SYNC_TRX_SYS);
+	LEVEL_MAP_INSERT(SYNC_LOCK_SYS_SHARD);
 	LEVEL_MAP_INSERT(SYNC_LOCK_SYS);
 	LEVEL_MAP_INSERT(SYNC_LOCK_WAIT_SYS);
 	LEVEL_MAP_INSERT(SYNC_INDEX_ONLINE_LOG);
@@ -767,6 +769,7 @@ LatchDebug::check_order(
 		/* Fall through */
 
 	case SYNC_MONITOR_MUTEX:
+	case SYNC_FIL_SPACE_HASH:
 	case SYNC_RECV:
 	case SYNC_FTS_BG_THREADS:
 	case SYNC_WORK_QUEUE:
@@ -783,6 +786,7 @@ LatchDebug::check_order(
 	case SYNC_SEARCH_SYS:
 	case SYNC_THREADS:
 	case SYNC_LOCK_SYS:
+	case SYNC_LOCK_SYS_SHARD:
 	case SYNC_LOCK_WAIT_SYS:
 	case SYNC_TRX_SYS:
 	case SYNC_IBUF_BITMAP_MUTEX:
@@ -1486,7 +1490,7 @@ sync_latch_meta_init()
 
 	LATCH_ADD_MUTEX(TRX, SYNC_TRX, trx_mutex_key);
 
-	LATCH_ADD_MUTEX(LOCK_SYS, SYNC_LOCK_SYS, lock_mutex_key);
+	LATCH_ADD_MUTEX(LOCK_SYS_SHARD, SYNC_LOCK_SYS_SHARD, lock_mutex_key);
 
 	LATCH_ADD_MUTEX(LOCK_SYS_WAIT, SYNC_LOCK_WAIT_SYS,
 			lock_wait_mutex_key);
@@ -1536,6 +1540,10 @@ sync_latch_meta_init()
 	LATCH_ADD_MUTEX(ROW_DROP_LIST, SYNC_NO_ORDER_CHECK,
 			row_drop_list_mutex_key);
 
+	LATCH_ADD_MUTEX(ROW_MERGE, SYNC_NO_ORDER_CHECK, row_merge_mutex_key);
+
+	LATCH_ADD_MUTEX(ROW_PREAD, SYNC_NO_ORDER_CHECK, row_pread_mutex_key);
+
 	LATCH_ADD_RWLOCK(INDEX_ONLINE_LOG, SYNC_INDEX_ONLINE_LOG,
 			index_online_log_key);
 
@@ -1544,6 +1552,9 @@ sync_latch_meta_init()
 	// Add the RW locks
 	LATCH_ADD_RWLOCK(BTR_SEARCH, SYNC_SEARCH_SYS, btr_search_latch_key);
 
+	LATCH_ADD_RWLOCK(BTR_SEARCH_PAGE, SYNC_SEARCH_SYS,
+			 btr_search_page_latch_key);
+
 #ifndef PFS_SKIP_BUFFER_MUTEX_RWLOCK
 	LATCH_ADD_RWLOCK(BUF_BLOCK_LOCK, SYNC_LEVEL_VARYING,
 			 buf_block_lock_key);
@@ -1564,8 +1575,13 @@ sync_latch_meta_init()
 
 	LATCH_ADD_RWLOCK(CHECKPOINT, SYNC_NO_ORDER_CHECK, checkpoint_lock_key);
 
+	LATCH_ADD_RWLOCK(LOCK_SYS, SYNC_LOCK_SYS, lock_sys_latch_key);
+
 	LATCH_ADD_RWLOCK(FIL_SPACE, SYNC_FSP, fil_space_latch_key);
 
+	LATCH_ADD_RWLOCK(FIL_SPACE_HASH, SYNC_FIL_SPACE_HASH,
+			 hash_table_locks_key);
+
 	LATCH_ADD_RWLOCK(FTS_CACHE, SYNC_FTS_CACHE, fts_cache_rw_lock_key);
 
 	LATCH_ADD_RWLOCK(FTS_CACHE_INIT, SYNC_FTS_CACHE_INIT,
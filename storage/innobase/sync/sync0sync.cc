@@ -115,6 +115,8 @@ mysql_pfs_key_t	sync_array_mutex_key;
 mysql_pfs_key_t	thread_mutex_key;
 mysql_pfs_key_t zip_pad_mutex_key;
 mysql_pfs_key_t row_drop_list_mutex_key;
+mysql_pfs_key_t	row_merge_mutex_key;
+mysql_pfs_key_t	row_pread_mutex_key;
 mysql_pfs_key_t	master_key_id_mutex_key;
 mysql_pfs_key_t	analyze_index_mutex_key;
 
@@ -122,6 +124,7 @@ mysql_pfs_key_t	analyze_index_mutex_key;
 
 #ifdef UNIV_PFS_RWLOCK
 mysql_pfs_key_t	btr_search_latch_key;
+mysql_pfs_key_t	btr_search_page_latch_key;
 #  ifndef PFS_SKIP_BUFFER_MUTEX_RWLOCK
 mysql_pfs_key_t	buf_block_lock_key;
 #  endif /* !PFS_SKIP_BUFFER_MUTEX_RWLOCK */
@@ -129,6 +132,7 @@ mysql_pfs_key_t	buf_block_lock_key;
 mysql_pfs_key_t	buf_block_debug_latch_key;
 # endif /* UNIV_DEBUG */
 mysql_pfs_key_t	checkpoint_lock_key;
+mysql_pfs_key_t	lock_sys_latch_key;
 mysql_pfs_key_t	dict_operation_lock_key;
 mysql_pfs_key_t	dict_table_stats_key;
 mysql_pfs_key_t	hash_table_locks_key;
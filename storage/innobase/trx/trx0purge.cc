@@ -58,6 +58,9 @@ Created 3/26/1996 Heikki Tuuri
 #include "trx0rseg.h"
 #include "trx0trx.h"
 
+#include <algorithm>
+#include <map>
+
 /** Maximum allowable purge history length.  <=0 means 'infinite'. */
 ulong		srv_max_purge_lag = 0;
 
@@ -273,6 +276,10 @@ trx_purge_sys_create(
 	purge_sys->view_active = true;
 
 	purge_sys->rseg_iter = UT_NEW_NOKEY(TrxUndoRsegsIterator(purge_sys));
+
+	purge_sys->heap = mem_heap_create(UNIV_PAGE_SIZE);
+
+	purge_sys->groups = UT_NEW_NOKEY(purge_groups_t());
 }
 
 /************************************************************************
@@ -309,6 +316,10 @@ trx_purge_sys_close(void)
 
 	UT_DELETE(purge_sys->rseg_iter);
 
+	UT_DELETE(purge_sys->groups);
+
+	mem_heap_free(purge_sys->heap);
+
 	ut_free(purge_sys);
 
 	purge_sys = NULL;
@@ -1623,8 +1634,32 @@ trx_purge_fetch_next_rec(
 	return(trx_purge_get_next_rec(n_pages_handled, heap));
 }
 
+/** Undo records of a purge batch, by table id */
+typedef std::map<
+	table_id_t, ib_vector_t*, std::less<table_id_t>,
+	ut_allocator<std::pair<const table_id_t, ib_vector_t*> > >
+	purge_table_map_t;
+
+/** Order the undo record groups of a purge batch, largest first.
+@param[in]	a	undo records of a table
+@param[in]	b	undo records of another table
+@return whether a has more records than b */
+static
+bool
+trx_purge_group_cmp(
+	const ib_vector_t*	a,
+	const ib_vector_t*	b)
+{
+	return(ib_vector_size(a) > ib_vector_size(b));
+}
+
 /*******************************************************************//**
-This function runs a purge batch.
+This function runs a purge batch. The undo records are grouped by table,
+so that the records of a table are purged by one thread and do not
+contend on the index latches of the table with the other threads. Each
+purge thread starts with one of the largest groups, and takes the next
+group that no thread has started when it is done with its own
+(see trx_purge_next_group()).
 @return number of undo log pages handled in the batch */
 static
 ulint
@@ -1634,10 +1669,12 @@ trx_purge_attach_undo_recs(
 	trx_purge_t*	purge_sys,	/*!< in/out: purge instance */
 	ulint		batch_size)	/*!< in: no. of pages to purge */
 {
-	que_thr_t*	thr;
-	ulint		i = 0;
-	ulint		n_pages_handled = 0;
-	ulint		n_thrs = UT_LIST_GET_LEN(purge_sys->query->thrs);
+	que_thr_t*		thr;
+	ulint			i = 0;
+	ulint			n_pages_handled = 0;
+	ulint			n_thrs = UT_LIST_GET_LEN(purge_sys->query->thrs);
+	purge_table_map_t	tables;
+	purge_groups_t*		groups = purge_sys->groups;
 
 	ut_a(n_purge_threads > 0);
 
@@ -1663,28 +1700,16 @@ trx_purge_attach_undo_recs(
 	/* There should never be fewer nodes than threads, the inverse
 	however is allowed because we only use purge threads as needed. */
 	ut_a(i == n_purge_threads);
-
-	/* Fetch and parse the UNDO records. The UNDO records are added
-	to a per purge node vector. */
-	thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
-	ut_a(n_thrs > 0 && thr != NULL);
+	ut_a(n_thrs > 0);
 
 	ut_ad(trx_purge_check_limit());
+	ut_ad(groups->empty());
 
-	i = 0;
-
+	/* Fetch and parse the UNDO records. The UNDO records are added
+	to a per table vector. */
 	for (;;) {
-		purge_node_t*		node;
-		trx_purge_rec_t*	purge_rec;
-
-		ut_a(!thr->is_active);
-
-		/* Get the purge node. */
-		node = (purge_node_t*) thr->child;
-		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
-
-		purge_rec = static_cast<trx_purge_rec_t*>(
-			mem_heap_zalloc(node->heap, sizeof(*purge_rec)));
+		trx_purge_rec_t	purge_rec;
+		table_id_t	table_id = 0;
 
 		/* Track the max {trx_id, undo_no} for truncating the
 		UNDO logs once we have purged the records. */
@@ -1694,44 +1719,84 @@ trx_purge_attach_undo_recs(
 		}
 
 		/* Fetch the next record, and advance the purge_sys->iter. */
-		purge_rec->undo_rec = trx_purge_fetch_next_rec(
-			&purge_rec->roll_ptr, &n_pages_handled, node->heap);
+		purge_rec.undo_rec = trx_purge_fetch_next_rec(
+			&purge_rec.roll_ptr, &n_pages_handled,
+			purge_sys->heap);
 
-		if (purge_rec->undo_rec != NULL) {
+		if (purge_rec.undo_rec == NULL) {
+			break;
+		}
 
-			if (node->undo_recs == NULL) {
-				node->undo_recs = ib_vector_create(
-					ib_heap_allocator_create(node->heap),
-					sizeof(trx_purge_rec_t),
-					batch_size);
-			} else {
-				ut_a(!ib_vector_is_empty(node->undo_recs));
-			}
+		if (purge_rec.undo_rec != &trx_purge_dummy_rec) {
+			ulint		type;
+			ulint		cmpl_info;
+			bool		updated_extern;
+			undo_no_t	undo_no;
 
-			ib_vector_push(node->undo_recs, purge_rec);
+			trx_undo_rec_get_pars(
+				purge_rec.undo_rec, &type, &cmpl_info,
+				&updated_extern, &undo_no, &table_id);
+		}
 
-			if (n_pages_handled >= batch_size) {
+		ib_vector_t*&	recs = tables[table_id];
 
-				break;
-			}
-		} else {
-			break;
+		if (recs == NULL) {
+			recs = ib_vector_create(
+				ib_heap_allocator_create(purge_sys->heap),
+				sizeof(trx_purge_rec_t), 16);
+
+			groups->push_back(recs);
 		}
 
-		thr = UT_LIST_GET_NEXT(thrs, thr);
+		ib_vector_push(recs, &purge_rec);
 
-		if (!(++i % n_purge_threads)) {
-			thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
+		if (n_pages_handled >= batch_size) {
+
+			break;
 		}
+	}
 
-		ut_a(thr != NULL);
+	std::stable_sort(groups->begin(), groups->end(), trx_purge_group_cmp);
+
+	/* Hand out the largest groups to the purge threads. */
+	i = 0;
+
+	for (thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
+	     thr != NULL && i < n_purge_threads && i < groups->size();
+	     thr = UT_LIST_GET_NEXT(thrs, thr), ++i) {
+
+		purge_node_t*	node = (purge_node_t*) thr->child;
+
+		node->undo_recs = (*groups)[i];
 	}
 
+	purge_sys->next_group = i;
+
+	MONITOR_INC_VALUE(MONITOR_PURGE_N_TABLES, groups->size());
+
 	ut_ad(trx_purge_check_limit());
 
 	return(n_pages_handled);
 }
 
+/** Take the undo records of a table that no purge thread has started
+purging in the current batch.
+@return vector of trx_purge_rec_t, or NULL if none is left */
+ib_vector_t*
+trx_purge_next_group()
+{
+	const ulint	n = os_atomic_increment_ulint(
+		&purge_sys->next_group, 1) - 1;
+
+	if (n >= purge_sys->groups->size()) {
+		return(NULL);
+	}
+
+	MONITOR_ATOMIC_INC(MONITOR_PURGE_N_TABLES_TAKEN);
+
+	return((*purge_sys->groups)[n]);
+}
+
 /*******************************************************************//**
 Calculate the DML delay required.
 @return delay in microseconds or ULINT_MAX */
@@ -1749,19 +1814,20 @@ trx_purge_dml_delay(void)
 	Note: we do a dirty read of the trx_sys_t data structure here,
 	without holding trx_sys->mutex. */
 
-	if (srv_max_purge_lag > 0
-	    && trx_sys->rseg_history_len
-	       > srv_n_purge_threads * srv_purge_batch_size) {
-		float	ratio;
+	const ulint	history_len = trx_sys->rseg_history_len;
 
-		ratio = float(trx_sys->rseg_history_len) / srv_max_purge_lag;
+	if (srv_max_purge_lag > 0
+	    && history_len > srv_n_purge_threads * srv_purge_batch_size) {
 
-		if (ratio > 1.0) {
+		if (history_len > srv_max_purge_lag) {
 			/* If the history list length exceeds the
 			srv_max_purge_lag, the data manipulation
-			statements are delayed by at least 5000
-			microseconds. */
-			delay = (ulint) ((ratio - .5) * 10000);
+			statements are delayed in proportion to the
+			excess: 10000 microseconds for each
+			srv_max_purge_lag of it. */
+			delay = static_cast<ulint>(
+				ib_uint64_t(history_len - srv_max_purge_lag)
+				* 10000 / srv_max_purge_lag);
 		}
 
 		if (delay > srv_max_purge_lag_delay) {
@@ -1912,6 +1978,10 @@ run_synchronously:
 	rw_lock_x_unlock(&purge_sys->latch);
 #endif /* UNIV_DEBUG */
 
+	/* Free the undo records of the batch. */
+	purge_sys->groups->clear();
+	mem_heap_empty(purge_sys->heap);
+
 	if (truncate) {
 		trx_purge_truncate();
 	}
@@ -1863,18 +1863,46 @@ trx_update_mod_tables_timestamp(
 	trx->mod_tables.clear();
 }
 
+/** Make the log of a commit durable if innodb_flush_log_at_trx_commit asks
+for it, or leave that to trx_commit_complete_for_mysql().
+@param[in,out]	trx	transaction
+@param[in]	lsn	lsn up to which the log has to be flushed */
+static
+void
+trx_commit_flush_log(
+	trx_t*	trx,
+	lsn_t	lsn)
+{
+	if (lsn == 0) {
+		/* Nothing to be done. */
+	} else if (trx->flush_log_later) {
+		/* Do nothing yet */
+		trx->must_flush_log_later = true;
+	} else if (srv_flush_log_at_trx_commit == 0
+		   || thd_requested_durability(trx->mysql_thd)
+		   == HA_IGNORE_DURABILITY) {
+		/* Do nothing */
+	} else {
+		trx_flush_log_if_needed(lsn, trx);
+	}
+
+	trx->commit_lsn = lsn;
+}
+
 /**
 Erase the transaction from running transaction lists and serialization
 list. Active RW transaction list of a MVCC snapshot(ReadView::prepare)
 won't include this transaction after this call. All implicit locks are
 also released by this call as trx is removed from rw_trx_list.
 @param[in] trx		Transaction to erase, must have an ID > 0
-@param[in] serialised	true if serialisation log was written */
+@param[in] serialised	true if serialisation log was written
+@param[in] commit_lsn	lsn of the commit, or 0 if no log was written */
 static
 void
 trx_erase_lists(
 	trx_t*	trx,
-	bool	serialised)
+	bool	serialised,
+	lsn_t	commit_lsn)
 {
 	ut_ad(trx->id > 0);
 	trx_sys_mutex_enter();
@@ -1883,6 +1911,10 @@ trx_erase_lists(
 		UT_LIST_REMOVE(trx_sys->serialisation_list, trx);
 	}
 
+	if (commit_lsn > trx_sys->max_commit_lsn) {
+		trx_sys->max_commit_lsn = commit_lsn;
+	}
+
 	trx_ids_t::iterator	it = std::lower_bound(
 		trx_sys->rw_trx_ids.begin(),
 		trx_sys->rw_trx_ids.end(),
@@ -1890,6 +1922,8 @@ trx_erase_lists(
 	ut_ad(*it == trx->id);
 	trx_sys->rw_trx_ids.erase(it);
 
+	++trx_sys->snapshot_version;
+
 	if (trx->read_only || trx->rsegs.m_redo.rseg == NULL) {
 
 		ut_ad(!trx->in_rw_trx_list);
@@ -1923,6 +1957,8 @@ trx_commit_in_memory(
 				/*!< in: true if serialisation log was
 				written */
 {
+	lsn_t	commit_lsn = 0;
+
 	trx->must_flush_log_later = false;
 
 	if (trx_is_autocommit_non_locking(trx)) {
@@ -1967,7 +2003,9 @@ trx_commit_in_memory(
 			/* For consistent snapshot, we need to remove current
 			transaction from running transaction id list for mvcc
 			before doing commit and releasing locks. */
-			trx_erase_lists(trx, serialised);
+			trx_erase_lists(
+				trx, serialised,
+				mtr != NULL ? mtr->commit_lsn() : 0);
 		}
 
 		lock_trx_release_locks(trx);
@@ -2030,22 +2068,9 @@ trx_commit_in_memory(
 		mutex would serialize all commits and prevent a group of
 		transactions from gathering. */
 
-		lsn_t	lsn = mtr->commit_lsn();
+		commit_lsn = mtr->commit_lsn();
 
-		if (lsn == 0) {
-			/* Nothing to be done. */
-		} else if (trx->flush_log_later) {
-			/* Do nothing yet */
-			trx->must_flush_log_later = true;
-		} else if (srv_flush_log_at_trx_commit == 0
-			   || thd_requested_durability(trx->mysql_thd)
-			   == HA_IGNORE_DURABILITY) {
-			/* Do nothing */
-		} else {
-			trx_flush_log_if_needed(lsn, trx);
-		}
-
-		trx->commit_lsn = lsn;
+		trx_commit_flush_log(trx, commit_lsn);
 
 		/* Tell server some activity has happened, since the trx
 		does changes something. Background utility threads like
@@ -2054,6 +2079,21 @@ trx_commit_in_memory(
 		srv_active_wake_master_thread();
 	}
 
+	if (commit_lsn == 0 && srv_commit_wait_dependencies) {
+		/* The transaction wrote no log, but it may have read the
+		changes of transactions whose commit is not durable yet:
+		trx_erase_lists() and lock_trx_release_locks() make the
+		changes of a transaction accessible before its log is
+		flushed. Do not let the commit be acknowledged before
+		theirs. A transaction that writes log does not have to
+		wait like this, because its own commit lsn is bigger. */
+		lsn_t	lsn = trx_sys->max_commit_lsn;
+
+		if (lsn > log_sys->flushed_to_disk_lsn) {
+			trx_commit_flush_log(trx, lsn);
+		}
+	}
+
 	/* Do not decrement the reference count before this point.
 	There is a potential issue where a thread attempting to truncate
 	an undo tablespace may end up truncating this undo space
@@ -0,0 +1,424 @@
+/* Copyright (c) 2023, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include "univ.i"
+
+#include "buf0buf.h"
+#include "buf0lru.h"
+
+namespace innodb_buf0lru_unittest {
+
+/** An access to a page in a trace */
+struct access_t {
+	/** time of the access, in milliseconds */
+	ulint		time;
+	/** page that was accessed */
+	page_id_t	page_id;
+
+	access_t(ulint t, ulint space, ulint page_no)
+		: time(t), page_id(space, page_no) {}
+};
+
+/** Hit ratio of a replay */
+struct replay_stat_t {
+	/** number of accesses */
+	ulint	n_gets;
+	/** number of accesses that missed the buffer pool */
+	ulint	n_reads;
+	/** number of misses that the ghost table recognized */
+	ulint	n_ghost_hits;
+
+	/** @return the fraction of the accesses that hit */
+	double hit_ratio() const
+	{
+		return(n_gets ? 1.0 - double(n_reads) / double(n_gets) : 0);
+	}
+};
+
+/** Model of the LRU list of a buffer pool instance. It makes pages
+young and evicts them like buf_page_make_young_if_needed(),
+buf_LRU_add_block() and buf_LRU_free_page(), and keeps the same table of
+evicted pages as the buffer pool under BUF_LRU_POLICY_2Q. */
+class LRU_model {
+public:
+	/** Constructor.
+	@param[in]	size		number of pages that fit
+	@param[in]	policy		buf_LRU_policy_t
+	@param[in]	old_ratio	innodb_old_blocks_pct
+	@param[in]	old_time	innodb_old_blocks_time */
+	LRU_model(ulint size, ulint policy, ulint old_ratio, ulint old_time)
+		: m_size(size), m_policy(policy),
+		  m_old_len(size * old_ratio / 100), m_old_time(old_time),
+		  m_freed_page_clock(0)
+	{
+		memset(&m_stat, 0, sizeof m_stat);
+		buf_LRU_ghost_create(&m_ghost, size / 2);
+	}
+
+	~LRU_model()
+	{
+		buf_LRU_ghost_free(&m_ghost);
+	}
+
+	/** Access a page.
+	@param[in]	access	the access */
+	void get(const access_t& access)
+	{
+		const ib_uint64_t	key = (ib_uint64_t(
+			access.page_id.space()) << 32)
+			| access.page_id.page_no();
+		pages_t::iterator	it = m_pages.find(key);
+
+		m_stat.n_gets++;
+
+		if (it == m_pages.end()) {
+			read(key, access);
+			return;
+		}
+
+		cached_t&	page = it->second;
+
+		if (page.old) {
+			/* buf_page_peek_if_too_old() */
+			if (m_policy == BUF_LRU_POLICY_2Q
+			    || access.time - page.access_time < m_old_time) {
+				return;
+			}
+
+			m_old.erase(page.pos);
+		} else {
+			/* buf_page_peek_if_young() */
+			if (m_freed_page_clock - page.freed_page_clock
+			    < m_size / 4) {
+				return;
+			}
+
+			m_young.erase(page.pos);
+		}
+
+		make_young(page, key);
+	}
+
+	/** @return the statistics of the replay */
+	const replay_stat_t& stat() const
+	{
+		return(m_stat);
+	}
+
+private:
+	/** A page in the model of the buffer pool */
+	struct cached_t {
+		/** position in m_young or m_old */
+		std::list<ib_uint64_t>::iterator	pos;
+		/** whether the page is in m_old */
+		bool					old;
+		/** time of the first access, in milliseconds */
+		ulint					access_time;
+		/** m_freed_page_clock when the page was made young */
+		ulint					freed_page_clock;
+	};
+
+	typedef std::map<ib_uint64_t, cached_t>	pages_t;
+
+	/** Read a page that is not in the buffer pool.
+	@param[in]	key	key of the page in m_pages
+	@param[in]	access	the access */
+	void read(ib_uint64_t key, const access_t& access)
+	{
+		cached_t	page;
+
+		m_stat.n_reads++;
+
+		if (m_pages.size() >= m_size) {
+			evict();
+		}
+
+		page.access_time = access.time;
+
+		if (m_policy == BUF_LRU_POLICY_2Q
+		    && buf_LRU_ghost_remove(&m_ghost, access.page_id)) {
+			m_stat.n_ghost_hits++;
+			make_young(page, key);
+			return;
+		}
+
+		m_old.push_front(key);
+		page.pos = m_old.begin();
+		page.old = true;
+		m_pages[key] = page;
+
+		/* buf_LRU_old_adjust_len() moves the boundary, leaving the
+		first old blocks in the new blocks. */
+		while (m_old.size() > m_old_len) {
+			const ib_uint64_t	first = m_old.front();
+			cached_t&		moved = m_pages[first];
+
+			m_old.pop_front();
+			m_young.push_back(first);
+			moved.pos = --m_young.end();
+			moved.old = false;
+			moved.freed_page_clock = m_freed_page_clock;
+		}
+	}
+
+	/** Move a page to the head of the LRU list, and keep the length
+	of the old blocks.
+	@param[in,out]	page	the page
+	@param[in]	key	key of the page in m_pages */
+	void make_young(cached_t& page, ib_uint64_t key)
+	{
+		m_young.push_front(key);
+		page.pos = m_young.begin();
+		page.old = false;
+		page.freed_page_clock = m_freed_page_clock;
+		m_pages[key] = page;
+
+		while (m_young.size() > m_size - m_old_len) {
+			const ib_uint64_t	last = m_young.back();
+			cached_t&		moved = m_pages[last];
+
+			m_young.pop_back();
+			m_old.push_front(last);
+			moved.pos = m_old.begin();
+			moved.old = true;
+		}
+	}
+
+	/** Evict the page at the tail of the LRU list. */
+	void evict()
+	{
+		std::list<ib_uint64_t>&	list = m_old.empty() ? m_young : m_old;
+		const ib_uint64_t	key = list.back();
+
+		list.pop_back();
+		m_pages.erase(key);
+		m_freed_page_clock++;
+
+		if (m_policy == BUF_LRU_POLICY_2Q) {
+			buf_LRU_ghost_insert(
+				&m_ghost, page_id_t(ulint(key >> 32),
+						    ulint(key & 0xFFFFFFFF)));
+		}
+	}
+
+	/** number of pages that fit */
+	const ulint		m_size;
+	/** buf_LRU_policy_t */
+	const ulint		m_policy;
+	/** length of the old blocks */
+	const ulint		m_old_len;
+	/** innodb_old_blocks_time */
+	const ulint		m_old_time;
+	/** number of evicted pages */
+	ulint			m_freed_page_clock;
+	/** the new blocks, the most recently used first */
+	std::list<ib_uint64_t>	m_young;
+	/** the old blocks, the most recently used first */
+	std::list<ib_uint64_t>	m_old;
+	/** the pages in the buffer pool */
+	pages_t			m_pages;
+	/** table of recently evicted pages */
+	buf_LRU_ghost_t		m_ghost;
+	/** statistics of the replay */
+	replay_stat_t		m_stat;
+};
+
+/** Replay a trace.
+@param[in]	trace		the trace
+@param[in]	size		number of pages that fit in the buffer pool
+@param[in]	policy		buf_LRU_policy_t
+@param[in]	old_time	innodb_old_blocks_time
+@return the statistics of the replay */
+static
+replay_stat_t
+replay(
+	const std::vector<access_t>&	trace,
+	ulint				size,
+	ulint				policy,
+	ulint				old_time)
+{
+	LRU_model	model(size, policy, 37, old_time);
+
+	for (std::vector<access_t>::const_iterator it = trace.begin();
+	     it != trace.end(); ++it) {
+		model.get(*it);
+	}
+
+	return(model.stat());
+}
+
+/** Load a trace of page accesses that was recorded as lines of
+"time_in_milliseconds space_id page_no".
+@param[in]	name	file name
+@param[out]	trace	the trace
+@return whether the file could be read */
+static
+bool
+load_trace(const char* name, std::vector<access_t>* trace)
+{
+	FILE*		f = fopen(name, "r");
+	unsigned long	time;
+	unsigned long	space;
+	unsigned long	page_no;
+
+	if (f == NULL) {
+		return(false);
+	}
+
+	while (fscanf(f, "%lu %lu %lu", &time, &space, &page_no) == 3) {
+		trace->push_back(access_t(time, space, page_no));
+	}
+
+	fclose(f);
+
+	return(true);
+}
+
+/** Generate a trace of an OLTP workload on a skewed set of pages that
+is larger than the buffer pool and slowly moves, while a report scans a
+table that is larger than the buffer pool. The report processes the rows of a page for longer than
+innodb_old_blocks_time, so that each page of the table is accessed again
+after it has been in the buffer pool for a while.
+@param[in]	size	number of pages that fit in the buffer pool
+@param[out]	trace	the trace */
+static
+void
+make_scan_trace(ulint size, std::vector<access_t>* trace)
+{
+	const ulint	n_hot = size * 4;
+	const ulint	n_scan = size * 3;
+	ulint		rnd = 1;
+	ulint		time = 0;
+
+	for (ulint round = 0; round < 5; round++) {
+		/* Every round, a quarter of the hot set is new. */
+		const ulint	hot_start = round * n_hot / 4;
+
+		for (ulint page_no = 0; page_no < n_scan; page_no++) {
+			for (ulint i = 0; i < 3; i++) {
+				trace->push_back(access_t(time, 2, page_no));
+
+				for (ulint j = 0; j < 20; j++) {
+					rnd = rnd * 1103515245 + 12345;
+
+					/* Skew the accesses to the
+					first pages of the hot set. */
+					const double	u = double(
+						(rnd >> 16) & 0x7FFF)
+						/ 0x8000;
+
+					trace->push_back(access_t(
+						time, 1, hot_start
+						+ ulint(u * u * u * n_hot)));
+					time += 30;
+				}
+			}
+		}
+	}
+}
+
+/** Print the hit ratio of a replay.
+@param[in]	name	name of the replay
+@param[in]	stat	statistics of the replay */
+static
+void
+print_stat(const char* name, const replay_stat_t& stat)
+{
+	printf("%-24s gets %8lu reads %8lu ghost hits %8lu hit ratio %.4f\n",
+	       name, static_cast<unsigned long>(stat.n_gets),
+	       static_cast<unsigned long>(stat.n_reads),
+	       static_cast<unsigned long>(stat.n_ghost_hits),
+	       stat.hit_ratio());
+}
+
+/* Check the table of recently evicted pages. */
+TEST(buf0lru, ghost)
+{
+	buf_LRU_ghost_t	ghost;
+
+	buf_LRU_ghost_create(&ghost, 100);
+
+	EXPECT_FALSE(buf_LRU_ghost_remove(&ghost, page_id_t(0, 0)));
+
+	buf_LRU_ghost_insert(&ghost, page_id_t(0, 0));
+	buf_LRU_ghost_insert(&ghost, page_id_t(5, 7));
+
+	EXPECT_FALSE(buf_LRU_ghost_remove(&ghost, page_id_t(7, 5)));
+	EXPECT_TRUE(buf_LRU_ghost_remove(&ghost, page_id_t(5, 7)));
+	/* A page is forgotten when it is read again. */
+	EXPECT_FALSE(buf_LRU_ghost_remove(&ghost, page_id_t(5, 7)));
+	EXPECT_TRUE(buf_LRU_ghost_remove(&ghost, page_id_t(0, 0)));
+
+	buf_LRU_ghost_free(&ghost);
+}
+
+/* Replay the trace named by the environment variable INNODB_LRU_TRACE,
+or a generated trace of table scans, under each LRU policy. The size of
+the buffer pool in pages is INNODB_LRU_TRACE_SIZE, 1000 by default. */
+TEST(buf0lru, replay)
+{
+	std::vector<access_t>	trace;
+	const char*		name = getenv("INNODB_LRU_TRACE");
+	const char*		size_str = getenv("INNODB_LRU_TRACE_SIZE");
+	const ulint		size = size_str != NULL
+		? strtoul(size_str, NULL, 10) : 1000;
+
+	if (name == NULL || !load_trace(name, &trace)) {
+		name = NULL;
+		make_scan_trace(size, &trace);
+	}
+
+	const replay_stat_t	midpoint_0 = replay(
+		trace, size, BUF_LRU_POLICY_MIDPOINT, 0);
+	const replay_stat_t	midpoint = replay(
+		trace, size, BUF_LRU_POLICY_MIDPOINT, 1000);
+	const replay_stat_t	twoq = replay(
+		trace, size, BUF_LRU_POLICY_2Q, 1000);
+
+	print_stat("midpoint, old time 0", midpoint_0);
+	print_stat("midpoint, old time 1000", midpoint);
+	print_stat("2q", twoq);
+
+	if (name == NULL) {
+		/* 2Q must keep the hot pages over the scans. */
+		EXPECT_GE(twoq.hit_ratio(), midpoint_0.hit_ratio());
+		EXPECT_GE(twoq.hit_ratio() + 0.01, midpoint.hit_ratio());
+		EXPECT_TRUE(twoq.n_ghost_hits > 0);
+	}
+}
+
+}
@@ -0,0 +1,237 @@
+/* Copyright (c) 2023, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "univ.i"
+
+#include "dict0mem.h"
+#include "dict0stats.h"
+
+namespace innodb_dict0stats_unittest {
+
+/** Length of the INT columns of the tests */
+static const ulint	INT_LEN = 4;
+
+/** Make an INT column.
+@param[out]	col		column
+@param[in]	is_unsigned	whether the column is INT UNSIGNED */
+static
+void
+make_int_col(dict_col_t* col, bool is_unsigned)
+{
+	ulint	prtype = MYSQL_TYPE_LONG;
+
+	if (is_unsigned) {
+		prtype |= DATA_UNSIGNED;
+	}
+
+	memset(col, 0, sizeof *col);
+	dict_mem_fill_column_struct(col, 0, DATA_INT, prtype, INT_LEN);
+}
+
+/** Convert a value of an INT column as InnoDB stores it.
+@param[in]	value		value of the column
+@param[in]	is_unsigned	whether the column is INT UNSIGNED
+@return value in the format of dict_col_hist_t */
+static
+ib_uint64_t
+stored(int64_t value, bool is_unsigned)
+{
+	ib_uint64_t	v = static_cast<ib_uint64_t>(value);
+
+	if (!is_unsigned) {
+		/* The sign bit is inverted. */
+		v += ib_uint64_t(1) << (8 * INT_LEN - 1);
+	}
+
+	return(v & 0xFFFFFFFF);
+}
+
+/* Only integer columns get a histogram. */
+TEST(dict0stats, hist_col_ok)
+{
+	dict_col_t	col;
+
+	make_int_col(&col, false);
+	EXPECT_TRUE(dict_stats_hist_col_ok(&col));
+
+	make_int_col(&col, true);
+	EXPECT_TRUE(dict_stats_hist_col_ok(&col));
+
+	memset(&col, 0, sizeof col);
+	dict_mem_fill_column_struct(&col, 0, DATA_INT, MYSQL_TYPE_YEAR, 1);
+	EXPECT_FALSE(dict_stats_hist_col_ok(&col));
+
+	memset(&col, 0, sizeof col);
+	dict_mem_fill_column_struct(&col, 0, DATA_DOUBLE, MYSQL_TYPE_DOUBLE, 8);
+	EXPECT_FALSE(dict_stats_hist_col_ok(&col));
+}
+
+/* A column with fewer distinct values than buckets gets a bucket for
+each value, and the estimates are exact. */
+TEST(dict0stats, hist_singleton)
+{
+	dict_col_t			col;
+	dict_col_hist_t			hist;
+	std::vector<ib_uint64_t>	values;
+
+	make_int_col(&col, false);
+
+	/* -2 once, 0 twice, 3 three times, 5 four times, and two NULLs */
+	static const int	data[][2] = {{-2, 1}, {0, 2}, {3, 3}, {5, 4}};
+
+	for (ulint i = 0; i < 4; i++) {
+		for (int j = 0; j < data[i][1]; j++) {
+			values.push_back(stored(data[i][0], false));
+		}
+	}
+
+	dict_stats_hist_build(&hist, 7, &values[0], values.size(), 12, 8);
+
+	EXPECT_EQ(7U, hist.col_no);
+	EXPECT_EQ(12U, hist.n_rows);
+	EXPECT_EQ(4U, hist.n_distinct);
+	EXPECT_EQ(4U, hist.n_buckets);
+	EXPECT_EQ(stored(-2, false), hist.lower);
+	EXPECT_EQ(stored(5, false), hist.upper[3]);
+	EXPECT_EQ(10U, hist.n_le[3]);
+
+	EXPECT_NEAR(3.0 / 12,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_EQ, 3),
+		    1e-9);
+	EXPECT_NEAR(3.0 / 12,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_LT, 3),
+		    1e-9);
+	EXPECT_NEAR(6.0 / 12,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_LE, 3),
+		    1e-9);
+	EXPECT_NEAR(4.0 / 12,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_GT, 3),
+		    1e-9);
+	EXPECT_NEAR(7.0 / 12,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_GE, 2.5),
+		    1e-9);
+	EXPECT_NEAR(1.0 / 12,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_LT, -1),
+		    1e-9);
+
+	/* Values that are not in the sample get half a record. */
+	EXPECT_NEAR(0.5 / 12,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_EQ, 4),
+		    1e-9);
+	EXPECT_NEAR(0.5 / 12,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_EQ, 3.5),
+		    1e-9);
+	EXPECT_NEAR(0.5 / 12,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_GT, 5),
+		    1e-9);
+	EXPECT_NEAR(0.5 / 12,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_LT, -2),
+		    1e-9);
+}
+
+/* A column with more distinct values than buckets gets buckets that
+hold about the same number of values. */
+TEST(dict0stats, hist_equi_height)
+{
+	dict_col_t			col;
+	dict_col_hist_t			hist;
+	std::vector<ib_uint64_t>	values;
+
+	make_int_col(&col, true);
+
+	/* 0, 2, 4, ..., 1998 in descending order */
+	for (ulint i = 1000; i-- > 0; ) {
+		values.push_back(stored(2 * i, true));
+	}
+
+	dict_stats_hist_build(&hist, 0, &values[0], values.size(), 1000, 10);
+
+	EXPECT_EQ(1000U, hist.n_distinct);
+	EXPECT_EQ(10U, hist.n_buckets);
+	EXPECT_EQ(0U, hist.lower);
+
+	for (ulint b = 0; b < hist.n_buckets; b++) {
+		EXPECT_EQ((b + 1) * 100, hist.n_le[b]);
+		EXPECT_EQ(200 * b + 198, hist.upper[b]);
+	}
+
+	EXPECT_NEAR(0.5,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_LT, 1000),
+		    0.01);
+	EXPECT_NEAR(0.25,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_GE, 1500),
+		    0.01);
+	EXPECT_NEAR(0.1,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_LE, 199),
+		    0.01);
+	EXPECT_NEAR(1.0 / 1000,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_EQ, 1000),
+		    1e-4);
+	EXPECT_NEAR(1.0,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_LE, 5000),
+		    1e-9);
+}
+
+/* A frequent value gets buckets of its own, so that ranges that contain
+it are estimated well. */
+TEST(dict0stats, hist_skew)
+{
+	dict_col_t			col;
+	dict_col_hist_t			hist;
+	std::vector<ib_uint64_t>	values;
+
+	make_int_col(&col, false);
+
+	/* -1000..-1 and 1..1000 once, 0 2000 times */
+	for (int i = 1; i <= 1000; i++) {
+		values.push_back(stored(i, false));
+		values.push_back(stored(-i, false));
+	}
+
+	values.insert(values.end(), 2000, stored(0, false));
+
+	dict_stats_hist_build(&hist, 0, &values[0], values.size(), 4000, 20);
+
+	EXPECT_EQ(2001U, hist.n_distinct);
+
+	EXPECT_NEAR(0.75,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_LE, 0),
+		    0.01);
+	EXPECT_NEAR(0.25,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_LT, 0),
+		    0.01);
+	EXPECT_NEAR(0.25,
+		    dict_stats_hist_estimate(&hist, &col, DICT_HIST_GT, 0),
+		    0.01);
+}
+
+}
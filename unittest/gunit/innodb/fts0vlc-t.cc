@@ -0,0 +1,161 @@
+/* Copyright (c) 2023, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "univ.i"
+
+#include "fts0types.h"
+#include "fts0tokenize.h"
+#include "ut0rnd.h"
+
+namespace innodb_fts0vlc_unittest {
+
+/** Values that encode to 1 to 5 bytes, some of them with 0x00 bytes
+after the first one. */
+static const ulint	values[] = {
+	1, 2, 127, 128, 129, 255, 16383, 16384, 2097151, 2097152,
+	268435455, 268435456, 4294967295u
+};
+
+/** Append a random list of word positions to an ilist.
+@param[in,out]	ilist	ilist
+@param[in]	n	number of positions
+@param[in,out]	seed	random seed */
+static
+void
+append_positions(
+	std::vector<byte>&	ilist,
+	ulint			n,
+	ulint*			seed)
+{
+	byte	buf[5];
+
+	for (ulint i = 0; i < n; ++i) {
+		*seed = ut_rnd_gen_next_ulint(*seed);
+
+		ulint	val = values[*seed % UT_ARR_SIZE(values)];
+		ulint	len = fts_encode_int(val, buf);
+
+		ilist.insert(ilist.end(), buf, buf + len);
+	}
+
+	ilist.push_back(0);
+}
+
+/* fts_skip_positions() stops at the same byte as decoding the positions
+one by one, whatever the alignment of the lists and the end of the
+ilist. */
+TEST(fts0vlc, skip_positions)
+{
+	ulint	seed = 12345;
+
+	for (ulint n_docs = 1; n_docs < 40; ++n_docs) {
+		std::vector<byte>	ilist;
+		std::vector<ulint>	n_positions;
+
+		for (ulint i = 0; i < n_docs; ++i) {
+			seed = ut_rnd_gen_next_ulint(seed);
+
+			ulint	n = seed % 20;
+
+			n_positions.push_back(n);
+			append_positions(ilist, n, &seed);
+		}
+
+		const byte*	end = &ilist[0] + ilist.size();
+		byte*		ptr = &ilist[0];
+		byte*		dec = &ilist[0];
+
+		for (ulint i = 0; i < n_docs; ++i) {
+			ulint	n = 0;
+
+			while (*dec) {
+				fts_decode_vlc(&dec);
+				++n;
+			}
+
+			++dec;
+
+			EXPECT_EQ(n_positions[i], n);
+			EXPECT_EQ(n, fts_skip_positions(&ptr, end));
+			EXPECT_EQ(dec, ptr);
+		}
+
+		EXPECT_EQ(end, ptr);
+	}
+}
+
+/** Check fts_get_ctype() against the charset.
+@param[in]	cs	charset
+@param[in]	str	text */
+static
+void
+check_ctype(
+	const CHARSET_INFO*	cs,
+	const char*		str)
+{
+	const byte*	p = reinterpret_cast<const byte*>(str);
+	const byte*	end = p + strlen(str);
+
+	while (p < end) {
+		int	ctype;
+		int	expected;
+		int	mbl = fts_get_ctype(cs, &ctype, p, end);
+
+		EXPECT_EQ(cs->cset->ctype(cs, &expected, p, end), mbl);
+		EXPECT_EQ(true_word_char(expected, *p),
+			  true_word_char(ctype, *p));
+
+		p += mbl > 0 ? mbl : (mbl < 0 ? -mbl : 1);
+	}
+}
+
+/* The single-byte fast paths classify characters like the charset. */
+TEST(fts0vlc, get_ctype)
+{
+	char	ascii[128];
+
+	for (ulint i = 1; i < sizeof ascii; ++i) {
+		ascii[i - 1] = static_cast<char>(i);
+	}
+
+	ascii[sizeof ascii - 1] = 0;
+
+	check_ctype(&my_charset_latin1, ascii);
+	check_ctype(&my_charset_utf8_general_ci, ascii);
+	check_ctype(&my_charset_utf8mb4_general_ci, ascii);
+
+	check_ctype(&my_charset_latin1, "caf\xe9 na\xefve _x1");
+	check_ctype(&my_charset_utf8mb4_general_ci,
+		    "caf\xc3\xa9 na\xc3\xafve \xe2\x82\xac" "5 \xf0\x9f\x98\x80");
+}
+
+}
@@ -0,0 +1,558 @@
+/* Copyright (c) 2023, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <vector>
+
+#include "m_ctype.h"
+#include "my_sys.h"
+
+#include "univ.i"
+
+#include "buf0buf.h"
+#include "dict0dict.h"
+#include "dict0mem.h"
+#include "fsp0sysspace.h"
+#include "mem0mem.h"
+#include "os0event.h"
+#include "page0cur.h"
+#include "page0page.h"
+#include "page0zip.h"
+#include "rem0rec.h"
+#include "srv0srv.h"
+#include "trx0undo.h"
+#include "ut0rnd.h"
+
+namespace innodb_page0zip_unittest {
+
+/** Size of the compressed pages (KEY_BLOCK_SIZE=8) */
+static const ulint	ZIP_SIZE = 8192;
+
+/** Compression level, as innodb_compression_level=6 */
+static const ulint	LEVEL = 6;
+
+/** Values of the name column */
+static const char*	names[] = {
+	"alpha", "bravo", "charlie", "delta", "echo", "foxtrot"
+};
+
+/** Clustered index (id, DB_TRX_ID, DB_ROLL_PTR, counter, name) of the
+table CREATE TABLE t1 (id INT UNSIGNED PRIMARY KEY, counter INT UNSIGNED
+NOT NULL, name VARCHAR(20) NOT NULL) CHARSET=latin1
+ROW_FORMAT=COMPRESSED */
+static dict_index_t*	index;
+
+class page0zip : public ::testing::Test {
+protected:
+	static
+	void
+	SetUpTestCase()
+	{
+		srv_max_n_threads = srv_sync_array_size + 1;
+		os_event_global_init();
+		sync_check_init();
+
+		/* The pages are built in blocks of the temporary
+		tablespace, which are modified without latching them. */
+		srv_buf_pool_instances = 1;
+		srv_tmp_space.set_space_id(1);
+
+		/* Initialize all_charsets[] for the name column. */
+		ASSERT_STREQ("latin1_swedish_ci",
+			     get_charset_name(my_charset_latin1.number));
+
+		dict_table_t*	table = dict_mem_table_create(
+			"test/t1", 1, 3, 0, DICT_TF_COMPACT, 0);
+
+		dict_mem_table_add_col(table, table->heap, "id", DATA_INT,
+				       DATA_NOT_NULL | DATA_UNSIGNED, 4);
+		dict_mem_table_add_col(table, table->heap, "counter",
+				       DATA_INT,
+				       DATA_NOT_NULL | DATA_UNSIGNED, 4);
+		dict_mem_table_add_col(table, table->heap, "name",
+				       DATA_VARCHAR,
+				       dtype_form_prtype(
+					       DATA_NOT_NULL,
+					       my_charset_latin1.number),
+				       20);
+		dict_table_add_system_columns(table, table->heap);
+
+		index = dict_mem_index_create(
+			"test/t1", "PRIMARY", 1,
+			DICT_CLUSTERED | DICT_UNIQUE, 5);
+		index->table = table;
+		index->id = 42;
+
+		dict_index_add_col(index, table,
+				   dict_table_get_nth_col(table, 0), 0);
+		dict_index_add_col(index, table,
+				   dict_table_get_sys_col(table, DATA_TRX_ID),
+				   0);
+		dict_index_add_col(index, table,
+				   dict_table_get_sys_col(table,
+							  DATA_ROLL_PTR),
+				   0);
+		dict_index_add_col(index, table,
+				   dict_table_get_nth_col(table, 1), 0);
+		dict_index_add_col(index, table,
+				   dict_table_get_nth_col(table, 2), 0);
+
+		index->n_uniq = 1;
+		index->trx_id_offset = 4;
+		/* avoid ut_ad(index->cached) in
+		dict_index_get_n_unique_in_tree() */
+		index->cached = TRUE;
+	}
+	static
+	void
+	TearDownTestCase()
+	{
+		dict_table_t*	table = index->table;
+
+		dict_mem_index_free(index);
+		dict_mem_table_free(table);
+
+		sync_check_close();
+		os_event_global_destroy();
+	}
+};
+
+/** An index page in a block of its own */
+class page_buf {
+public:
+	page_buf()
+		: m_mem(UNIV_PAGE_SIZE * 2)
+	{
+		m_block = static_cast<buf_block_t*>(
+			ut_zalloc_nokey(sizeof *m_block));
+		m_block->frame = static_cast<byte*>(
+			ut_align(&m_mem[0], UNIV_PAGE_SIZE));
+		m_block->page.state = BUF_BLOCK_MEMORY;
+		m_block->page.id.reset(srv_tmp_space.space_id(), 0);
+	}
+
+	~page_buf()
+	{
+		ut_free(m_block);
+	}
+
+	/** @return the page frame */
+	page_t* page() const
+	{
+		return(m_block->frame);
+	}
+
+	/** @return the block */
+	buf_block_t* block() const
+	{
+		return(m_block);
+	}
+
+private:
+	/** Memory for the frame */
+	std::vector<byte>	m_mem;
+	/** Block descriptor */
+	buf_block_t*		m_block;
+};
+
+/** A compressed page */
+class zip_buf {
+public:
+	zip_buf()
+		: m_mem(ZIP_SIZE)
+	{
+		page_zip_des_init(&m_zip);
+		m_zip.data = &m_mem[0];
+		page_zip_set_size(&m_zip, ZIP_SIZE);
+	}
+
+	/** @return the descriptor */
+	page_zip_des_t* zip()
+	{
+		return(&m_zip);
+	}
+
+	/** @return whether the compressed stream is in the LZ4 format */
+	bool is_lz4() const
+	{
+		return(m_zip.data[PAGE_DATA] == 0x01);
+	}
+
+	/** @return length of the compressed stream */
+	ulint stream_len() const
+	{
+		return(m_zip.m_end - PAGE_DATA);
+	}
+
+private:
+	/** Memory for the compressed page */
+	std::vector<byte>	m_mem;
+	/** Compressed page descriptor */
+	page_zip_des_t		m_zip;
+};
+
+/** Build the data tuple of a leaf record, like it is written by an
+INSERT that assigns consecutive ids and was committed in a few
+transactions.
+@param[in]	seed	seed of the page
+@param[in]	i	number of the record on the page
+@param[in,out]	heap	memory heap
+@return data tuple */
+static
+dtuple_t*
+make_leaf_tuple(
+	ulint		seed,
+	ulint		i,
+	mem_heap_t*	heap)
+{
+	const ulint	rnd = ut_rnd_gen_next_ulint(seed * 1000 + i);
+	dtuple_t*	tuple = dtuple_create(heap, 5);
+	byte*		buf = static_cast<byte*>(mem_heap_alloc(heap, 48));
+
+	dict_index_copy_types(tuple, index, 5);
+
+	mach_write_to_4(buf, seed * 10000 + i);
+	mach_write_to_6(buf + 4, 0x1234 + seed * 100 + i / 16);
+	trx_write_roll_ptr(buf + 10, trx_undo_build_roll_ptr(
+				   TRUE, 1 + seed % 32, 300 + i / 64,
+				   38 + (i % 64) * 60));
+	mach_write_to_4(buf + 17, rnd % 1000);
+
+	int	len = ut_snprintf(reinterpret_cast<char*>(buf + 21), 20,
+			       "%s-%04lu", names[rnd % UT_ARR_SIZE(names)],
+			       static_cast<unsigned long>(rnd % 10000));
+
+	dfield_set_data(dtuple_get_nth_field(tuple, 0), buf, 4);
+	dfield_set_data(dtuple_get_nth_field(tuple, 1), buf + 4, 6);
+	dfield_set_data(dtuple_get_nth_field(tuple, 2), buf + 10, 7);
+	dfield_set_data(dtuple_get_nth_field(tuple, 3), buf + 17, 4);
+	dfield_set_data(dtuple_get_nth_field(tuple, 4), buf + 21, len);
+
+	return(tuple);
+}
+
+/** Build an index page of the table, with the records that
+make_leaf_tuple() creates, or node pointers to the leaf pages.
+@param[out]	page	page
+@param[in]	level	0 for a leaf page, 1 for a page of node pointers
+@param[in]	seed	seed of the page
+@param[in]	n	number of records
+@return whether the records fit on the page */
+static
+bool
+make_page(
+	page_buf&	page,
+	ulint		level,
+	ulint		seed,
+	ulint		n)
+{
+	mem_heap_t*	heap = mem_heap_create(1024);
+	bool		fit = true;
+
+	page_parse_create(page.block(), TRUE, false);
+	page_t*	frame = page.page();
+
+	mach_write_to_8(frame + PAGE_HEADER + PAGE_INDEX_ID, index->id);
+	mach_write_to_2(frame + PAGE_HEADER + PAGE_LEVEL, level);
+
+	rec_t*	last = page_get_infimum_rec(frame);
+
+	for (ulint i = 0; fit && i < n; i++) {
+		dtuple_t*	tuple = make_leaf_tuple(seed, i, heap);
+		byte*		buf = static_cast<byte*>(mem_heap_alloc(
+			heap, rec_get_converted_size(index, tuple, 0)));
+		rec_t*		rec = rec_convert_dtuple_to_rec(
+			buf, index, tuple, 0);
+
+		if (level > 0) {
+			/* The leaf pages are allocated in order. */
+			tuple = dict_index_build_node_ptr(
+				index, rec, 4 + seed * 1000 + i, heap,
+				level - 1);
+			buf = static_cast<byte*>(mem_heap_alloc(
+				heap,
+				rec_get_converted_size(index, tuple, 0)));
+			rec = rec_convert_dtuple_to_rec(
+				buf, index, tuple, 0);
+		}
+
+		ulint*	offsets = rec_get_offsets(
+			rec, index, NULL, ULINT_UNDEFINED, &heap);
+
+		last = page_cur_insert_rec_low(last, index, rec, offsets,
+					       NULL);
+		fit = last != NULL;
+		mem_heap_empty(heap);
+	}
+
+	mem_heap_free(heap);
+
+	return(fit);
+}
+
+/** Compress a page.
+@param[out]	zip	compressed page
+@param[in]	page	page
+@param[in]	codec	codec
+@return whether the page was compressed */
+static
+bool
+compress(
+	zip_buf&		zip,
+	const page_buf&		page,
+	page_zip_codec_t	codec)
+{
+	return(page_zip_compress(zip.zip(), page.page(), index,
+				 LEVEL | codec << PAGE_ZIP_LEVEL_CODEC_SHIFT,
+				 NULL, NULL));
+}
+
+/** Check if a page with some records compresses with a codec.
+@param[out]	page	page
+@param[in]	level	0 for a leaf page, 1 for a page of node pointers
+@param[in]	seed	seed of the page
+@param[in]	n	number of records
+@param[in]	codec	codec
+@return whether the page fits in a compressed page with the codec */
+static
+bool
+page_fits(
+	page_buf&		page,
+	ulint			level,
+	ulint			seed,
+	ulint			n,
+	page_zip_codec_t	codec)
+{
+	zip_buf	zip;
+
+	/* Pages that do not fit with LZ4 are compressed with zlib. */
+	return(make_page(page, level, seed, n)
+	       && compress(zip, page, codec)
+	       && zip.is_lz4() == (codec == PAGE_ZIP_CODEC_LZ4));
+}
+
+/** Build a page that is as full as the B-tree would fill a compressed
+page of the table with one codec: the page compresses with the codec,
+but not with one more record.
+@param[out]	page	page
+@param[in]	level	0 for a leaf page, 1 for a page of node pointers
+@param[in]	seed	seed of the page
+@param[in]	codec	codec
+@return number of records on the page */
+static
+ulint
+fill_page(
+	page_buf&		page,
+	ulint			level,
+	ulint			seed,
+	page_zip_codec_t	codec)
+{
+	ulint	n = 0;
+
+	for (ulint step = 256; step > 0; ) {
+		if (page_fits(page, level, seed, n + step, codec)) {
+			n += step;
+		} else {
+			step /= 2;
+		}
+	}
+
+	EXPECT_TRUE(make_page(page, level, seed, n));
+
+	return(n);
+}
+
+/** Check that the records of two pages are identical.
+@param[in]	page	page
+@param[in]	page2	decompressed copy of the page */
+static
+void
+check_page(
+	const page_t*	page,
+	const page_t*	page2)
+{
+	mem_heap_t*	heap = NULL;
+
+	ASSERT_EQ(page_is_leaf(page), page_is_leaf(page2));
+	ASSERT_EQ(page_get_n_recs(page), page_get_n_recs(page2));
+
+	const rec_t*	rec = page_get_infimum_rec(page);
+	const rec_t*	rec2 = page_get_infimum_rec(page2);
+
+	do {
+		rec = page_rec_get_next_const(rec);
+		rec2 = page_rec_get_next_const(rec2);
+
+		ASSERT_EQ(page_offset(rec), page_offset(rec2));
+
+		ulint*	offsets = rec_get_offsets(
+			rec, index, NULL, ULINT_UNDEFINED, &heap);
+
+		EXPECT_EQ(0, memcmp(rec - rec_offs_extra_size(offsets),
+				    rec2 - rec_offs_extra_size(offsets),
+				    rec_offs_size(offsets)));
+	} while (!page_rec_is_supremum(rec));
+
+	mem_heap_free(heap);
+}
+
+/* Leaf and non-leaf pages compressed with each codec decompress to the
+original page, and the codec is identified by the compressed data. */
+TEST_F(page0zip, codec_round_trip)
+{
+	page_buf	page;
+	page_buf	page2;
+
+	for (ulint level = 0; level < 2; level++) {
+		for (ulint seed = 0; seed < 4; seed++) {
+			ASSERT_LT(0U, fill_page(page, level, seed,
+						PAGE_ZIP_CODEC_LZ4));
+
+			for (ulint c = 0; c < PAGE_ZIP_CODEC_N; c++) {
+				zip_buf	zip;
+
+				ASSERT_TRUE(compress(zip, page,
+						     page_zip_codec_t(c)));
+				EXPECT_EQ(c == PAGE_ZIP_CODEC_LZ4,
+					  zip.is_lz4());
+
+				memset(page2.page(), 0, UNIV_PAGE_SIZE);
+				ASSERT_TRUE(page_zip_decompress(
+						    zip.zip(), page2.page(),
+						    TRUE));
+				check_page(page.page(), page2.page());
+			}
+		}
+	}
+}
+
+/* A page that does not fit with LZ4 is compressed with zlib, if it fits
+with zlib. */
+TEST_F(page0zip, codec_fallback)
+{
+	page_buf	page;
+	page_buf	page2;
+
+	for (ulint level = 0; level < 2; level++) {
+		const ulint	n_lz4 = fill_page(page, level, 0,
+						  PAGE_ZIP_CODEC_LZ4);
+		const ulint	n_zlib = fill_page(page, level, 0,
+						   PAGE_ZIP_CODEC_ZLIB);
+
+		/* zlib compresses index pages better than LZ4, so the
+		pages that the B-tree fills with zlib need the fallback. */
+		ASSERT_LT(n_lz4, n_zlib);
+
+		zip_buf	zip;
+
+		ASSERT_TRUE(compress(zip, page, PAGE_ZIP_CODEC_LZ4));
+		EXPECT_FALSE(zip.is_lz4());
+
+		ASSERT_TRUE(page_zip_decompress(zip.zip(), page2.page(),
+						TRUE));
+		check_page(page.page(), page2.page());
+
+		/* Neither codec fits. */
+		ASSERT_TRUE(make_page(page, level, 0, n_zlib + 1));
+		EXPECT_FALSE(compress(zip, page, PAGE_ZIP_CODEC_LZ4));
+		EXPECT_FALSE(compress(zip, page, PAGE_ZIP_CODEC_ZLIB));
+	}
+}
+
+/* Compression and decompression speed and the compression ratio of each
+codec on full leaf and non-leaf pages. Increase n_rounds for actual
+benchmarking! */
+TEST_F(page0zip, codec_speed)
+{
+	static const char*	codec_names[] = {"zlib", "lz4"};
+	static const char*	level_names[] = {"leaf", "non-leaf"};
+	const ulint		n_pages = 8;
+	const ulint		n_rounds = 4;
+	page_buf		pages[n_pages];
+	zip_buf			zips[n_pages];
+	page_buf		page2;
+
+	for (ulint level = 0; level < 2; level++) {
+		ulint	data_len = 0;
+
+		/* Pages that both codecs can compress */
+		for (ulint i = 0; i < n_pages; i++) {
+			fill_page(pages[i], level, i, PAGE_ZIP_CODEC_LZ4);
+			data_len += page_header_get_field(
+				pages[i].page(), PAGE_HEAP_TOP) - PAGE_DATA;
+		}
+
+		for (ulint c = 0; c < PAGE_ZIP_CODEC_N; c++) {
+			ulint		total = 0;
+			ulonglong	start = my_micro_time();
+
+			for (ulint r = 0; r < n_rounds; r++) {
+				for (ulint i = 0; i < n_pages; i++) {
+					ASSERT_TRUE(compress(
+						zips[i], pages[i],
+						page_zip_codec_t(c)));
+				}
+			}
+
+			ulonglong	t_compress = my_micro_time() - start;
+
+			for (ulint i = 0; i < n_pages; i++) {
+				total += zips[i].stream_len();
+			}
+
+			start = my_micro_time();
+
+			for (ulint r = 0; r < n_rounds; r++) {
+				for (ulint i = 0; i < n_pages; i++) {
+					ASSERT_TRUE(page_zip_decompress(
+						zips[i].zip(), page2.page(),
+						TRUE));
+				}
+			}
+
+			ulonglong	t_decompress = my_micro_time() - start;
+
+			const double	mb = static_cast<double>(
+				n_rounds * data_len) / (1024 * 1024);
+
+			std::cout << level_names[level]
+				<< " codec: " << codec_names[c]
+				<< " compress: "
+				<< mb * 1000000 / (t_compress + 1) << " MB/s"
+				<< " decompress: "
+				<< mb * 1000000 / (t_decompress + 1) << " MB/s"
+				<< " ratio: "
+				<< static_cast<double>(data_len) / total
+				<< std::endl;
+		}
+	}
+}
+
+}
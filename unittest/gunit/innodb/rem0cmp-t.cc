@@ -0,0 +1,165 @@
+/* Copyright (c) 2023, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <vector>
+
+#include "my_sys.h"
+
+#include "univ.i"
+
+#include "rem0cmp.h"
+#include "ut0rnd.h"
+
+namespace innodb_rem0cmp_unittest {
+
+/** The sign of a comparison result. */
+static
+int
+sign(int cmp)
+{
+	return(cmp < 0 ? -1 : cmp > 0);
+}
+
+/** Precise type of a BINARY(n) column */
+static const ulint	BINARY_PRTYPE = dtype_form_prtype(
+	DATA_NOT_NULL | DATA_BINARY_TYPE, DATA_MYSQL_BINARY_CHARSET_COLL);
+
+/** Fill two keys which are equal up to a random position.
+@param[out]	key1	first key
+@param[out]	key2	second key
+@param[in]	len	length of the keys */
+static
+void
+make_keys(byte* key1, byte* key2, ulint len)
+{
+	ulint	diff = ut_rnd_gen_ulint() % (len + 1);
+
+	for (ulint i = 0; i < len; i++) {
+		key1[i] = key2[i] = static_cast<byte>(ut_rnd_gen_ulint());
+	}
+
+	if (diff < len) {
+		key2[diff] = static_cast<byte>(ut_rnd_gen_ulint());
+	}
+}
+
+/* cmp_fixed_binary() orders fields like cmp_data_data() does for
+the integer, system and binary columns. */
+TEST(rem0cmp, fixed_binary)
+{
+	byte	key1[40];
+	byte	key2[40];
+
+	for (ulint len = 0; len <= sizeof key1; len++) {
+		for (ulint i = 0; i < 1000; i++) {
+			make_keys(key1, key2, len);
+
+			int	expected = sign(cmp_data_data(
+				DATA_FIXBINARY, BINARY_PRTYPE,
+				key1, len, key2, len));
+
+			EXPECT_EQ(expected,
+				  sign(cmp_fixed_binary(key1, key2, len)));
+			EXPECT_EQ(expected, sign(cmp_data_data(
+				DATA_INT, DATA_NOT_NULL | DATA_UNSIGNED,
+				key1, len, key2, len)));
+			EXPECT_EQ(-expected,
+				  sign(cmp_fixed_binary(key2, key1, len)));
+		}
+	}
+
+	/* The sign bit of the first byte is significant. */
+	byte	lo[8] = {0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+	byte	hi[8] = {0x80, 0, 0, 0, 0, 0, 0, 0};
+
+	for (ulint len = 1; len <= 8; len++) {
+		EXPECT_GT(0, cmp_fixed_binary(lo, hi, len));
+		EXPECT_LT(0, cmp_fixed_binary(hi, lo, len));
+		EXPECT_EQ(0, cmp_fixed_binary(hi, hi, len));
+	}
+}
+
+/* Comparisons per second of the generic and the fixed-length path,
+for the key lengths of INT, DB_ROW_ID, BIGINT and BINARY(16) columns.
+Increase n_cmp for actual benchmarking! */
+TEST(rem0cmp, fixed_binary_speed)
+{
+	const ulint	n_keys = 1024;
+	const ulint	n_cmp = 200000;
+	const ulint	lens[] = {4, 6, 8, 16};
+
+	for (ulint l = 0; l < UT_ARR_SIZE(lens); l++) {
+		const ulint		len = lens[l];
+		std::vector<byte>	keys(2 * n_keys * len);
+
+		for (ulint i = 0; i < n_keys; i++) {
+			make_keys(&keys[2 * i * len],
+				  &keys[(2 * i + 1) * len], len);
+		}
+
+		int		sum_data = 0;
+		int		sum_fixed = 0;
+		ulonglong	start = my_micro_time();
+
+		for (ulint i = 0; i < n_cmp; i++) {
+			const byte*	key = &keys[2 * (i % n_keys) * len];
+
+			sum_data += sign(cmp_data_data(
+				DATA_FIXBINARY, BINARY_PRTYPE,
+				key, len, key + len, len));
+		}
+
+		ulonglong	t_data = my_micro_time() - start;
+
+		start = my_micro_time();
+
+		for (ulint i = 0; i < n_cmp; i++) {
+			const byte*	key = &keys[2 * (i % n_keys) * len];
+
+			sum_fixed += sign(cmp_fixed_binary(
+				key, key + len, len));
+		}
+
+		ulonglong	t_fixed = my_micro_time() - start;
+
+		EXPECT_EQ(sum_data, sum_fixed);
+
+		const double	n = static_cast<double>(n_cmp);
+
+		std::cout << "key length: " << len
+			<< " cmp_data: "
+			<< n * 1000000 / (t_data + 1) << " cmp/s"
+			<< " cmp_fixed_binary: "
+			<< n * 1000000 / (t_fixed + 1) << " cmp/s"
+			<< std::endl;
+	}
+}
+
+}
@@ -0,0 +1,263 @@
+/* Copyright (c) 2023, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <vector>
+
+#include "my_sys.h"
+#include "thr_mutex.h"
+#include "thread_utils.h"
+
+#include "univ.i"
+
+#include "os0thread.h"
+#include "ut0link_buf.h"
+
+namespace innodb_ut0link_buf_unittest {
+
+typedef Link_buf<ib_uint64_t>	lsn_link_buf_t;
+
+/* Links added in order are consumed at once. */
+TEST(ut0link_buf, sequential)
+{
+	lsn_link_buf_t	buf(16);
+
+	buf.reset(100);
+	EXPECT_EQ(100U, buf.tail());
+	EXPECT_FALSE(buf.advance_tail());
+
+	buf.add_link(100, 105);
+	buf.add_link(105, 120);
+	EXPECT_TRUE(buf.advance_tail());
+	EXPECT_EQ(120U, buf.tail());
+	EXPECT_TRUE(buf.has_space(135));
+	EXPECT_FALSE(buf.has_space(136));
+}
+
+/* The tail stops at the first range which is not completed yet. */
+TEST(ut0link_buf, out_of_order)
+{
+	lsn_link_buf_t	buf(64);
+
+	buf.reset(0);
+
+	buf.add_link(10, 20);
+	buf.add_link(30, 31);
+	EXPECT_FALSE(buf.advance_tail());
+	EXPECT_FALSE(buf.advance_tail_until(10));
+
+	buf.add_link(0, 10);
+	EXPECT_TRUE(buf.advance_tail_until(20));
+	EXPECT_EQ(20U, buf.tail());
+
+	buf.add_link(20, 30);
+	EXPECT_TRUE(buf.advance_tail_until(31));
+	EXPECT_EQ(31U, buf.tail());
+
+	/* Wrap around the slots. */
+	buf.add_link(31, 100);
+	buf.add_link(100, 101);
+	EXPECT_TRUE(buf.advance_tail_until(101));
+	ut_d(buf.validate_no_links());
+}
+
+/** Simulated redo log system: mini-transactions reserve an LSN range
+under a mutex and copy their records into a circular buffer. */
+struct sim_log_t {
+	/** Size of the simulated log buffer in bytes */
+	static const ulint	BUF_SIZE = 1024 * 1024;
+
+	sim_log_t(bool copy_under_mutex)
+		:
+		m_recent_written(64 * 1024),
+		m_lsn(0),
+		m_copy_under_mutex(copy_under_mutex)
+	{
+		native_mutex_init(&m_mutex, NULL);
+		m_buf = new byte[BUF_SIZE];
+		m_recent_written.reset(0);
+	}
+
+	~sim_log_t()
+	{
+		delete[] m_buf;
+		native_mutex_destroy(&m_mutex);
+	}
+
+	/** Commit a mini-transaction of the given length. */
+	void commit(const byte* rec, ulint len)
+	{
+		native_mutex_lock(&m_mutex);
+
+		/* Like log_reserve_and_open(): wait for space in the
+		buffer and in the link buffer. */
+		while (m_lsn + len - m_recent_written.tail() > BUF_SIZE
+		       || !m_recent_written.has_space(m_lsn)) {
+
+			if (!m_recent_written.advance_tail()) {
+				native_mutex_unlock(&m_mutex);
+				os_thread_yield();
+				native_mutex_lock(&m_mutex);
+			}
+		}
+
+		const ib_uint64_t	start_lsn = m_lsn;
+
+		m_lsn += len;
+
+		if (m_copy_under_mutex) {
+			copy(start_lsn, rec, len);
+			m_recent_written.add_link(start_lsn, start_lsn + len);
+			native_mutex_unlock(&m_mutex);
+		} else {
+			native_mutex_unlock(&m_mutex);
+			copy(start_lsn, rec, len);
+			m_recent_written.add_link(start_lsn, start_lsn + len);
+		}
+	}
+
+	/** Copy records to the circular buffer. */
+	void copy(ib_uint64_t lsn, const byte* rec, ulint len)
+	{
+		for (ulint i = 0; i < len; ++i) {
+			m_buf[(lsn + i) % BUF_SIZE] = rec[i];
+		}
+	}
+
+	/** @return end of the completed prefix */
+	ib_uint64_t completed_lsn()
+	{
+		native_mutex_lock(&m_mutex);
+		m_recent_written.advance_tail();
+		ib_uint64_t	lsn = m_recent_written.tail();
+		native_mutex_unlock(&m_mutex);
+		return(lsn);
+	}
+
+	native_mutex_t	m_mutex;
+	lsn_link_buf_t	m_recent_written;
+	ib_uint64_t		m_lsn;
+	byte*		m_buf;
+	bool		m_copy_under_mutex;
+};
+
+/** A thread committing mini-transactions. */
+class Committer : public thread::Thread {
+public:
+	Committer(sim_log_t* log, ulint n_commits, ulint rec_len)
+		:
+		m_log(log),
+		m_n_commits(n_commits),
+		m_rec(rec_len, 0xa5)
+	{}
+
+protected:
+	virtual void run()
+	{
+		for (ulint i = 0; i < m_n_commits; ++i) {
+			m_log->commit(&m_rec[0], m_rec.size());
+		}
+	}
+
+private:
+	sim_log_t*		m_log;
+	ulint			m_n_commits;
+	std::vector<byte>	m_rec;
+};
+
+/** Run a number of committing threads.
+@return elapsed time in microseconds */
+static
+ulonglong
+run_committers(sim_log_t* log, ulint n_threads, ulint n_commits, ulint len)
+{
+	std::vector<Committer*>	threads;
+
+	ulonglong	start = my_micro_time();
+
+	for (ulint i = 0; i < n_threads; ++i) {
+		threads.push_back(new Committer(log, n_commits, len));
+		threads.back()->start();
+	}
+
+	for (ulint i = 0; i < n_threads; ++i) {
+		threads[i]->join();
+		delete threads[i];
+	}
+
+	return(my_micro_time() - start);
+}
+
+/* All the concurrently reserved ranges are eventually consumed. */
+TEST(ut0link_buf, concurrent)
+{
+	const ulint	n_threads = 8;
+	const ulint	n_commits = 2000;
+	const ulint	len = 97;
+
+	sim_log_t	log(false);
+
+	run_committers(&log, n_threads, n_commits, len);
+
+	EXPECT_EQ(n_threads * n_commits * len, log.completed_lsn());
+	EXPECT_EQ(log.m_lsn, log.completed_lsn());
+}
+
+/* Commit throughput when the records are copied under the log mutex,
+compared to reserving under the mutex and copying in parallel.
+Increase n_commits for actual benchmarking! */
+TEST(ut0link_buf, commit_scaling)
+{
+	const ulint	n_commits = 200;
+	const ulint	len = 512;
+
+	for (ulint n_threads = 1; n_threads <= 64; n_threads *= 2) {
+		sim_log_t	serial(true);
+		sim_log_t	parallel(false);
+
+		ulonglong	t_serial = run_committers(
+			&serial, n_threads, n_commits, len);
+		ulonglong	t_parallel = run_committers(
+			&parallel, n_threads, n_commits, len);
+
+		EXPECT_EQ(serial.m_lsn, serial.completed_lsn());
+		EXPECT_EQ(parallel.m_lsn, parallel.completed_lsn());
+
+		const double	n = static_cast<double>(n_threads * n_commits);
+
+		std::cout << "threads: " << n_threads
+			<< " copy under mutex: "
+			<< n * 1000000 / (t_serial + 1) << " commits/s"
+			<< " reserve and link: "
+			<< n * 1000000 / (t_parallel + 1) << " commits/s"
+			<< std::endl;
+	}
+}
+
+}